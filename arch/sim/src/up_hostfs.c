@@ -45,15 +45,48 @@
 #include <sys/ioctl.h>
 
 #include <dirent.h>
+#include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
 #include <errno.h>
 
+#ifdef __linux__
+#  include <stdint.h>
+#  include <sys/syscall.h>
+#endif
+
 #define __SIM__ 1
 #include "hostfs.h"
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef __linux__
+/* The form of one directory record returned by the Linux getdents64()
+ * system call.
+ */
+
+struct host_dirent64_s
+{
+  uint64_t       d_ino;
+  int64_t        d_off;          /* Offset of the next record */
+  unsigned short d_reclen;       /* Size of this record */
+  unsigned char  d_type;
+  char           d_name[];
+};
+
+/* The largest possible record:  The name is at most NAME_MAX bytes plus a
+ * NUL terminator and the record is padded to a multiple of 8 bytes.
+ */
+
+#define HOST_DIRENT64_MAX \
+  ((offsetof(struct host_dirent64_s, d_name) + NAME_MAX + 1 + 7) & ~7)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,6 +138,31 @@ static void host_stat_convert(struct stat *hostbuf, struct nuttx_stat_s *buf)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: host_dtype_convert
+ ****************************************************************************/
+
+static uint8_t host_dtype_convert(unsigned char d_type)
+{
+  switch (d_type)
+    {
+      case DT_REG:
+        return NUTTX_DTYPE_FILE;
+
+      case DT_CHR:
+        return NUTTX_DTYPE_CHR;
+
+      case DT_BLK:
+        return NUTTX_DTYPE_BLK;
+
+      case DT_DIR:
+        return NUTTX_DTYPE_DIRECTORY;
+
+      default:
+        return 0;
+    }
+}
+
 /****************************************************************************
  * Name: host_open
  ****************************************************************************/
@@ -112,6 +170,7 @@ static void host_stat_convert(struct stat *hostbuf, struct nuttx_stat_s *buf)
 int host_open(const char *pathname, int flags, int mode)
 {
   int mapflags;
+  int ret;
 
   /* Perform flag mapping */
 
@@ -153,7 +212,8 @@ int host_open(const char *pathname, int flags, int mode)
       mapflags |= O_NONBLOCK;
     }
 
-  return open(pathname, mapflags, mode);
+  ret = open(pathname, mapflags, mode);
+  return ret < 0 ? -errno : ret;
 }
 
 /****************************************************************************
@@ -162,9 +222,12 @@ int host_open(const char *pathname, int flags, int mode)
 
 int host_close(int fd)
 {
+  int ret;
+
   /* Just call the close routine */
 
-  return close(fd);
+  ret = close(fd);
+  return ret < 0 ? -errno : ret;
 }
 
 /****************************************************************************
@@ -173,9 +236,12 @@ int host_close(int fd)
 
 ssize_t host_read(int fd, void* buf, size_t count)
 {
+  ssize_t ret;
+
   /* Just call the read routine */
 
-  return read(fd, buf, count);
+  ret = read(fd, buf, count);
+  return ret < 0 ? -errno : ret;
 }
 
 /****************************************************************************
@@ -184,9 +250,41 @@ ssize_t host_read(int fd, void* buf, size_t count)
 
 ssize_t host_write(int fd, const void *buf, size_t count)
 {
+  ssize_t ret;
+
   /* Just call the write routine */
 
-  return write(fd, buf, count);
+  ret = write(fd, buf, count);
+  return ret < 0 ? -errno : ret;
+}
+
+/****************************************************************************
+ * Name: host_pread
+ ****************************************************************************/
+
+ssize_t host_pread(int fd, void *buf, size_t count, nuttx_off_t offset)
+{
+  ssize_t ret;
+
+  /* Read at the given offset without moving the file position */
+
+  ret = pread(fd, buf, count, offset);
+  return ret < 0 ? -errno : ret;
+}
+
+/****************************************************************************
+ * Name: host_pwrite
+ ****************************************************************************/
+
+ssize_t host_pwrite(int fd, const void *buf, size_t count,
+                    nuttx_off_t offset)
+{
+  ssize_t ret;
+
+  /* Write at the given offset without moving the file position */
+
+  ret = pwrite(fd, buf, count, offset);
+  return ret < 0 ? -errno : ret;
 }
 
 /****************************************************************************
@@ -195,9 +293,12 @@ ssize_t host_write(int fd, const void *buf, size_t count)
 
 off_t host_lseek(int fd, off_t offset, int whence)
 {
+  off_t ret;
+
   /* Just call the lseek routine */
 
-  return lseek(fd, offset, whence);
+  ret = lseek(fd, offset, whence);
+  return ret < 0 ? -errno : ret;
 }
 
 /****************************************************************************
@@ -206,9 +307,12 @@ off_t host_lseek(int fd, off_t offset, int whence)
 
 int host_ioctl(int fd, int request, unsigned long arg)
 {
+  int ret;
+
   /* Just call the ioctl routine */
 
-  return ioctl(fd, request, arg);
+  ret = ioctl(fd, request, arg);
+  return ret < 0 ? -errno : ret;
 }
 
 /****************************************************************************
@@ -228,7 +332,10 @@ void host_sync(int fd)
 
 int host_dup(int fd)
 {
-  return dup(fd);
+  int ret;
+
+  ret = dup(fd);
+  return ret < 0 ? -errno : ret;
 }
 
 /****************************************************************************
@@ -243,6 +350,10 @@ int host_fstat(int fd, struct nuttx_stat_s *buf)
   /* Call the host's stat routine */
 
   ret = fstat(fd, &hostbuf);
+  if (ret < 0)
+    {
+      return -errno;
+    }
 
   /* Map the return values */
 
@@ -280,30 +391,84 @@ int host_readdir(void* dirp, struct nuttx_dirent_s* entry)
 
       /* Map the type */
 
-      entry->d_type = 0;
-      if (ent->d_type == DT_REG)
-        {
-          entry->d_type = NUTTX_DTYPE_FILE;
-        }
-      else if (ent->d_type == DT_CHR)
-        {
-          entry->d_type = NUTTX_DTYPE_CHR;
-        }
-      else if (ent->d_type == DT_BLK)
-        {
-          entry->d_type = NUTTX_DTYPE_BLK;
-        }
-      else if (ent->d_type == DT_DIR)
-        {
-          entry->d_type = NUTTX_DTYPE_DIRECTORY;
-        }
-
+      entry->d_type = host_dtype_convert(ent->d_type);
       return 0;
     }
 
   return -ENOENT;
 }
 
+/****************************************************************************
+ * Name: host_readdirv
+ *
+ * Description:
+ *   Read up to 'nentries' directory entries.  On Linux, all of them come
+ *   from a single getdents64() system call on the directory.  Returns the
+ *   number of entries read; zero at the end of the directory.
+ *
+ ****************************************************************************/
+
+int host_readdirv(void *dirp, struct nuttx_dirent_s *entries, int nentries)
+{
+#ifdef __linux__
+  struct host_dirent64_s *ent = NULL;
+  char *buffer;
+  long nread;
+  long pos;
+  int fd;
+  int n;
+
+  fd = dirfd(dirp);
+  buffer = malloc(nentries * HOST_DIRENT64_MAX);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nread = syscall(SYS_getdents64, fd, buffer,
+                  nentries * HOST_DIRENT64_MAX);
+  if (nread < 0)
+    {
+      n = -errno;
+      free(buffer);
+      return n;
+    }
+
+  for (n = 0, pos = 0; n < nentries && pos < nread; n++)
+    {
+      ent = (struct host_dirent64_s *)&buffer[pos];
+      pos += ent->d_reclen;
+
+      strncpy(entries[n].d_name, ent->d_name, sizeof(entries[n].d_name));
+      entries[n].d_type = host_dtype_convert(ent->d_type);
+    }
+
+  /* Short names may have let more records into the buffer than were
+   * asked for.  Resume the next read after the last record returned.
+   */
+
+  if (pos < nread)
+    {
+      lseek(fd, ent->d_off, SEEK_SET);
+    }
+
+  free(buffer);
+  return n;
+#else
+  int n;
+
+  for (n = 0; n < nentries; n++)
+    {
+      if (host_readdir(dirp, &entries[n]) < 0)
+        {
+          break;
+        }
+    }
+
+  return n;
+#endif
+}
+
 /****************************************************************************
  * Name: host_rewinddir
  ****************************************************************************/
@@ -321,7 +486,10 @@ void host_rewinddir(void *dirp)
 
 int host_closedir(void *dirp)
 {
-  return closedir(dirp);
+  int ret;
+
+  ret = closedir(dirp);
+  return ret < 0 ? -errno : ret;
 }
 
 /****************************************************************************
@@ -336,6 +504,10 @@ int host_statfs(const char *path, struct nuttx_statfs_s *buf)
   /* Call the host's statfs routine */
 
   ret = statfs(path, &hostbuf);
+  if (ret < 0)
+    {
+      return -errno;
+    }
 
   /* Map the struct statfs value */
 
@@ -357,7 +529,10 @@ int host_statfs(const char *path, struct nuttx_statfs_s *buf)
 
 int host_unlink(const char *pathname)
 {
-  return unlink(pathname);
+  int ret;
+
+  ret = unlink(pathname);
+  return ret < 0 ? -errno : ret;
 }
 
 /****************************************************************************
@@ -366,9 +541,12 @@ int host_unlink(const char *pathname)
 
 int host_mkdir(const char *pathname, mode_t mode)
 {
+  int ret;
+
   /* Just call the host's mkdir routine */
 
-  return mkdir(pathname, mode);
+  ret = mkdir(pathname, mode);
+  return ret < 0 ? -errno : ret;
 }
 
 /****************************************************************************
@@ -377,7 +555,10 @@ int host_mkdir(const char *pathname, mode_t mode)
 
 int host_rmdir(const char *pathname)
 {
-  return rmdir(pathname);
+  int ret;
+
+  ret = rmdir(pathname);
+  return ret < 0 ? -errno : ret;
 }
 
 /****************************************************************************
@@ -386,7 +567,10 @@ int host_rmdir(const char *pathname)
 
 int host_rename(const char *oldpath, const char *newpath)
 {
-  return rename(oldpath, newpath);
+  int ret;
+
+  ret = rename(oldpath, newpath);
+  return ret < 0 ? -errno : ret;
 }
 
 /****************************************************************************
@@ -401,6 +585,10 @@ int host_stat(const char *path, struct nuttx_stat_s *buf)
   /* Call the host's stat routine */
 
   ret = stat(path, &hostbuf);
+  if (ret < 0)
+    {
+      return -errno;
+    }
 
   /* Map the return values */
 
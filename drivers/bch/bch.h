@@ -55,6 +55,17 @@
 #define bchlib_semgive(d) nxsem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* Number of consecutive sectors held in the sector cache */
+
+#ifndef CONFIG_BCH_CACHE_NSECTORS
+#  define CONFIG_BCH_CACHE_NSECTORS 1
+#endif
+
+/* Address of a cached sector in the sector cache */
+
+#define bchlib_sectbuf(d,s) \
+  (&(d)->buffer[((s) - (d)->sector) * (d)->sectsize])
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -64,13 +75,16 @@ struct bchlib_s
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
+  size_t sector;           /* The first sector in the buffer */
   sem_t sem;               /* For atomic accesses to this structure */
+  uint16_t ncached;        /* Number of sectors in the buffer */
+  uint16_t dirtyfirst;     /* First dirty sector (relative to sector) */
+  uint16_t dirtylast;      /* Last dirty sector (relative to sector) */
   uint8_t refs;            /* Number of references */
   bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* Buffer of consecutive sectors */
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -98,6 +112,15 @@ EXTERN const struct file_operations bch_fops;
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_cachesectors(FAR struct bchlib_s *bch, size_t sector,
+                                size_t nsectors);
+EXTERN void bchlib_markdirty(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors, bool invalidate);
+#if defined(CONFIG_BCH_ENCRYPTION)
+EXTERN void bchlib_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data,
+                          size_t sector, size_t nsectors, int encrypt);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -70,48 +70,55 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
 #endif
 
 /****************************************************************************
- * Name: bch_cypher
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_cypher
+ *
+ * Description:
+ *   Encrypt or decrypt a run of consecutive sectors in place
+ *
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+void bchlib_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data,
+                   size_t sector, size_t nsectors, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)data;
   int i;
 
-  for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+  for (; nsectors > 0; nsectors--, sector++)
     {
-      uint32_t T[4];
-      uint32_t X[4] =
-      {
-        bch->sector, 0, 0, i
-      };
+      for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+        {
+          uint32_t T[4];
+          uint32_t X[4] =
+          {
+            sector, 0, 0, i
+          };
 
-      aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, CYPHER_ENCRYPT);
+          aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
+                     AES_MODE_ECB, CYPHER_ENCRYPT);
 
-      /* Xor-Encrypt-Xor */
+          /* Xor-Encrypt-Xor */
 
-      bch_xor(T, X, buffer);
-      aes_cypher(T, T, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, encrypt);
-      bch_xor(buffer, X, T);
+          bch_xor(T, X, buffer);
+          aes_cypher(T, T, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
+                     AES_MODE_ECB, encrypt);
+          bch_xor(buffer, X, T);
+        }
     }
-
-  return OK;
 }
 #endif
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush the dirty sectors in the sector buffer (if any) with a single
+ *   write to the block driver.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -121,6 +128,9 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 int bchlib_flushsector(FAR struct bchlib_s *bch)
 {
   FAR struct inode *inode;
+  FAR uint8_t *buffer;
+  size_t sector;
+  size_t nsectors;
   ssize_t ret = OK;
 
   /* Check if the sector has been modified and is out of synch with the
@@ -129,20 +139,23 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 
   if (bch->dirty)
     {
-      inode = bch->inode;
+      inode    = bch->inode;
+      sector   = bch->sector + bch->dirtyfirst;
+      nsectors = bch->dirtylast - bch->dirtyfirst + 1;
+      buffer   = bchlib_sectbuf(bch, sector);
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bchlib_cypher(bch, buffer, sector, nsectors, CYPHER_ENCRYPT);
 #endif
 
-      /* Write the sector to the media */
+      /* Write the sectors to the media */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      ret = inode->u.i_bops->write(inode, buffer, sector, nsectors);
       if (ret < 0)
         {
-          ferr("Write failed: %d\n");
+          ferr("Write failed: %d\n", ret);
         }
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -150,7 +163,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bchlib_cypher(bch, buffer, sector, nsectors, CYPHER_DECRYPT);
 #endif
 
       /* The sector is now in sync with the media */
@@ -165,7 +178,12 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make sure that the sector is in the sector buffer.  If the sector
+ *   immediately follows the sectors in the buffer, sequential access is
+ *   assumed:  The sector is appended to the buffer if there is room (so
+ *   that dirty sectors on both sides of the boundary are written together)
+ *   or else the buffer is refilled with as many sectors as it will hold
+ *   (read-ahead).  Otherwise only the requested sector is read.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -175,25 +193,173 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
   FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR uint8_t *buffer;
+  size_t nsectors;
+  ssize_t ret;
+
+  if (sector >= bch->sector && sector < bch->sector + bch->ncached)
+    {
+      return OK;
+    }
 
-  if (bch->sector != sector)
+  inode    = bch->inode;
+  nsectors = 1;
+
+  if (bch->ncached > 0 && sector == bch->sector + bch->ncached)
     {
-      inode = bch->inode;
+      /* Sequential access.  Append if there is room, else read ahead */
+
+      if (bch->ncached < CONFIG_BCH_CACHE_NSECTORS)
+        {
+          nsectors = CONFIG_BCH_CACHE_NSECTORS - bch->ncached;
+        }
+      else
+        {
+          nsectors = CONFIG_BCH_CACHE_NSECTORS;
+        }
 
-      (void)bchlib_flushsector(bch);
-      bch->sector = (size_t)-1;
+      if (sector + nsectors > bch->nsectors)
+        {
+          nsectors = bch->nsectors - sector;
+        }
+    }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+  if (bch->ncached == 0 || sector != bch->sector + bch->ncached ||
+      bch->ncached >= CONFIG_BCH_CACHE_NSECTORS)
+    {
+      /* Replace the buffer contents */
+
+      ret = bchlib_flushsector(bch);
       if (ret < 0)
         {
-          ferr("Read failed: %d\n");
+          return (int)ret;
         }
-      bch->sector = sector;
+
+      bch->sector  = sector;
+      bch->ncached = 0;
+    }
+
+  buffer = &bch->buffer[bch->ncached * bch->sectsize];
+  ret    = inode->u.i_bops->read(inode, buffer, sector, nsectors);
+  if (ret < 0)
+    {
+      ferr("Read failed: %d\n", ret);
+
+      /* Keep whatever was already in the buffer; if nothing was, the
+       * buffer is empty.
+       */
+
+      if (bch->ncached == 0)
+        {
+          bch->sector = (size_t)-1;
+        }
+
+      return (int)ret;
+    }
+
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+  bchlib_cypher(bch, buffer, sector, nsectors, CYPHER_DECRYPT);
 #endif
+
+  bch->ncached += nsectors;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_cachesectors
+ *
+ * Description:
+ *   Place up to nsectors consecutive sectors in the sector buffer without
+ *   reading them.  The caller must overwrite all of them.  Returns the
+ *   number of sectors placed in the buffer.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_cachesectors(FAR struct bchlib_s *bch, size_t sector,
+                        size_t nsectors)
+{
+  int ret;
+
+  ret = bchlib_flushsector(bch);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (nsectors > CONFIG_BCH_CACHE_NSECTORS)
+    {
+      nsectors = CONFIG_BCH_CACHE_NSECTORS;
+    }
+
+  bch->sector  = sector;
+  bch->ncached = nsectors;
+  return nsectors;
+}
+
+/****************************************************************************
+ * Name: bchlib_markdirty
+ *
+ * Description:
+ *   Mark a sector in the sector buffer as modified
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_markdirty(FAR struct bchlib_s *bch, size_t sector)
+{
+  uint16_t index = sector - bch->sector;
+
+  DEBUGASSERT(sector >= bch->sector && index < bch->ncached);
+
+  if (!bch->dirty)
+    {
+      bch->dirtyfirst = index;
+      bch->dirtylast  = index;
+      bch->dirty      = true;
+    }
+  else if (index < bch->dirtyfirst)
+    {
+      bch->dirtyfirst = index;
+    }
+  else if (index > bch->dirtylast)
+    {
+      bch->dirtylast = index;
     }
-  return (int)ret;
 }
 
+/****************************************************************************
+ * Name: bchlib_flushrange
+ *
+ * Description:
+ *   Prepare for a transfer that bypasses the sector buffer.  If any of the
+ *   sectors are in the sector buffer, dirty sectors are flushed and, if
+ *   the transfer will modify the sectors, the buffer is invalidated.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                      size_t nsectors, bool invalidate)
+{
+  int ret = OK;
+
+  if (bch->ncached > 0 && sector < bch->sector + bch->ncached &&
+      sector + nsectors > bch->sector)
+    {
+      ret = bchlib_flushsector(bch);
+      if (invalidate)
+        {
+          bch->sector  = (size_t)-1;
+          bch->ncached = 0;
+        }
+    }
+
+  return ret;
+}
@@ -48,6 +48,10 @@
 
 #include "bch.h"
 
+#if defined(CONFIG_BCH_ENCRYPTION)
+#  include <crypto/crypto.h>
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -113,7 +117,11 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
     {
       /* Read the sector into the sector buffer */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector to the user buffer */
 
@@ -126,7 +134,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, bchlib_sectbuf(bch, sector) + sectoffset, nbytes);
 
       /* Adjust pointers and counts */
 
@@ -142,8 +150,29 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
       len       -= nbytes;
     }
 
-  /* Then read all of the full sectors following the partial sector directly
-   * into the user buffer.
+  /* Take any full sectors that are already in the sector buffer (usually
+   * because of read-ahead) from there.
+   */
+
+  while (len >= bch->sectsize && sector >= bch->sector &&
+         sector < bch->sector + bch->ncached)
+    {
+      memcpy(buffer, bchlib_sectbuf(bch, sector), bch->sectsize);
+
+      sector++;
+      bytesread += bch->sectsize;
+
+      if (sector >= bch->nsectors)
+        {
+          return bytesread;
+        }
+
+      buffer    += bch->sectsize;
+      len       -= bch->sectsize;
+    }
+
+  /* Then read all of the remaining full sectors directly into the user
+   * buffer.
    */
 
   if (len >= bch->sectsize)
@@ -154,14 +183,29 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           nsectors = bch->nsectors - sector;
         }
 
+      /* Make sure that the media holds any modified data in the range */
+
+      ret = bchlib_flushrange(bch, sector, nsectors, false);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
       ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
                                        sector, nsectors);
       if (ret < 0)
         {
-          ferr("ERROR: Read failed: %d\n");
+          ferr("ERROR: Read failed: %d\n", ret);
           return ret;
         }
 
+#if defined(CONFIG_BCH_ENCRYPTION)
+      /* Decrypt the whole run in place */
+
+      bchlib_cypher(bch, (FAR uint8_t *)buffer, sector, nsectors,
+                    CYPHER_DECRYPT);
+#endif
+
       /* Adjust pointers and counts */
 
       sector    += nsectors;
@@ -183,11 +227,15 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
     {
       /* Read the sector into the sector buffer */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector);
+      if (ret < 0)
+        {
+          return bytesread > 0 ? (ssize_t)bytesread : ret;
+        }
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      memcpy(buffer, bchlib_sectbuf(bch, sector), len);
 
       /* Adjust counts */
 
@@ -51,6 +51,10 @@
 
 #include "bch.h"
 
+#if defined(CONFIG_BCH_ENCRYPTION)
+#  include <crypto/crypto.h>
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -99,7 +103,11 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
     {
       /* Read the full sector into the sector buffer */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector from the user buffer */
 
@@ -112,8 +120,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           nbytes = len;
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      memcpy(bchlib_sectbuf(bch, sector) + sectoffset, buffer, nbytes);
+      bchlib_markdirty(bch, sector);
 
       /* Adjust pointers and counts */
 
@@ -129,9 +137,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
       len          -= nbytes;
     }
 
-  /* Then write all of the full sectors following the partial sector
-   * directly from the user buffer.
-   */
+  /* Then write all of the full sectors following the partial sector */
 
   if (len >= bch->sectsize)
     {
@@ -141,7 +147,55 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      /* Write the contiguous sectors */
+#if defined(CONFIG_BCH_ENCRYPTION)
+      /* The user buffer cannot be encrypted in place, so the sectors are
+       * staged through the sector buffer, as many as it will hold at a
+       * time.
+       */
+
+      while (nsectors > 0)
+        {
+          ret = bchlib_cachesectors(bch, sector, nsectors);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          nbytes = ret * bch->sectsize;
+          memcpy(bch->buffer, buffer, nbytes);
+          bchlib_markdirty(bch, sector);
+          bchlib_markdirty(bch, sector + ret - 1);
+
+          ret = bchlib_flushsector(bch);
+          if (ret < 0)
+            {
+              ferr("ERROR: Write failed: %d\n", ret);
+              return ret;
+            }
+
+          /* Adjust pointers and counts */
+
+          sector       += bch->ncached;
+          nsectors     -= bch->ncached;
+          byteswritten += nbytes;
+          buffer       += nbytes;
+          len          -= nbytes;
+        }
+
+      if (sector >= bch->nsectors)
+        {
+          return byteswritten;
+        }
+#else
+      /* Write the contiguous sectors directly from the user buffer.  Any
+       * copy of them in the sector buffer is now stale.
+       */
+
+      ret = bchlib_flushrange(bch, sector, nsectors, true);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
                                         sector, nsectors);
@@ -164,20 +218,27 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
 
       buffer    += nbytes;
       len       -= nbytes;
+#endif
     }
 
   /* Then write any partial final sector */
 
   if (len > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector buffer.  If it follows the initial
+       * partial sector, both are written back together.
+       */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      memcpy(bchlib_sectbuf(bch, sector), buffer, len);
+      bchlib_markdirty(bch, sector);
 
       /* Adjust counts */
 
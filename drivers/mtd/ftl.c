@@ -50,11 +50,17 @@
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/drivers/rwbuffer.h>
 
+#ifdef CONFIG_FTL_REMAP
+#  include <crc32.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -63,10 +69,71 @@
 #  define FTL_HAVE_RWBUFFER 1
 #endif
 
+#ifdef CONFIG_FTL_REMAP
+/* Remapping FTL.  The first R/W block of every physical erase block holds
+ * a header identifying the logical erase block stored in the remaining R/W
+ * blocks.  A logical erase block is updated by writing a complete new copy
+ * to a spare physical erase block, header last.  The header carries a
+ * sequence number so that if power is lost before the old copy is erased,
+ * the newest complete copy is selected on the next initialization.
+ */
+
+#  ifndef CONFIG_FTL_REMAP_SPARES
+#    define CONFIG_FTL_REMAP_SPARES 4
+#  endif
+
+#  ifndef CONFIG_FTL_REMAP_WEARLEVEL
+#    define CONFIG_FTL_REMAP_WEARLEVEL 16
+#  endif
+
+/* Stale erase blocks are erased from the low priority work queue if it is
+ * available.  Otherwise they are erased when they are next allocated.
+ */
+
+#  ifdef CONFIG_SCHED_LPWORK
+#    define FTL_HAVE_RECLAIM 1
+#  endif
+
+#  define FTL_MAGIC          "FTL1"
+#  define FTL_MAGICSIZE      4
+#  define FTL_ERASEDSTATE    0xff
+#  define FTL_UNMAPPED       0xffff
+#  define FTL_UNKNOWN        0xffffffff
+
+/* Physical erase block states */
+
+#  define FTL_PSTATE_ERASED  0     /* Erased, in the spare pool */
+#  define FTL_PSTATE_MAPPED  1     /* Holds the current copy of a logical block */
+#  define FTL_PSTATE_STALE   2     /* Must be erased before it can be reused */
+#  define FTL_PSTATE_BAD     3     /* Failed to erase, never used again */
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FTL_REMAP
+/* This is the header in the first R/W block of each physical erase block */
+
+struct ftl_header_s
+{
+  uint8_t               magic[FTL_MAGICSIZE]; /* FTL_MAGIC */
+  uint16_t              lblock;  /* Logical erase block held here */
+  uint16_t              reserved;
+  uint32_t              seqno;   /* Larger sequence number is newer */
+  uint32_t              erasecount; /* Erase count of this erase block */
+  uint32_t              crc;     /* CRC32 of all of the above */
+};
+
+/* This is the in-memory state of each physical erase block */
+
+struct ftl_pblock_s
+{
+  uint32_t              erasecount; /* Number of times erased */
+  uint8_t               state;   /* See FTL_PSTATE_* definitions */
+};
+#endif
+
 struct ftl_struct_s
 {
   FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
@@ -78,6 +145,17 @@ struct ftl_struct_s
 #ifdef CONFIG_FS_WRITABLE
   FAR uint8_t          *eblock;  /* One, in-memory erase block */
 #endif
+#ifdef CONFIG_FTL_REMAP
+  sem_t                 exclsem; /* Protects the mapping state */
+  uint16_t              datper;  /* Data R/W blocks per erase block */
+  uint16_t              nlblocks; /* Number of logical erase blocks */
+  uint32_t              seqno;   /* Next sequence number */
+  FAR uint16_t         *lmap;    /* Logical to physical erase block map */
+  FAR struct ftl_pblock_s *pblock; /* State of each physical erase block */
+#ifdef FTL_HAVE_RECLAIM
+  struct work_s         work;    /* Background reclaim */
+#endif
+#endif
 };
 
 /****************************************************************************
@@ -99,6 +177,23 @@ static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer,
 static int     ftl_geometry(FAR struct inode *inode, struct geometry *geometry);
 static int     ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg);
 
+#ifdef CONFIG_FTL_REMAP
+static void    ftl_semtake(FAR struct ftl_struct_s *dev);
+static ssize_t ftl_remap_reload(FAR struct ftl_struct_s *dev,
+                 FAR uint8_t *buffer, off_t startblock, size_t nblocks);
+static int     ftl_remap_erase(FAR struct ftl_struct_s *dev, int pblock);
+static int     ftl_remap_allocate(FAR struct ftl_struct_s *dev);
+static int     ftl_remap_commit(FAR struct ftl_struct_s *dev,
+                 uint16_t lblock, int pblock, FAR const uint8_t *data);
+static ssize_t ftl_remap_flush(FAR struct ftl_struct_s *dev,
+                 FAR const uint8_t *buffer, off_t startblock, size_t nblocks);
+#ifdef FTL_HAVE_RECLAIM
+static void    ftl_remap_worker(FAR void *arg);
+#endif
+static bool    ftl_remap_iserased(FAR struct ftl_struct_s *dev, int pblock);
+static int     ftl_remap_scan(FAR struct ftl_struct_s *dev);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -161,6 +256,14 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
                           off_t startblock, size_t nblocks)
 {
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
+#ifdef CONFIG_FTL_REMAP
+  ssize_t nread;
+
+  ftl_semtake(dev);
+  nread = ftl_remap_reload(dev, buffer, startblock, nblocks);
+  nxsem_post(&dev->exclsem);
+  return nread;
+#else
   ssize_t nread;
 
   /* Read the full erase block into the buffer */
@@ -173,6 +276,7 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
     }
 
   return nread;
+#endif
 }
 
 /****************************************************************************
@@ -211,6 +315,14 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
                          off_t startblock, size_t nblocks)
 {
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
+#ifdef CONFIG_FTL_REMAP
+  ssize_t nxfrd;
+
+  ftl_semtake(dev);
+  nxfrd = ftl_remap_flush(dev, buffer, startblock, nblocks);
+  nxsem_post(&dev->exclsem);
+  return nxfrd;
+#else
   off_t  alignedblock;
   off_t  mask;
   off_t  rwblock;
@@ -373,6 +485,7 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
     }
 
   return nblocks;
+#endif /* CONFIG_FTL_REMAP */
 }
 #endif
 
@@ -425,7 +538,11 @@ static int ftl_geometry(FAR struct inode *inode, struct geometry *geometry)
 #else
       geometry->geo_writeenabled  = false;
 #endif
+#ifdef CONFIG_FTL_REMAP
+      geometry->geo_nsectors      = dev->nlblocks * dev->datper;
+#else
       geometry->geo_nsectors      = dev->geo.neraseblocks * dev->blkper;
+#endif
       geometry->geo_sectorsize    = dev->geo.blocksize;
 
       finfo("available: true mediachanged: false writeenabled: %s\n",
@@ -454,6 +571,27 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   finfo("Entry\n");
   DEBUGASSERT(inode && inode->i_private);
 
+#ifdef CONFIG_FTL_REMAP
+  /* With remapping, a logical erase block may be stored in any physical
+   * erase block.  Commands that address the physical media directly would
+   * bypass the remapping table and are not supported.
+   */
+
+  switch (cmd)
+    {
+      case BIOC_XIPBASE:
+      case MTDIOC_XIPBASE:
+      case MTDIOC_BULKERASE:
+      case MTDIOC_PROTECT:
+      case MTDIOC_UNPROTECT:
+        ferr("ERROR: ioctl(%04x) not supported with remapping\n", cmd);
+        return -ENOTTY;
+
+      default:
+        break;
+    }
+#endif
+
   /* Only one block driver ioctl command is supported by this driver (and
    * that command is just passed on to the MTD driver in a slightly
    * different form).
@@ -494,6 +632,588 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: ftl_semtake
+ *
+ * Description: Take the semaphore that protects the remapping state
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_REMAP
+static void ftl_semtake(FAR struct ftl_struct_s *dev)
+{
+  int ret;
+
+  do
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait(&dev->exclsem);
+
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_remap_reload
+ *
+ * Description: Read logical R/W blocks through the logical to physical
+ *   erase block map.  Logical blocks that have never been written read
+ *   back as erased.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_REMAP
+static ssize_t ftl_remap_reload(FAR struct ftl_struct_s *dev,
+                                FAR uint8_t *buffer, off_t startblock,
+                                size_t nblocks)
+{
+  uint16_t lblock;
+  uint16_t pblock;
+  off_t    offset;
+  size_t   remaining;
+  size_t   nxfr;
+  ssize_t  nread;
+
+  if (startblock + nblocks > (off_t)dev->nlblocks * dev->datper)
+    {
+      return -EINVAL;
+    }
+
+  remaining = nblocks;
+  while (remaining > 0)
+    {
+      lblock = startblock / dev->datper;
+      offset = startblock - (off_t)lblock * dev->datper;
+      nxfr   = dev->datper - offset;
+      if (nxfr > remaining)
+        {
+          nxfr = remaining;
+        }
+
+      pblock = dev->lmap[lblock];
+      if (pblock == FTL_UNMAPPED)
+        {
+          memset(buffer, FTL_ERASEDSTATE, nxfr * dev->geo.blocksize);
+        }
+      else
+        {
+          /* Skip over the header block */
+
+          nread = MTD_BREAD(dev->mtd, (off_t)pblock * dev->blkper + 1 + offset,
+                            nxfr, buffer);
+          if (nread != nxfr)
+            {
+              ferr("ERROR: Read %d blocks from erase block %d failed: %d\n",
+                   nxfr, pblock, nread);
+              return -EIO;
+            }
+        }
+
+      startblock += nxfr;
+      remaining  -= nxfr;
+      buffer     += nxfr * dev->geo.blocksize;
+    }
+
+  return nblocks;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_remap_erase
+ *
+ * Description: Erase a physical erase block and add it to the spare pool
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_REMAP
+static int ftl_remap_erase(FAR struct ftl_struct_s *dev, int pblock)
+{
+  int ret;
+
+  ret = MTD_ERASE(dev->mtd, pblock, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block=%d failed: %d\n", pblock, ret);
+      dev->pblock[pblock].state = FTL_PSTATE_BAD;
+      return ret;
+    }
+
+  dev->pblock[pblock].erasecount++;
+  dev->pblock[pblock].state = FTL_PSTATE_ERASED;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_remap_allocate
+ *
+ * Description: Select the least worn erase block from the spare pool.  If
+ *   the spare pool is empty, the least worn stale erase block is erased.
+ *   Returns the physical erase block number or a negated errno value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_REMAP
+static int ftl_remap_allocate(FAR struct ftl_struct_s *dev)
+{
+  int erased = -1;
+  int stale  = -1;
+  int ret;
+  int i;
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      FAR struct ftl_pblock_s *pb = &dev->pblock[i];
+
+      if (pb->state == FTL_PSTATE_ERASED &&
+          (erased < 0 || pb->erasecount < dev->pblock[erased].erasecount))
+        {
+          erased = i;
+        }
+      else if (pb->state == FTL_PSTATE_STALE &&
+               (stale < 0 || pb->erasecount < dev->pblock[stale].erasecount))
+        {
+          stale = i;
+        }
+    }
+
+  if (erased >= 0)
+    {
+      return erased;
+    }
+
+  if (stale < 0)
+    {
+      ferr("ERROR: No spare erase blocks\n");
+      return -ENOSPC;
+    }
+
+  ret = ftl_remap_erase(dev, stale);
+  return ret < 0 ? ret : stale;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_remap_commit
+ *
+ * Description: Write a complete copy of a logical erase block to the
+ *   (erased) physical erase block pblock.  The data blocks are written
+ *   first and the header last so that an interrupted write leaves the
+ *   previous copy in effect.  The previous copy then becomes stale.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_REMAP
+static int ftl_remap_commit(FAR struct ftl_struct_s *dev, uint16_t lblock,
+                            int pblock, FAR const uint8_t *data)
+{
+  FAR struct ftl_header_s *header;
+  uint16_t oldblock;
+  ssize_t  nxfrd;
+
+  DEBUGASSERT(dev->pblock[pblock].state == FTL_PSTATE_ERASED);
+
+  /* Once written, the erase block must be erased again before reuse */
+
+  dev->pblock[pblock].state = FTL_PSTATE_STALE;
+
+  nxfrd = MTD_BWRITE(dev->mtd, (off_t)pblock * dev->blkper + 1, dev->datper,
+                     data);
+  if (nxfrd != dev->datper)
+    {
+      ferr("ERROR: Write erase block %d failed: %d\n", pblock, nxfrd);
+      return -EIO;
+    }
+
+  /* Build the header in the first block of the erase block buffer.  This
+   * does not overlap the data if the data is also in the buffer.
+   */
+
+  memset(dev->eblock, FTL_ERASEDSTATE, dev->geo.blocksize);
+  header             = (FAR struct ftl_header_s *)dev->eblock;
+  memcpy(header->magic, FTL_MAGIC, FTL_MAGICSIZE);
+  header->lblock     = lblock;
+  header->reserved   = 0;
+  header->seqno      = dev->seqno;
+  header->erasecount = dev->pblock[pblock].erasecount;
+  header->crc        = crc32((FAR const uint8_t *)header,
+                             offsetof(struct ftl_header_s, crc));
+
+  nxfrd = MTD_BWRITE(dev->mtd, (off_t)pblock * dev->blkper, 1, dev->eblock);
+  if (nxfrd != 1)
+    {
+      ferr("ERROR: Write header of erase block %d failed: %d\n",
+           pblock, nxfrd);
+      return -EIO;
+    }
+
+  /* The new copy is now in effect */
+
+  dev->seqno++;
+  dev->pblock[pblock].state = FTL_PSTATE_MAPPED;
+
+  oldblock = dev->lmap[lblock];
+  dev->lmap[lblock] = pblock;
+
+  if (oldblock != FTL_UNMAPPED)
+    {
+      dev->pblock[oldblock].state = FTL_PSTATE_STALE;
+#ifdef FTL_HAVE_RECLAIM
+      if (work_available(&dev->work))
+        {
+          work_queue(LPWORK, &dev->work, ftl_remap_worker, dev, 0);
+        }
+#endif
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_remap_flush
+ *
+ * Description: Write logical R/W blocks.  Each affected logical erase
+ *   block is rewritten as a whole to a spare erase block; the data of a
+ *   partially written logical erase block is merged with its current copy.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_REMAP
+static ssize_t ftl_remap_flush(FAR struct ftl_struct_s *dev,
+                               FAR const uint8_t *buffer, off_t startblock,
+                               size_t nblocks)
+{
+  FAR const uint8_t *src;
+  FAR uint8_t *data;
+  uint16_t lblock;
+  off_t    offset;
+  size_t   remaining;
+  size_t   nxfr;
+  ssize_t  nread;
+  int      pblock;
+  int      ret;
+
+  if (startblock + nblocks > (off_t)dev->nlblocks * dev->datper)
+    {
+      return -EINVAL;
+    }
+
+  /* The data portion of the erase block buffer follows the header block */
+
+  data      = dev->eblock + dev->geo.blocksize;
+  remaining = nblocks;
+
+  while (remaining > 0)
+    {
+      lblock = startblock / dev->datper;
+      offset = startblock - (off_t)lblock * dev->datper;
+      nxfr   = dev->datper - offset;
+      if (nxfr > remaining)
+        {
+          nxfr = remaining;
+        }
+
+      if (nxfr == dev->datper)
+        {
+          /* The whole logical erase block is replaced */
+
+          src = buffer;
+        }
+      else
+        {
+          /* Merge the new data with the current copy */
+
+          nread = ftl_remap_reload(dev, data,
+                                   (off_t)lblock * dev->datper, dev->datper);
+          if (nread < 0)
+            {
+              return nread;
+            }
+
+          memcpy(data + offset * dev->geo.blocksize, buffer,
+                 nxfr * dev->geo.blocksize);
+          src = data;
+        }
+
+      pblock = ftl_remap_allocate(dev);
+      if (pblock < 0)
+        {
+          return pblock;
+        }
+
+      finfo("Write logical erase block %d to erase block %d\n",
+            lblock, pblock);
+
+      ret = ftl_remap_commit(dev, lblock, pblock, src);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      startblock += nxfr;
+      remaining  -= nxfr;
+      buffer     += nxfr * dev->geo.blocksize;
+    }
+
+  return nblocks;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_remap_worker
+ *
+ * Description: Background reclaim.  Erase all stale erase blocks, returning
+ *   them to the spare pool.  Then, if the wear of the most worn spare erase
+ *   block exceeds the wear of the least worn mapped erase block by more than
+ *   CONFIG_FTL_REMAP_WEARLEVEL, move the (presumably static) data of the
+ *   least worn block to the most worn one so that the least worn block is
+ *   returned to circulation.
+ *
+ ****************************************************************************/
+
+#ifdef FTL_HAVE_RECLAIM
+static void ftl_remap_worker(FAR void *arg)
+{
+  FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)arg;
+#if CONFIG_FTL_REMAP_WEARLEVEL > 0
+  FAR uint8_t *data;
+  int mapped = -1;
+  int erased = -1;
+  int ret;
+#endif
+  int i;
+
+  ftl_semtake(dev);
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      if (dev->pblock[i].state == FTL_PSTATE_STALE)
+        {
+          (void)ftl_remap_erase(dev, i);
+        }
+    }
+
+#if CONFIG_FTL_REMAP_WEARLEVEL > 0
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      FAR struct ftl_pblock_s *pb = &dev->pblock[i];
+
+      if (pb->state == FTL_PSTATE_MAPPED &&
+          (mapped < 0 || pb->erasecount < dev->pblock[mapped].erasecount))
+        {
+          mapped = i;
+        }
+      else if (pb->state == FTL_PSTATE_ERASED &&
+               (erased < 0 || pb->erasecount > dev->pblock[erased].erasecount))
+        {
+          erased = i;
+        }
+    }
+
+  if (mapped >= 0 && erased >= 0 &&
+      dev->pblock[erased].erasecount - dev->pblock[mapped].erasecount >
+      CONFIG_FTL_REMAP_WEARLEVEL)
+    {
+      /* Find the logical erase block held by the least worn erase block */
+
+      for (i = 0; i < dev->nlblocks; i++)
+        {
+          if (dev->lmap[i] == mapped)
+            {
+              break;
+            }
+        }
+
+      data = dev->eblock + dev->geo.blocksize;
+      ret  = MTD_BREAD(dev->mtd, (off_t)mapped * dev->blkper + 1,
+                       dev->datper, data);
+      if (ret == dev->datper && i < dev->nlblocks)
+        {
+          finfo("Move logical erase block %d from %d to %d\n",
+                i, mapped, erased);
+
+          ret = ftl_remap_commit(dev, i, erased, data);
+          if (ret >= 0)
+            {
+              /* Release the least worn erase block right away.  The
+               * commit already queued more work if there may be more to
+               * do.
+               */
+
+              (void)ftl_remap_erase(dev, mapped);
+            }
+        }
+    }
+#endif
+
+  nxsem_post(&dev->exclsem);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_remap_iserased
+ *
+ * Description: Return true if the physical erase block pblock has been
+ *   erased and never written.  The first R/W block has already been read
+ *   into dev->eblock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_REMAP
+static bool ftl_remap_iserased(FAR struct ftl_struct_s *dev, int pblock)
+{
+  FAR uint8_t *data = dev->eblock + dev->geo.blocksize;
+  ssize_t nread;
+  size_t  i;
+
+  for (i = 0; i < dev->geo.blocksize; i++)
+    {
+      if (dev->eblock[i] != FTL_ERASEDSTATE)
+        {
+          return false;
+        }
+    }
+
+  /* The header is written last, so the data blocks of an interrupted copy
+   * may have been written even though the header is still erased.
+   */
+
+  nread = MTD_BREAD(dev->mtd, (off_t)pblock * dev->blkper + 1, dev->datper,
+                    data);
+  if (nread != dev->datper)
+    {
+      return false;
+    }
+
+  for (i = 0; i < (size_t)dev->datper * dev->geo.blocksize; i++)
+    {
+      if (data[i] != FTL_ERASEDSTATE)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_remap_scan
+ *
+ * Description: Build the logical to physical erase block map from the
+ *   headers of all physical erase blocks.  If there are multiple copies of
+ *   a logical erase block, the one with the largest sequence number is
+ *   used.  Erase blocks that are fully erased are spares.  Any other erase
+ *   block without a valid header is stale.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_REMAP
+static int ftl_remap_scan(FAR struct ftl_struct_s *dev)
+{
+  struct ftl_header_s header;
+  FAR uint32_t *seqno;
+  uint32_t maxcount = 0;
+  uint16_t other;
+  ssize_t  nread;
+  int      i;
+
+  /* Sequence numbers of the current copies, only needed during the scan */
+
+  seqno = (FAR uint32_t *)kmm_malloc(dev->nlblocks * sizeof(uint32_t));
+  if (seqno == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < dev->nlblocks; i++)
+    {
+      dev->lmap[i] = FTL_UNMAPPED;
+    }
+
+  dev->seqno = 0;
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      FAR struct ftl_pblock_s *pb = &dev->pblock[i];
+
+      pb->state      = FTL_PSTATE_STALE;
+      pb->erasecount = FTL_UNKNOWN;
+
+      nread = MTD_BREAD(dev->mtd, (off_t)i * dev->blkper, 1, dev->eblock);
+      if (nread != 1)
+        {
+          continue;
+        }
+
+      memcpy(&header, dev->eblock, sizeof(struct ftl_header_s));
+      if (memcmp(header.magic, FTL_MAGIC, FTL_MAGICSIZE) != 0 ||
+          header.crc != crc32((FAR const uint8_t *)&header,
+                              offsetof(struct ftl_header_s, crc)))
+        {
+          if (ftl_remap_iserased(dev, i))
+            {
+              pb->state = FTL_PSTATE_ERASED;
+            }
+
+          continue;
+        }
+
+      pb->erasecount = header.erasecount;
+      if (header.erasecount > maxcount)
+        {
+          maxcount = header.erasecount;
+        }
+
+      if (header.seqno >= dev->seqno)
+        {
+          dev->seqno = header.seqno + 1;
+        }
+
+      if (header.lblock >= dev->nlblocks)
+        {
+          continue;
+        }
+
+      other = dev->lmap[header.lblock];
+      if (other == FTL_UNMAPPED || header.seqno > seqno[header.lblock])
+        {
+          if (other != FTL_UNMAPPED)
+            {
+              dev->pblock[other].state = FTL_PSTATE_STALE;
+            }
+
+          dev->lmap[header.lblock] = i;
+          seqno[header.lblock]     = header.seqno;
+          pb->state                = FTL_PSTATE_MAPPED;
+        }
+    }
+
+  /* Erase blocks without a valid header have an unknown erase count.
+   * Assume the worst so that blocks of known wear are preferred.
+   */
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      if (dev->pblock[i].erasecount == FTL_UNKNOWN)
+        {
+          dev->pblock[i].erasecount = maxcount;
+        }
+    }
+
+  kmm_free(seqno);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -565,20 +1285,74 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
       dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
       DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+#ifdef CONFIG_FTL_REMAP
+      /* The first R/W block of each erase block holds the header and some
+       * erase blocks are kept as spares.
+       */
+
+      if (dev->blkper < 2 || dev->geo.neraseblocks <= CONFIG_FTL_REMAP_SPARES ||
+          dev->geo.neraseblocks > FTL_UNMAPPED)
+        {
+          ferr("ERROR: Unsupported geometry\n");
+          ret = -EINVAL;
+          goto errout_with_eblock;
+        }
+
+      dev->datper   = dev->blkper - 1;
+      dev->nlblocks = dev->geo.neraseblocks - CONFIG_FTL_REMAP_SPARES;
+
+      dev->lmap   = (FAR uint16_t *)kmm_malloc(dev->nlblocks * sizeof(uint16_t));
+      dev->pblock = (FAR struct ftl_pblock_s *)
+        kmm_malloc(dev->geo.neraseblocks * sizeof(struct ftl_pblock_s));
+      if (dev->lmap == NULL || dev->pblock == NULL)
+        {
+          ferr("ERROR: Failed to allocate the erase block maps\n");
+          ret = -ENOMEM;
+          goto errout_with_maps;
+        }
+
+      nxsem_init(&dev->exclsem, 0, 1);
+
+      ret = ftl_remap_scan(dev);
+      if (ret < 0)
+        {
+          ferr("ERROR: ftl_remap_scan failed: %d\n", ret);
+          goto errout_with_sem;
+        }
+
+#ifdef FTL_HAVE_RECLAIM
+      /* Start erasing any stale erase blocks found by the scan */
+
+      work_queue(LPWORK, &dev->work, ftl_remap_worker, dev, 0);
+#endif
+#endif
+
       /* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
       dev->rwb.blocksize   = dev->geo.blocksize;
+#ifdef CONFIG_FTL_REMAP
+      dev->rwb.nblocks     = dev->nlblocks * dev->datper;
+#else
       dev->rwb.nblocks     = dev->geo.neraseblocks * dev->blkper;
+#endif
       dev->rwb.dev         = (FAR void *)dev;
 
 #if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_FTL_WRITEBUFFER)
+#ifdef CONFIG_FTL_REMAP
+      dev->rwb.wrmaxblocks = dev->datper;
+#else
       dev->rwb.wrmaxblocks = dev->blkper;
+#endif
       dev->rwb.wrflush     = ftl_flush;
 #endif
 
 #ifdef CONFIG_FTL_READAHEAD
+#ifdef CONFIG_FTL_REMAP
+      dev->rwb.rhmaxblocks = dev->datper;
+#else
       dev->rwb.rhmaxblocks = dev->blkper;
+#endif
       dev->rwb.rhreload    = ftl_reload;
 #endif
 
@@ -586,11 +1360,7 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
       if (ret < 0)
         {
           ferr("ERROR: rwb_initialize failed: %d\n", ret);
-#ifdef CONFIG_FS_WRITABLE
-          kmm_free(dev->eblock);
-#endif
-          kmm_free(dev);
-          return ret;
+          goto errout_with_sem;
         }
 #endif
 
@@ -604,12 +1374,35 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
       if (ret < 0)
         {
           ferr("ERROR: register_blockdriver failed: %d\n", -ret);
-#ifdef CONFIG_FS_WRITABLE
-          kmm_free(dev->eblock);
-#endif
-          kmm_free(dev);
+          goto errout_with_sem;
         }
     }
 
   return ret;
+
+errout_with_sem:
+#ifdef CONFIG_FTL_REMAP
+#ifdef FTL_HAVE_RECLAIM
+  work_cancel(LPWORK, &dev->work);
+#endif
+  nxsem_destroy(&dev->exclsem);
+
+errout_with_maps:
+  if (dev->lmap != NULL)
+    {
+      kmm_free(dev->lmap);
+    }
+
+  if (dev->pblock != NULL)
+    {
+      kmm_free(dev->pblock);
+    }
+
+errout_with_eblock:
+#endif
+#ifdef CONFIG_FS_WRITABLE
+  kmm_free(dev->eblock);
+#endif
+  kmm_free(dev);
+  return ret;
 }
@@ -135,6 +135,17 @@
 #endif
 
 #define SMART_MAX_ALLOCS        10
+
+/* Number of hash chains used for logical sector cache lookups.  Must be a
+ * power of two.
+ */
+
+#ifndef CONFIG_MTD_SMART_SECTOR_CACHE_HASH
+#  define CONFIG_MTD_SMART_SECTOR_CACHE_HASH 64
+#endif
+
+#define SMART_CACHE_HASH(l)     ((l) & (CONFIG_MTD_SMART_SECTOR_CACHE_HASH - 1))
+#define SMART_CACHE_NONE        0xffff
 //#define CONFIG_MTD_SMART_PACK_COUNTS
 
 #ifndef CONFIG_MTD_SMART_ALLOC_DEBUG
@@ -194,6 +205,7 @@ struct smart_cache_s
   uint16_t              logical;          /* Logical sector number */
   uint16_t              physical;         /* Associated physical sector */
   uint16_t              birth;            /* The "birthday" of this entry */
+  uint16_t              next;             /* Next entry in the hash chain */
 };
 #endif
 
@@ -260,6 +272,7 @@ struct smart_struct_s
 #else
   FAR uint8_t          *sBitMap;          /* Virtual sector used bit-map */
   FAR struct smart_cache_s *sCache;       /* Sector cache */
+  FAR uint16_t         *cache_hash;       /* Sector cache hash chain heads */
   uint16_t              cache_entries;    /* Number of valid entries in the cache */
   uint16_t              cache_lastlog;    /* Keep track of the last sector accessed */
   uint16_t              cache_lastphys;   /* Keep the physical sector number also */
@@ -1179,6 +1192,7 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
     {
       dev->sCache = (FAR struct smart_cache_s *) smart_malloc(dev,
         CONFIG_MTD_SMART_SECTOR_CACHE_SIZE * sizeof(struct smart_cache_s) +
+        CONFIG_MTD_SMART_SECTOR_CACHE_HASH * sizeof(uint16_t) +
         allocsize, "Sector Cache");
     }
 
@@ -1188,8 +1202,12 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
       goto errexit;
     }
 
-  dev->releasecount = (FAR uint8_t *) dev->sCache + (CONFIG_MTD_SMART_SECTOR_CACHE_SIZE *
-      sizeof(struct smart_cache_s));
+  /* The hash chain heads follow the cache entries.  All chains are empty */
+
+  dev->cache_hash = (FAR uint16_t *) &dev->sCache[CONFIG_MTD_SMART_SECTOR_CACHE_SIZE];
+  memset(dev->cache_hash, 0xff, CONFIG_MTD_SMART_SECTOR_CACHE_HASH * sizeof(uint16_t));
+
+  dev->releasecount = (FAR uint8_t *) &dev->cache_hash[CONFIG_MTD_SMART_SECTOR_CACHE_HASH];
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
   if (dev->sectorsPerBlk > 16)
@@ -1372,6 +1390,99 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_cache_find
+ *
+ * Description: Find the cache entry for the logical sector using the hash
+ *              chains.  Returns the index of the cache entry or
+ *              SMART_CACHE_NONE if the logical sector is not cached.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static uint16_t smart_cache_find(FAR struct smart_struct_s *dev,
+                                 uint16_t logical)
+{
+  uint16_t index;
+
+  for (index = dev->cache_hash[SMART_CACHE_HASH(logical)];
+       index != SMART_CACHE_NONE;
+       index = dev->sCache[index].next)
+    {
+      if (dev->sCache[index].logical == logical)
+        {
+          break;
+        }
+    }
+
+  return index;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cache_link / smart_cache_unlink
+ *
+ * Description: Add or remove the cache entry at index to / from the hash
+ *              chain selected by its logical sector number.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static void smart_cache_link(FAR struct smart_struct_s *dev, uint16_t index)
+{
+  FAR uint16_t *head = &dev->cache_hash[SMART_CACHE_HASH(dev->sCache[index].logical)];
+
+  dev->sCache[index].next = *head;
+  *head = index;
+}
+
+static void smart_cache_unlink(FAR struct smart_struct_s *dev, uint16_t index)
+{
+  FAR uint16_t *link = &dev->cache_hash[SMART_CACHE_HASH(dev->sCache[index].logical)];
+
+  while (*link != SMART_CACHE_NONE)
+    {
+      if (*link == index)
+        {
+          *link = dev->sCache[index].next;
+          break;
+        }
+
+      link = &dev->sCache[*link].next;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cache_touch
+ *
+ * Description: Mark the cache entry at index as the most recently used
+ *              entry.  Before the 16-bit birthday counter can wrap around,
+ *              all birthdays are halved.  That keeps their relative order
+ *              even when entries added by a volume scan still have a
+ *              birthday of zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static void smart_cache_touch(FAR struct smart_struct_s *dev, uint16_t index)
+{
+  uint16_t x;
+
+  if (dev->cache_nextbirth >= 0xff00)
+    {
+      for (x = 0; x < dev->cache_entries; x++)
+        {
+          dev->sCache[x].birth >>= 1;
+        }
+
+      dev->cache_nextbirth >>= 1;
+    }
+
+  dev->sCache[index].birth = dev->cache_nextbirth++;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_add_sector_to_cache
  *
@@ -1380,8 +1491,8 @@ errout:
  *              a one-to-one mapping of all logical sectors and only keeping
  *              a fixed number of mappings per the
  *              CONFIG_MTD_SMART_SECTOR_CACHE_SIZE parameter.  Sectors are
- *              automatically managed and removed based on the time since
- *              they were accessed last.
+ *              automatically managed and the least recently used entry is
+ *              replaced when the cache is full.
  *
  ****************************************************************************/
 
@@ -1392,18 +1503,30 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
   uint16_t    index, x;
   uint16_t    oldest;
 
+  /* If the sector is already cached, then just update the mapping */
+
+  index = smart_cache_find(dev, logical);
+  if (index != SMART_CACHE_NONE)
+    {
+      dev->sCache[index].physical = physical;
+    }
+
   /* If we aren't full yet, just add the sector to the end of the list */
 
-  index = 1;
-  if (dev->cache_entries < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE)
+  else if (dev->cache_entries < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE)
     {
-      oldest = 0;
-      index  = dev->cache_entries++;
+      index = dev->cache_entries++;
+      dev->sCache[index].logical = logical;
+      dev->sCache[index].physical = physical;
+      smart_cache_link(dev, index);
     }
   else
     {
-      /* Cache is full.  We must find the least accessed entry and replace it */
+      /* Cache is full.  We must find the least recently used entry and
+       * replace it.
+       */
 
+      index  = 1;
       oldest = 0xffff;
       for (x = 0; x < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE; x++)
         {
@@ -1412,21 +1535,22 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
           if (dev->sCache[x].logical < SMART_FIRST_ALLOC_SECTOR)
             continue;
 
-          /* If the hit count is zero, then choose this entry */
-
           if (dev->sCache[x].birth < oldest)
             {
               oldest = dev->sCache[x].birth;
               index  = x;
             }
         }
-    }
 
-  /* Now add the sector at index */
+      /* Now replace the sector at index */
 
-  dev->sCache[index].logical = logical;
-  dev->sCache[index].physical = physical;
-  dev->sCache[index].birth = dev->cache_nextbirth++;
+      smart_cache_unlink(dev, index);
+      dev->sCache[index].logical = logical;
+      dev->sCache[index].physical = physical;
+      smart_cache_link(dev, index);
+    }
+
+  smart_cache_touch(dev, index);
   dev->cache_lastlog = logical;
   dev->cache_lastphys = physical;
 
@@ -1436,18 +1560,6 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
           logical, physical, index, line);
     }
 
-  /* Test if the birthdays need to be adjusted */
-
-  if (oldest >= CONFIG_MTD_SMART_SECTOR_CACHE_SIZE + 1024)
-    {
-      for (x = 0; x < dev->cache_entries; x++)
-        {
-          dev->sCache[x].birth -= 1024;
-        }
-
-      dev->cache_nextbirth -= 1024;
-    }
-
   return index;
 }
 #endif
@@ -1456,10 +1568,15 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
  * Name: smart_cache_lookup
  *
  * Description: Perform a cache lookup for the requested logical sector.
- *              If the sector is in the cache, then update the hitcount and
- *              return the physical mapping.  If a cache miss occurs, then
- *              the routine will scan the volume to find the logical sector
- *              and add / replace a cache entry with the newly located sector.
+ *              If the sector is in the cache, then mark it as the most
+ *              recently used entry and return the physical mapping.  If a
+ *              cache miss occurs, then the routine will scan the volume to
+ *              find the logical sector and add / replace a cache entry with
+ *              the newly located sector.
+ *
+ *              Other committed sectors found during the scan are added to
+ *              the cache as long as there are unused cache entries; they
+ *              never replace existing entries.
  *
  ****************************************************************************/
 
@@ -1481,17 +1598,23 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
       return dev->cache_lastphys;
     }
 
+  /* There is no need to search for sectors that have not been allocated */
+
+  if (logical >= dev->totalsectors ||
+      !(dev->sBitMap[logical >> 3] & (1 << (logical & 0x07))))
+    {
+      return 0xffff;
+    }
+
   /* First search for the entry in the cache */
 
-  for (x = 0; x < dev->cache_entries; x++)
+  x = smart_cache_find(dev, logical);
+  if (x != SMART_CACHE_NONE)
     {
-      if (dev->sCache[x].logical == logical)
-        {
-          /* Entry found in the cache.  Grab the physical mapping. */
+      /* Entry found in the cache.  Grab the physical mapping. */
 
-          physical = dev->sCache[x].physical;
-          break;
-        }
+      physical = dev->sCache[x].physical;
+      smart_cache_touch(dev, x);
     }
 
   /* If the entry wasn't found in the cache, then we must search the volume
@@ -1568,6 +1691,22 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
                   smart_add_sector_to_cache(dev, logical, physical, __LINE__);
                   break;
                 }
+
+              /* Not the one we are looking for, but remember where it is
+               * if there is still room in the cache.  That may save the
+               * next scan.
+               */
+
+              if (dev->cache_entries < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE &&
+                  logicalsector < dev->totalsectors &&
+                  smart_cache_find(dev, logicalsector) == SMART_CACHE_NONE)
+                {
+                  x = dev->cache_entries++;
+                  dev->sCache[x].logical  = logicalsector;
+                  dev->sCache[x].physical = block * dev->sectorsPerBlk + sector;
+                  dev->sCache[x].birth    = 0;
+                  smart_cache_link(dev, x);
+                }
             }
         }
     }
@@ -1596,34 +1735,40 @@ static void smart_update_cache(FAR struct smart_struct_s *dev, uint16_t
     logical, uint16_t physical)
 {
   uint16_t    x;
+  uint16_t    last;
 
-  /* Scan through all cache entries and find the logical sector entry */
+  /* Find the logical sector entry */
 
-  for (x = 0; x < dev->cache_entries; x++)
+  x = smart_cache_find(dev, logical);
+  if (x != SMART_CACHE_NONE)
     {
-      if (dev->sCache[x].logical == logical)
-        {
-          /* Entry found.  Update it's physical mapping */
+      /* Entry found.  Update it's physical mapping */
 
-          dev->sCache[x].physical = physical;
+      dev->sCache[x].physical = physical;
 
-          /* If we are freeing a sector, then remove the logical entry from
-           * the cache.
-           */
+      /* If we are freeing a sector, then remove the logical entry from
+       * the cache.  The last entry is moved into its place.
+       */
 
-          if (physical == 0xffff)
+      if (physical == 0xffff)
+        {
+          last = dev->cache_entries - 1;
+          smart_cache_unlink(dev, x);
+          if (x != last)
             {
-                dev->sCache[x].logical = dev->sCache[dev->cache_entries-1].logical;
-                dev->sCache[x].physical = dev->sCache[dev->cache_entries-1].physical;
-                dev->cache_entries--;
+              smart_cache_unlink(dev, last);
+              dev->sCache[x].logical = dev->sCache[last].logical;
+              dev->sCache[x].physical = dev->sCache[last].physical;
+              dev->sCache[x].birth = dev->sCache[last].birth;
+              smart_cache_link(dev, x);
             }
 
-          if (dev->debuglevel > 1)
-            {
-              _err("Update Cache:  Log=%d, Phys=%d at index %d\n", logical, physical, x);
-            }
+          dev->cache_entries--;
+        }
 
-          break;
+      if (dev->debuglevel > 1)
+        {
+          _err("Update Cache:  Log=%d, Phys=%d at index %d\n", logical, physical, x);
         }
     }
 
@@ -4243,8 +4388,6 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
 
   finfo("Entry\n");
   req = (FAR struct smart_read_write_s *) arg;
-  DEBUGASSERT(req->offset <= dev->sectorsize);
-  DEBUGASSERT(req->offset+req->count <= dev->sectorsize);
 
   /* Ensure the logical sector has been allocated */
 
@@ -4255,6 +4398,20 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
       ret = -EINVAL;
       goto errout;
     }
+
+  /* The data follows the sector header in rwbuffer and must fit within
+   * the sector.
+   */
+
+  if ((uint32_t)req->offset + req->count +
+      sizeof(struct smart_sect_header_s) > dev->sectorsize)
+    {
+      ferr("ERROR: Offset %d count %d exceeds sector size %d\n",
+           req->offset, req->count, dev->sectorsize);
+
+      ret = -EINVAL;
+      goto errout;
+    }
   header = (FAR struct smart_sect_header_s *) dev->rwbuffer;
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
@@ -4638,15 +4795,12 @@ static int smart_readsector(FAR struct smart_struct_s *dev,
   FAR struct smart_sect_header_s *header;
 #endif
 #else
-  uint32_t  readaddr;
-  struct smart_sect_header_s header;
+  FAR struct smart_sect_header_s *header;
+  size_t    nbytes;
 #endif
 
   finfo("Entry\n");
   req = (FAR struct smart_read_write_s *) arg;
-  DEBUGASSERT(req->offset < dev->sectorsize);
-  DEBUGASSERT(req->offset+req->count+ sizeof(struct smart_sect_header_s) <=
-              dev->sectorsize);
 
   /* Ensure the logical sector has been allocated */
 
@@ -4658,6 +4812,20 @@ static int smart_readsector(FAR struct smart_struct_s *dev,
       goto errout;
     }
 
+  /* The data follows the sector header in rwbuffer and must fit within
+   * the sector.
+   */
+
+  if ((uint32_t)req->offset + req->count +
+      sizeof(struct smart_sect_header_s) > dev->sectorsize)
+    {
+      ferr("ERROR: Offset %d count %d exceeds sector size %d\n",
+           req->offset, req->count, dev->sectorsize);
+
+      ret = -EINVAL;
+      goto errout;
+    }
+
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
   physsector = dev->sMap[req->logsector];
 #else
@@ -4721,21 +4889,26 @@ static int smart_readsector(FAR struct smart_struct_s *dev,
 
 #else /* CONFIG_MTD_SMART_ENABLE_CRC */
 
-  /* Read the sector header data to validate as a sanity check */
+  /* Read the sector header and the requested data in a single MTD
+   * transaction.  The header is needed to validate the data as a sanity
+   * check.
+   */
 
+  nbytes = sizeof(struct smart_sect_header_s) + req->offset + req->count;
   ret = MTD_READ(dev->mtd, physsector * dev->mtdBlksPerSector * dev->geo.blocksize,
-          sizeof(struct smart_sect_header_s), (FAR uint8_t *) &header);
-  if (ret != sizeof(struct smart_sect_header_s))
+          nbytes, (FAR uint8_t *) dev->rwbuffer);
+  if (ret != nbytes)
     {
-      ferr("ERROR: Error reading sector %d header\n", physsector);
+      ferr("ERROR: Error reading phys sector %d\n", physsector);
       ret = -EIO;
       goto errout;
     }
 
   /* Do a sanity check on the header data */
 
-  if (((*(FAR uint16_t *) header.logicalsector) != req->logsector) ||
-      ((header.status & SMART_STATUS_COMMITTED) ==
+  header = (FAR struct smart_sect_header_s *) dev->rwbuffer;
+  if (((*(FAR uint16_t *) header->logicalsector) != req->logsector) ||
+      ((header->status & SMART_STATUS_COMMITTED) ==
        (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED)))
     {
       /* Error in sector header! How do we handle this? */
@@ -4746,25 +4919,145 @@ static int smart_readsector(FAR struct smart_struct_s *dev,
       goto errout;
     }
 
-  /* Read the sector data into the buffer */
+  /* Copy data to the output buffer */
+
+  memcpy((FAR char *) req->buffer, &dev->rwbuffer[req->offset +
+      sizeof(struct smart_sect_header_s)], req->count);
+  ret = req->count;
+
+#endif
 
-  readaddr = (uint32_t) physsector * dev->mtdBlksPerSector * dev->geo.blocksize +
-    req->offset + sizeof(struct smart_sect_header_s);
+errout:
+    return ret;
+}
 
-  ret = MTD_READ(dev->mtd, readaddr, req->count, (FAR uint8_t *)
-          req->buffer);
-  if (ret != req->count)
+/****************************************************************************
+ * Name: smart_checkrun
+ *
+ * Description:  Validate a run of consecutive logical sectors before any of
+ *               them is read or written, so that a bad request fails as a
+ *               whole rather than part way through the run.
+ *
+ ****************************************************************************/
+
+static int smart_checkrun(FAR struct smart_struct_s *dev,
+                    FAR const struct smart_multi_read_write_s *mreq)
+{
+  if (mreq->nsectors == 0 ||
+      (uint32_t)mreq->logsector + mreq->nsectors > dev->totalsectors)
     {
-      ferr("ERROR: Error reading phys sector %d\n", physsector);
-      ret = -EIO;
-      goto errout;
+      ferr("ERROR: Invalid sector run %d+%d\n",
+           mreq->logsector, mreq->nsectors);
+      return -EINVAL;
+    }
+
+  if ((uint32_t)mreq->offset + mreq->count +
+      sizeof(struct smart_sect_header_s) > dev->sectorsize)
+    {
+      ferr("ERROR: Offset %d count %d exceeds sector size %d\n",
+           mreq->offset, mreq->count, dev->sectorsize);
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: smart_readsectors
+ *
+ * Description:  Reads the same range of bytes from a run of consecutive
+ *               logical sectors.  The data from each sector is packed
+ *               back-to-back in the caller's buffer.
+ *
+ ****************************************************************************/
+
+static int smart_readsectors(FAR struct smart_struct_s *dev,
+                    unsigned long arg)
+{
+  FAR struct smart_multi_read_write_s *mreq;
+  struct smart_read_write_s req;
+  uint16_t  x;
+  int       ret;
+
+  mreq = (FAR struct smart_multi_read_write_s *) arg;
+  ret  = smart_checkrun(dev, mreq);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  req.offset = mreq->offset;
+  req.count  = mreq->count;
+
+  for (x = 0; x < mreq->nsectors; x++)
+    {
+      req.logsector = mreq->logsector + x;
+      req.buffer    = &mreq->buffer[(size_t) x * mreq->count];
+
+      ret = smart_readsector(dev, (unsigned long) &req);
+      if (ret < 0)
+        {
+          return ret;
+        }
     }
 
+  return mreq->nsectors;
+}
+
+/****************************************************************************
+ * Name: smart_writesectors
+ *
+ * Description:  Writes the same range of bytes to a run of consecutive
+ *               logical sectors.  The data for each sector is taken
+ *               back-to-back from the caller's buffer.  The wear status is
+ *               written once for the whole run rather than once for each
+ *               sector as with BIOC_WRITESECT.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static int smart_writesectors(FAR struct smart_struct_s *dev,
+                    unsigned long arg)
+{
+  FAR struct smart_multi_read_write_s *mreq;
+  struct smart_read_write_s req;
+  uint16_t  x;
+  int       ret;
+
+  mreq = (FAR struct smart_multi_read_write_s *) arg;
+  ret  = smart_checkrun(dev, mreq);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  req.offset = mreq->offset;
+  req.count  = mreq->count;
+
+  for (x = 0; x < mreq->nsectors; x++)
+    {
+      req.logsector = mreq->logsector + x;
+      req.buffer    = &mreq->buffer[(size_t) x * mreq->count];
+
+      ret = smart_writesector(dev, (unsigned long) &req);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+    {
+      /* Write new wear status bits to the device */
+
+      smart_write_wearstatus(dev);
+    }
 #endif
 
-errout:
-    return ret;
+  return ret < 0 ? ret : mreq->nsectors;
 }
+#endif /* CONFIG_FS_WRITABLE */
 
 /****************************************************************************
  * Name: smart_allocsector
@@ -5190,6 +5483,13 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       ret = smart_readsector(dev, arg);
       goto ok_out;
 
+    case BIOC_READSECTS:
+
+      /* Read from a run of consecutive logical sectors */
+
+      ret = smart_readsectors(dev, arg);
+      goto ok_out;
+
 #ifdef CONFIG_FS_WRITABLE
     case BIOC_LLFORMAT:
 
@@ -5235,6 +5535,13 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #endif
 
       goto ok_out;
+
+    case BIOC_WRITESECTS:
+
+      /* Write to a run of consecutive logical sectors */
+
+      ret = smart_writesectors(dev, arg);
+      goto ok_out;
 #endif /* CONFIG_FS_WRITABLE */
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
@@ -99,6 +99,19 @@
 # define CONFIG_TUN_NINTERFACES 1
 #endif
 
+/* CONFIG_NET_TUN_NTXBUFS is the number of outgoing packets that can be
+ * queued for the application to read.
+ */
+
+#ifndef CONFIG_NET_TUN_NTXBUFS
+# define CONFIG_NET_TUN_NTXBUFS 1
+#endif
+
+/* The buffer that receives the next outgoing packet */
+
+#define TUN_READ_TAIL(priv) \
+  (((priv)->read_head + (priv)->read_count) % CONFIG_NET_TUN_NTXBUFS)
+
 /* TX poll delay = 1 seconds. CLK_TCK is the number of clock ticks per
  * second
  */
@@ -127,8 +140,12 @@ struct tun_device_s
 
   bool              read_wait;
 
-  uint8_t           read_buf[CONFIG_NET_TUN_MTU];
-  size_t            read_d_len;
+  /* Outgoing packets waiting to be read, oldest at read_head */
+
+  uint8_t           read_buf[CONFIG_NET_TUN_NTXBUFS][CONFIG_NET_TUN_MTU];
+  size_t            read_d_len[CONFIG_NET_TUN_NTXBUFS];
+  uint8_t           read_head;
+  uint8_t           read_count;
   uint8_t           write_buf[CONFIG_NET_TUN_MTU];
   size_t            write_d_len;
 
@@ -387,12 +404,22 @@ static int tun_txpoll(struct net_driver_s *dev)
 
   if (priv->dev.d_len > 0)
     {
-      /* Send the packet */
+      /* Queue the packet for the application */
 
-      priv->read_d_len = priv->dev.d_len;
+      priv->read_d_len[TUN_READ_TAIL(priv)] = priv->dev.d_len;
+      priv->read_count++;
       tun_fd_transmit(priv);
 
-      return 1;
+      /* Stop polling if the queue is full.  Otherwise, continue the poll
+       * into the next free buffer.
+       */
+
+      if (priv->read_count >= CONFIG_NET_TUN_NTXBUFS)
+        {
+          return 1;
+        }
+
+      priv->dev.d_buf = priv->read_buf[TUN_READ_TAIL(priv)];
     }
 
   /* If zero is returned, the polling will continue until all connections have
@@ -527,10 +554,13 @@ static void tun_txdone(FAR struct tun_device_s *priv)
 
   NETDEV_TXDONE(&priv->dev);
 
-  /* Then poll the network for new XMIT data */
+  /* Then poll the network for new XMIT data if there is room for it */
 
-  priv->dev.d_buf = priv->read_buf;
-  (void)devif_poll(&priv->dev, tun_txpoll);
+  if (priv->read_count < CONFIG_NET_TUN_NTXBUFS)
+    {
+      priv->dev.d_buf = priv->read_buf[TUN_READ_TAIL(priv)];
+      (void)devif_poll(&priv->dev, tun_txpoll);
+    }
 }
 
 /****************************************************************************
@@ -563,11 +593,11 @@ static void tun_poll_work(FAR void *arg)
    * the TX poll if he are unable to accept another packet for transmission.
    */
 
-  if (priv->read_d_len == 0)
+  if (priv->read_count < CONFIG_NET_TUN_NTXBUFS)
     {
       /* If so, poll the network for new XMIT data. */
 
-      priv->dev.d_buf = priv->read_buf;
+      priv->dev.d_buf = priv->read_buf[TUN_READ_TAIL(priv)];
       (void)devif_timer(&priv->dev, tun_txpoll);
     }
 
@@ -720,7 +750,7 @@ static void tun_txavail_work(FAR void *arg)
 
   /* Check if there is room to hold another network packet. */
 
-  if (priv->read_d_len != 0 || priv->write_d_len != 0)
+  if (priv->read_count >= CONFIG_NET_TUN_NTXBUFS || priv->write_d_len != 0)
     {
       tun_unlock(priv);
       return;
@@ -731,7 +761,7 @@ static void tun_txavail_work(FAR void *arg)
     {
       /* Poll the network for new XMIT data */
 
-      priv->dev.d_buf = priv->read_buf;
+      priv->dev.d_buf = priv->read_buf[TUN_READ_TAIL(priv)];
       (void)devif_poll(&priv->dev, tun_txpoll);
     }
 
@@ -1066,17 +1096,14 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
       priv->write_d_len = 0;
       tun_pollnotify(priv, POLLOUT);
 
-      if (priv->read_d_len == 0)
-        {
-          net_lock();
-          tun_txdone(priv);
-          net_unlock();
-        }
+      net_lock();
+      tun_txdone(priv);
+      net_unlock();
 
       goto out;
     }
 
-  if (priv->read_d_len == 0)
+  if (priv->read_count == 0)
     {
       if ((filep->f_oflags & O_NONBLOCK) != 0)
         {
@@ -1092,18 +1119,31 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
 
   net_lock();
 
-  read_d_len = priv->read_d_len;
-  if (buflen < read_d_len)
+  /* Take the oldest queued packet.  The wait may also have been ended by a
+   * reply placed in the write buffer, in which case nothing is queued.
+   */
+
+  if (priv->read_count == 0)
     {
-      ret = -EINVAL;
+      ret = 0;
     }
   else
     {
-      memcpy(buffer, priv->read_buf, read_d_len);
-      ret = (ssize_t)read_d_len;
+      read_d_len = priv->read_d_len[priv->read_head];
+      if (buflen < read_d_len)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          memcpy(buffer, priv->read_buf[priv->read_head], read_d_len);
+          ret = (ssize_t)read_d_len;
+        }
+
+      priv->read_head = (priv->read_head + 1) % CONFIG_NET_TUN_NTXBUFS;
+      priv->read_count--;
     }
 
-  priv->read_d_len = 0;
   tun_txdone(priv);
 
   net_unlock();
@@ -1162,7 +1202,7 @@ int tun_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
        * So check it too.
        */
 
-      if (priv->read_d_len != 0 || priv->write_d_len != 0)
+      if (priv->read_count != 0 || priv->write_d_len != 0)
         {
           eventset |= (fds->events & POLLIN);
         }
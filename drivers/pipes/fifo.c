@@ -67,8 +67,10 @@ static const struct file_operations fifo_fops =
   pipecommon_poll,  /* poll */
 #endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  pipecommon_unlink /* unlink */
+  pipecommon_unlink, /* unlink */
 #endif
+  pipecommon_readv, /* readv */
+  pipecommon_writev /* writev */
 };
 
 /****************************************************************************
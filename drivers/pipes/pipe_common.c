@@ -42,6 +42,8 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -60,6 +62,8 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/drivers/drivers.h>
+#include <nuttx/net/net.h>
 
 #include "pipe_common.h"
 
@@ -112,6 +116,21 @@ static void pipecommon_semtake(FAR sem_t *sem)
   while (ret == -EINTR);
 }
 
+/****************************************************************************
+ * Name: pipecommon_write
+ ****************************************************************************/
+
+ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t len)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR char *)buffer;
+  iov.iov_len  = len;
+
+  return pipecommon_writev(filep, &iov, 1);
+}
+
 /****************************************************************************
  * Name: pipecommon_pollnotify
  ****************************************************************************/
@@ -154,6 +173,337 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
 #  define pipecommon_pollnotify(dev,event)
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up every thread waiting on one of the read/write semaphores.  The
+ *   semaphore is not touched at all if nobody is waiting on it.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_nbytes
+ *
+ * Description:
+ *   Return the number of bytes held in the circular buffer.
+ *
+ ****************************************************************************/
+
+static inline size_t pipecommon_nbytes(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      return dev->d_wrndx - dev->d_rdndx;
+    }
+
+  return (dev->d_bufsize - dev->d_rdndx) + dev->d_wrndx;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copyin
+ *
+ * Description:
+ *   Copy as much of 'buffer' into the circular buffer as will fit, using at
+ *   most two memcpy's when the free space wraps around the end of the
+ *   buffer.  One slot is always left unused so that a full buffer can be
+ *   distinguished from an empty one.  Returns the number of bytes copied.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyin(FAR struct pipe_dev_s *dev,
+                                FAR const char *buffer, size_t len)
+{
+  size_t ndx = dev->d_wrndx;
+  size_t nfree;
+  size_t first;
+
+  nfree = dev->d_bufsize - 1 - pipecommon_nbytes(dev);
+  if (len > nfree)
+    {
+      len = nfree;
+    }
+
+  first = dev->d_bufsize - ndx;
+  if (first > len)
+    {
+      first = len;
+    }
+
+  memcpy(&dev->d_buffer[ndx], buffer, first);
+  memcpy(dev->d_buffer, buffer + first, len - first);
+
+  ndx += len;
+  if (ndx >= dev->d_bufsize)
+    {
+      ndx -= dev->d_bufsize;
+    }
+
+  dev->d_wrndx = ndx;
+  return len;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copyout
+ *
+ * Description:
+ *   Copy up to 'len' bytes out of the circular buffer, using at most two
+ *   memcpy's when the data wraps around the end of the buffer.  Returns the
+ *   number of bytes copied.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyout(FAR struct pipe_dev_s *dev,
+                                 FAR char *buffer, size_t len)
+{
+  size_t ndx = dev->d_rdndx;
+  size_t nbytes;
+  size_t first;
+
+  nbytes = pipecommon_nbytes(dev);
+  if (len > nbytes)
+    {
+      len = nbytes;
+    }
+
+  first = dev->d_bufsize - ndx;
+  if (first > len)
+    {
+      first = len;
+    }
+
+  memcpy(buffer, &dev->d_buffer[ndx], first);
+  memcpy(buffer + first, dev->d_buffer, len - first);
+
+  ndx += len;
+  if (ndx >= dev->d_bufsize)
+    {
+      ndx -= dev->d_bufsize;
+    }
+
+  dev->d_rdndx = ndx;
+  return len;
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitdata
+ *
+ * Description:
+ *   Wait until there is data in the pipe that may be consumed.  Data that
+ *   is currently reserved by a PIPEIOC_SPLICE transfer may not be consumed
+ *   by anyone else.  Called with d_bfsem held.
+ *
+ * Returned Value:
+ *   The number of bytes available with d_bfsem still held; zero on end of
+ *   file or a negated errno value on failure, both with d_bfsem released.
+ *
+ ****************************************************************************/
+
+static int pipecommon_waitdata(FAR struct file *filep,
+                               FAR struct pipe_dev_s *dev)
+{
+  size_t nbytes;
+  int ret;
+
+  for (; ; )
+    {
+      nbytes = pipecommon_nbytes(dev);
+      if (nbytes > 0 && !PIPE_IS_SPLICING(dev->d_flags))
+        {
+          return (int)nbytes;
+        }
+
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (nbytes == 0 && dev->d_nwriters <= 0)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return 0;
+        }
+
+      /* Otherwise, wait for something to be written to the pipe */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      ret = nxsem_wait(&dev->d_rdsem);
+      sched_unlock();
+
+      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_splicev
+ *
+ * Description:
+ *   Write the reserved segments of the circular buffer directly to the
+ *   destination descriptor of a PIPEIOC_SPLICE transfer.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splicev(FAR struct inode *inode, int fd,
+                                  FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct file *filep;
+  int ret;
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      FAR struct socket *psock;
+      struct msghdr msg;
+
+      psock = sockfd_socket(fd);
+      if (psock == NULL)
+        {
+          return -EBADF;
+        }
+
+      memset(&msg, 0, sizeof(struct msghdr));
+      msg.msg_iov    = (FAR struct iovec *)iov;
+      msg.msg_iovlen = iovcnt;
+
+      return psock_sendmsg(psock, &msg, 0);
+    }
+#endif
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Splicing a pipe into itself would wait forever on its own data */
+
+  if (filep->f_inode == inode)
+    {
+      return -EINVAL;
+    }
+
+  return file_writev(filep, iov, iovcnt);
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice
+ *
+ * Description:
+ *   Handle the PIPEIOC_SPLICE ioctl command:  Move buffered data from the
+ *   pipe to another file or socket without copying it through a user
+ *   buffer.  The data is reserved and d_bfsem is released while the
+ *   destination is written so that writers may keep filling the pipe and a
+ *   slow destination cannot hold up poll() or the writers.  Other readers
+ *   wait until the reserved data has been consumed.
+ *
+ ****************************************************************************/
+
+static int pipecommon_splice(FAR struct file *filep,
+                             FAR const struct pipe_splice_s *splice)
+{
+  FAR struct inode      *inode = filep->f_inode;
+  FAR struct pipe_dev_s *dev   = inode->i_private;
+  struct iovec           iov[2];
+  ssize_t                nsent;
+  size_t                 len;
+  size_t                 ndx;
+  int                    iovcnt;
+  int                    ret;
+
+  if (splice == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (splice->ps_len == 0)
+    {
+      return 0;
+    }
+
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = pipecommon_waitdata(filep, dev);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  len = splice->ps_len < (size_t)ret ? splice->ps_len : (size_t)ret;
+
+  /* Describe the data as (at most) two segments of the circular buffer */
+
+  iov[0].iov_base = &dev->d_buffer[dev->d_rdndx];
+  iov[0].iov_len  = dev->d_bufsize - dev->d_rdndx;
+  iovcnt          = 1;
+
+  if (iov[0].iov_len >= len)
+    {
+      iov[0].iov_len = len;
+    }
+  else
+    {
+      iov[1].iov_base = dev->d_buffer;
+      iov[1].iov_len  = len - iov[0].iov_len;
+      iovcnt          = 2;
+    }
+
+  dev->d_flags |= PIPE_FLAG_SPLICE;
+  nxsem_post(&dev->d_bfsem);
+
+  nsent = pipecommon_splicev(inode, splice->ps_fd, iov, iovcnt);
+
+  /* Consume whatever was accepted by the destination and release the
+   * reservation.
+   */
+
+  pipecommon_semtake(&dev->d_bfsem);
+  dev->d_flags &= ~PIPE_FLAG_SPLICE;
+
+  if (nsent > 0)
+    {
+      ndx = dev->d_rdndx + nsent;
+      if (ndx >= dev->d_bufsize)
+        {
+          ndx -= dev->d_bufsize;
+        }
+
+      dev->d_rdndx = ndx;
+
+      pipecommon_wakeup(&dev->d_wrsem);
+      pipecommon_pollnotify(dev, POLLOUT);
+    }
+
+  /* Readers that were held off by the reservation may proceed */
+
+  pipecommon_wakeup(&dev->d_rdsem);
+
+  nxsem_post(&dev->d_bfsem);
+  return (int)nsent;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -421,22 +771,33 @@ int pipecommon_close(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: pipecommon_read
+ * Name: pipecommon_readv
+ *
+ * Description:
+ *   Read from the pipe into an array of buffers.  The device structure is
+ *   locked once and the available data is scattered over the buffers in
+ *   order.
+ *
  ****************************************************************************/
 
-ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
+ssize_t pipecommon_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                         int iovcnt)
 {
   FAR struct inode      *inode  = filep->f_inode;
   FAR struct pipe_dev_s *dev    = inode->i_private;
-#ifdef CONFIG_DEV_PIPEDUMP
-  FAR uint8_t           *start  = (FAR uint8_t *)buffer;
-#endif
   ssize_t                nread  = 0;
-  int                    sval;
+  size_t                 len;
+  size_t                 n;
   int                    ret;
+  int                    i;
 
   DEBUGASSERT(dev);
 
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
   if (len == 0)
     {
       return 0;
@@ -452,84 +813,88 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* If the pipe is empty, then wait for something to be written to it */
 
-  while (dev->d_wrndx == dev->d_rdndx)
+  ret = pipecommon_waitdata(filep, dev);
+  if (ret <= 0)
     {
-      /* If O_NONBLOCK was set, then return EGAIN */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          nxsem_post(&dev->d_bfsem);
-          return -EAGAIN;
-        }
-
-      /* If there are no writers on the pipe, then return end of file */
-
-      if (dev->d_nwriters <= 0)
-        {
-          nxsem_post(&dev->d_bfsem);
-          return 0;
-        }
-
-      /* Otherwise, wait for something to be written to the pipe */
-
-      sched_lock();
-      nxsem_post(&dev->d_bfsem);
-      ret = nxsem_wait(&dev->d_rdsem);
-      sched_unlock();
-
-      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
-        {
-          return ret;
-        }
+      return ret;
     }
 
-  /* Then return whatever is available in the pipe (which is at least one byte) */
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte), one bulk copy per buffer.
+   */
 
-  nread = 0;
-  while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
+  for (i = 0; i < iovcnt; i++)
     {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
+      n = pipecommon_copyout(dev, (FAR char *)iov[i].iov_base,
+                             iov[i].iov_len);
+
+      pipe_dumpbuffer("From PIPE:", (FAR uint8_t *)iov[i].iov_base, n);
+      nread += n;
+
+      if (n < iov[i].iov_len)
         {
-          dev->d_rdndx = 0;
+          break;
         }
-
-      nread++;
     }
 
   /* Notify all waiting writers that bytes have been removed from the buffer */
 
-  while (nxsem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
-    {
-      nxsem_post(&dev->d_wrsem);
-    }
+  pipecommon_wakeup(&dev->d_wrsem);
 
   /* Notify all poll/select waiters that they can write to the FIFO */
 
   pipecommon_pollnotify(dev, POLLOUT);
 
   nxsem_post(&dev->d_bfsem);
-  pipe_dumpbuffer("From PIPE:", start, nread);
   return nread;
 }
 
 /****************************************************************************
- * Name: pipecommon_write
+ * Name: pipecommon_read
  ****************************************************************************/
 
-ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t len)
+ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
+{
+  struct iovec iov;
+
+  iov.iov_base = buffer;
+  iov.iov_len  = len;
+
+  return pipecommon_readv(filep, &iov, 1);
+}
+
+/****************************************************************************
+ * Name: pipecommon_writev
+ *
+ * Description:
+ *   Write an array of buffers to the pipe.  The data is written as if it
+ *   came from one contiguous buffer, taking the device structure lock only
+ *   once unless the writer has to wait for space.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                          int iovcnt)
 {
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
+  FAR const char        *buffer;
   ssize_t                nwritten = 0;
   ssize_t                last;
-  int                    nxtwrndx;
-  int                    sval;
+  size_t                 bufrem;
+  size_t                 len;
+  size_t                 n;
   int                    ret;
+  int                    i;
 
   DEBUGASSERT(dev);
-  pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)buffer, len);
+
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)iov[i].iov_base,
+                      iov[i].iov_len);
+      len += iov[i].iov_len;
+    }
 
   if (len == 0)
     {
@@ -559,62 +924,37 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
       return ret;
     }
 
-  /* Loop until all of the bytes have been written */
+  /* Loop until all of the bytes have been written, copying as much of each
+   * buffer as will fit at a time.
+   */
 
   last = 0;
-  for (; ; )
-    {
-      /* Calculate the write index AFTER the next byte is written */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
-        {
-          nxtwrndx = 0;
-        }
-
-      /* Would the next write overflow the circular buffer? */
+  for (i = 0; i < iovcnt; i++)
+    {
+      buffer = (FAR const char *)iov[i].iov_base;
+      bufrem = iov[i].iov_len;
 
-      if (nxtwrndx != dev->d_rdndx)
+      while (bufrem > 0)
         {
-          /* No... copy the byte */
-
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
-
-          /* Is the write complete? */
-
-          nwritten++;
-          if ((size_t)nwritten >= len)
+          n = pipecommon_copyin(dev, buffer, bufrem);
+          if (n > 0)
             {
-              /* Yes.. Notify all of the waiting readers that more data is available */
-
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
-
-              /* Notify all poll/select waiters that they can read from the FIFO */
-
-              pipecommon_pollnotify(dev, POLLIN);
-
-              /* Return the number of bytes written */
-
-              nxsem_post(&dev->d_bfsem);
-              return len;
+              buffer   += n;
+              bufrem   -= n;
+              nwritten += n;
+              continue;
             }
-        }
-      else
-        {
-          /* There is not enough room for the next byte.  Was anything written in this pass? */
+
+          /* There is no room in the buffer.  Was anything written in this
+           * pass?
+           */
 
           if (last < nwritten)
             {
               /* Yes.. Notify all of the waiting readers that more data is available */
 
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
+              pipecommon_wakeup(&dev->d_rdsem);
 
               /* Notify all poll/select waiters that they can read from the FIFO */
 
@@ -645,6 +985,21 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
           pipecommon_semtake(&dev->d_bfsem);
         }
     }
+
+  /* The write is complete.  Notify all of the waiting readers that more
+   * data is available.
+   */
+
+  pipecommon_wakeup(&dev->d_rdsem);
+
+  /* Notify all poll/select waiters that they can read from the FIFO */
+
+  pipecommon_pollnotify(dev, POLLIN);
+
+  /* Return the number of bytes written */
+
+  nxsem_post(&dev->d_bfsem);
+  return len;
 }
 
 /****************************************************************************
@@ -789,6 +1144,17 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
+  /* PIPEIOC_SPLICE manages d_bfsem itself because it may have to wait for
+   * data and for the destination.
+   */
+
+  if (cmd == PIPEIOC_SPLICE)
+    {
+      return pipecommon_splice(filep,
+                               (FAR const struct pipe_splice_s *)
+                               ((uintptr_t)arg));
+    }
+
   pipecommon_semtake(&dev->d_bfsem);
 
   switch (cmd)
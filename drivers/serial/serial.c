@@ -51,6 +51,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/sched.h>
 #include <nuttx/signal.h>
 #include <nuttx/semaphore.h>
@@ -188,6 +189,22 @@ static int uart_takesem(FAR sem_t *sem, bool errout)
 
 #define uart_givesem(sem) (void)nxsem_post(sem)
 
+/************************************************************************************
+ * Name: uart_nbuffered
+ *
+ * Description:
+ *   Return the number of bytes held in a circular buffer.
+ *
+ ************************************************************************************/
+
+static inline int16_t uart_nbuffered(FAR struct uart_buffer_s *buf)
+{
+  int16_t head = buf->head;
+  int16_t tail = buf->tail;
+
+  return head >= tail ? head - tail : buf->size - tail + head;
+}
+
 /****************************************************************************
  * Name: uart_pollnotify
  ****************************************************************************/
@@ -581,6 +598,9 @@ static int uart_open(FAR struct file *filep)
 
 #ifdef CONFIG_SERIAL_TERMIOS
       dev->tc_iflag = 0;
+      dev->tc_vmin  = 1;
+      dev->tc_vtime = 0;
+
       if (dev->isconsole)
         {
           /* Enable \n -> \r\n translation for the console */
@@ -703,6 +723,14 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #endif
   irqstate_t flags;
   ssize_t recvd = 0;
+  size_t minread;
+  size_t maxwait;
+  size_t nwait;
+  size_t n;
+#ifdef CONFIG_SERIAL_TERMIOS
+  uint32_t idle = 0;
+#endif
+  int16_t head;
   int16_t tail;
   char ch;
   int ret;
@@ -720,6 +748,46 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
       return ret;
     }
 
+  /* How many bytes must be returned before the read may complete?  Unless
+   * CONFIG_DEV_SERIAL_FULLBLOCKS is selected, this is given by the termios
+   * VMIN setting (one byte by default).  A non-zero VTIME is the time the
+   * line may stay idle before the read completes with what it has.
+   */
+
+#if defined(CONFIG_DEV_SERIAL_FULLBLOCKS)
+  minread = buflen;
+#elif defined(CONFIG_SERIAL_TERMIOS)
+  minread = dev->tc_vmin;
+  if (minread == 0 && dev->tc_vtime > 0)
+    {
+      minread = 1;
+    }
+
+  if (minread > buflen)
+    {
+      minread = buflen;
+    }
+
+  idle = DSEC2TICK(dev->tc_vtime);
+#else
+  minread = 1;
+#endif
+
+  /* The reader is woken up once this many bytes have been buffered.  It must
+   * be reachable before the RX buffer fills or RX flow control kicks in.
+   */
+
+#ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
+  maxwait = (CONFIG_SERIAL_IFLOWCONTROL_UPPER_WATERMARK * rxbuf->size) / 100;
+#else
+  maxwait = rxbuf->size - 1;
+#endif
+
+  if (maxwait < 1)
+    {
+      maxwait = 1;
+    }
+
   /* Loop while we still have data to copy to the receive buffer.
    * we add data to the head of the buffer; uart_xmitchars takes the
    * data from the end of the buffer.
@@ -754,9 +822,35 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
        * 8-bit accesses to obtain the 16-bit head index.
        */
 
+      head = rxbuf->head;
       tail = rxbuf->tail;
-      if (rxbuf->head != tail)
+      if (head != tail)
         {
+#ifdef CONFIG_SERIAL_TERMIOS
+          if ((dev->tc_iflag & (INLCR | IGNCR | ICRNL)) == 0)
+#endif
+            {
+              /* No input processing.  Copy the contiguous run of data that
+               * starts at the tail of the buffer in one go.
+               */
+
+              n = (head > tail ? head : rxbuf->size) - tail;
+              if (n > buflen - (size_t)recvd)
+                {
+                  n = buflen - (size_t)recvd;
+                }
+
+              memcpy(buffer, &rxbuf->buffer[tail], n);
+              buffer += n;
+              recvd  += n;
+
+              /* Update the tail index with a single store */
+
+              tail += n;
+              rxbuf->tail = tail >= rxbuf->size ? 0 : tail;
+              continue;
+            }
+
           /* Take the next character from the tail of the buffer */
 
           ch = rxbuf->buffer[tail];
@@ -774,27 +868,22 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
           rxbuf->tail = tail;
 
 #ifdef CONFIG_SERIAL_TERMIOS
-          /* Do input processing if any is enabled */
+          /* Do input processing.  \n -> \r or \r -> \n translation? */
 
-          if (dev->tc_iflag & (INLCR | IGNCR | ICRNL))
+          if ((ch == '\n') && (dev->tc_iflag & INLCR))
             {
-              /* \n -> \r or \r -> \n translation? */
-
-              if ((ch == '\n') && (dev->tc_iflag & INLCR))
-                {
-                  ch = '\r';
-                }
-              else if ((ch == '\r') && (dev->tc_iflag & ICRNL))
-                {
-                  ch = '\n';
-                }
+              ch = '\r';
+            }
+          else if ((ch == '\r') && (dev->tc_iflag & ICRNL))
+            {
+              ch = '\n';
+            }
 
-              /* Discarding \r ? */
+          /* Discarding \r ? */
 
-              if ((ch == '\r') & (dev->tc_iflag & IGNCR))
-                {
-                  continue;
-                }
+          if ((ch == '\r') & (dev->tc_iflag & IGNCR))
+            {
+              continue;
             }
 
           /* Specifically not handled:
@@ -813,7 +902,19 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
           recvd++;
         }
 
-#ifdef CONFIG_DEV_SERIAL_FULLBLOCKS
+      /* No... the circular buffer is empty.  Have we returned enough to
+       * the caller?
+       */
+
+      else if ((size_t)recvd >= minread)
+        {
+          /* Yes.. break out of the loop and return the number of bytes
+           * received up to the wait condition.
+           */
+
+          break;
+        }
+
       /* No... then we would have to wait to get receive more data.
        * If the user has specified the O_NONBLOCK option, then just
        * return what we have.
@@ -831,34 +932,8 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
             }
 
           break;
-       }
-#else
-      /* No... the circular buffer is empty.  Have we returned anything
-       * to the caller?
-       */
-
-      else if (recvd > 0)
-       {
-          /* Yes.. break out of the loop and return the number of bytes
-           * received up to the wait condition.
-           */
-
-          break;
-       }
-
-      /* No... then we would have to wait to get receive some data.
-       * If the user has specified the O_NONBLOCK option, then do not
-       * wait.
-       */
-
-      else if ((filep->f_oflags & O_NONBLOCK) != 0)
-        {
-          /* Break out of the loop returning -EAGAIN */
-
-          recvd = -EAGAIN;
-          break;
         }
-#endif
+
       /* Otherwise we are going to have to wait for data to arrive */
 
       else
@@ -897,6 +972,26 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 
               uart_enablerxint(dev);
 
+              /* Only wake up once the rest of the minimum read is buffered
+               * rather than on every received character.
+               */
+
+              nwait = minread - (size_t)recvd;
+
+#ifdef CONFIG_SERIAL_TERMIOS
+              /* With VTIME set, the idle timer starts with the first byte.
+               * Wake up as soon as it arrives so that the timed wait below
+               * can begin, rather than waiting untimed for all of VMIN.
+               */
+
+              if (idle > 0 && recvd == 0)
+                {
+                  nwait = 1;
+                }
+#endif
+
+              dev->recvmin = nwait > maxwait ? maxwait : nwait;
+
 #ifdef CONFIG_SERIAL_REMOVABLE
               /* Check again if the removable device is still connected
                * while we have interrupts off.  We do not want the transition
@@ -913,14 +1008,50 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
                   /* Now wait with the Rx interrupt re-enabled.  NuttX will
                    * automatically re-enable global interrupts when this
                    * thread goes to sleep.
+                   *
+                   * VTIME is an idle timer:  It only runs once something
+                   * has been received, or when VMIN is zero.
                    */
 
                   dev->recvwaiting = true;
-                  ret = uart_takesem(&dev->recvsem, true);
+
+#ifdef CONFIG_SERIAL_TERMIOS
+                  if (idle > 0 && (recvd > 0 || dev->tc_vmin == 0))
+                    {
+                      ret = nxsem_tickwait(&dev->recvsem, clock_systimer(),
+                                           idle);
+                      if (ret == -ETIMEDOUT)
+                        {
+                          dev->recvwaiting = false;
+                        }
+                    }
+                  else
+#endif
+                    {
+                      ret = uart_takesem(&dev->recvsem, true);
+                    }
                 }
 
               leave_critical_section(flags);
 
+#ifdef CONFIG_SERIAL_TERMIOS
+              /* The idle timer expired.  If nothing at all was received in
+               * the meantime, the line was idle and the read completes with
+               * what it has.  Otherwise, collect the new data and restart
+               * the timer.
+               */
+
+              if (ret == -ETIMEDOUT)
+                {
+                  if (rxbuf->head == rxbuf->tail)
+                    {
+                      break;
+                    }
+
+                  continue;
+                }
+#endif
+
               /* Was a signal received while waiting for data to be
                * received?  Was a removable device disconnected while
                * we were waiting?
@@ -1373,6 +1504,8 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               termiosp->c_iflag = dev->tc_iflag;
               termiosp->c_oflag = dev->tc_oflag;
               termiosp->c_lflag = dev->tc_lflag;
+              termiosp->c_cc[VMIN]  = dev->tc_vmin;
+              termiosp->c_cc[VTIME] = dev->tc_vtime;
             }
             break;
 
@@ -1391,6 +1524,8 @@ static int uart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               dev->tc_iflag = termiosp->c_iflag;
               dev->tc_oflag = termiosp->c_oflag;
               dev->tc_lflag = termiosp->c_lflag;
+              dev->tc_vmin  = termiosp->c_cc[VMIN];
+              dev->tc_vtime = termiosp->c_cc[VTIME];
             }
             break;
         }
@@ -1592,9 +1727,11 @@ int uart_register(FAR const char *path, FAR uart_dev_t *dev)
 
 void uart_datareceived(FAR uart_dev_t *dev)
 {
-  /* Is there a thread waiting for read data?  */
+  /* Is there a thread waiting for read data?  And has as much data been
+   * buffered as it asked for?
+   */
 
-  if (dev->recvwaiting)
+  if (dev->recvwaiting && uart_nbuffered(&dev->recv) >= dev->recvmin)
     {
       /* Yes... wake it up */
 
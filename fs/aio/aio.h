@@ -47,6 +47,7 @@
 #include <aio.h>
 #include <queue.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/net/net.h>
 
@@ -63,6 +64,36 @@
 #  define CONFIG_FS_NAIOC 8
 #endif
 
+/* AIO worker threads */
+
+#ifndef CONFIG_FS_AIO_NWORKERS
+#  define CONFIG_FS_AIO_NWORKERS 2
+#endif
+
+#ifndef CONFIG_FS_AIO_PRIORITY
+#  define CONFIG_FS_AIO_PRIORITY 100
+#endif
+
+#ifndef CONFIG_FS_AIO_STACKSIZE
+#  define CONFIG_FS_AIO_STACKSIZE 2048
+#endif
+
+/* Maximum number of adjacent requests merged into one transfer */
+
+#ifndef CONFIG_FS_AIO_MERGE_MAX
+#  define CONFIG_FS_AIO_MERGE_MAX 8
+#endif
+
+/* Values for the aioc_state field of struct aio_container_s */
+
+#define AIOC_CONTAINED   0         /* Contained, but not yet queued */
+#define AIOC_QUEUED      1         /* Queued, waiting for a worker */
+#define AIOC_ACTIVE      2         /* Taken by a worker thread */
+
+/* Values for the aioc_flags field of struct aio_container_s */
+
+#define AIOC_MERGE       (1 << 0)  /* May be merged with adjacent requests */
+
 #undef AIO_HAVE_FILEP
 #undef AIO_HAVE_PSOCK
 
@@ -101,13 +132,32 @@ struct aio_container_s
 #endif
     FAR void *ptr;                 /* Generic pointer to FAR data */
   } u;
-  struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+  FAR struct aio_container_s *aioc_next; /* Next request of a merged transfer */
+  worker_t aioc_worker;            /* Performs the I/O on the worker thread */
+  systime_t aioc_qtime;            /* Time that the request was queued */
   pid_t aioc_pid;                  /* ID of the waiting task */
+  uint8_t aioc_state;              /* See AIOC_* state definitions */
+  uint8_t aioc_flags;              /* See AIOC_* flag definitions */
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
 #endif
 };
 
+/* A snapshot of the AIO statistics, as reported by aio_getstats() */
+
+struct aio_stats_s
+{
+  uint32_t queued;                 /* Number of requests queued */
+  uint32_t completed;              /* Number of requests completed */
+  uint32_t merged;                 /* Number of requests merged into another */
+  uint32_t canceled;               /* Number of requests canceled */
+  uint32_t rate;                   /* Completions in the last full second */
+  uint32_t p50;                    /* Latency percentiles in microseconds */
+  uint32_t p90;
+  uint32_t p99;
+  uint32_t max;                    /* Longest latency in microseconds */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -240,15 +290,43 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp);
 
 FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
+/****************************************************************************
+ * Name: aioc_decantv
+ *
+ * Description:
+ *   Decant each AIO control block of a merged transfer:  The container
+ *   passed to the worker and all of the containers linked to it through
+ *   aioc_next.
+ *
+ * Input Parameters:
+ *   aioc   - Pointer to the first AIO control block container
+ *   aiocbp - Receives the no-longer contained AIO control blocks.  Must
+ *            hold CONFIG_FS_AIO_MERGE_MAX entries.
+ *   pid    - Receives the ID of the task waiting for each control block.
+ *
+ * Returned Value:
+ *   The number of AIO control blocks decanted.
+ *
+ ****************************************************************************/
+
+int aioc_decantv(FAR struct aio_container_s *aioc,
+                 FAR struct aiocb **aiocbp, FAR pid_t *pid);
+
 /****************************************************************************
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the AIO worker threads.  The worker
+ *   threads are started when the first I/O is queued.
+ *
+ *   The worker is called with the container as its argument.  If the
+ *   container has the AIOC_MERGE flag, the worker must also be prepared to
+ *   handle a merged transfer:  A chain of containers linked through
+ *   aioc_next that describe adjacent I/O on the same file.
  *
  * Input Parameters:
- *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *   aioc   - The AIO control block container
+ *   worker - The function that performs the I/O on the worker thread
  *
  * Returned Value:
  *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
@@ -277,6 +355,34 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
 int aio_signal(pid_t pid, FAR struct aiocb *aiocbp);
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove an AIO request that has not yet been started by a worker thread.
+ *   The caller must hold the AIO lock.
+ *
+ * Input Parameters:
+ *   aioc - The AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed from the queue.  -EBUSY if the
+ *   request has already been started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc);
+
+/****************************************************************************
+ * Name: aio_getstats
+ *
+ * Description:
+ *   Return a snapshot of the AIO statistics.
+ *
+ ****************************************************************************/
+
+void aio_getstats(FAR struct aio_stats_s *stats);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
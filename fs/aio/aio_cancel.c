@@ -44,8 +44,6 @@
 #include <assert.h>
 #include <errno.h>
 
-#include <nuttx/wqueue.h>
-
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
@@ -98,6 +96,7 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
 {
   FAR struct aio_container_s *aioc;
   FAR struct aio_container_s *next;
+  pid_t pid;
   int status;
   int ret;
 
@@ -130,27 +129,26 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
           if (aioc)
             {
               /* Yes... attempt to cancel the I/O.  There are two
-               * possibilities:* (1) the work has already been started and
-               * is no longer queued, or (2) the work has not been started
-               * and is still in the work queue.  Only the second case can
-               * be canceled.  work_cancel() will return -ENOENT in the
-               * first case.
+               * possibilities:* (1) the work has already been started by
+               * an AIO worker thread, or (2) the work has not been started
+               * and is still queued.  Only the second case can be
+               * canceled.  aio_dequeue() will return -EBUSY in the first
+               * case; the worker thread will then complete the I/O and
+               * release the container.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              pid    = aioc->aioc_pid;
+              status = aio_dequeue(aioc);
               if (status >= 0)
                 {
                   aiocbp->aio_result = -ECANCELED;
+                  (void)aio_signal(pid, aiocbp);
                   ret = AIO_CANCELED;
                 }
               else
                 {
                   ret = AIO_NOTCANCELED;
                 }
-
-              /* Remove the container from the list of pending transfers */
-
-              (void)aioc_decant(aioc);
             }
         }
     }
@@ -173,25 +171,20 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
 
           if (aioc)
             {
-              /* Yes... attempt to cancel the I/O.  There are two
-               * possibilities:* (1) the work has already been started and
-               * is no longer queued, or (2) the work has not been started
-               * and is still in the work queue.  Only the second case can
-               * be canceled.  work_cancel() will return -ENOENT in the
-               * first case.
+              /* Yes... attempt to cancel the I/O.  Only I/O that has not
+               * yet been started by an AIO worker thread can be canceled.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
-
-              /* Remove the container from the list of pending transfers */
-
               next   = (FAR struct aio_container_s *)aioc->aioc_link.flink;
-              aiocbp = aioc_decant(aioc);
+              aiocbp = aioc->aioc_aiocbp;
+              pid    = aioc->aioc_pid;
               DEBUGASSERT(aiocbp);
 
+              status = aio_dequeue(aioc);
               if (status >= 0)
                 {
                   aiocbp->aio_result = -ECANCELED;
+                  (void)aio_signal(pid, aiocbp);
                   if (ret != AIO_NOTCANCELED)
                     {
                       ret = AIO_CANCELED;
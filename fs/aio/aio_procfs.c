@@ -0,0 +1,325 @@
+/****************************************************************************
+ * fs/aio/aio_procfs.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "aio/aio.h"
+
+#if defined(CONFIG_FS_AIO) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_AIO)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of the buffer that holds the complete formatted
+ * statistics.
+ */
+
+#define AIO_PROCFS_BUFSIZE 192
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct aio_file_s
+{
+  struct procfs_file_s base;        /* Base open file structure */
+  unsigned int linesize;            /* Number of valid characters in line[] */
+  char line[AIO_PROCFS_BUFSIZE];    /* Formatted statistics */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     aio_procfs_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     aio_procfs_close(FAR struct file *filep);
+static ssize_t aio_procfs_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     aio_procfs_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     aio_procfs_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there. */
+
+const struct procfs_operations aio_procfsoperations =
+{
+  aio_procfs_open,   /* open */
+  aio_procfs_close,  /* close */
+  aio_procfs_read,   /* read */
+  NULL,              /* write */
+
+  aio_procfs_dup,    /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  aio_procfs_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_procfs_open
+ ****************************************************************************/
+
+static int aio_procfs_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode)
+{
+  FAR struct aio_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "fs/aio" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "fs/aio") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = (FAR struct aio_file_s *)kmm_zalloc(sizeof(struct aio_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_procfs_close
+ ****************************************************************************/
+
+static int aio_procfs_close(FAR struct file *filep)
+{
+  FAR struct aio_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct aio_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_procfs_read
+ ****************************************************************************/
+
+static ssize_t aio_procfs_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct aio_file_s *attr;
+  struct aio_stats_s stats;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct aio_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* If f_pos is zero, then sample the statistics.  Otherwise, use the
+   * text formatted by the previous read() so that the values remain
+   * stable if the user reads the file in pieces.
+   */
+
+  if (filep->f_pos == 0)
+    {
+      aio_getstats(&stats);
+
+      ret = snprintf(attr->line, AIO_PROCFS_BUFSIZE,
+                     "Workers:   %u\n"
+                     "Queued:    %lu\n"
+                     "Completed: %lu\n"
+                     "Merged:    %lu\n"
+                     "Canceled:  %lu\n"
+                     "Rate:      %lu req/s\n"
+                     "Latency:   p50 %lu p90 %lu p99 %lu max %lu usec\n",
+                     CONFIG_FS_AIO_NWORKERS,
+                     (unsigned long)stats.queued,
+                     (unsigned long)stats.completed,
+                     (unsigned long)stats.merged,
+                     (unsigned long)stats.canceled,
+                     (unsigned long)stats.rate,
+                     (unsigned long)stats.p50,
+                     (unsigned long)stats.p90,
+                     (unsigned long)stats.p99,
+                     (unsigned long)stats.max);
+
+      if (ret >= AIO_PROCFS_BUFSIZE)
+        {
+          ret = AIO_PROCFS_BUFSIZE - 1;
+        }
+
+      attr->linesize = ret;
+    }
+
+  /* Transfer the statistics to the user receive buffer */
+
+  offset = filep->f_pos;
+  ret    = procfs_memcpy(attr->line, attr->linesize, buffer, buflen, &offset);
+
+  /* Update the file offset */
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: aio_procfs_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int aio_procfs_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct aio_file_s *oldattr;
+  FAR struct aio_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct aio_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the file attributes */
+
+  newattr = (FAR struct aio_file_s *)kmm_malloc(sizeof(struct aio_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct aio_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_procfs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int aio_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fs/aio" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "fs/aio") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "fs/aio" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_FS_AIO && CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_AIO */
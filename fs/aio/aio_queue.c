@@ -33,36 +33,486 @@
  *
  ****************************************************************************/
 
+
 /****************************************************************************
  * Included Files
  ****************************************************************************/
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
 #include <sched.h>
 #include <aio.h>
+#include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
-#include <nuttx/wqueue.h>
+#include <nuttx/sched.h>
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
 
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Latencies are accumulated in a histogram of power-of-two buckets:  Bucket
+ * n counts the latencies less than 2^n microseconds (and not counted in a
+ * lower bucket).  The last bucket counts everything else.
+ */
+
+#define AIO_NBUCKETS 32
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The AIO worker threads wait on this semaphore for queued requests */
+
+static sem_t g_aio_wakesem;
+
+/* The IDs of the worker threads and the file (or socket) that each worker
+ * is currently performing I/O on.  A queued request is not started while
+ * another request on the same file is in progress.  That keeps the requests
+ * on each file in order.
+ */
+
+static bool g_aio_started;
+static pid_t g_aio_pid[CONFIG_FS_AIO_NWORKERS];
+static FAR void *g_aio_busy[CONFIG_FS_AIO_NWORKERS];
+
+/* Statistics.  These are protected by the AIO lock. */
+
+static uint32_t g_aio_nqueued;         /* Requests queued */
+static uint32_t g_aio_ncompleted;      /* Requests completed */
+static uint32_t g_aio_nmerged;         /* Requests merged into another */
+static uint32_t g_aio_ncanceled;       /* Requests canceled */
+static uint32_t g_aio_maxlatency;      /* Longest latency (usec) */
+static uint32_t g_aio_latency[AIO_NBUCKETS];
+
+static systime_t g_aio_ratestart;      /* Start of the current second */
+static uint32_t g_aio_ratecount;       /* Completions in the current second */
+static uint32_t g_aio_lastrate;        /* Completions in the last second */
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_isbusy
+ *
+ * Description:
+ *   Return true if a worker thread is performing I/O on this file.
+ *
+ ****************************************************************************/
+
+static bool aio_isbusy(FAR void *ptr)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_AIO_NWORKERS; i++)
+    {
+      if (g_aio_busy[i] == ptr)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: aio_next
+ *
+ * Description:
+ *   Take the oldest queued request whose file is not busy, merging the
+ *   adjacent requests on the same file that follow it in the queue.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+static FAR struct aio_container_s *aio_next(int wndx)
+{
+  FAR struct aio_container_s *aioc;
+  FAR struct aio_container_s *tail;
+  FAR struct aio_container_s *next;
+  off_t offset;
+  int nmerged;
+
+  for (aioc = (FAR struct aio_container_s *)g_aio_pending.head;
+       aioc != NULL;
+       aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink)
+    {
+      if (aioc->aioc_state == AIOC_QUEUED && !aio_isbusy(aioc->u.ptr))
+        {
+          break;
+        }
+    }
+
+  if (aioc == NULL)
+    {
+      return NULL;
+    }
+
+  aioc->aioc_state = AIOC_ACTIVE;
+  aioc->aioc_next  = NULL;
+  g_aio_busy[wndx] = aioc->u.ptr;
+
+  /* Merge the following requests on the same file for as long as each one
+   * starts where the previous one ends.  Any other request on this file
+   * ends the merge so that the requests stay in order.
+   */
+
+  if ((aioc->aioc_flags & AIOC_MERGE) == 0)
+    {
+      return aioc;
+    }
+
+  tail    = aioc;
+  offset  = aioc->aioc_aiocbp->aio_offset + aioc->aioc_aiocbp->aio_nbytes;
+  nmerged = 1;
+
+  for (next = (FAR struct aio_container_s *)aioc->aioc_link.flink;
+       next != NULL && nmerged < CONFIG_FS_AIO_MERGE_MAX;
+       next = (FAR struct aio_container_s *)next->aioc_link.flink)
+    {
+      if (next->u.ptr != aioc->u.ptr)
+        {
+          continue;
+        }
+
+      if (next->aioc_state != AIOC_QUEUED ||
+          (next->aioc_flags & AIOC_MERGE) == 0 ||
+          next->aioc_worker != aioc->aioc_worker ||
+          next->aioc_aiocbp->aio_offset != offset)
+        {
+          break;
+        }
+
+      next->aioc_state = AIOC_ACTIVE;
+      next->aioc_next  = NULL;
+      tail->aioc_next  = next;
+      tail             = next;
+
+      offset += next->aioc_aiocbp->aio_nbytes;
+      nmerged++;
+    }
+
+  g_aio_nmerged += nmerged - 1;
+  return aioc;
+}
+
+/****************************************************************************
+ * Name: aio_account
+ *
+ * Description:
+ *   Update the statistics for a completed request.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+static void aio_account(systime_t now, systime_t qtime)
+{
+  uint32_t usec;
+  int bucket;
+
+  usec = TICK2USEC(now - qtime);
+  if (usec > g_aio_maxlatency)
+    {
+      g_aio_maxlatency = usec;
+    }
+
+  for (bucket = 0;
+       bucket < AIO_NBUCKETS - 1 && usec >= ((uint32_t)1 << bucket);
+       bucket++);
+
+  g_aio_latency[bucket]++;
+  g_aio_ncompleted++;
+  g_aio_ratecount++;
+}
+
+/****************************************************************************
+ * Name: aio_ratetick
+ *
+ * Description:
+ *   Start a new one second rate measurement interval if the current one
+ *   has expired.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+static void aio_ratetick(systime_t now)
+{
+  systime_t elapsed = now - g_aio_ratestart;
+
+  if (elapsed >= TICK_PER_SEC)
+    {
+      /* If more than one full interval has passed, then nothing at all
+       * completed in the last second.
+       */
+
+      g_aio_lastrate  = elapsed < 2 * TICK_PER_SEC ? g_aio_ratecount : 0;
+      g_aio_ratecount = 0;
+      g_aio_ratestart = now;
+    }
+}
+
+/****************************************************************************
+ * Name: aio_percentile
+ *
+ * Description:
+ *   Return the upper bound, in microseconds, of the latency histogram
+ *   bucket holding the given percentile.
+ *
+ ****************************************************************************/
+
+static uint32_t aio_percentile(unsigned int pct)
+{
+  uint32_t total;
+  uint32_t limit;
+  uint32_t usec;
+  int bucket;
+
+  for (bucket = 0, total = 0; bucket < AIO_NBUCKETS; bucket++)
+    {
+      total += g_aio_latency[bucket];
+    }
+
+  if (total == 0)
+    {
+      return 0;
+    }
+
+  limit = (uint32_t)(((uint64_t)total * pct + 99) / 100);
+  for (bucket = 0, total = 0; bucket < AIO_NBUCKETS - 1; bucket++)
+    {
+      total += g_aio_latency[bucket];
+      if (total >= limit)
+        {
+          break;
+        }
+    }
+
+  usec = (uint32_t)1 << bucket;
+  return usec < g_aio_maxlatency ? usec : g_aio_maxlatency;
+}
+
+/****************************************************************************
+ * Name: aio_setprio
+ *
+ * Description:
+ *   Set the priority of the calling worker thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+static void aio_setprio(int prio)
+{
+  struct sched_param param;
+
+  param.sched_priority = prio;
+  (void)nxsched_setparam(0, &param);
+}
+#endif
+
+/****************************************************************************
+ * Name: aio_thread
+ *
+ * Description:
+ *   The AIO worker thread.  Perform the queued requests until the end of
+ *   time.
+ *
+ ****************************************************************************/
+
+static int aio_thread(int argc, FAR char *argv[])
+{
+  FAR struct aio_container_s *aioc;
+  FAR struct aio_container_s *next;
+  systime_t qtime[CONFIG_FS_AIO_MERGE_MAX];
+  systime_t now;
+  worker_t worker;
+  pid_t me = getpid();
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  int prio;
+#endif
+  int wndx;
+  int nreq;
+  int i;
+
+  /* Find our index in the worker list */
+
+  for (wndx = 0; wndx < CONFIG_FS_AIO_NWORKERS; wndx++)
+    {
+      if (g_aio_pid[wndx] == me)
+        {
+          break;
+        }
+    }
+
+  DEBUGASSERT(wndx < CONFIG_FS_AIO_NWORKERS);
+
+  for (; ; )
+    {
+      /* Wait for a request that can be started */
+
+      aio_lock();
+      while ((aioc = aio_next(wndx)) == NULL)
+        {
+          aio_unlock();
+          (void)nxsem_wait(&g_aio_wakesem);
+          aio_lock();
+        }
+
+      /* Save what is needed after the worker has freed the containers */
+
+      worker = aioc->aioc_worker;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      prio   = CONFIG_FS_AIO_PRIORITY;
+#endif
+
+      for (nreq = 0, next = aioc; next != NULL; next = next->aioc_next)
+        {
+          qtime[nreq++] = next->aioc_qtime;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+          if (next->aioc_prio > prio)
+            {
+              prio = next->aioc_prio;
+            }
+#endif
+        }
+
+      aio_unlock();
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      /* Run at the priority of the waiting thread, if that is higher */
+
+      if (prio > CONFIG_FS_AIO_PRIORITY)
+        {
+          aio_setprio(prio);
+        }
+#endif
+
+      /* Perform the I/O.  The worker decants the containers. */
+
+      worker(aioc);
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      if (prio > CONFIG_FS_AIO_PRIORITY)
+        {
+          aio_setprio(CONFIG_FS_AIO_PRIORITY);
+        }
+#endif
+
+      /* The file is no longer busy.  Requests that were waiting for it may
+       * now be started by any worker.
+       */
+
+      aio_lock();
+      g_aio_busy[wndx] = NULL;
+
+      now = clock_systimer();
+      aio_ratetick(now);
+
+      for (i = 0; i < nreq; i++)
+        {
+          aio_account(now, qtime[i]);
+        }
+
+      if (!dq_empty(&g_aio_pending))
+        {
+          nxsem_post(&g_aio_wakesem);
+        }
+
+      aio_unlock();
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Name: aio_start
+ *
+ * Description:
+ *   Start the AIO worker threads.
+ *
+ * Assumptions:
+ *   The caller holds the AIO lock.
+ *
+ ****************************************************************************/
+
+static int aio_start(void)
+{
+  pid_t pid;
+  int wndx;
+
+  (void)nxsem_init(&g_aio_wakesem, 0, 0);
+  (void)nxsem_setprotocol(&g_aio_wakesem, SEM_PRIO_NONE);
+
+  g_aio_ratestart = clock_systimer();
+
+  /* Don't let the workers run until all of their IDs are known */
+
+  sched_lock();
+  for (wndx = 0; wndx < CONFIG_FS_AIO_NWORKERS; wndx++)
+    {
+      pid = kthread_create("aio", CONFIG_FS_AIO_PRIORITY,
+                           CONFIG_FS_AIO_STACKSIZE,
+                           (main_t)aio_thread, (FAR char * const *)NULL);
+      if (pid < 0)
+        {
+          ferr("ERROR: kthread_create %d failed: %d\n", wndx, (int)pid);
+
+          /* Carry on with fewer workers if at least one was started */
+
+          if (wndx == 0)
+            {
+              sched_unlock();
+              return (int)pid;
+            }
+
+          break;
+        }
+
+      g_aio_pid[wndx] = pid;
+    }
+
+  g_aio_started = true;
+  sched_unlock();
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the AIO worker threads.  The worker
+ *   threads are started when the first I/O is queued.
+ *
+ *   The worker is called with the container as its argument.  If the
+ *   container has the AIOC_MERGE flag, the worker must also be prepared to
+ *   handle a merged transfer:  A chain of containers linked through
+ *   aioc_next that describe adjacent I/O on the same file.
  *
  * Input Parameters:
- *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *   aioc   - The AIO control block container
+ *   worker - The function that performs the I/O on the worker thread
  *
  * Returned Value:
  *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
@@ -72,39 +522,98 @@
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 {
-  int ret;
+  FAR struct aiocb *aiocbp;
+  int ret = OK;
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Prohibit context switches until we complete the queuing */
+  aio_lock();
 
-  sched_lock();
+  /* Start the worker threads on the first use */
 
-  /* Make sure that the low-priority worker thread is running at at least
-   * the priority specified for this action.
-   */
+  if (!g_aio_started)
+    {
+      ret = aio_start();
+    }
 
-  lpwork_boostpriority(aioc->aioc_prio);
-#endif
+  if (ret >= 0)
+    {
+      /* Queue the request.  Any worker may take it. */
+
+      aioc->aioc_worker = worker;
+      aioc->aioc_qtime  = clock_systimer();
+      aioc->aioc_state  = AIOC_QUEUED;
+      g_aio_nqueued++;
+
+      aio_unlock();
+      nxsem_post(&g_aio_wakesem);
+      return OK;
+    }
+
+  /* The request could not be queued.  Release its container. */
 
-  /* Schedule the work on the low priority worker thread */
+  aiocbp = aioc_decant(aioc);
+  aio_unlock();
 
-  ret = work_queue(LPWORK, &aioc->aioc_work, worker, aioc, 0);
-  if (ret < 0)
+  aiocbp->aio_result = ret;
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove an AIO request that has not yet been started by a worker thread.
+ *   The caller must hold the AIO lock.
+ *
+ * Input Parameters:
+ *   aioc - The AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed from the queue.  -EBUSY if the
+ *   request has already been started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+  if (aioc->aioc_state != AIOC_QUEUED)
     {
-      FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
-      DEBUGASSERT(aiocbp);
+      return -EBUSY;
+    }
 
-      aiocbp->aio_result = ret;
-      set_errno(-ret);
-      ret = ERROR;
+  (void)aioc_decant(aioc);
+  g_aio_ncanceled++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_getstats
+ *
+ * Description:
+ *   Return a snapshot of the AIO statistics.
+ *
+ ****************************************************************************/
+
+void aio_getstats(FAR struct aio_stats_s *stats)
+{
+  aio_lock();
+
+  if (g_aio_started)
+    {
+      aio_ratetick(clock_systimer());
     }
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Now the low-priority work queue might run at its new priority */
+  stats->queued    = g_aio_nqueued;
+  stats->completed = g_aio_ncompleted;
+  stats->merged    = g_aio_nmerged;
+  stats->canceled  = g_aio_ncanceled;
+  stats->rate      = g_aio_lastrate;
+  stats->p50       = aio_percentile(50);
+  stats->p90       = aio_percentile(90);
+  stats->p99       = aio_percentile(99);
+  stats->max       = g_aio_maxlatency;
 
-  sched_unlock();
-#endif
-  return ret;
+  aio_unlock();
 }
 
 #endif /* CONFIG_FS_AIO */
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/uio.h>
 #include <unistd.h>
 #include <sched.h>
 #include <aio.h>
@@ -46,6 +47,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
 #include "aio/aio.h"
@@ -56,16 +58,60 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_preadv
+ *
+ * Description:
+ *   Read into several buffers starting at an absolute file position.  This
+ *   is file_pread() for a merged transfer.
+ *
+ ****************************************************************************/
+
+#ifdef AIO_HAVE_FILEP
+static ssize_t aio_preadv(FAR struct file *filep, FAR const struct iovec *iov,
+                          int iovcnt, off_t offset)
+{
+  off_t savepos;
+  off_t pos;
+  ssize_t ret;
+
+  savepos = file_seek(filep, 0, SEEK_CUR);
+  if (savepos < 0)
+    {
+      return (ssize_t)savepos;
+    }
+
+  pos = file_seek(filep, offset, SEEK_SET);
+  if (pos < 0)
+    {
+      return (ssize_t)pos;
+    }
+
+  ret = file_readv(filep, iov, iovcnt);
+
+  pos = file_seek(filep, savepos, SEEK_SET);
+  if (pos < 0 && ret >= 0)
+    {
+      ret = (ssize_t)pos;
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: aio_read_worker
  *
  * Description:
  *   This function executes on the worker thread and performs the
- *   asynchronous I/O operation.
+ *   asynchronous I/O operation.  Adjacent reads from the same file may
+ *   have been merged into one transfer.  In that case the data is read
+ *   with a single vectored read and the result is divided between the
+ *   requests in file order.
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *     struct aio_container_s cast to void *.
  *
  * Returned Value:
  *   None
@@ -75,40 +121,57 @@
 static void aio_read_worker(FAR void *arg)
 {
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
-  FAR struct aiocb *aiocbp;
-  pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  uint8_t prio;
+  FAR struct aiocb *aiocbp[CONFIG_FS_AIO_MERGE_MAX];
+  pid_t pid[CONFIG_FS_AIO_MERGE_MAX];
+#ifdef AIO_HAVE_FILEP
+  struct iovec iov[CONFIG_FS_AIO_MERGE_MAX];
 #endif
+  FAR void *ptr;
   ssize_t nread = 0;
-
-  /* Get the information from the container, decant the AIO control block,
-   * and free the container before starting any I/O.  That will minimize
-   * the delays by any other threads waiting for a pre-allocated container.
+  ssize_t remaining;
+  int nreq;
+  int i;
+
+  /* Get the information from the container(s), decant the AIO control
+   * block(s), and free the container(s) before starting any I/O.  That
+   * will minimize the delays by any other threads waiting for a
+   * pre-allocated container.
    */
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
-  pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  prio   = aioc->aioc_prio;
-#endif
-  aiocbp = aioc_decant(aioc);
+  ptr  = aioc->u.ptr;
+  nreq = aioc_decantv(aioc, aiocbp, pid);
 
 #if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
-  if (aiocbp->aio_fildes < CONFIG_NFILE_DESCRIPTORS)
+  if (aiocbp[0]->aio_fildes < CONFIG_NFILE_DESCRIPTORS)
 #endif
 #ifdef AIO_HAVE_FILEP
     {
       /* Perform the file read using:
        *
-       *   u.aioc_filep - File structure pointer
-       *   aio_buf      - Location of buffer
-       *   aio_nbytes   - Length of transfer
-       *   aio_offset   - File offset
+       *   ptr        - File structure pointer
+       *   aio_buf    - Location of buffer
+       *   aio_nbytes - Length of transfer
+       *   aio_offset - File offset
        */
 
-     nread = file_pread(aioc->u.aioc_filep, (FAR void *)aiocbp->aio_buf,
-                        aiocbp->aio_nbytes, aiocbp->aio_offset);
+      if (nreq == 1)
+        {
+          nread = file_pread((FAR struct file *)ptr,
+                             (FAR void *)aiocbp[0]->aio_buf,
+                             aiocbp[0]->aio_nbytes, aiocbp[0]->aio_offset);
+        }
+      else
+        {
+          for (i = 0; i < nreq; i++)
+            {
+              iov[i].iov_base = (FAR void *)aiocbp[i]->aio_buf;
+              iov[i].iov_len  = aiocbp[i]->aio_nbytes;
+            }
+
+          nread = aio_preadv((FAR struct file *)ptr, iov, nreq,
+                             aiocbp[0]->aio_offset);
+        }
     }
 #endif
 #if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
@@ -118,17 +181,22 @@ static void aio_read_worker(FAR void *arg)
     {
       /* Perform the socket receive using:
        *
-       *   u.aioc_psock - Socket structure pointer
-       *   aio_buf      - Location of buffer
-       *   aio_nbytes   - Length of transfer
+       *   ptr        - Socket structure pointer
+       *   aio_buf    - Location of buffer
+       *   aio_nbytes - Length of transfer
        */
 
-      nread = psock_recv(aioc->u.aioc_psock, (FAR void *)aiocbp->aio_buf,
-                         aiocbp->aio_nbytes, 0);
+      DEBUGASSERT(nreq == 1);
+      nread = psock_recv((FAR struct socket *)ptr,
+                         (FAR void *)aiocbp[0]->aio_buf,
+                         aiocbp[0]->aio_nbytes, 0);
     }
 #endif
 
-  /* Set the result of the read operation. */
+  /* Set the result of the read operation(s) and signal the client(s).
+   * Data read by a merged transfer is credited to the requests in order;
+   * the requests beyond the end of file get zero.
+   */
 
 #ifdef CONFIG_DEBUG_FS_ERROR
   if (nread < 0)
@@ -137,17 +205,25 @@ static void aio_read_worker(FAR void *arg)
     }
 #endif
 
-  aiocbp->aio_result = nread;
-
-  /* Signal the client */
-
-  (void)aio_signal(pid, aiocbp);
-
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Restore the low priority worker thread default priority */
-
-  lpwork_restorepriority(prio);
-#endif
+  for (i = 0, remaining = nread; i < nreq; i++)
+    {
+      if (nread < 0 || nreq == 1)
+        {
+          aiocbp[i]->aio_result = nread;
+        }
+      else if ((size_t)remaining >= aiocbp[i]->aio_nbytes)
+        {
+          aiocbp[i]->aio_result = aiocbp[i]->aio_nbytes;
+          remaining -= aiocbp[i]->aio_nbytes;
+        }
+      else
+        {
+          aiocbp[i]->aio_result = remaining;
+          remaining = 0;
+        }
+
+      (void)aio_signal(pid[i], aiocbp[i]);
+    }
 }
 
 /****************************************************************************
@@ -275,6 +351,17 @@ int aio_read(FAR struct aiocb *aiocbp)
       return ERROR;
     }
 
+#ifdef AIO_HAVE_FILEP
+  /* Reads from a file may be merged with adjacent reads */
+
+#ifdef AIO_HAVE_PSOCK
+  if (aiocbp->aio_fildes < CONFIG_NFILE_DESCRIPTORS)
+#endif
+    {
+      aioc->aioc_flags |= AIOC_MERGE;
+    }
+#endif
+
   /* Defer the work to the worker thread */
 
   ret = aio_queue(aioc, aio_read_worker);
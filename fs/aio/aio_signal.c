@@ -73,7 +73,8 @@
  *   negated errno value is returned.
  *
  * Assumptions:
- *   This function runs only in the context of the worker thread.
+ *   This function runs in the context of an AIO worker thread or, for
+ *   canceled I/O, in the context of aio_cancel().
  *
  ****************************************************************************/
 
@@ -97,7 +98,7 @@ int aio_signal(pid_t pid, FAR struct aiocb *aiocbp)
       ret = nxsig_queue(pid, aiocbp->aio_sigevent.sigev_signo,
                         aiocbp->aio_sigevent.sigev_value);
 #else
-      ret = nxsig_queue(pid, aiocbp->aio_sigevent.sigev_sign,
+      ret = nxsig_queue(pid, aiocbp->aio_sigevent.sigev_signo,
                         aiocbp->aio_sigevent.sigev_value.sival_ptr);
 #endif
       if (ret < 0)
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/uio.h>
 #include <stdarg.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -48,6 +49,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/fs/fs.h>
+
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
@@ -73,16 +76,61 @@ static inline int file_fcntl(FAR struct file *filep, int cmd, ...)
 }
 #endif
 
+/****************************************************************************
+ * Name: aio_pwritev
+ *
+ * Description:
+ *   Write from several buffers starting at an absolute file position.  This
+ *   is file_pwrite() for a merged transfer.
+ *
+ ****************************************************************************/
+
+#ifdef AIO_HAVE_FILEP
+static ssize_t aio_pwritev(FAR struct file *filep,
+                           FAR const struct iovec *iov, int iovcnt,
+                           off_t offset)
+{
+  off_t savepos;
+  off_t pos;
+  ssize_t ret;
+
+  savepos = file_seek(filep, 0, SEEK_CUR);
+  if (savepos < 0)
+    {
+      return (ssize_t)savepos;
+    }
+
+  pos = file_seek(filep, offset, SEEK_SET);
+  if (pos < 0)
+    {
+      return (ssize_t)pos;
+    }
+
+  ret = file_writev(filep, iov, iovcnt);
+
+  pos = file_seek(filep, savepos, SEEK_SET);
+  if (pos < 0 && ret >= 0)
+    {
+      ret = (ssize_t)pos;
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: aio_write_worker
  *
  * Description:
  *   This function executes on the worker thread and performs the
- *   asynchronous I/O operation.
+ *   asynchronous I/O operation.  Adjacent writes to the same file may
+ *   have been merged into one transfer.  In that case the data is written
+ *   with a single vectored write and the result is divided between the
+ *   requests in file order.
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *     struct aio_container_s cast to void *.
  *
  * Returned Value:
  *   None
@@ -92,67 +140,75 @@ static inline int file_fcntl(FAR struct file *filep, int cmd, ...)
 static void aio_write_worker(FAR void *arg)
 {
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
-  FAR struct aiocb *aiocbp;
-  pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  uint8_t prio;
-#endif
-  ssize_t nwritten = 0;
+  FAR struct aiocb *aiocbp[CONFIG_FS_AIO_MERGE_MAX];
+  pid_t pid[CONFIG_FS_AIO_MERGE_MAX];
 #ifdef AIO_HAVE_FILEP
+  struct iovec iov[CONFIG_FS_AIO_MERGE_MAX];
   int oflags;
 #endif
-
-  /* Get the information from the container, decant the AIO control block,
-   * and free the container before starting any I/O.  That will minimize
-   * the delays by any other threads waiting for a pre-allocated container.
+  FAR void *ptr;
+  ssize_t nwritten = 0;
+  ssize_t remaining;
+  int nreq;
+  int i;
+
+  /* Get the information from the container(s), decant the AIO control
+   * block(s), and free the container(s) before starting any I/O.  That
+   * will minimize the delays by any other threads waiting for a
+   * pre-allocated container.
    */
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
-  pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  prio   = aioc->aioc_prio;
-#endif
-  aiocbp = aioc_decant(aioc);
+  ptr  = aioc->u.ptr;
+  nreq = aioc_decantv(aioc, aiocbp, pid);
 
 #if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
-  if (aiocbp->aio_fildes < CONFIG_NFILE_DESCRIPTORS)
+  if (aiocbp[0]->aio_fildes < CONFIG_NFILE_DESCRIPTORS)
 #endif
 #ifdef AIO_HAVE_FILEP
     {
+      FAR struct file *filep = (FAR struct file *)ptr;
+
       /* Call fcntl(F_GETFL) to get the file open mode. */
 
-      oflags = file_fcntl(aioc->u.aioc_filep, F_GETFL);
+      oflags = file_fcntl(filep, F_GETFL);
       if (oflags < 0)
         {
           ferr("ERROR: file_fcntl failed: %d\n", oflags);
-          aiocbp->aio_result = oflags;
+          nwritten = oflags;
           goto errout;
         }
 
       /* Perform the write using:
        *
-       *   u.aioc_filep - File structure pointer
-       *   aio_buf      - Location of buffer
-       *   aio_nbytes   - Length of transfer
-       *   aio_offset   - File offset
+       *   ptr        - File structure pointer
+       *   aio_buf    - Location of buffer
+       *   aio_nbytes - Length of transfer
+       *   aio_offset - File offset
        */
 
+      for (i = 0; i < nreq; i++)
+        {
+          iov[i].iov_base = (FAR void *)aiocbp[i]->aio_buf;
+          iov[i].iov_len  = aiocbp[i]->aio_nbytes;
+        }
+
       /* Check if O_APPEND is set in the file open flags */
 
       if ((oflags & O_APPEND) != 0)
         {
           /* Append to the current file position */
 
-          nwritten = file_write(aioc->u.aioc_filep,
-                                (FAR const void *)aiocbp->aio_buf,
-                                aiocbp->aio_nbytes);
+          nwritten = file_writev(filep, iov, nreq);
+        }
+      else if (nreq == 1)
+        {
+          nwritten = file_pwrite(filep, iov[0].iov_base, iov[0].iov_len,
+                                 aiocbp[0]->aio_offset);
         }
       else
         {
-          nwritten = file_pwrite(aioc->u.aioc_filep,
-                                 (FAR const void *)aiocbp->aio_buf,
-                                 aiocbp->aio_nbytes,
-                                 aiocbp->aio_offset);
+          nwritten = aio_pwritev(filep, iov, nreq, aiocbp[0]->aio_offset);
         }
     }
 #endif
@@ -163,39 +219,50 @@ static void aio_write_worker(FAR void *arg)
     {
       /* Perform the send using:
        *
-       *   u.aioc_psock - Socket structure pointer
-       *   aio_buf      - Location of buffer
-       *   aio_nbytes   - Length of transfer
+       *   ptr        - Socket structure pointer
+       *   aio_buf    - Location of buffer
+       *   aio_nbytes - Length of transfer
        */
 
-      nwritten = psock_send(aioc->u.aioc_psock,
-                            (FAR const void *)aiocbp->aio_buf,
-                            aiocbp->aio_nbytes, 0);
+      DEBUGASSERT(nreq == 1);
+      nwritten = psock_send((FAR struct socket *)ptr,
+                            (FAR const void *)aiocbp[0]->aio_buf,
+                            aiocbp[0]->aio_nbytes, 0);
     }
 #endif
 
   if (nwritten < 0)
     {
-      ferr("ERROR: write/pwrite/send failed: %d\n", nwritten);
+      ferr("ERROR: write/pwrite/send failed: %d\n", (int)nwritten);
     }
 
-  /* Save the result of the write */
-
-  aiocbp->aio_result = nwritten;
-
 #ifdef AIO_HAVE_FILEP
 errout:
 #endif
 
-  /* Signal the client */
-
-  (void)aio_signal(pid, aiocbp);
+  /* Save the result of the write(s) and signal the client(s).  Data
+   * written by a merged transfer is credited to the requests in order.
+   */
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Restore the low priority worker thread default priority */
+  for (i = 0, remaining = nwritten; i < nreq; i++)
+    {
+      if (nwritten < 0 || nreq == 1)
+        {
+          aiocbp[i]->aio_result = nwritten;
+        }
+      else if ((size_t)remaining >= aiocbp[i]->aio_nbytes)
+        {
+          aiocbp[i]->aio_result = aiocbp[i]->aio_nbytes;
+          remaining -= aiocbp[i]->aio_nbytes;
+        }
+      else
+        {
+          aiocbp[i]->aio_result = remaining;
+          remaining = 0;
+        }
 
-  lpwork_restorepriority(prio);
-#endif
+      (void)aio_signal(pid[i], aiocbp[i]);
+    }
 }
 
 /****************************************************************************
@@ -325,6 +392,22 @@ int aio_write(FAR struct aiocb *aiocbp)
       return ERROR;
     }
 
+#ifdef AIO_HAVE_FILEP
+  /* Writes to a file may be merged with adjacent writes unless the file
+   * was opened for appending.
+   */
+
+#ifdef AIO_HAVE_PSOCK
+  if (aiocbp->aio_fildes < CONFIG_NFILE_DESCRIPTORS)
+#endif
+    {
+      if ((aioc->u.aioc_filep->f_oflags & O_APPEND) == 0)
+        {
+          aioc->aioc_flags |= AIOC_MERGE;
+        }
+    }
+#endif
+
   /* Defer the work to the worker thread */
 
   ret = aio_queue(aioc, aio_write_worker);
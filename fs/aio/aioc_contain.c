@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sched.h>
+#include <assert.h>
 #include <errno.h>
 
 #include <nuttx/sched.h>
@@ -79,7 +80,7 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
 #ifdef AIO_HAVE_FILEP
     FAR struct file *filep;
 #endif
-#ifdef AIO_HAVE_FILEP
+#ifdef AIO_HAVE_PSOCK
     FAR struct socket *psock;
 #endif
     FAR void *ptr;
@@ -191,4 +192,44 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc)
   return aiocbp;
 }
 
+/****************************************************************************
+ * Name: aioc_decantv
+ *
+ * Description:
+ *   Decant each AIO control block of a merged transfer:  The container
+ *   passed to the worker and all of the containers linked to it through
+ *   aioc_next.
+ *
+ * Input Parameters:
+ *   aioc   - Pointer to the first AIO control block container
+ *   aiocbp - Receives the no-longer contained AIO control blocks.  Must
+ *            hold CONFIG_FS_AIO_MERGE_MAX entries.
+ *   pid    - Receives the ID of the task waiting for each control block.
+ *
+ * Returned Value:
+ *   The number of AIO control blocks decanted.
+ *
+ ****************************************************************************/
+
+int aioc_decantv(FAR struct aio_container_s *aioc,
+                 FAR struct aiocb **aiocbp, FAR pid_t *pid)
+{
+  FAR struct aio_container_s *next;
+  int n;
+
+  DEBUGASSERT(aioc);
+
+  aio_lock();
+  for (n = 0; aioc != NULL && n < CONFIG_FS_AIO_MERGE_MAX; aioc = next)
+    {
+      next      = aioc->aioc_next;
+      pid[n]    = aioc->aioc_pid;
+      aiocbp[n] = aioc_decant(aioc);
+      n++;
+    }
+
+  aio_unlock();
+  return n;
+}
+
 #endif /* CONFIG_FS_AIO */
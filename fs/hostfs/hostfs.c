@@ -52,6 +52,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
@@ -139,6 +140,7 @@ const struct mountpt_operations hostfs_operations =
   hostfs_sync,          /* sync */
   hostfs_dup,           /* dup */
   hostfs_fstat,         /* fstat */
+  NULL,                 /* truncate */
 
   hostfs_opendir,       /* opendir */
   hostfs_closedir,      /* closedir */
@@ -252,6 +254,162 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+/****************************************************************************
+ * Name: hostfs_flush
+ *
+ * Description: Write any data held in the write-behind buffer of an open
+ *   file to the host.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+static int hostfs_flush(FAR struct hostfs_ofile_s *hf)
+{
+  ssize_t nwritten;
+
+  if (!hf->dirty)
+    {
+      return OK;
+    }
+
+  nwritten = host_pwrite(hf->fd, hf->buffer, hf->buflen, hf->bufpos);
+
+  hf->dirty  = false;
+  hf->buflen = 0;
+
+  if (nwritten < 0)
+    {
+      ferr("ERROR: host_pwrite failed: %d\n", (int)nwritten);
+      return (int)nwritten;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_flushall
+ *
+ * Description: Flush the write-behind buffers of all open files on the
+ *   mountpoint.  This is done before the host is asked about data that
+ *   could still be sitting in one of those buffers.
+ *
+ ****************************************************************************/
+
+static void hostfs_flushall(FAR struct hostfs_mountpt_s *fs)
+{
+  FAR struct hostfs_ofile_s *hf;
+
+  for (hf = fs->fs_head; hf != NULL; hf = hf->fnext)
+    {
+      (void)hostfs_flush(hf);
+    }
+}
+
+/****************************************************************************
+ * Name: hostfs_invalidate
+ *
+ * Description: Discard the read-ahead data of all open files on the
+ *   mountpoint after the host file content has been changed.
+ *
+ ****************************************************************************/
+
+static void hostfs_invalidate(FAR struct hostfs_mountpt_s *fs)
+{
+  FAR struct hostfs_ofile_s *hf;
+
+  for (hf = fs->fs_head; hf != NULL; hf = hf->fnext)
+    {
+      if (!hf->dirty)
+        {
+          hf->buflen = 0;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: hostfs_attrflush
+ *
+ * Description: Discard all cached attributes.  Called whenever something
+ *   is modified through this mountpoint.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+static void hostfs_attrflush(FAR struct hostfs_mountpt_s *fs)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTRCACHE; i++)
+    {
+      fs->fs_attr[i].path[0] = '\0';
+    }
+}
+
+/****************************************************************************
+ * Name: hostfs_attrfind
+ *
+ * Description: Return the cached attributes of the host file at 'path', or
+ *   NULL if there are none or they are older than CONFIG_FS_HOSTFS_ATTRTTL.
+ *
+ ****************************************************************************/
+
+static FAR struct hostfs_attr_s *
+hostfs_attrfind(FAR struct hostfs_mountpt_s *fs, FAR const char *path)
+{
+  FAR struct hostfs_attr_s *attr;
+  systime_t now = clock_systimer();
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTRCACHE; i++)
+    {
+      attr = &fs->fs_attr[i];
+      if (attr->path[0] != '\0' && strcmp(attr->path, path) == 0)
+        {
+          if (now - attr->stamp < MSEC2TICK(CONFIG_FS_HOSTFS_ATTRTTL))
+            {
+              return attr;
+            }
+
+          /* Expired */
+
+          attr->path[0] = '\0';
+          break;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: hostfs_attrsave
+ *
+ * Description: Remember the result of a host stat() operation.
+ *
+ ****************************************************************************/
+
+static void hostfs_attrsave(FAR struct hostfs_mountpt_s *fs,
+                            FAR const char *path, int result,
+                            FAR const struct stat *buf)
+{
+  FAR struct hostfs_attr_s *attr;
+
+  attr = &fs->fs_attr[fs->fs_attrnext];
+  if (++fs->fs_attrnext >= CONFIG_FS_HOSTFS_ATTRCACHE)
+    {
+      fs->fs_attrnext = 0;
+    }
+
+  strncpy(attr->path, path, HOSTFS_MAX_PATH - 1);
+  attr->path[HOSTFS_MAX_PATH - 1] = '\0';
+  attr->stamp  = clock_systimer();
+  attr->result = result;
+  memcpy(&attr->st, buf, sizeof(struct stat));
+}
+#else
+#  define hostfs_attrflush(fs)
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -283,9 +441,10 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
 
   hostfs_semtake(fs);
 
-  /* Allocate memory for the open file */
+  /* Allocate memory for the open file and its buffer */
 
-  hf = (struct hostfs_ofile_s *) kmm_malloc(sizeof *hf);
+  hf = (struct hostfs_ofile_s *)
+    kmm_malloc(sizeof(struct hostfs_ofile_s) + CONFIG_FS_HOSTFS_BUFSIZE);
   if (hf == NULL)
     {
       ret = -ENOMEM;
@@ -299,11 +458,11 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
   /* Try to open the file in the host file system */
 
   hf->fd = host_open(path, oflags, mode);
-  if (hf->fd == -1)
+  if (hf->fd < 0)
     {
       /* Error opening file */
 
-      ret = -EBADF;
+      ret = hf->fd;
       goto errout_with_buffer;
     }
 
@@ -320,8 +479,22 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
   hf->fnext = fs->fs_head;
   hf->crefs = 1;
   hf->oflags = oflags;
+  hf->pos = 0;
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  hf->dirty = false;
+  hf->bufpos = 0;
+  hf->buflen = 0;
+  hf->buffer = (FAR uint8_t *)(hf + 1);
+#endif
   fs->fs_head = hf;
 
+  /* Opening for write may have created or truncated the file */
+
+  if ((oflags & O_WROK) != 0)
+    {
+      hostfs_attrflush(fs);
+    }
+
   ret = OK;
   goto errout_with_semaphore;
 
@@ -406,6 +579,12 @@ static int hostfs_close(FAR struct file *filep)
         }
     }
 
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  /* Write out any buffered data */
+
+  (void)hostfs_flush(hf);
+#endif
+
   /* Close the host file */
 
   host_close(hf->fd);
@@ -422,6 +601,11 @@ okout:
 
 /****************************************************************************
  * Name: hostfs_read
+ *
+ * Description: Read from the file.  Small reads are satisfied from the
+ *   read-ahead buffer, which is refilled with one host call at a time.
+ *   Reads at least as large as the buffer go directly to the host.
+ *
  ****************************************************************************/
 
 static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
@@ -430,7 +614,11 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
   FAR struct inode *inode;
   FAR struct hostfs_mountpt_s *fs;
   FAR struct hostfs_ofile_s *hf;
-  int ret = OK;
+  ssize_t nread = 0;
+  ssize_t ret = OK;
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  size_t ncopy;
+#endif
 
   /* Sanity checks */
 
@@ -448,16 +636,97 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
 
   hostfs_semtake(fs);
 
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  while (buflen > 0)
+    {
+      /* Return whatever part of the request is already buffered */
+
+      if (!hf->dirty && hf->pos >= hf->bufpos &&
+          hf->pos < hf->bufpos + (off_t)hf->buflen)
+        {
+          ncopy = hf->bufpos + hf->buflen - hf->pos;
+          if (ncopy > buflen)
+            {
+              ncopy = buflen;
+            }
+
+          memcpy(buffer, &hf->buffer[hf->pos - hf->bufpos], ncopy);
+          hf->pos += ncopy;
+          buffer  += ncopy;
+          buflen  -= ncopy;
+          nread   += ncopy;
+          continue;
+        }
+
+      /* Anything written through this mountpoint must reach the host
+       * before the host is asked for file data.
+       */
+
+      hostfs_flushall(fs);
+
+      /* Large transfers bypass the buffer */
+
+      if (buflen >= CONFIG_FS_HOSTFS_BUFSIZE)
+        {
+          ret = host_pread(hf->fd, buffer, buflen, hf->pos);
+          if (ret > 0)
+            {
+              hf->pos += ret;
+              nread   += ret;
+            }
+
+          break;
+        }
+
+      /* Refill the buffer from the current position */
+
+      hf->buflen = 0;
+      ret = host_pread(hf->fd, hf->buffer, CONFIG_FS_HOSTFS_BUFSIZE,
+                       hf->pos);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      hf->bufpos = hf->pos;
+      hf->buflen = ret;
+
+      /* A short read means that the end of the file was reached.  Copy out
+       * what was read, but do not ask the host again.
+       */
+
+      if (ret < CONFIG_FS_HOSTFS_BUFSIZE && (size_t)ret < buflen)
+        {
+          memcpy(buffer, hf->buffer, ret);
+          hf->pos += ret;
+          nread   += ret;
+          break;
+        }
+    }
+#else
   /* Call the host to perform the read */
 
-  ret = host_read(hf->fd, buffer, buflen);
+  ret = host_pread(hf->fd, buffer, buflen, hf->pos);
+  if (ret > 0)
+    {
+      hf->pos += ret;
+      nread    = ret;
+    }
+#endif
 
   hostfs_semgive(fs);
-  return ret;
+
+  /* Report an error only if nothing was transferred */
+
+  return (nread > 0 || ret >= 0) ? nread : ret;
 }
 
 /****************************************************************************
  * Name: hostfs_write
+ *
+ * Description: Write to the file.  Small sequential writes are collected
+ *   in the write-behind buffer and passed to the host together.
+ *
  ****************************************************************************/
 
 static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
@@ -466,7 +735,7 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
   FAR struct inode *inode;
   FAR struct hostfs_mountpt_s *fs;
   FAR struct hostfs_ofile_s *hf;
-  int ret;
+  ssize_t ret;
 
   /* Sanity checks.  I have seen the following assertion misfire if
    * CONFIG_DEBUG_MM is enabled while re-directing output to a
@@ -506,9 +775,78 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_semaphore;
     }
 
+  /* Cached attributes and read-ahead data may now be stale */
+
+  hostfs_attrflush(fs);
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  hostfs_invalidate(fs);
+#endif
+
+  /* Appending writes go to the host directly.  Only the host knows where
+   * the end of the file is.
+   */
+
+  if ((hf->oflags & O_APPEND) != 0)
+    {
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+      ret = hostfs_flush(hf);
+      if (ret < 0)
+        {
+          goto errout_with_semaphore;
+        }
+#endif
+
+      ret = host_write(hf->fd, buffer, buflen);
+      if (ret > 0)
+        {
+          hf->pos = host_lseek(hf->fd, 0, SEEK_CUR);
+        }
+
+      goto errout_with_semaphore;
+    }
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  /* Extend the pending data if this write continues it and fits */
+
+  if (hf->dirty && hf->pos == hf->bufpos + (off_t)hf->buflen &&
+      hf->buflen + buflen <= CONFIG_FS_HOSTFS_BUFSIZE)
+    {
+      memcpy(&hf->buffer[hf->buflen], buffer, buflen);
+      hf->buflen += buflen;
+      hf->pos    += buflen;
+      ret         = buflen;
+      goto errout_with_semaphore;
+    }
+
+  /* Otherwise write out the pending data first */
+
+  ret = hostfs_flush(hf);
+  if (ret < 0)
+    {
+      goto errout_with_semaphore;
+    }
+
+  if (buflen < CONFIG_FS_HOSTFS_BUFSIZE)
+    {
+      /* Start collecting new data at the current position */
+
+      memcpy(hf->buffer, buffer, buflen);
+      hf->dirty  = true;
+      hf->bufpos = hf->pos;
+      hf->buflen = buflen;
+      hf->pos   += buflen;
+      ret        = buflen;
+      goto errout_with_semaphore;
+    }
+#endif
+
   /* Call the host to perform the write */
 
-  ret = host_write(hf->fd, buffer, buflen);
+  ret = host_pwrite(hf->fd, buffer, buflen, hf->pos);
+  if (ret > 0)
+    {
+      hf->pos += ret;
+    }
 
 errout_with_semaphore:
   hostfs_semgive(fs);
@@ -517,6 +855,10 @@ errout_with_semaphore:
 
 /****************************************************************************
  * Name: hostfs_seek
+ *
+ * Description: The file position is kept here.  All transfers use explicit
+ *   offsets, so the host file position is only consulted for SEEK_END.
+ *
  ****************************************************************************/
 
 static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
@@ -524,7 +866,7 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
   FAR struct inode *inode;
   FAR struct hostfs_mountpt_s *fs;
   FAR struct hostfs_ofile_s *hf;
-  int ret;
+  off_t ret;
 
   /* Sanity checks */
 
@@ -542,9 +884,38 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
 
   hostfs_semtake(fs);
 
-  /* Call our internal routine to perform the seek */
+  switch (whence)
+    {
+      case SEEK_SET:
+        ret = offset;
+        break;
+
+      case SEEK_CUR:
+        ret = hf->pos + offset;
+        break;
+
+      case SEEK_END:
+        /* The host must see all of the data to know the file size */
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+        (void)hostfs_flush(hf);
+#endif
+        ret = host_lseek(hf->fd, offset, SEEK_END);
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
 
-  ret = host_lseek(hf->fd, offset, whence);
+  if (ret >= 0)
+    {
+      hf->pos = ret;
+    }
+  else if (whence != SEEK_END)
+    {
+      ret = -EINVAL;
+    }
 
   hostfs_semgive(fs);
   return ret;
@@ -577,6 +948,15 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   hostfs_semtake(fs);
 
+  /* The ioctl may depend on or change the host file state */
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  (void)hostfs_flush(hf);
+  hostfs_invalidate(fs);
+#endif
+  hostfs_attrflush(fs);
+  (void)host_lseek(hf->fd, hf->pos, SEEK_SET);
+
   /* Call our internal routine to perform the ioctl */
 
   ret = host_ioctl(hf->fd, cmd, arg);
@@ -615,6 +995,9 @@ static int hostfs_sync(FAR struct file *filep)
 
   hostfs_semtake(fs);
 
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  (void)hostfs_flush(hf);
+#endif
   host_sync(hf->fd);
 
   hostfs_semgive(fs);
@@ -685,7 +1068,13 @@ static int hostfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   hostfs_semtake(fs);
 
-  /* Call the host to perform the read */
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  /* The file size must include any buffered data */
+
+  (void)hostfs_flush(hf);
+#endif
+
+  /* Call the host to perform the fstat */
 
   ret = host_fstat(hf->fd, buf);
 
@@ -732,6 +1121,19 @@ static int hostfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
       goto errout_with_semaphore;
     }
 
+  /* Allocate space for a batch of directory entries */
+
+  dir->u.hostfs.fs_ents = (FAR struct dirent *)
+    kmm_malloc(CONFIG_FS_HOSTFS_NDIRENTS * sizeof(struct dirent));
+  if (dir->u.hostfs.fs_ents == NULL)
+    {
+      host_closedir(dir->u.hostfs.fs_dir);
+      ret = -ENOMEM;
+      goto errout_with_semaphore;
+    }
+
+  dir->u.hostfs.fs_nents = 0;
+  dir->u.hostfs.fs_index = 0;
   ret = OK;
 
 errout_with_semaphore:
@@ -767,6 +1169,7 @@ static int hostfs_closedir(FAR struct inode *mountpt,
   /* Call the host's closedir function */
 
   host_closedir(dir->u.hostfs.fs_dir);
+  kmm_free(dir->u.hostfs.fs_ents);
 
   hostfs_semgive(fs);
   return OK;
@@ -783,7 +1186,8 @@ static int hostfs_readdir(FAR struct inode *mountpt,
                           FAR struct fs_dirent_s *dir)
 {
   FAR struct hostfs_mountpt_s *fs;
-  int ret;
+  FAR struct fs_hostfsdir_s *hdir;
+  int ret = OK;
 
   /* Sanity checks */
 
@@ -791,15 +1195,35 @@ static int hostfs_readdir(FAR struct inode *mountpt,
 
   /* Recover our private data from the inode instance */
 
-  fs = mountpt->i_private;
+  fs   = mountpt->i_private;
+  hdir = &dir->u.hostfs;
 
   /* Take the semaphore */
 
   hostfs_semtake(fs);
 
-  /* Call the host OS's readdir function */
+  /* Fetch the next batch of entries from the host if all of the previous
+   * batch has been returned.
+   */
+
+  if (hdir->fs_index >= hdir->fs_nents)
+    {
+      ret = host_readdirv(hdir->fs_dir, hdir->fs_ents,
+                          CONFIG_FS_HOSTFS_NDIRENTS);
+      hdir->fs_index = 0;
+      hdir->fs_nents = ret > 0 ? ret : 0;
+    }
 
-  ret = host_readdir(dir->u.hostfs.fs_dir, &dir->fd_dir);
+  if (hdir->fs_index < hdir->fs_nents)
+    {
+      memcpy(&dir->fd_dir, &hdir->fs_ents[hdir->fs_index++],
+             sizeof(struct dirent));
+      ret = OK;
+    }
+  else if (ret >= 0)
+    {
+      ret = -ENOENT;
+    }
 
   hostfs_semgive(fs);
   return ret;
@@ -823,6 +1247,11 @@ static int hostfs_rewinddir(FAR struct inode *mountpt,
 
   host_rewinddir(dir->u.hostfs.fs_dir);
 
+  /* Discard any entries that were fetched but not yet returned */
+
+  dir->u.hostfs.fs_nents = 0;
+  dir->u.hostfs.fs_index = 0;
+
   return OK;
 }
 
@@ -994,6 +1423,10 @@ static int hostfs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
   memset(buf, 0, sizeof(struct statfs));
   buf->f_type = HOSTFS_MAGIC;
 
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  hostfs_flushall(fs);
+#endif
+
   /* Call the host fs to perform the statfs */
 
   ret = host_statfs(fs->fs_root, buf);
@@ -1032,6 +1465,7 @@ static int hostfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host fs to perform the unlink */
 
   ret = host_unlink(path);
+  hostfs_attrflush(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1068,6 +1502,7 @@ static int hostfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_mkdir(path, mode);
+  hostfs_attrflush(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1105,6 +1540,7 @@ int hostfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host FS to do the mkdir */
 
   ret = host_rmdir(path);
+  hostfs_attrflush(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1145,6 +1581,7 @@ int hostfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_rename(oldpath, newpath);
+  hostfs_attrflush(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1161,6 +1598,9 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                        FAR struct stat *buf)
 {
   FAR struct hostfs_mountpt_s *fs;
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  FAR struct hostfs_attr_s *attr;
+#endif
   char path[HOSTFS_MAX_PATH];
   int ret;
 
@@ -1178,10 +1618,34 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   hostfs_mkpath(fs, relpath, path, sizeof(path));
 
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  /* Use the cached attributes if they are still fresh */
+
+  attr = hostfs_attrfind(fs, path);
+  if (attr != NULL)
+    {
+      memcpy(buf, &attr->st, sizeof(struct stat));
+      ret = attr->result;
+      goto errout_with_semaphore;
+    }
+#endif
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  /* The host must see any buffered data to report the correct size */
+
+  hostfs_flushall(fs);
+#endif
+
   /* Call the host FS to do the stat operation */
 
   ret = host_stat(path, buf);
 
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  hostfs_attrsave(fs, path, ret, buf);
+
+errout_with_semaphore:
+#endif
+
   hostfs_semgive(fs);
   return ret;
 }
@@ -43,10 +43,13 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
 
+#include <nuttx/clock.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -63,6 +66,24 @@
 
 #define HOSTFS_MAX_PATH     256
 
+/* Configuration */
+
+#ifndef CONFIG_FS_HOSTFS_BUFSIZE
+#  define CONFIG_FS_HOSTFS_BUFSIZE 4096
+#endif
+
+#ifndef CONFIG_FS_HOSTFS_NDIRENTS
+#  define CONFIG_FS_HOSTFS_NDIRENTS 16
+#endif
+
+#ifndef CONFIG_FS_HOSTFS_ATTRCACHE
+#  define CONFIG_FS_HOSTFS_ATTRCACHE 8
+#endif
+
+#ifndef CONFIG_FS_HOSTFS_ATTRTTL
+#  define CONFIG_FS_HOSTFS_ATTRTTL 100
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -77,8 +98,29 @@ struct hostfs_ofile_s
   int16_t                   crefs;      /* Reference count */
   mode_t                    oflags;     /* Open mode */
   int                       fd;
+  off_t                     pos;        /* Current file position */
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  bool                      dirty;      /* buffer[] holds unwritten data */
+  off_t                     bufpos;     /* File position of buffer[0] */
+  size_t                    buflen;     /* Number of valid bytes in buffer[] */
+  FAR uint8_t              *buffer;     /* Read-ahead / write-behind buffer */
+#endif
 };
 
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+/* This structure holds one cached host stat() result.  An empty path
+ * marks an unused entry.
+ */
+
+struct hostfs_attr_s
+{
+  systime_t                 stamp;      /* Time when the entry was filled */
+  int                       result;     /* Return value of host_stat() */
+  struct stat               st;         /* File attributes */
+  char                      path[HOSTFS_MAX_PATH];
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a hostfs filesystem.
@@ -89,6 +131,10 @@ struct hostfs_mountpt_s
   sem_t                      *fs_sem;       /* Used to assure thread-safe access */
   FAR struct hostfs_ofile_s  *fs_head;      /* A singly-linked list of open files */
   char                        fs_root[HOSTFS_MAX_PATH];
+#if CONFIG_FS_HOSTFS_ATTRCACHE > 0
+  uint8_t                     fs_attrnext;  /* Next cache entry to replace */
+  struct hostfs_attr_s        fs_attr[CONFIG_FS_HOSTFS_ATTRCACHE];
+#endif
 };
 
 /****************************************************************************
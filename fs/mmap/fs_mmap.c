@@ -66,11 +66,15 @@
  *     a. The filesystem supports the FIOC_MMAP ioctl command.  Any file
  *        system that maps files contiguously on the media should support
  *        this ioctl. (vs. file system that scatter files over the media
- *        in non-contiguous sectors).  As of this writing, ROMFS is the
- *        only file system that meets this requirement.
- *     b. The underlying block driver supports the BIOC_XIPBASE ioctl
- *        command that maps the underlying media to a randomly accessible
- *        address. At  present, only the RAM/ROM disk driver does this.
+ *        in non-contiguous sectors).  As of this writing, ROMFS and TMPFS
+ *        meet this requirement.
+ *     b. For ROMFS, the underlying block driver supports the BIOC_XIPBASE
+ *        ioctl command that maps the underlying media to a randomly
+ *        accessible address. At  present, only the RAM/ROM disk driver does
+ *        this.  TMPFS files are always in memory.
+ *
+ *     The file storage itself is mapped, so writes through the mapping
+ *     and write() to the file are visible to all mappers (MAP_SHARED).
  *
  *   2. If CONFIG_FS_RAMMAP is defined in the configuration, then mmap() will
  *      support simulation of memory mapped files by copying files whole
@@ -168,7 +172,23 @@ FAR void *mmap(FAR void *start, size_t length, int prot, int flags,
 #endif
     }
 
+  addr = (FAR void *)(((FAR uint8_t *)addr) + offset);
+
+#ifdef CONFIG_FS_RAMMAP
+  /* The mapping refers to the file's own storage.  Keep the file open
+   * while it is mapped so that munmap() can release it.
+   */
+
+  ret = rammap_inplace(fd, addr, length, offset);
+  if (ret < 0)
+    {
+      ferr("ERROR: rammap_inplace() failed: %d\n", ret);
+      set_errno(-ret);
+      return MAP_FAILED;
+    }
+#endif
+
   /* Return the offset address */
 
-  return (FAR void *)(((FAR uint8_t *)addr) + offset);
+  return addr;
 }
@@ -48,6 +48,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
 #include "fs_rammap.h"
@@ -112,7 +113,9 @@ int munmap(FAR void *start, size_t length)
 {
   FAR struct fs_rammap_s *prev;
   FAR struct fs_rammap_s *curr;
+#ifdef CONFIG_DEBUG_ASSERTIONS
   FAR void *newaddr;
+#endif
   unsigned int offset;
   int ret;
   int errcode;
@@ -149,6 +152,38 @@ int munmap(FAR void *start, size_t length)
       goto errout_with_semaphore;
     }
 
+  /* Is this a mapping of file storage (vs. a copy of the file)? */
+
+  if (curr->inplace)
+    {
+      if ((uintptr_t)start > (uintptr_t)curr->addr)
+        {
+          /* Only the tail of the mapping is removed.  Nothing is freed. */
+
+          curr->length = (uintptr_t)start - (uintptr_t)curr->addr;
+        }
+      else
+        {
+          /* Remove the mapping from the list and release the file */
+
+          if (prev)
+            {
+              prev->flink = curr->flink;
+            }
+          else
+            {
+              g_rammaps.head = curr->flink;
+            }
+
+          (void)file_ioctl(&curr->file, FIOC_MUNMAP, 0);
+          (void)file_close_detached(&curr->file);
+          kmm_free(curr);
+        }
+
+      nxsem_post(&g_rammaps.exclsem);
+      return OK;
+    }
+
   /* Get the offset from the beginning of the region and the actual number
    * of bytes to "unmap".  All mappings must extend to the end of the region.
    * There is no support for free a block of memory but leaving a block of
@@ -196,8 +231,12 @@ int munmap(FAR void *start, size_t length)
 
   else
     {
+#ifdef CONFIG_DEBUG_ASSERTIONS
       newaddr = kumm_realloc(curr->addr, sizeof(struct fs_rammap_s) + length);
       DEBUGASSERT(newaddr == (FAR void *)(curr->addr));
+#else
+      (void)kumm_realloc(curr->addr, sizeof(struct fs_rammap_s) + length);
+#endif
       curr->length = length;
     }
 
@@ -42,6 +42,7 @@
 #include <sys/types.h>
 #include <sys/mman.h>
 
+#include <sys/ioctl.h>
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
@@ -235,4 +236,83 @@ errout:
   return MAP_FAILED;
 }
 
+/****************************************************************************
+ * Name: rammap_inplace
+ *
+ * Description:
+ *   Register a mapping of file storage obtained with FIOC_MMAP.  A
+ *   reference to the open file is kept so that the file persists while it
+ *   is mapped, even if the file descriptor is closed, and so that munmap()
+ *   can release the mapping with FIOC_MUNMAP.
+ *
+ * Parameters:
+ *   fd      file descriptor of the mapped file.
+ *   addr    The mapped address returned to the caller of mmap()
+ *   length  The length of the mapping.
+ *   offset  The offset into the file that was mapped
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  On failure,
+ *   the mapping is released with FIOC_MUNMAP.
+ *
+ ****************************************************************************/
+
+int rammap_inplace(int fd, FAR void *addr, size_t length, off_t offset)
+{
+  FAR struct fs_rammap_s *map;
+  FAR struct file *filep;
+  int ret;
+
+  map = (FAR struct fs_rammap_s *)kmm_zalloc(sizeof(struct fs_rammap_s));
+  if (map == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  map->addr    = addr;
+  map->length  = length;
+  map->offset  = offset;
+  map->inplace = true;
+
+  /* Take a reference to the open file */
+
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout_with_map;
+    }
+
+  ret = file_dup2(filep, &map->file);
+  if (ret < 0)
+    {
+      goto errout_with_map;
+    }
+
+  /* Add the mapping to the list of regions */
+
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      goto errout_with_file;
+    }
+
+  map->flink     = g_rammaps.head;
+  g_rammaps.head = map;
+
+  nxsem_post(&g_rammaps.exclsem);
+  return OK;
+
+errout_with_file:
+  (void)file_close_detached(&map->file);
+
+errout_with_map:
+  kmm_free(map);
+
+errout:
+  (void)ioctl(fd, FIOC_MUNMAP, 0);
+  return ret;
+}
+
 #endif /* CONFIG_FS_RAMMAP */
@@ -45,8 +45,11 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <semaphore.h>
 
+#include <nuttx/fs/fs.h>
+
 #ifdef CONFIG_FS_RAMMAP
 
 /****************************************************************************
@@ -76,6 +79,8 @@ struct fs_rammap_s
   FAR void           *addr;        /* Start of allocated memory */
   size_t              length;      /* Length of region */
   off_t               offset;      /* File offset */
+  bool                inplace;     /* True: File storage mapped via FIOC_MMAP */
+  struct file         file;        /* Open reference to an in-place mapped file */
 };
 
 /* This structure defines all "mapped" files */
@@ -142,5 +147,28 @@ void rammap_initialize(void);
 
 FAR void *rammap(int fd, size_t length, off_t offset);
 
+/****************************************************************************
+ * Name: rammap_inplace
+ *
+ * Description:
+ *   Register a mapping of file storage obtained with FIOC_MMAP.  A
+ *   reference to the open file is kept so that the file persists while it
+ *   is mapped, even if the file descriptor is closed, and so that munmap()
+ *   can release the mapping with FIOC_MUNMAP.
+ *
+ * Parameters:
+ *   fd      file descriptor of the mapped file.
+ *   addr    The mapped address returned to the caller of mmap()
+ *   length  The length of the mapping.
+ *   offset  The offset into the file that was mapped
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  On failure,
+ *   the mapping is released with FIOC_MUNMAP.
+ *
+ ****************************************************************************/
+
+int rammap_inplace(int fd, FAR void *addr, size_t length, off_t offset);
+
 #endif /* CONFIG_FS_RAMMAP */
 #endif /* __FS_MMAP_RAMMAP_H */
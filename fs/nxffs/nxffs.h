@@ -53,6 +53,10 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/nxffs.h>
 
+#ifdef CONFIG_NXFFS_PACK_INCREMENTAL
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -133,7 +137,10 @@
  *    open flag is not supported.
  * 6. The re-packing process occurs only during a write when the free FLASH
  *    memory at the end of the FLASH is exhausted.  Thus, occasionally, file
- *    writing may take a long time.
+ *    writing may take a long time.  With CONFIG_NXFFS_PACK_INCREMENTAL,
+ *    packing is also performed a few erase blocks at a time on the low-
+ *    priority work queue when free FLASH falls below a watermark, making
+ *    these long stalls much less likely.
  * 7. Another limitation is that there can be only a single NXFFS volume
  *    mounted at any time.  This has to do with the fact that we bind to
  *    an MTD driver (instead of a block driver) and bypass all of the normal
@@ -185,6 +192,22 @@
 
 #define NXFFS_NERASED             128
 
+/* Incremental packing configuration */
+
+#ifdef CONFIG_NXFFS_PACK_INCREMENTAL
+#  ifndef CONFIG_NXFFS_PACK_WATERMARK
+#    define CONFIG_NXFFS_PACK_WATERMARK  25
+#  endif
+
+#  ifndef CONFIG_NXFFS_PACK_STEPBLOCKS
+#    define CONFIG_NXFFS_PACK_STEPBLOCKS 1
+#  endif
+
+#  ifndef CONFIG_NXFFS_PACK_INTERVAL
+#    define CONFIG_NXFFS_PACK_INTERVAL   100
+#  endif
+#endif
+
 /* Quasi-standard definitions */
 
 #ifndef MIN
@@ -302,6 +325,10 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+  struct nxffs_packstats_s  packstats; /* Packing statistics */
+#ifdef CONFIG_NXFFS_PACK_INCREMENTAL
+  struct work_s             packwork;  /* Supports background packing */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -1082,6 +1109,57 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
 int nxffs_pack(FAR struct nxffs_volume_s *volume);
 
+/****************************************************************************
+ * Name: nxffs_packstep
+ *
+ * Description:
+ *   Perform one bounded step of the packing operation.  Packing proceeds
+ *   as with nxffs_pack() but is suspended at the first inode boundary after
+ *   'neraseblocks' erase blocks have been rewritten.  The FLASH is left in
+ *   a consistent state:  The unused region behind the packed inodes is
+ *   covered by a deleted "filler" inode so that a subsequent step (or a
+ *   full nxffs_pack()) will naturally resume packing at that position.
+ *
+ * Input Parameters:
+ *   volume       - The volume to be packed.
+ *   neraseblocks - The (soft) limit on the number of erase blocks to be
+ *     rewritten.  Zero means no limit.
+ *
+ * Returned Value:
+ *   Zero is returned if packing ran to completion (or if there was nothing
+ *   to pack).  A positive value is returned if packing was suspended and
+ *   more remains to be done.  Otherwise, a negated errno value is returned
+ *   to indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_packstep(FAR struct nxffs_volume_s *volume, off_t neraseblocks);
+
+/****************************************************************************
+ * Name: nxffs_packtrigger
+ *
+ * Description:
+ *   Check the amount of free FLASH at the end of the volume and, if it has
+ *   fallen below CONFIG_NXFFS_PACK_WATERMARK percent, schedule incremental
+ *   packing on the low-priority work queue.
+ *
+ * Input Parameters:
+ *   volume - The volume to be checked.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the volume exclsem.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACK_INCREMENTAL
+void nxffs_packtrigger(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_packtrigger(v)
+#endif
+
 /****************************************************************************
  * Standard mountpoint operation methods
  *
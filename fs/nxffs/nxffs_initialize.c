@@ -276,6 +276,11 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   ret = nxffs_limits(volume);
   if (ret == OK)
     {
+      /* Begin reclaiming deleted FLASH in the background if the volume is
+       * already running low on free FLASH.
+       */
+
+      nxffs_packtrigger(volume);
       return OK;
     }
 
@@ -565,6 +570,17 @@ int nxffs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return -ENOSYS;
     }
 
-  return g_volume.ofiles ? -EBUSY : OK;
+  if (g_volume.ofiles)
+    {
+      return -EBUSY;
+    }
+
+#ifdef CONFIG_NXFFS_PACK_INCREMENTAL
+  /* Stop any background packing activity */
+
+  (void)work_cancel(LPWORK, &g_volume.packwork);
+#endif
+
+  return OK;
 #endif
 }
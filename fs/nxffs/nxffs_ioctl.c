@@ -92,7 +92,7 @@ int nxffs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       goto errout;
     }
 
-  /* Only a reformat and optimize commands are supported */
+  /* Only reformat, optimize, and pack statistics commands are supported */
 
   if (cmd == FIOC_REFORMAT)
     {
@@ -120,6 +120,27 @@ int nxffs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       ret = nxffs_pack(volume);
     }
+
+  else if (cmd == FIOC_PACKSTATS)
+    {
+      FAR struct nxffs_packstats_s *stats =
+        (FAR struct nxffs_packstats_s *)((uintptr_t)arg);
+
+      finfo("Pack statistics command\n");
+
+      if (stats == NULL)
+        {
+          ret = -EINVAL;
+          goto errout_with_semaphore;
+        }
+
+      /* Return a snapshot of the packing statistics */
+
+      memcpy(stats, &volume->packstats, sizeof(struct nxffs_packstats_s));
+      stats->froffset = volume->froffset;
+      stats->volsize  = volume->nblocks * volume->geo.blocksize;
+      ret = OK;
+    }
   else
     {
       /* No other commands supported */
@@ -1167,6 +1167,12 @@ int nxffs_close(FAR struct file *filep)
       if ((ofile->oflags & O_WROK) != 0)
         {
           ret = nxffs_wrclose(volume, (FAR struct nxffs_wrfile_s *)ofile);
+
+          /* The writer is gone.  Now is a good time to reclaim deleted
+           * FLASH in the background if free space is running low.
+           */
+
+          nxffs_packtrigger(volume);
         }
 
       /* Release all resouces held by the open file */
@@ -1269,10 +1275,12 @@ int nxffs_wrinode(FAR struct nxffs_volume_s *volume,
            volume->ioblock, -ret);
     }
 
-  /* The volume is now available for other writers */
+  /* NOTE: The single writer semaphore (wrsem) is not released here.  That
+   * is the responsibility of nxffs_wrclose().  This function is also used
+   * by the packing logic which may not hold wrsem at all.
+   */
 
 errout:
-  nxsem_post(&volume->wrsem);
   return ret;
 }
 
@@ -48,6 +48,8 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
 
 #include "nxffs.h"
 
@@ -86,6 +88,12 @@ struct nxffs_pack_s
   off_t                ioblock;    /* I/O block number */
   off_t                block0;     /* First I/O block number in the erase block */
   uint16_t             iooffset;   /* I/O block offset */
+
+  /* These support incremental packing */
+
+  off_t                limit;      /* Erase block budget (zero: no limit) */
+  off_t                nerased;    /* Number of erase blocks rewritten */
+  off_t                ninodes;    /* Number of inodes moved */
 };
 
 /****************************************************************************
@@ -861,6 +869,124 @@ static int nxffs_endsrcblock(FAR struct nxffs_volume_s *volume,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nxffs_packsuspend
+ *
+ * Description:
+ *   Try to suspend an incremental packing operation.  This is called at an
+ *   inode boundary:  All inodes before the source inode have been packed
+ *   and the source inode has not yet been touched.
+ *
+ *   Packing can only be suspended here if the source inode lies beyond the
+ *   erase block that is being packed now (otherwise, stale copies of inodes
+ *   that were already moved would remain visible) and if a deleted inode
+ *   header can be placed at the current destination position.  That deleted
+ *   "filler" inode spans the unused FLASH up to the source inode so that
+ *   FLASH scans skip over the gap.  The gap itself will be found by
+ *   nxffs_startpos() when packing is resumed.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed
+ *   pack   - The volume packing state structure.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the filler inode was added to the pack buffer
+ *   and packing may be suspended.  -ENOSPC is returned if packing cannot
+ *   be suspended at this position.
+ *
+ ****************************************************************************/
+
+static int nxffs_packsuspend(FAR struct nxffs_volume_s *volume,
+                             FAR struct nxffs_pack_s *pack)
+{
+  FAR struct nxffs_inode_s *inode;
+  off_t nexterase;
+  off_t remaining;
+  off_t hoffset;
+  off_t doffset;
+  off_t target;
+  off_t gap;
+  off_t datlen;
+  uint16_t maxsize;
+  uint32_t crc;
+
+  /* Always move at least one inode in each step so that progress is
+   * guaranteed.
+   */
+
+  if (pack->ninodes < 1)
+    {
+      return -ENOSPC;
+    }
+
+  /* The source inode must lie beyond the current erase block */
+
+  target    = pack->src.entry.hoffset;
+  nexterase = (pack->block0 + volume->blkper) * volume->geo.blocksize;
+  remaining = nexterase - nxffs_packtell(volume, pack);
+
+  if (target < nexterase)
+    {
+      return -ENOSPC;
+    }
+
+  /* Don't suspend if the (approximate) size of the next inode would still
+   * fit into the current erase block.  It costs nothing to pack it now.
+   */
+
+  if (nxffs_inodeend(volume, &pack->src.entry) - target < remaining)
+    {
+      return -ENOSPC;
+    }
+
+  /* There must be space for the filler inode header in this I/O block */
+
+  if (pack->iooffset + SIZEOF_NXFFS_INODE_HDR > volume->geo.blocksize)
+    {
+      return -ENOSPC;
+    }
+
+  /* The filler inode has no name.  Its data length is selected so that
+   * nxffs_inodeend() will return an offset just before the source inode
+   * header.
+   */
+
+  hoffset = nxffs_packtell(volume, pack);
+  doffset = hoffset + SIZEOF_NXFFS_INODE_HDR;
+  maxsize = volume->geo.blocksize - SIZEOF_NXFFS_BLOCK_HDR -
+            SIZEOF_NXFFS_DATA_HDR;
+  gap     = target - doffset;
+  datlen  = gap - ((gap + maxsize - 1) / maxsize) * SIZEOF_NXFFS_DATA_HDR;
+
+  if (datlen <= 0)
+    {
+      return -ENOSPC;
+    }
+
+  inode = (FAR struct nxffs_inode_s *)&pack->iobuffer[pack->iooffset];
+  memcpy(inode->magic, g_inodemagic, NXFFS_MAGICSIZE);
+
+  inode->state  = CONFIG_NXFFS_ERASEDSTATE;
+  inode->namlen = 0;
+
+  nxffs_wrle32(inode->noffs,  doffset);
+  nxffs_wrle32(inode->doffs,  doffset);
+  nxffs_wrle32(inode->utc,    0);
+  nxffs_wrle32(inode->crc,    0);
+  nxffs_wrle32(inode->datlen, datlen);
+
+  crc = crc32((FAR const uint8_t *)inode, SIZEOF_NXFFS_INODE_HDR);
+
+  inode->state = INODE_STATE_DELETED;
+  nxffs_wrle32(inode->crc, crc);
+
+  pack->iooffset += SIZEOF_NXFFS_INODE_HDR;
+  volume->packstats.packpos = hoffset;
+
+  finfo("Suspended at %d, next inode at %d\n", hoffset, target);
+  return OK;
+}
+
 /****************************************************************************
  * Name: nxffs_packblock
  *
@@ -950,6 +1076,7 @@ static inline int nxffs_packblock(FAR struct nxffs_volume_s *volume,
 
           nxffs_wrdathdr(volume, pack);
           nxffs_wrinodehdr(volume, pack);
+          pack->ninodes++;
 
           /* Find the next valid source inode */
 
@@ -966,6 +1093,18 @@ static inline int nxffs_packblock(FAR struct nxffs_volume_s *volume,
               return -ENOSPC;
             }
 
+          /* If this is an incremental packing step and the erase block
+           * budget has been spent, then try to suspend packing at this
+           * inode boundary.  -EAGAIN is a special return value that means
+           * that packing has been suspended.
+           */
+
+          if (pack->limit > 0 && pack->nerased + 1 >= pack->limit &&
+              nxffs_packsuspend(volume, pack) == OK)
+            {
+              return -EAGAIN;
+            }
+
           /* Setup the new source stream */
 
           ret = nxffs_srcsetup(volume, pack, pack->src.entry.doffset);
@@ -1243,41 +1382,114 @@ static inline int nxffs_packwriter(FAR struct nxffs_volume_s *volume,
   return -ENOSYS;
 }
 
+/****************************************************************************
+ * Name: nxffs_packworker
+ *
+ * Description:
+ *   Perform one incremental packing step on the low-priority work queue.
+ *   If more remains to be done, the next step is re-scheduled after a
+ *   delay so that other users of the volume (and of the work queue) can
+ *   make progress.
+ *
+ * Input Parameters:
+ *   arg - The NXFFS volume (cast to void *)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACK_INCREMENTAL
+static void nxffs_packworker(FAR void *arg)
+{
+  FAR struct nxffs_volume_s *volume = (FAR struct nxffs_volume_s *)arg;
+  int ret;
+
+  ret = nxsem_wait(&volume->exclsem);
+  if (ret < 0)
+    {
+      ferr("ERROR: nxsem_wait failed: %d\n", ret);
+      return;
+    }
+
+  /* Don't pack underneath an active writer.  The writer may have partially
+   * written data in the volume cache.  Packing will be triggered again
+   * when the writer closes the file.
+   */
+
+  if (nxffs_findwriter(volume) != NULL)
+    {
+      nxsem_post(&volume->exclsem);
+      return;
+    }
+
+  ret = nxffs_packstep(volume, CONFIG_NXFFS_PACK_STEPBLOCKS);
+  nxsem_post(&volume->exclsem);
+
+  if (ret < 0)
+    {
+      ferr("ERROR: Background packing failed: %d\n", ret);
+    }
+  else if (ret > 0)
+    {
+      /* More remains to be done */
+
+      (void)work_queue(LPWORK, &volume->packwork, nxffs_packworker, volume,
+                       MSEC2TICK(CONFIG_NXFFS_PACK_INTERVAL));
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nxffs_pack
+ * Name: nxffs_packstep
  *
  * Description:
- *   Pack and re-write the filesystem in order to free up memory at the end
- *   of FLASH.
+ *   Perform one bounded step of the packing operation.  Packing proceeds
+ *   as with nxffs_pack() but is suspended at the first inode boundary after
+ *   'neraseblocks' erase blocks have been rewritten.
  *
  * Input Parameters:
- *   volume - The volume to be packed.
+ *   volume       - The volume to be packed.
+ *   neraseblocks - The (soft) limit on the number of erase blocks to be
+ *     rewritten.  Zero means no limit.
  *
  * Returned Value:
- *   Zero on success; Otherwise, a negated errno value is returned to
- *   indicate the nature of the failure.
+ *   Zero is returned if packing ran to completion (or if there was nothing
+ *   to pack).  A positive value is returned if packing was suspended and
+ *   more remains to be done.  Otherwise, a negated errno value is returned
+ *   to indicate the nature of the failure.
  *
  ****************************************************************************/
 
-int nxffs_pack(FAR struct nxffs_volume_s *volume)
+int nxffs_packstep(FAR struct nxffs_volume_s *volume, off_t neraseblocks)
 {
   struct nxffs_pack_s pack;
   FAR struct nxffs_wrfile_s *wrfile;
+  off_t froffset;
   off_t iooffset;
   off_t eblock;
   off_t block;
+  bool suspended;
   bool packed;
   int i;
   int ret = OK;
 
   /* Get the offset to the first valid inode entry */
 
-  wrfile = NULL;
-  packed = false;
+  wrfile    = NULL;
+  packed    = false;
+  suspended = false;
+  froffset  = volume->froffset;
+
+  volume->packstats.packpos = 0;
+  if (neraseblocks > 0)
+    {
+      volume->packstats.nsteps++;
+    }
 
   iooffset = nxffs_mediacheck(volume, &pack);
   if (iooffset == 0)
@@ -1339,7 +1551,13 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
    */
 
   ret = nxffs_startpos(volume, &pack, &iooffset);
-  if (ret < 0)
+  if (ret == OK)
+    {
+      /* Only the normal inode packing operation may be suspended */
+
+      pack.limit = neraseblocks;
+    }
+  else
     {
       /* This is a normal situation if the volume is full */
 
@@ -1510,6 +1728,18 @@ start_pack:
 
                               wrfile = nxffs_setupwriter(volume, &pack);
                             }
+
+                          /* The error -EAGAIN is another special value that
+                           * means that the incremental packing step has been
+                           * suspended.  Nothing further will be packed but
+                           * the current erase block must still be written.
+                           */
+
+                          else if (ret == -EAGAIN)
+                            {
+                              packed    = true;
+                              suspended = true;
+                            }
                           else
                             {
                               /* Otherwise, something really bad happened */
@@ -1594,6 +1824,46 @@ start_pack:
                eblock, pack.block0, -ret);
           goto errout_with_pack;
         }
+
+      pack.nerased++;
+      volume->packstats.nerased++;
+
+      /* Stop here if the packing step was suspended */
+
+      if (suspended)
+        {
+          break;
+        }
+    }
+
+  /* Blocks in the volume cache may have been re-written */
+
+  volume->cblock = (off_t)-1;
+
+  if (suspended)
+    {
+      /* Nothing has been moved at the end of FLASH yet; the free FLASH
+       * region is unchanged.
+       */
+
+      volume->froffset = froffset;
+      ret = 1;
+    }
+  else
+    {
+      /* Packing is complete.  Account for the erase blocks reclaimed at the
+       * end of FLASH.
+       */
+
+      if (froffset > volume->froffset)
+        {
+          volume->packstats.nreclaimed +=
+            froffset / volume->geo.erasesize -
+            volume->froffset / volume->geo.erasesize;
+        }
+
+      volume->packstats.npacks++;
+      ret = OK;
     }
 
 errout_with_pack:
@@ -1601,3 +1871,63 @@ errout_with_pack:
   nxffs_freeentry(&pack.dest.entry);
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxffs_pack
+ *
+ * Description:
+ *   Pack and re-write the filesystem in order to free up memory at the end
+ *   of FLASH.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_pack(FAR struct nxffs_volume_s *volume)
+{
+  int ret = nxffs_packstep(volume, 0);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_packtrigger
+ *
+ * Description:
+ *   Check the amount of free FLASH at the end of the volume and, if it has
+ *   fallen below CONFIG_NXFFS_PACK_WATERMARK percent, schedule incremental
+ *   packing on the low-priority work queue.
+ *
+ * Input Parameters:
+ *   volume - The volume to be checked.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the volume exclsem.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACK_INCREMENTAL
+void nxffs_packtrigger(FAR struct nxffs_volume_s *volume)
+{
+  off_t volsize = volume->nblocks * volume->geo.blocksize;
+  off_t nfree   = volsize - volume->froffset;
+
+  /* Divide first:  nfree * 100 would overflow a 32-bit off_t on volumes
+   * larger than about 20MB.
+   */
+
+  if (nfree < (volsize / 100) * CONFIG_NXFFS_PACK_WATERMARK &&
+      work_available(&volume->packwork))
+    {
+      finfo("Free FLASH %d/%d: Start background packing\n", nfree, volsize);
+      (void)work_queue(LPWORK, &volume->packwork, nxffs_packworker, volume, 0);
+    }
+}
+#endif
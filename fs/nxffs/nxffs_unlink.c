@@ -167,6 +167,12 @@ int nxffs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Then remove the NXFFS inode */
 
   ret = nxffs_rminode(volume, relpath);
+  if (ret >= 0)
+    {
+      /* The deleted inode may now be reclaimed in the background */
+
+      nxffs_packtrigger(volume);
+    }
 
   nxsem_post(&volume->exclsem);
 
@@ -423,7 +423,9 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
        */
 
       nsectors = SEC_NSECTORS(rm, buflen);
-      if (nsectors > 0 && sectorndx == 0)
+      if (nsectors > 0 && sectorndx == 0 &&
+          (sector < rf->rf_cachesector ||
+           sector >= rf->rf_cachesector + rf->rf_ncached))
         {
           /* Read maximum contiguous sectors directly to the user's
            * buffer without using our tiny read buffer.
@@ -474,7 +476,10 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
             }
 
           finfo("Return %d bytes from sector offset %d\n", bytesread, sectorndx);
-          memcpy(userbuffer, &rf->rf_buffer[sectorndx], bytesread);
+          memcpy(userbuffer,
+                 &rf->rf_buffer[(sector - rf->rf_cachesector) *
+                                rm->rm_hwsectorsize + sectorndx],
+                 bytesread);
         }
 
       /* Set up for the next sector read */
@@ -1017,6 +1022,18 @@ static int romfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       goto errout_with_buffer;
     }
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  /* Build the directory index.  The volume is still usable without it;
+   * lookups just fall back to walking the directories on the media.
+   */
+
+  ret = romfs_buildindex(rm);
+  if (ret < 0)
+    {
+      fwarn("WARNING: romfs_buildindex failed: %d\n", ret);
+    }
+#endif
+
   /* Mounted! */
 
   *handle = (FAR void *)rm;
@@ -1026,7 +1043,7 @@ static int romfs_bind(FAR struct inode *blkdriver, FAR const void *data,
 errout_with_buffer:
   if (!rm->rm_xipbase)
     {
-      kmm_free(rm->rm_buffer);
+      kmm_free(rm->rm_cache);
     }
 
 errout_with_sem:
@@ -1102,11 +1119,18 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
       /* Release the mountpoint private data */
 
-      if (!rm->rm_xipbase && rm->rm_buffer)
+      if (!rm->rm_xipbase && rm->rm_cache)
         {
-          kmm_free(rm->rm_buffer);
+          kmm_free(rm->rm_cache);
         }
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+      if (rm->rm_index)
+        {
+          kmm_free(rm->rm_index);
+        }
+#endif
+
       nxsem_destroy(&rm->rm_sem);
       kmm_free(rm);
       return OK;
@@ -125,10 +125,36 @@
 
 #define ROMF_MAX_LINKS 64
 
+/* Number of sectors in the mountpoint sector cache and in each file sector
+ * buffer (non-XIP media only).
+ */
+
+#ifndef CONFIG_FS_ROMFS_CACHE_NSECTORS
+#  define CONFIG_FS_ROMFS_CACHE_NSECTORS 1
+#endif
+
+#ifndef CONFIG_FS_ROMFS_FILE_NSECTORS
+#  define CONFIG_FS_ROMFS_FILE_NSECTORS 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+/* One entry in the in-memory directory index.  The index is sorted by
+ * parent directory and name hash.
+ */
+
+struct romfs_dirindex_s
+{
+  uint32_t ri_parent;               /* Offset to the first entry in the
+                                     * directory */
+  uint32_t ri_hash;                 /* Hash of the entry name */
+  uint32_t ri_offset;               /* Offset to the entry header */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -148,7 +174,20 @@ struct romfs_mountpt_s
   uint32_t rm_volsize;              /* Size of the ROMFS volume */
   uint32_t rm_cachesector;          /* Current sector in the rm_buffer */
   uint8_t *rm_xipbase;              /* Base address of directly accessible media */
-  uint8_t *rm_buffer;               /* Device sector buffer, allocated if rm_xipbase==0 */
+  uint8_t *rm_buffer;               /* Current device sector (in rm_cache
+                                     * if rm_xipbase==0) */
+  uint8_t *rm_cache;                /* Device sector cache, allocated if
+                                     * rm_xipbase==0 */
+  uint32_t rm_cacheclock;           /* Incremented on each cache access */
+
+  /* Sector in each cache slot and last access to each slot */
+
+  uint32_t rm_cachesectors[CONFIG_FS_ROMFS_CACHE_NSECTORS];
+  uint32_t rm_cacheused[CONFIG_FS_ROMFS_CACHE_NSECTORS];
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  FAR struct romfs_dirindex_s *rm_index; /* Directory index (NULL if none) */
+  uint32_t rm_nindex;               /* Number of entries in rm_index */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -161,8 +200,9 @@ struct romfs_file_s
   FAR struct romfs_file_s *rf_next; /* Retained in a singly linked list */
   uint32_t rf_startoffset;          /* Offset to the start of the file data */
   uint32_t rf_size;                 /* Size of the file in bytes */
-  uint32_t rf_cachesector;          /* Current sector in the rf_buffer */
+  uint32_t rf_cachesector;          /* First sector in the rf_buffer */
   uint8_t *rf_buffer;               /* File sector buffer, allocated if rm_xipbase==0 */
+  uint16_t rf_ncached;              /* Number of sectors in rf_buffer */
   uint8_t rf_type;                  /* File type (for fstat()) */
 };
 
@@ -223,6 +263,9 @@ int  romfs_parsefilename(FAR struct romfs_mountpt_s *rm, uint32_t offset,
        FAR char *pname);
 int  romfs_datastart(FAR struct romfs_mountpt_s *rm, uint32_t offset,
        FAR uint32_t *start);
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+int  romfs_buildindex(FAR struct romfs_mountpt_s *rm);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -190,6 +190,8 @@ static inline int romfs_checkentry(struct romfs_mountpt_s *rm,
 int16_t romfs_devcacheread(struct romfs_mountpt_s *rm, uint32_t offset)
 {
   uint32_t sector;
+  int      slot;
+  int      i;
   int      ret;
 
   /* rm->rm_cachesector holds the current sector that is buffer in or referenced
@@ -212,13 +214,42 @@ int16_t romfs_devcacheread(struct romfs_mountpt_s *rm, uint32_t offset)
         }
       else
         {
-          /* In non-XIP mode, we will have to read the new sector. */
+          /* In non-XIP mode, look for the sector in the sector cache.  If
+           * it is not there, replace the least recently used sector.
+           */
 
-          ret = romfs_hwread(rm, rm->rm_buffer, sector, 1);
-          if (ret < 0)
+          for (i = 0, slot = 0; i < CONFIG_FS_ROMFS_CACHE_NSECTORS; i++)
             {
-               return (int16_t)ret;
+              if (rm->rm_cachesectors[i] == sector)
+                {
+                  slot = i;
+                  break;
+                }
+
+              if (rm->rm_cacheused[i] < rm->rm_cacheused[slot])
+                {
+                  slot = i;
+                }
             }
+
+          rm->rm_buffer = rm->rm_cache + slot * rm->rm_hwsectorsize;
+          if (i >= CONFIG_FS_ROMFS_CACHE_NSECTORS)
+            {
+              /* Not cached.. we will have to read the new sector. */
+
+              rm->rm_cachesectors[slot] = (uint32_t)-1;
+              rm->rm_cachesector        = (uint32_t)-1;
+
+              ret = romfs_hwread(rm, rm->rm_buffer, sector, 1);
+              if (ret < 0)
+                {
+                   return (int16_t)ret;
+                }
+
+              rm->rm_cachesectors[slot] = sector;
+            }
+
+          rm->rm_cacheused[slot] = ++rm->rm_cacheclock;
         }
 
       /* Update the cached sector number */
@@ -277,6 +308,187 @@ static int romfs_followhardlinks(struct romfs_mountpt_s *rm, uint32_t offset,
   return -ELOOP;
 }
 
+/****************************************************************************
+ * Name: romfs_hashname
+ *
+ * Description:
+ *   Return the 32-bit FNV-1a hash of a name that is not necessarily
+ *   terminated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+static uint32_t romfs_hashname(FAR const char *name, int namelen)
+{
+  uint32_t hash = 2166136261u;
+
+  while (namelen-- > 0)
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: romfs_cmpindex
+ *
+ * Description:
+ *   qsort() comparison of two directory index entries
+ *
+ ****************************************************************************/
+
+static int romfs_cmpindex(FAR const void *a, FAR const void *b)
+{
+  FAR const struct romfs_dirindex_s *ria = a;
+  FAR const struct romfs_dirindex_s *rib = b;
+
+  if (ria->ri_parent != rib->ri_parent)
+    {
+      return ria->ri_parent < rib->ri_parent ? -1 : 1;
+    }
+
+  if (ria->ri_hash != rib->ri_hash)
+    {
+      return ria->ri_hash < rib->ri_hash ? -1 : 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: romfs_indexdir
+ *
+ * Description:
+ *   Add all of the entries of the directory beginning at offset 'dir' to
+ *   the directory index.
+ *
+ ****************************************************************************/
+
+static int romfs_indexdir(FAR struct romfs_mountpt_s *rm, uint32_t dir,
+                          FAR uint32_t *maxindex)
+{
+  FAR struct romfs_dirindex_s *newindex;
+  FAR struct romfs_dirindex_s *ri;
+  char name[NAME_MAX+1];
+  uint32_t offset;
+  uint32_t next;
+  int16_t  ndx;
+  int      ret;
+
+  offset = dir;
+  do
+    {
+      ndx = romfs_devcacheread(rm, offset);
+      if (ndx < 0)
+        {
+          return ndx;
+        }
+
+      next = romfs_devread32(rm, ndx + ROMFS_FHDR_NEXT) & RFNEXT_OFFSETMASK;
+
+      ret = romfs_parsefilename(rm, offset, name);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* There can be no more entries than 16-byte headers in the volume.
+       * Anything else means that the volume is corrupted.
+       */
+
+      if (rm->rm_nindex >= rm->rm_volsize / ROMFS_ALIGNMENT)
+        {
+          return -EINVAL;
+        }
+
+      /* Grow the index as necessary */
+
+      if (rm->rm_nindex >= *maxindex)
+        {
+          *maxindex = *maxindex > 0 ? 2 * *maxindex : 16;
+          newindex  = (FAR struct romfs_dirindex_s *)
+            kmm_realloc(rm->rm_index,
+                        *maxindex * sizeof(struct romfs_dirindex_s));
+          if (newindex == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          rm->rm_index = newindex;
+        }
+
+      ri            = &rm->rm_index[rm->rm_nindex++];
+      ri->ri_parent = dir;
+      ri->ri_hash   = romfs_hashname(name, strlen(name));
+      ri->ri_offset = offset;
+
+      offset = next;
+    }
+  while (next != 0);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: romfs_searchindex
+ *
+ * Description:
+ *   This is the romfs_searchdir() logic using the directory index.  Only
+ *   the entries whose name hash matches are examined on the media.
+ *
+ ****************************************************************************/
+
+static int romfs_searchindex(FAR struct romfs_mountpt_s *rm,
+                             FAR const char *entryname, int entrylen,
+                             FAR struct romfs_dirinfo_s *dirinfo)
+{
+  FAR struct romfs_dirindex_s *ri;
+  struct romfs_dirindex_s key;
+  uint32_t lo;
+  uint32_t hi;
+  uint32_t mid;
+  int ret;
+
+  key.ri_parent = dirinfo->rd_dir.fr_firstoffset;
+  key.ri_hash   = romfs_hashname(entryname, entrylen);
+
+  /* Find the first index entry for this directory and hash */
+
+  lo = 0;
+  hi = rm->rm_nindex;
+  while (lo < hi)
+    {
+      mid = (lo + hi) >> 1;
+      if (romfs_cmpindex(&rm->rm_index[mid], &key) < 0)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  /* Then check each candidate against the name on the media */
+
+  for (ri = &rm->rm_index[lo];
+       lo < rm->rm_nindex && romfs_cmpindex(ri, &key) == 0;
+       lo++, ri++)
+    {
+      ret = romfs_checkentry(rm, ri->ri_offset, entryname, entrylen,
+                             dirinfo);
+      if (ret != -ENOENT)
+        {
+          return ret;
+        }
+    }
+
+  return -ENOENT;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_searchdir
  *
@@ -295,6 +507,15 @@ static inline int romfs_searchdir(struct romfs_mountpt_s *rm,
   int16_t  ndx;
   int      ret;
 
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+  /* Use the directory index if one was built when the volume was mounted */
+
+  if (rm->rm_index != NULL)
+    {
+      return romfs_searchindex(rm, entryname, entrylen, dirinfo);
+    }
+#endif
+
   /* Then loop through the current directory until the directory
    * with the matching name is found.  Or until all of the entries
    * the directory have been examined.
@@ -440,6 +661,8 @@ int romfs_hwread(struct romfs_mountpt_s *rm, uint8_t *buffer, uint32_t sector,
 int romfs_filecacheread(struct romfs_mountpt_s *rm, struct romfs_file_s *rf,
                         uint32_t sector)
 {
+  uint32_t lastsector;
+  unsigned int nsectors;
   int ret;
 
   finfo("sector: %d cached: %d sectorsize: %d XIP base: %p buffer: %p\n",
@@ -451,10 +674,12 @@ int romfs_filecacheread(struct romfs_mountpt_s *rm, struct romfs_file_s *rf,
    * then we do nothing.
    */
 
-  if (rf->rf_cachesector != sector)
+  if (sector < rf->rf_cachesector ||
+      sector >= rf->rf_cachesector + rf->rf_ncached)
     {
       /* Check the access mode */
 
+      nsectors = 1;
       if (rm->rm_xipbase)
         {
           /* In XIP mode, rf_buffer is just an offset pointer into the device
@@ -466,10 +691,26 @@ int romfs_filecacheread(struct romfs_mountpt_s *rm, struct romfs_file_s *rf,
         }
       else
         {
-          /* In non-XIP mode, we will have to read the new sector. */
+          /* In non-XIP mode, we will have to read the new sector.  Read
+           * ahead as many following sectors of the file as the buffer
+           * holds.
+           */
+
+          lastsector = SEC_NSECTORS(rm, rf->rf_startoffset + rf->rf_size - 1);
+          if (lastsector >= rm->rm_hwnsectors)
+            {
+              lastsector = rm->rm_hwnsectors - 1;
+            }
+
+          nsectors = CONFIG_FS_ROMFS_FILE_NSECTORS;
+          if (sector + nsectors > lastsector + 1)
+            {
+              nsectors = sector <= lastsector ? lastsector + 1 - sector : 1;
+            }
 
           finfo("Calling romfs_hwread\n");
-          ret = romfs_hwread(rm, rf->rf_buffer, sector, 1);
+          rf->rf_ncached = 0;
+          ret = romfs_hwread(rm, rf->rf_buffer, sector, nsectors);
           if (ret < 0)
             {
               ferr("ERROR: romfs_hwread failed: %d\n", ret);
@@ -480,6 +721,7 @@ int romfs_filecacheread(struct romfs_mountpt_s *rm, struct romfs_file_s *rf,
       /* Update the cached sector number */
 
       rf->rf_cachesector = sector;
+      rf->rf_ncached     = nsectors;
     }
 
   return OK;
@@ -547,14 +789,17 @@ int romfs_hwconfigure(struct romfs_mountpt_s *rm)
         }
     }
 
-  /* Allocate the device cache buffer for normal sector accesses */
+  /* Allocate the device sector cache for normal sector accesses */
 
-  rm->rm_buffer = (FAR uint8_t *)kmm_malloc(rm->rm_hwsectorsize);
-  if (!rm->rm_buffer)
+  rm->rm_cache = (FAR uint8_t *)
+    kmm_malloc(CONFIG_FS_ROMFS_CACHE_NSECTORS * rm->rm_hwsectorsize);
+  if (!rm->rm_cache)
     {
       return -ENOMEM;
     }
 
+  memset(rm->rm_cachesectors, 0xff, sizeof(rm->rm_cachesectors));
+  rm->rm_buffer = rm->rm_cache;
   return OK;
 }
 
@@ -627,6 +872,7 @@ int romfs_fileconfigure(struct romfs_mountpt_s *rm, struct romfs_file_s *rf)
       /* We'll put a valid address in rf_buffer just in case. */
 
       rf->rf_cachesector = 0;
+      rf->rf_ncached     = 1;
       rf->rf_buffer      = rm->rm_xipbase;
     }
   else
@@ -634,10 +880,14 @@ int romfs_fileconfigure(struct romfs_mountpt_s *rm, struct romfs_file_s *rf)
       /* Nothing in the cache buffer */
 
       rf->rf_cachesector = (uint32_t)-1;
+      rf->rf_ncached     = 0;
 
-      /* Create a file buffer to support partial sector accesses */
+      /* Create a file buffer to support partial sector accesses and
+       * read-ahead.
+       */
 
-      rf->rf_buffer = (FAR uint8_t *)kmm_malloc(rm->rm_hwsectorsize);
+      rf->rf_buffer = (FAR uint8_t *)
+        kmm_malloc(CONFIG_FS_ROMFS_FILE_NSECTORS * rm->rm_hwsectorsize);
       if (!rf->rf_buffer)
         {
           return -ENOMEM;
@@ -968,3 +1218,70 @@ int romfs_datastart(struct romfs_mountpt_s *rm, uint32_t offset,
 
   return -EINVAL; /* Won't get here */
 }
+
+/****************************************************************************
+ * Name: romfs_buildindex
+ *
+ * Description:
+ *   Build the in-memory directory index.  This is called when the volume
+ *   is mounted.  All directories are visited breadth first; the index
+ *   itself serves as the list of directories still to be visited.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_ROMFS_DIRINDEX
+int romfs_buildindex(FAR struct romfs_mountpt_s *rm)
+{
+  uint32_t maxindex = 0;
+  uint32_t linkoffset;
+  uint32_t next;
+  uint32_t info;
+  uint32_t size;
+  uint32_t i;
+  int ret;
+
+  rm->rm_index  = NULL;
+  rm->rm_nindex = 0;
+
+  ret = romfs_indexdir(rm, rm->rm_rootoffset, &maxindex);
+  for (i = 0; ret >= 0 && i < rm->rm_nindex; i++)
+    {
+      ret = romfs_parsedirentry(rm, rm->rm_index[i].ri_offset, &linkoffset,
+                                &next, &info, &size);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      /* Descend into real directories only.  Hard links (such as "." and
+       * "..") refer to directories that are indexed elsewhere.
+       */
+
+      if (IS_DIRECTORY(next) && linkoffset == rm->rm_index[i].ri_offset &&
+          info != 0)
+        {
+          ret = romfs_indexdir(rm, info, &maxindex);
+        }
+    }
+
+  if (ret < 0)
+    {
+      if (rm->rm_index != NULL)
+        {
+          kmm_free(rm->rm_index);
+        }
+
+      rm->rm_index  = NULL;
+      rm->rm_nindex = 0;
+      return ret;
+    }
+
+  /* Sort the index by directory and name hash for binary searching */
+
+  qsort(rm->rm_index, rm->rm_nindex, sizeof(struct romfs_dirindex_s),
+        romfs_cmpindex);
+
+  finfo("Indexed %lu directory entries\n", (unsigned long)rm->rm_nindex);
+  return OK;
+}
+#endif
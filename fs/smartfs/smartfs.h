@@ -49,6 +49,7 @@
 
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/smart.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -188,6 +189,20 @@
 #define FS_BOPS(f)        (f)->fs_blkdriver->u.i_bops
 #define FS_IOCTL(f,c,a)   (FS_BOPS(f)->ioctl ? FS_BOPS(f)->ioctl((f)->fs_blkdriver,c,a) : (-ENOSYS))
 
+/* Write amplification accounting.  Every sector write request passed to the
+ * MTD layer goes through FS_WRITESECT so that it can be counted.
+ */
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+#  define SMARTFS_WRSTAT(f,m,n) ((f)->fs_wrstats.m += (n))
+#else
+#  define SMARTFS_WRSTAT(f,m,n) ((void)0)
+#endif
+
+#define FS_WRITESECT(f,rw) \
+  (SMARTFS_WRSTAT(f, nwrites, 1), SMARTFS_WRSTAT(f, nflashbytes, (rw)->count), \
+   FS_IOCTL(f, BIOC_WRITESECT, (unsigned long)(rw)))
+
 /* The logical sector number of the root directory. */
 
 #define SMARTFS_ROOT_DIR_SECTOR   3
@@ -222,8 +237,26 @@
 #define SMARTFS_NEXTSECTOR(h)    (*((uint16_t *)h->nextsector))
 #define SMARTFS_USED(h)          (*((uint16_t *)h->used))
 
-#ifdef CONFIG_MTD_SMART_ENABLE_CRC
-#define CONFIG_SMARTFS_USE_SECTOR_BUFFER
+/* The sector buffer is required when CRC is enabled in the MTD layer since
+ * every sector must then be written as a whole.  Otherwise it is optional.
+ */
+
+#if defined(CONFIG_MTD_SMART_ENABLE_CRC) && !defined(CONFIG_SMARTFS_USE_SECTOR_BUFFER)
+#  define CONFIG_SMARTFS_USE_SECTOR_BUFFER
+#endif
+
+/* Dirty sector buffers are flushed from the low priority work queue after
+ * CONFIG_SMARTFS_FLUSH_INTERVAL milliseconds.
+ */
+
+#ifndef CONFIG_SMARTFS_FLUSH_INTERVAL
+#  define CONFIG_SMARTFS_FLUSH_INTERVAL 0
+#endif
+
+#undef SMARTFS_FLUSH_WORK
+#if defined(CONFIG_SMARTFS_USE_SECTOR_BUFFER) && defined(CONFIG_SCHED_LPWORK) && \
+    CONFIG_SMARTFS_FLUSH_INTERVAL > 0
+#  define SMARTFS_FLUSH_WORK 1
 #endif
 
 /****************************************************************************
@@ -315,6 +348,18 @@ struct smartfs_ofile_s
                                           * causes the sector to change. */
 };
 
+/* Write amplification counters.  Reported through procfs. */
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+struct smartfs_wrstats_s
+{
+  uint32_t                  nuserbytes; /* Bytes passed to write() */
+  uint32_t                  nflashbytes;/* Bytes passed to the MTD layer */
+  uint32_t                  nwrites;    /* Sector write requests */
+  uint32_t                  nflushes;   /* Sector buffer flushes */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a smartfs filesystem.
@@ -333,6 +378,12 @@ struct smartfs_mountpt_s
   char                       *fs_rwbuffer;  /* Read/Write working buffer */
   char                       *fs_workbuffer;/* Working buffer */
   uint8_t                     fs_rootsector;/* Root directory sector num */
+#ifdef SMARTFS_FLUSH_WORK
+  struct work_s               fs_flushwork; /* Delayed sector buffer flush */
+#endif
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+  struct smartfs_wrstats_s    fs_wrstats;   /* Write amplification counters */
+#endif
 };
 
 /****************************************************************************
@@ -377,6 +428,11 @@ int smartfs_countdirentries(FAR struct smartfs_mountpt_s *fs,
 int smartfs_sync_internal(FAR struct smartfs_mountpt_s *fs,
         FAR struct smartfs_ofile_s *sf);
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+int smartfs_loadbuffer(FAR struct smartfs_mountpt_s *fs,
+        FAR struct smartfs_ofile_s *sf);
+#endif
+
 off_t smartfs_seek_internal(FAR struct smartfs_mountpt_s *fs,
         FAR struct smartfs_ofile_s *sf, off_t offset, int whence);
 
@@ -795,6 +795,7 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
   int       ret;
   size_t    len;
   int       utilization;
+  uint32_t  amplification;
 
   priv = (FAR struct smartfs_file_s *) filep->f_priv;
 
@@ -851,6 +852,45 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
            );
         }
 
+      /* Add the write amplification counters of the file system.  The
+       * amplification is the ratio of bytes sent to the MTD layer to the
+       * bytes written by the user.
+       */
+
+      if (len < buflen)
+        {
+          FAR struct smartfs_wrstats_s *wrstats =
+            &priv->level1.mount->fs_wrstats;
+
+          if (wrstats->nuserbytes == 0)
+            {
+              amplification = 0;
+            }
+          else
+            {
+              /* In hundredths, avoiding overflow of the multiplication */
+
+              amplification = 100 * (wrstats->nflashbytes / wrstats->nuserbytes) +
+                              (wrstats->nflashbytes % wrstats->nuserbytes) /
+                              ((wrstats->nuserbytes + 99) / 100);
+            }
+
+          len += snprintf(&buffer[len], buflen - len,
+                          "User Bytes:        %lu\nFlash Bytes:       %lu\n"
+                          "Sector Writes:     %lu\nBuffer Flushes:    %lu\n"
+                          "Write Amplif.:     %lu.%02lu\n",
+                          (unsigned long)wrstats->nuserbytes,
+                          (unsigned long)wrstats->nflashbytes,
+                          (unsigned long)wrstats->nwrites,
+                          (unsigned long)wrstats->nflushes,
+                          (unsigned long)(amplification / 100),
+                          (unsigned long)(amplification % 100));
+          if (len > buflen)
+            {
+              len = buflen;
+            }
+        }
+
       /* Indicate we have already provided all the data */
 
       priv->offset = 0xFF;
@@ -52,6 +52,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
@@ -66,6 +67,10 @@
  * Private Function Prototypes
  ****************************************************************************/
 
+#ifdef SMARTFS_FLUSH_WORK
+static void    smartfs_flushworker(FAR void *arg);
+#endif
+
 static int     smartfs_open(FAR struct file *filep, const char *relpath,
                         int oflags, mode_t mode);
 static int     smartfs_close(FAR struct file *filep);
@@ -168,6 +173,41 @@ const struct mountpt_operations smartfs_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: smartfs_flushworker
+ *
+ * Description: Write out the dirty sector buffers of all files open on the
+ *   volume.  Runs on the low priority work queue some time after a write()
+ *   left data in a sector buffer.
+ *
+ ****************************************************************************/
+
+#ifdef SMARTFS_FLUSH_WORK
+static void smartfs_flushworker(FAR void *arg)
+{
+  FAR struct smartfs_mountpt_s *fs = (FAR struct smartfs_mountpt_s *)arg;
+  FAR struct smartfs_ofile_s *sf;
+  int ret;
+
+  smartfs_semtake(fs);
+
+  for (sf = fs->fs_head; sf != NULL; sf = sf->fnext)
+    {
+      if (sf->bflags & SMARTFS_BFLAG_DIRTY)
+        {
+          ret = smartfs_sync_internal(fs, sf);
+          if (ret < 0)
+            {
+              ferr("ERROR: Failed to flush sector %d: %d\n",
+                   sf->currsector, ret);
+            }
+        }
+    }
+
+  smartfs_semgive(fs);
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_open
  ****************************************************************************/
@@ -324,6 +364,22 @@ static int smartfs_open(FAR struct file *filep, const char *relpath,
   sf->currsector = sf->entry.firstsector;
   sf->byteswritten = 0;
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+  /* If the sector buffer was not set up by creating or truncating the
+   * file, then read in the first sector.  The sector buffer must always
+   * hold the current sector.
+   */
+
+  if (sf->bflags == 0 && sf->currsector != SMARTFS_ERASEDSTATE_16BIT)
+    {
+      ret = smartfs_loadbuffer(fs, sf);
+      if (ret < 0)
+        {
+          goto errout_with_buffer;
+        }
+    }
+#endif
+
   /* Test if we opened for APPEND mode.  If we did, then seek to the
    * end of the file.
    */
@@ -360,6 +416,10 @@ errout_with_buffer:
       sf->entry.name = NULL;
     }
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+  kmm_free(sf->buffer);
+#endif
+
   kmm_free(sf);
 
 errout_with_semaphore:
@@ -484,6 +544,10 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
   uint32_t                  bytesread;
   uint16_t                  bytestoread;
   uint16_t                  bytesinsector;
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+  uint16_t                  rwsector = SMARTFS_ERASEDSTATE_16BIT;
+  uint16_t                  firstsector;
+#endif
 
   /* Sanity checks */
 
@@ -501,6 +565,21 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 
   smartfs_semtake(fs);
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+  /* Data is read from FLASH, so any buffered data must be written first */
+
+  if (sf->bflags & SMARTFS_BFLAG_DIRTY)
+    {
+      ret = smartfs_sync_internal(fs, sf);
+      if (ret < 0)
+        {
+          goto errout_with_semaphore;
+        }
+    }
+
+  firstsector = sf->currsector;
+#endif
+
   /* Loop until all byte read or error */
 
   bytesread = 0;
@@ -529,6 +608,10 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
           goto errout_with_semaphore;
         }
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+      rwsector = sf->currsector;
+#endif
+
       /* Point header to the read data to get used byte count */
 
       header = (struct smartfs_chain_header_s *) fs->fs_rwbuffer;
@@ -586,6 +669,29 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
         }
     }
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+  /* If we moved to another sector, then the sector buffer must follow.  The
+   * last sector read may still be in the read/write buffer.
+   */
+
+  if (sf->currsector != firstsector &&
+      sf->currsector != SMARTFS_ERASEDSTATE_16BIT)
+    {
+      if (sf->currsector == rwsector)
+        {
+          memcpy(sf->buffer, fs->fs_rwbuffer, fs->fs_llformat.availbytes);
+        }
+      else
+        {
+          ret = smartfs_loadbuffer(fs, sf);
+          if (ret < 0)
+            {
+              goto errout_with_semaphore;
+            }
+        }
+    }
+#endif
+
   /* Return the number of bytes we read */
 
   ret = bytesread;
@@ -637,6 +743,7 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
   /* Take the semaphore */
 
   smartfs_semtake(fs);
+  byteswritten = 0;
 
   /* Test the permissions.  Only allow write if the file was opened with
    * write flags.
@@ -652,7 +759,6 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
    * a new one. */
 
   header = (struct smartfs_chain_header_s *) fs->fs_rwbuffer;
-  byteswritten = 0;
   while ((sf->filepos < sf->entry.datlen) && (buflen > 0))
     {
       /* Overwriting data caused by a seek, etc.  In this case, we need
@@ -687,13 +793,19 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
 
       if (readwrite.count > 0)
         {
-          ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+          memcpy(&sf->buffer[sf->curroffset], readwrite.buffer,
+                 readwrite.count);
+          sf->bflags |= SMARTFS_BFLAG_DIRTY;
+#else
+          ret = FS_WRITESECT(fs, &readwrite);
           if (ret < 0)
             {
               ferr("ERROR: Error %d writing sector %d data\n",
                    ret, sf->currsector);
               goto errout_with_semaphore;
             }
+#endif
 
           /* Update our control variables */
 
@@ -712,6 +824,30 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
            * header to get the sector chain info.
            */
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+          /* The sector header is already in the sector buffer.  Write the
+           * buffer out and read in the next sector.
+           */
+
+          ret = smartfs_sync_internal(fs, sf);
+          if (ret < 0)
+            {
+              goto errout_with_semaphore;
+            }
+
+          header = (struct smartfs_chain_header_s *) sf->buffer;
+          sf->curroffset = sizeof(struct smartfs_chain_header_s);
+          sf->currsector = SMARTFS_NEXTSECTOR(header);
+
+          if (sf->currsector != SMARTFS_ERASEDSTATE_16BIT)
+            {
+              ret = smartfs_loadbuffer(fs, sf);
+              if (ret < 0)
+                {
+                  goto errout_with_semaphore;
+                }
+            }
+#else
           readwrite.offset = 0;
           readwrite.buffer = (uint8_t *) fs->fs_rwbuffer;
           readwrite.count = sizeof(struct smartfs_chain_header_s);
@@ -727,6 +863,7 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
 
           sf->curroffset = sizeof(struct smartfs_chain_header_s);
           sf->currsector = SMARTFS_NEXTSECTOR(header);
+#endif
         }
     }
 
@@ -764,7 +901,7 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
 
       if (readwrite.count > 0)
         {
-          ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+          ret = FS_WRITESECT(fs, &readwrite);
           if (ret < 0)
             {
               ferr("ERROR: Error %d writing sector %d data\n",
@@ -861,7 +998,7 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
                 nextsector);
               readwrite.buffer = (uint8_t *) header->nextsector;
               readwrite.count = sizeof(uint16_t);
-              ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+              ret = FS_WRITESECT(fs, &readwrite);
               if (ret < 0)
                 {
                   ferr("ERROR: Error %d writing next sector\n", ret);
@@ -889,6 +1026,19 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
   ret = byteswritten;
 
 errout_with_semaphore:
+  SMARTFS_WRSTAT(fs, nuserbytes, byteswritten);
+
+#ifdef SMARTFS_FLUSH_WORK
+  /* Schedule a flush of the data left in the sector buffer */
+
+  if ((sf->bflags & SMARTFS_BFLAG_DIRTY) != 0 &&
+      work_available(&fs->fs_flushwork))
+    {
+      work_queue(LPWORK, &fs->fs_flushwork, smartfs_flushworker, fs,
+                 MSEC2TICK(CONFIG_SMARTFS_FLUSH_INTERVAL));
+    }
+#endif
+
   smartfs_semgive(fs);
   return ret;
 }
@@ -1451,6 +1601,12 @@ static int smartfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
     }
   else
     {
+#ifdef SMARTFS_FLUSH_WORK
+      /* There is nothing left to flush */
+
+      work_cancel(LPWORK, &fs->fs_flushwork);
+#endif
+
        /* Unmount ... close the block driver */
 
       ret = smartfs_unmount(fs);
@@ -1846,7 +2002,7 @@ int smartfs_rename(struct inode *mountpt, const char *oldrelpath,
       readwrite.offset = oldentry.doffset;
       readwrite.count = sizeof(direntry->flags);
       readwrite.buffer = (uint8_t *) &direntry->flags;
-      ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+      ret = FS_WRITESECT(fs, &readwrite);
       if (ret < 0)
         {
           ferr("ERROR: Error %d writing flag bytes for sector %d\n",
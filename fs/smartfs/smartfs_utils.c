@@ -941,7 +941,7 @@ int smartfs_createentry(FAR struct smartfs_mountpt_s *fs,
               nextsector);
           readwrite.count = sizeof(uint16_t);
           readwrite.buffer = chainheader->nextsector;
-          ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+          ret = FS_WRITESECT(fs, &readwrite);
           if (ret < 0)
             {
               ferr("ERROR: Error chaining sector %d\n", nextsector);
@@ -1018,7 +1018,7 @@ int smartfs_createentry(FAR struct smartfs_mountpt_s *fs,
           readwrite.offset = offsetof(struct smartfs_chain_header_s, type);
           readwrite.buffer = (uint8_t *) &chainheader->type;
           readwrite.logsector = nextsector;
-          ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+          ret = FS_WRITESECT(fs, &readwrite);
           if (ret < 0)
             {
               ferr("ERROR: Error %d setting new sector type for sector %d\n",
@@ -1052,7 +1052,7 @@ int smartfs_createentry(FAR struct smartfs_mountpt_s *fs,
   readwrite.offset = offset;
   readwrite.count = entrysize;
   readwrite.buffer = (uint8_t *) &fs->fs_rwbuffer[offset];
-  ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+  ret = FS_WRITESECT(fs, &readwrite);
   if (ret < 0)
     {
       goto errout;
@@ -1182,7 +1182,7 @@ int smartfs_deleteentry(struct smartfs_mountpt_s *fs,
   readwrite.offset = entry->doffset;
   readwrite.count = sizeof(uint16_t);
   readwrite.buffer = (uint8_t *) &direntry->flags;
-  ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+  ret = FS_WRITESECT(fs, &readwrite);
   if (ret < 0)
     {
       ferr("ERROR: Error marking entry inactive at sector %d\n",
@@ -1266,7 +1266,7 @@ int smartfs_deleteentry(struct smartfs_mountpt_s *fs,
                   readwrite.count  = sizeof(uint16_t);
                   readwrite.buffer = header->nextsector;
 
-                  ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+                  ret = FS_WRITESECT(fs, &readwrite);
                   if (ret < 0)
                     {
                       ferr("ERROR: Error unchaining sector (%d)\n", nextsector);
@@ -1425,7 +1425,7 @@ int smartfs_sync_internal(FAR struct smartfs_mountpt_s *fs,
       readwrite.count     = fs->fs_llformat.availbytes;
       readwrite.buffer    = sf->buffer;
 
-      ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+      ret = FS_WRITESECT(fs, &readwrite);
       if (ret < 0)
         {
           ferr("ERROR: Error %d writing used bytes for sector %d\n",
@@ -1433,6 +1433,7 @@ int smartfs_sync_internal(FAR struct smartfs_mountpt_s *fs,
           goto errout;
         }
 
+      SMARTFS_WRSTAT(fs, nflushes, 1);
       sf->byteswritten = 0;
       sf->bflags = 0;
     }
@@ -1476,7 +1477,7 @@ int smartfs_sync_internal(FAR struct smartfs_mountpt_s *fs,
       readwrite.count  = sizeof(uint16_t);
       readwrite.buffer = (uint8_t *) &fs->fs_rwbuffer[readwrite.offset];
 
-      ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+      ret = FS_WRITESECT(fs, &readwrite);
       if (ret < 0)
         {
           ferr("ERROR: Error %d writing used bytes for sector %d\n",
@@ -1492,6 +1493,40 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smartfs_loadbuffer
+ *
+ * Description:
+ *   Read the current sector of the file into its sector buffer.  Any dirty
+ *   data in the sector buffer must have been synchronized first.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+int smartfs_loadbuffer(FAR struct smartfs_mountpt_s *fs,
+                       FAR struct smartfs_ofile_s *sf)
+{
+  struct smart_read_write_s readwrite;
+  int ret;
+
+  DEBUGASSERT((sf->bflags & SMARTFS_BFLAG_DIRTY) == 0);
+
+  readwrite.logsector = sf->currsector;
+  readwrite.offset    = 0;
+  readwrite.count     = fs->fs_llformat.availbytes;
+  readwrite.buffer    = (uint8_t *) sf->buffer;
+
+  ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long) &readwrite);
+  if (ret < 0)
+    {
+      ferr("ERROR: Error %d reading sector %d\n", ret, sf->currsector);
+      return ret;
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_seek_internal
  *
@@ -1522,7 +1557,11 @@ off_t smartfs_seek_internal(FAR struct smartfs_mountpt_s *fs,
 
   /* Test if we need to sync the file */
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+  if (sf->byteswritten > 0 || (sf->bflags & SMARTFS_BFLAG_DIRTY) != 0)
+#else
   if (sf->byteswritten > 0)
+#endif
     {
       /* Perform a sync */
 
@@ -1781,7 +1820,7 @@ int smartfs_shrinkfile(FAR struct smartfs_mountpt_s *fs,
 
           readwrite.count = fs->fs_llformat.availbytes;
 
-          ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&readwrite);
+          ret = FS_WRITESECT(fs, &readwrite);
           if (ret < 0)
             {
               ferr("ERROR: Error blanking 1st sector (%d) of file\n", nextsector);
@@ -1823,7 +1862,7 @@ int smartfs_shrinkfile(FAR struct smartfs_mountpt_s *fs,
 
       if (length == 0)
         {
-          dest       = (FAR uint8_t *)&sf->buffer;
+          dest       = (FAR uint8_t *)sf->buffer;
           destsize   = fs->fs_llformat.availbytes;
         }
       else
@@ -1947,7 +1986,7 @@ int smartfs_extendfile(FAR struct smartfs_mountpt_s *fs,
 
       if (readwrite.count > 0)
         {
-          ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+          ret = FS_WRITESECT(fs, &readwrite);
           if (ret < 0)
             {
               ferr("ERROR: Error %d writing sector %d data\n",
@@ -2043,7 +2082,7 @@ int smartfs_extendfile(FAR struct smartfs_mountpt_s *fs,
               readwrite.buffer = (FAR uint8_t *)header->nextsector;
               readwrite.count  = sizeof(uint16_t);
 
-              ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long) &readwrite);
+              ret = FS_WRITESECT(fs, &readwrite);
               if (ret < 0)
                 {
                   ferr("ERROR: Error %d writing next sector\n", ret);
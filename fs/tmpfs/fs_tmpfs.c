@@ -67,9 +67,14 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
-#endif
+/* Number of directory entries added when the directory entry array has to
+ * be reallocated.
+ */
+
+#define TMPFS_DIRECTORY_GUARD \
+  ((CONFIG_FS_TMPFS_DIRECTORY_ALLOCGUARD + \
+    sizeof(FAR struct tmpfs_dirent_s *) - 1) / \
+   sizeof(FAR struct tmpfs_dirent_s *))
 
 #define tmpfs_lock_file(tfo) \
            (tmpfs_lock_object((FAR struct tmpfs_object_s *)tfo))
@@ -91,17 +96,28 @@ static void tmpfs_unlock_reentrant(FAR struct tmpfs_sem_s *sem);
 static void tmpfs_unlock(FAR struct tmpfs_s *fs);
 static void tmpfs_lock_object(FAR struct tmpfs_object_s *to);
 static void tmpfs_unlock_object(FAR struct tmpfs_object_s *to);
-static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
+static uint32_t tmpfs_hash_name(FAR const char *name);
+static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
-static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
+static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static void tmpfs_copyout(FAR struct tmpfs_file_s *tfo, size_t offset,
+              FAR char *buffer, size_t buflen);
+static void tmpfs_copyin(FAR struct tmpfs_file_s *tfo, size_t offset,
+              FAR const char *buffer, size_t buflen);
+static int  tmpfs_map_file(FAR struct tmpfs_file_s *tfo);
+static void tmpfs_unmap_file(FAR struct tmpfs_file_s *tfo);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
+static void tmpfs_free_directory(FAR struct tmpfs_directory_s *tdo);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR const char *name);
+static void tmpfs_free_dirent(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
 static int  tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR const char *name);
-static int  tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
+static int  tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR struct tmpfs_object_s *to, FAR const char *name);
 static FAR struct tmpfs_file_s *tmpfs_alloc_file(void);
 static int  tmpfs_create_file(FAR struct tmpfs_s *fs,
@@ -311,133 +327,423 @@ static void tmpfs_unlock_object(FAR struct tmpfs_object_s *to)
   tmpfs_unlock_reentrant(&to->to_exclsem);
 }
 
+/****************************************************************************
+ * Name: tmpfs_hash_name
+ ****************************************************************************/
+
+static uint32_t tmpfs_hash_name(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  /* 32-bit FNV-1a */
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
 /****************************************************************************
  * Name: tmpfs_realloc_directory
  ****************************************************************************/
 
-static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
+static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
                                    unsigned int nentries)
 {
-  FAR struct tmpfs_directory_s *oldtdo = *tdo;
-  FAR struct tmpfs_directory_s *newtdo;
-  size_t objsize;
-  int ret = oldtdo->tdo_nentries;
+  FAR struct tmpfs_dirent_s **newentry;
+  unsigned int maxentries;
 
-  /* Get the new object size */
+  /* Is the directory entry array already big enough? */
 
-  objsize = SIZEOF_TMPFS_DIRECTORY(nentries);
-  if (objsize <= oldtdo->tdo_alloc)
+  if (nentries <= tdo->tdo_maxentries)
     {
-      /* Already big enough.
+      /* Yes.
        * REVISIT: Missing logic to shrink directory objects.
        */
 
-      oldtdo->tdo_nentries = nentries;
-      return ret;
+      return OK;
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
-   */
+  if (nentries > UINT16_MAX)
+    {
+      return -ENOSPC;
+    }
 
-  objsize += CONFIG_FS_TMPFS_DIRECTORY_ALLOCGUARD;
+  /* Added some additional entries to account frequent reallocations.
+   * Only the array of pointers is reallocated; the directory object and
+   * the directory entries themselves never move.
+   */
 
-  /* Realloc the directory object */
+  maxentries = nentries + TMPFS_DIRECTORY_GUARD;
+  if (maxentries > UINT16_MAX)
+    {
+      maxentries = UINT16_MAX;
+    }
 
-  newtdo = (FAR struct tmpfs_directory_s *)kmm_realloc(oldtdo, objsize);
-  if (newtdo == NULL)
+  newentry = (FAR struct tmpfs_dirent_s **)
+    kmm_realloc(tdo->tdo_entry,
+                maxentries * sizeof(FAR struct tmpfs_dirent_s *));
+  if (newentry == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Adjust the reference in the parent directory entry */
+  tdo->tdo_alloc     += (maxentries - tdo->tdo_maxentries) *
+                        sizeof(FAR struct tmpfs_dirent_s *);
+  tdo->tdo_entry      = newentry;
+  tdo->tdo_maxentries = maxentries;
+  return OK;
+}
 
-  DEBUGASSERT(newtdo->tdo_dirent);
-  newtdo->tdo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtdo;
+/****************************************************************************
+ * Name: tmpfs_realloc_file
+ ****************************************************************************/
 
-  /* Return the new address of the reallocated directory object */
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
+                              size_t newsize)
+{
+  FAR struct tmpfs_chunk_s *newchunks;
+  FAR struct tmpfs_chunk_s *tc;
+  FAR uint8_t *block;
+  FAR uint8_t *newblock;
+  unsigned int nchunks;
+  unsigned int maxchunks;
+  unsigned int nalloc;
+  unsigned int first;
+  bool shrink;
+
+  /* Get the number of chunks needed to hold the new file size */
+
+  nchunks = TMPFS_NCHUNKS(newsize);
+
+  /* Grow the array of chunk descriptions if necessary.  Only this array is
+   * ever reallocated; the file data is not copied.  The array size is
+   * doubled so that appending to a file takes constant time on average.
+   */
 
-  newtdo->tdo_alloc    = objsize;
-  newtdo->tdo_nentries = nentries;
-  *tdo                 = newtdo;
+  if (nchunks > tfo->tfo_maxchunks)
+    {
+      maxchunks = 2 * tfo->tfo_maxchunks;
+      if (maxchunks < nchunks)
+        {
+          maxchunks = nchunks;
+        }
 
-  /* Adjust the reference in the parent directory entry */
+      newchunks = (FAR struct tmpfs_chunk_s *)
+        kmm_realloc(tfo->tfo_chunks,
+                    maxchunks * sizeof(struct tmpfs_chunk_s));
+      if (newchunks == NULL)
+        {
+          return -ENOMEM;
+        }
 
-  DEBUGASSERT(newtdo->tdo_dirent);
-  newtdo->tdo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtdo;
+      tfo->tfo_alloc    += (maxchunks - tfo->tfo_maxchunks) *
+                           sizeof(struct tmpfs_chunk_s);
+      tfo->tfo_chunks    = newchunks;
+      tfo->tfo_maxchunks = maxchunks;
+    }
 
-  /* Return the index to the first, newly allocated directory entry */
+  /* Chunks that are part of the mapped block are simply reused */
 
-  return ret;
+  while (tfo->tfo_nchunks < nchunks &&
+         tfo->tfo_nchunks < tfo->tfo_mapchunks)
+    {
+      tc           = &tfo->tfo_chunks[tfo->tfo_nchunks];
+      tc->tc_data  = tfo->tfo_mapbase + tfo->tfo_nchunks * TMPFS_CHUNKSIZE;
+      tc->tc_first = (tfo->tfo_nchunks == 0);
+
+      tfo->tfo_nchunks++;
+      tfo->tfo_alloc += TMPFS_CHUNKSIZE;
+    }
+
+  /* Allocate the remaining new chunks as one block so that a file that is
+   * sized by a single write() or ftruncate() is contiguous in memory and
+   * can be mapped in place.  If that allocation fails, fall back to
+   * allocating the chunks one at a time.  On a failure, the chunks already
+   * allocated are retained beyond the end of the file until the next
+   * reallocation.
+   */
+
+  while (tfo->tfo_nchunks < nchunks)
+    {
+      nalloc = nchunks - tfo->tfo_nchunks;
+      block  = (FAR uint8_t *)kmm_malloc(nalloc * TMPFS_CHUNKSIZE);
+      if (block == NULL && nalloc > 1)
+        {
+          nalloc = 1;
+          block  = (FAR uint8_t *)kmm_malloc(TMPFS_CHUNKSIZE);
+        }
+
+      if (block == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      for (first = 0; first < nalloc; first++)
+        {
+          tc           = &tfo->tfo_chunks[tfo->tfo_nchunks++];
+          tc->tc_data  = block + first * TMPFS_CHUNKSIZE;
+          tc->tc_first = (first == 0);
+        }
+
+      tfo->tfo_alloc += nalloc * TMPFS_CHUNKSIZE;
+    }
+
+  /* Free chunks that are no longer needed.  A block is freed with its first
+   * chunk.  Chunks in the mapped block are left to tmpfs_unmap_file().
+   */
+
+  shrink = false;
+  while (tfo->tfo_nchunks > nchunks)
+    {
+      tc = &tfo->tfo_chunks[--tfo->tfo_nchunks];
+      if (tfo->tfo_nchunks >= tfo->tfo_mapchunks)
+        {
+          if (tc->tc_first)
+            {
+              kmm_free(tc->tc_data);
+            }
+
+          shrink = !tc->tc_first;
+        }
+
+      tfo->tfo_alloc -= TMPFS_CHUNKSIZE;
+    }
+
+  /* If the file now ends part way through a block, give the tail of that
+   * block back to the heap.  Shrinking an allocation never moves it.
+   */
+
+  if (shrink)
+    {
+      first = nchunks - 1;
+      while (!tfo->tfo_chunks[first].tc_first)
+        {
+          first--;
+        }
+
+      block    = tfo->tfo_chunks[first].tc_data;
+      newblock = (FAR uint8_t *)
+        kmm_realloc(block, (nchunks - first) * TMPFS_CHUNKSIZE);
+
+      DEBUGASSERT(newblock == block);
+      UNUSED(newblock);
+    }
+
+  /* The mapped block can be freed with the last chunk if it is no longer
+   * mapped.
+   */
+
+  if (nchunks == 0 && tfo->tfo_mapbase != NULL && tfo->tfo_nmaps == 0)
+    {
+      kmm_free(tfo->tfo_mapbase);
+      tfo->tfo_mapbase   = NULL;
+      tfo->tfo_mapchunks = 0;
+    }
+
+  /* Free the array of chunk descriptions when the file becomes empty */
+
+  if (nchunks == 0 && tfo->tfo_chunks != NULL)
+    {
+      kmm_free(tfo->tfo_chunks);
+      tfo->tfo_alloc    -= tfo->tfo_maxchunks * sizeof(struct tmpfs_chunk_s);
+      tfo->tfo_chunks    = NULL;
+      tfo->tfo_maxchunks = 0;
+    }
+
+  tfo->tfo_size = newsize;
+  return OK;
 }
 
 /****************************************************************************
- * Name: tmpfs_realloc_file
+ * Name: tmpfs_copyout
+ *
+ * Description:
+ *   Copy file data from the chunks of the file to a buffer.  The region
+ *   must lie within the file.
+ *
  ****************************************************************************/
 
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
-                              size_t newsize)
+static void tmpfs_copyout(FAR struct tmpfs_file_s *tfo, size_t offset,
+                          FAR char *buffer, size_t buflen)
 {
-  FAR struct tmpfs_file_s *oldtfo = *tfo;
-  FAR struct tmpfs_file_s *newtfo;
-  size_t objsize;
-  size_t allocsize;
-  size_t delta;
+  size_t chunkoffset;
+  size_t ncopy;
 
-  /* Check if the current allocation is sufficient */
+  while (buflen > 0)
+    {
+      chunkoffset = offset % TMPFS_CHUNKSIZE;
+      ncopy       = TMPFS_CHUNKSIZE - chunkoffset;
+      if (ncopy > buflen)
+        {
+          ncopy = buflen;
+        }
+
+      memcpy(buffer,
+             tfo->tfo_chunks[offset / TMPFS_CHUNKSIZE].tc_data + chunkoffset,
+             ncopy);
+
+      offset += ncopy;
+      buffer += ncopy;
+      buflen -= ncopy;
+    }
+}
 
-  objsize = SIZEOF_TMPFS_FILE(newsize);
+/****************************************************************************
+ * Name: tmpfs_copyin
+ *
+ * Description:
+ *   Copy data from a buffer into the chunks of the file, or zero the
+ *   region if the buffer is NULL.  The region must lie within the file.
+ *
+ ****************************************************************************/
 
-  /* Are we growing or shrinking the object? */
+static void tmpfs_copyin(FAR struct tmpfs_file_s *tfo, size_t offset,
+                         FAR const char *buffer, size_t buflen)
+{
+  FAR uint8_t *dest;
+  size_t chunkoffset;
+  size_t ncopy;
 
-  if (objsize <= oldtfo->tfo_alloc)
+  while (buflen > 0)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
-       */
+      chunkoffset = offset % TMPFS_CHUNKSIZE;
+      ncopy       = TMPFS_CHUNKSIZE - chunkoffset;
+      if (ncopy > buflen)
+        {
+          ncopy = buflen;
+        }
 
-      if (newsize > 0)
+      dest = tfo->tfo_chunks[offset / TMPFS_CHUNKSIZE].tc_data + chunkoffset;
+      if (buffer != NULL)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          memcpy(dest, buffer, ncopy);
+          buffer += ncopy;
+        }
+      else
+        {
+          memset(dest, 0, ncopy);
+        }
 
-          delta = oldtfo->tfo_alloc - objsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
-            {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+      offset += ncopy;
+      buflen -= ncopy;
+    }
+}
 
-              oldtfo->tfo_size = newsize;
-              return OK;
-            }
+/****************************************************************************
+ * Name: tmpfs_map_file
+ *
+ * Description:
+ *   Map the file data in place.  This is possible when all of the file data
+ *   lies in one allocated block; the file data is never copied to make a
+ *   file contiguous.  Otherwise this fails and mmap() falls back to a
+ *   private copy of the mapped region that munmap() frees.
+ *
+ ****************************************************************************/
+
+static int tmpfs_map_file(FAR struct tmpfs_file_s *tfo)
+{
+  unsigned int i;
+
+  /* Is the file already mapped? */
+
+  if (tfo->tfo_mapbase != NULL)
+    {
+      return tfo->tfo_nchunks <= tfo->tfo_mapchunks ? OK : -ENOSYS;
+    }
+
+  if (tfo->tfo_nchunks == 0)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 1; i < tfo->tfo_nchunks; i++)
+    {
+      if (tfo->tfo_chunks[i].tc_first)
+        {
+          return -ENOSYS;
         }
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
+  /* The block stays in place while it is mapped, even if the file grows or
+   * is truncated.
    */
 
-  allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+  tfo->tfo_mapbase   = tfo->tfo_chunks[0].tc_data;
+  tfo->tfo_mapchunks = tfo->tfo_nchunks;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_unmap_file
+ *
+ * Description:
+ *   Release one mapping of the file.  When the last mapping is released,
+ *   the mapped block becomes an ordinary block of the file again.  If the
+ *   file was truncated while it was mapped, the unused tail of the block is
+ *   freed.
+ *
+ ****************************************************************************/
 
-  /* Realloc the file object */
+static void tmpfs_unmap_file(FAR struct tmpfs_file_s *tfo)
+{
+  FAR uint8_t *newbase;
 
-  newtfo = (FAR struct tmpfs_file_s *)kmm_realloc(oldtfo, allocsize);
-  if (newtfo == NULL)
+  if (tfo->tfo_nmaps > 0 && --tfo->tfo_nmaps == 0 &&
+      tfo->tfo_mapbase != NULL)
     {
-      return -ENOMEM;
+      if (tfo->tfo_nchunks == 0)
+        {
+          kmm_free(tfo->tfo_mapbase);
+        }
+      else if (tfo->tfo_nchunks < tfo->tfo_mapchunks)
+        {
+          newbase = (FAR uint8_t *)
+            kmm_realloc(tfo->tfo_mapbase,
+                        tfo->tfo_nchunks * TMPFS_CHUNKSIZE);
+
+          DEBUGASSERT(newbase == tfo->tfo_mapbase);
+          UNUSED(newbase);
+        }
+
+      tfo->tfo_mapbase   = NULL;
+      tfo->tfo_mapchunks = 0;
     }
+}
 
-  /* Adjust the reference in the parent directory entry */
+/****************************************************************************
+ * Name: tmpfs_free_file
+ ****************************************************************************/
 
-  DEBUGASSERT(newtfo->tfo_dirent);
-  newtfo->tfo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtfo;
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+  /* Shrinking the file to zero frees all of its data and cannot fail */
 
-  /* Return the new address of the reallocated file object */
+  tfo->tfo_nmaps = 0;
+  (void)tmpfs_realloc_file(tfo, 0);
 
-  newtfo->tfo_alloc = allocsize;
-  newtfo->tfo_size  = newsize;
-  *tfo              = newtfo;
-  return OK;
+  nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
+  kmm_free(tfo);
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_directory
+ ****************************************************************************/
+
+static void tmpfs_free_directory(FAR struct tmpfs_directory_s *tdo)
+{
+  DEBUGASSERT(tdo->tdo_nentries == 0);
+
+  if (tdo->tdo_entry != NULL)
+    {
+      kmm_free(tdo->tdo_entry);
+    }
+
+  nxsem_destroy(&tdo->tdo_exclsem.ts_sem);
+  kmm_free(tdo);
 }
 
 /****************************************************************************
@@ -475,8 +781,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Otherwise, just decrement the reference count on the file object */
@@ -495,71 +800,95 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
                              FAR const char *name)
 {
-  int i;
-
-  /* Search the list of directory entries for a match */
+  FAR struct tmpfs_dirent_s *tde;
+  uint32_t hash;
 
-  for (i = 0;
-       i < tdo->tdo_nentries &&
-       strcmp(tdo->tdo_entry[i].tde_name, name) != 0;
-       i++);
+  /* Search the hash chain for a match */
 
-  /* Return what we found, if anything */
+  hash = tmpfs_hash_name(name);
+  for (tde = tdo->tdo_hash[hash % TMPFS_NHASH];
+       tde != NULL;
+       tde = tde->tde_hnext)
+    {
+      if (tde->tde_hash == hash && strcmp(tde->tde_name, name) == 0)
+        {
+          return tde->tde_index;
+        }
+    }
 
-  return i < tdo->tdo_nentries ? i : -ENOENT;
+  return -ENOENT;
 }
 
 /****************************************************************************
- * Name: tmpfs_remove_dirent
+ * Name: tmpfs_free_dirent
+ *
+ * Description:
+ *   Remove the directory entry at index from the directory and free it.
+ *   The object that it refers to is not affected.
+ *
  ****************************************************************************/
 
-static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
-                               FAR const char *name)
+static void tmpfs_free_dirent(FAR struct tmpfs_directory_s *tdo,
+                              unsigned int index)
 {
-  int index;
-  int last;
+  FAR struct tmpfs_dirent_s **pprev;
+  FAR struct tmpfs_dirent_s *tde;
+  unsigned int last;
 
-  /* Search the list of directory entries for a match */
+  DEBUGASSERT(index < tdo->tdo_nentries);
+  tde = tdo->tdo_entry[index];
 
-  index = tmpfs_find_dirent(tdo, name);
-  if (index < 0)
-    {
-      return index;
-    }
+  /* Remove the entry from its hash chain */
 
-  /* Free the object name */
+  for (pprev = &tdo->tdo_hash[tde->tde_hash % TMPFS_NHASH];
+       *pprev != tde;
+       pprev = &(*pprev)->tde_hnext);
 
-  if (tdo->tdo_entry[index].tde_name != NULL)
-    {
-      kmm_free(tdo->tdo_entry[index].tde_name);
-    }
+  *pprev = tde->tde_hnext;
 
   /* Remove by replacing this entry with the final directory entry */
 
   last = tdo->tdo_nentries - 1;
   if (index != last)
     {
-      FAR struct tmpfs_dirent_s *newtde;
-      FAR struct tmpfs_dirent_s *oldtde;
-      FAR struct tmpfs_object_s *to;
-
-      /* Move the directory entry */
+      tdo->tdo_entry[index] = tdo->tdo_entry[last];
+      tdo->tdo_entry[index]->tde_index = index;
+    }
 
-      newtde             = &tdo->tdo_entry[index];
-      oldtde             = &tdo->tdo_entry[last];
-      to                 = oldtde->tde_object;
+  /* And decrement the count of directory entries */
 
-      newtde->tde_object = to;
-      newtde->tde_name   = oldtde->tde_name;
+  tdo->tdo_nentries = last;
+  tdo->tdo_alloc   -= sizeof(struct tmpfs_dirent_s);
 
-      /* Reset the backward link to the directory entry */
+  /* Free the object name and the directory entry */
 
-      to->to_dirent      = newtde;
+  if (tde->tde_name != NULL)
+    {
+      kmm_free(tde->tde_name);
     }
 
-  /* And decrement the count of directory entries */
+  tde->tde_object->to_dirent = NULL;
+  kmm_free(tde);
+}
 
-  tdo->tdo_nentries = last;
+/****************************************************************************
+ * Name: tmpfs_remove_dirent
+ ****************************************************************************/
+
+static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
+                               FAR const char *name)
+{
+  int index;
+
+  /* Search the list of directory entries for a match */
+
+  index = tmpfs_find_dirent(tdo, name);
+  if (index < 0)
+    {
+      return index;
+    }
+
+  tmpfs_free_dirent(tdo, index);
   return OK;
 }
 
@@ -567,16 +896,14 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
  * Name: tmpfs_add_dirent
  ****************************************************************************/
 
-static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
+static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
                             FAR struct tmpfs_object_s *to,
                             FAR const char *name)
 {
-  FAR struct tmpfs_directory_s *oldtdo;
-  FAR struct tmpfs_directory_s *newtdo;
   FAR struct tmpfs_dirent_s *tde;
   FAR char *newname;
-  unsigned int nentries;
-  int index;
+  unsigned int index;
+  int ret;
 
   /* Copy the name string so that it will persist as long as the
    * directory entry.
@@ -588,31 +915,50 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
       return -ENOMEM;
     }
 
-  /* Get the new number of entries */
+  /* Allocate the new directory entry */
 
-  oldtdo = *tdo;
-  nentries = oldtdo->tdo_nentries + 1;
+  tde = (FAR struct tmpfs_dirent_s *)kmm_malloc(sizeof(struct tmpfs_dirent_s));
+  if (tde == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_name;
+    }
 
-  /* Reallocate the directory object (if necessary) */
+  /* Reallocate the directory entry array (if necessary) */
 
-  index = tmpfs_realloc_directory(tdo, nentries);
-  if (index < 0)
+  index = tdo->tdo_nentries;
+  ret   = tmpfs_realloc_directory(tdo, index + 1);
+  if (ret < 0)
     {
-      kmm_free(newname);
-      return index;
+      goto errout_with_dirent;
     }
 
-  /* Save the new object info in the new directory entry */
+  /* Save the new object info in the new directory entry and add it to
+   * the directory.
+   */
 
-  newtdo          = *tdo;
-  tde             = &newtdo->tdo_entry[index];
   tde->tde_object = to;
   tde->tde_name   = newname;
+  tde->tde_hash   = tmpfs_hash_name(newname);
+  tde->tde_index  = index;
+  tde->tde_hnext  = tdo->tdo_hash[tde->tde_hash % TMPFS_NHASH];
+
+  tdo->tdo_hash[tde->tde_hash % TMPFS_NHASH] = tde;
+  tdo->tdo_entry[index] = tde;
+  tdo->tdo_nentries     = index + 1;
+  tdo->tdo_alloc       += sizeof(struct tmpfs_dirent_s);
 
   /* Add backward link to the directory entry to the object */
 
   to->to_dirent  = tde;
   return OK;
+
+errout_with_dirent:
+  kmm_free(tde);
+
+errout_with_name:
+  kmm_free(newname);
+  return ret;
 }
 
 /****************************************************************************
@@ -622,12 +968,12 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
 static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
 {
   FAR struct tmpfs_file_s *tfo;
-  size_t allocsize;
 
-  /* Create a new zero length file object */
+  /* Create a new zero length file object.  No data chunks are allocated
+   * until the file is written.
+   */
 
-  allocsize = SIZEOF_TMPFS_FILE(CONFIG_FS_TMPFS_FILE_ALLOCGUARD);
-  tfo = (FAR struct tmpfs_file_s *)kmm_malloc(allocsize);
+  tfo = (FAR struct tmpfs_file_s *)kmm_zalloc(sizeof(struct tmpfs_file_s));
   if (tfo == NULL)
     {
       return NULL;
@@ -637,11 +983,9 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
    * locked with one reference count.
    */
 
-  tfo->tfo_alloc = allocsize;
+  tfo->tfo_alloc = sizeof(struct tmpfs_file_s);
   tfo->tfo_type  = TMPFS_REGULAR;
   tfo->tfo_refs  = 1;
-  tfo->tfo_flags = 0;
-  tfo->tfo_size  = 0;
 
   tfo->tfo_exclsem.ts_holder = getpid();
   tfo->tfo_exclsem.ts_count  = 1;
@@ -737,7 +1081,7 @@ static int tmpfs_create_file(FAR struct tmpfs_s *fs,
 
   /* Then add the new, empty file to the directory */
 
-  ret = tmpfs_add_dirent(&parent, (FAR struct tmpfs_object_s *)newtfo, name);
+  ret = tmpfs_add_dirent(parent, (FAR struct tmpfs_object_s *)newtfo, name);
   if (ret < 0)
     {
       goto errout_with_file;
@@ -757,8 +1101,7 @@ static int tmpfs_create_file(FAR struct tmpfs_s *fs,
 /* Error exits */
 
 errout_with_file:
-  nxsem_destroy(&newtfo->tfo_exclsem.ts_sem);
-  kmm_free(newtfo);
+  tmpfs_free_file(newtfo);
 
 errout_with_parent:
   parent->tdo_refs--;
@@ -776,19 +1119,13 @@ errout_with_copy:
 static FAR struct tmpfs_directory_s *tmpfs_alloc_directory(void)
 {
   FAR struct tmpfs_directory_s *tdo;
-  size_t allocsize;
-  unsigned int nentries;
-
-  /* Convert the pre-allocated memory to a number of directory entries */
-
-  nentries = (CONFIG_FS_TMPFS_DIRECTORY_ALLOCGUARD +
-              sizeof(struct tmpfs_dirent_s) - 1) /
-             sizeof(struct tmpfs_dirent_s);
 
-  /* Create a new zero length directory object */
+  /* Create a new empty directory object with empty hash chains.  The
+   * directory entry array is allocated when the first entry is added.
+   */
 
-  allocsize = SIZEOF_TMPFS_DIRECTORY(nentries);
-  tdo = (FAR struct tmpfs_directory_s *)kmm_malloc(allocsize);
+  tdo = (FAR struct tmpfs_directory_s *)
+    kmm_zalloc(sizeof(struct tmpfs_directory_s));
   if (tdo == NULL)
     {
       return NULL;
@@ -796,10 +1133,8 @@ static FAR struct tmpfs_directory_s *tmpfs_alloc_directory(void)
 
   /* Initialize the new directory object */
 
-  tdo->tdo_alloc    = allocsize;
+  tdo->tdo_alloc    = sizeof(struct tmpfs_directory_s);
   tdo->tdo_type     = TMPFS_DIRECTORY;
-  tdo->tdo_refs     = 0;
-  tdo->tdo_nentries = 0;
 
   tdo->tdo_exclsem.ts_holder = TMPFS_NO_HOLDER;
   tdo->tdo_exclsem.ts_count  = 0;
@@ -893,7 +1228,7 @@ static int tmpfs_create_directory(FAR struct tmpfs_s *fs,
 
   /* Then add the new, empty file to the directory */
 
-  ret = tmpfs_add_dirent(&parent, (FAR struct tmpfs_object_s *)newtdo, name);
+  ret = tmpfs_add_dirent(parent, (FAR struct tmpfs_object_s *)newtdo, name);
   if (ret < 0)
     {
       goto errout_with_directory;
@@ -919,8 +1254,7 @@ static int tmpfs_create_directory(FAR struct tmpfs_s *fs,
 /* Error exits */
 
 errout_with_directory:
-  nxsem_destroy(&newtdo->tdo_exclsem.ts_sem);
-  kmm_free(newtdo);
+  tmpfs_free_directory(newtdo);
 
 errout_with_parent:
   parent->tdo_refs--;
@@ -990,7 +1324,7 @@ static int tmpfs_find_object(FAR struct tmpfs_s *fs,
           return index;
         }
 
-      to = tdo->tdo_entry[index].tde_object;
+      to = tdo->tdo_entry[index]->tde_object;
 
       /* Is this object another directory? */
 
@@ -1169,7 +1503,7 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 
   DEBUGASSERT(tdo != NULL && arg != NULL && index < tdo->tdo_nentries);
 
-  to     = tdo->tdo_entry[index].tde_object;
+  to     = tdo->tdo_entry[index]->tde_object;
   tmpbuf = (FAR struct tmpfs_statfs_s *)arg;
 
   DEBUGASSERT(to != NULL);
@@ -1195,19 +1529,15 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
       FAR struct tmpfs_directory_s *tmptdo;
-      size_t inuse;
-      size_t avail;
 
       /* It is a directory object.  Update the amount of memory in use
        * for the directory and estimate the number of free directory nodes.
        */
 
       tmptdo = (FAR struct tmpfs_directory_s *)to;
-      inuse  = SIZEOF_TMPFS_DIRECTORY(tmptdo->tdo_nentries);
-      avail  = tmptdo->tdo_alloc - inuse;
 
-      tmpbuf->tsf_inuse += inuse;
-      tmpbuf->tsf_ffree += avail / sizeof(struct tmpfs_dirent_s);
+      tmpbuf->tsf_inuse += SIZEOF_TMPFS_DIRECTORY(tmptdo->tdo_nentries);
+      tmpbuf->tsf_ffree += tmptdo->tdo_maxentries - tmptdo->tdo_nentries;
     }
 
   return TMPFS_CONTINUE;
@@ -1220,45 +1550,13 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
                               unsigned int index, FAR void *arg)
 {
-  FAR struct tmpfs_dirent_s *tde;
   FAR struct tmpfs_object_s *to;
   FAR struct tmpfs_file_s *tfo;
-  unsigned int last;
-
-  /* Free the object name */
-
-  if (tdo->tdo_entry[index].tde_name != NULL)
-    {
-      kmm_free(tdo->tdo_entry[index].tde_name);
-    }
-
-  /* Remove by replacing this entry with the final directory entry */
-
-  tde  = &tdo->tdo_entry[index];
-  to   = tde->tde_object;
-  last = tdo->tdo_nentries - 1;
-
-  if (index != last)
-    {
-      FAR struct tmpfs_dirent_s *oldtde;
-      FAR struct tmpfs_object_s *oldto;
-
-      /* Move the directory entry */
-
-      oldtde           = &tdo->tdo_entry[last];
-      oldto            = oldtde->tde_object;
-
-      tde->tde_object  = oldto;
-      tde->tde_name    = oldtde->tde_name;
-
-      /* Reset the backward link to the directory entry */
 
-      oldto->to_dirent = tde;
-    }
+  /* Remove and free the directory entry */
 
-  /* And decrement the count of directory entries */
-
-  tdo->tdo_nentries = last;
+  to = tdo->tdo_entry[index]->tde_object;
+  tmpfs_free_dirent(tdo, index);
 
   /* Is this directory entry a file object? */
 
@@ -1275,12 +1573,14 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           tfo->tfo_flags |= TFO_FLAG_UNLINKED;
           return TMPFS_UNLINKED;
         }
-    }
 
-  /* Free the object now */
+      tmpfs_free_file(tfo);
+    }
+  else
+    {
+      tmpfs_free_directory((FAR struct tmpfs_directory_s *)to);
+    }
 
-  nxsem_destroy(&to->to_exclsem.ts_sem);
-  kmm_free(to);
   return TMPFS_DELETED;
 }
 
@@ -1301,7 +1601,7 @@ static int tmpfs_foreach(FAR struct tmpfs_directory_s *tdo,
     {
       /* Lock the object and take a reference */
 
-      to = tdo->tdo_entry[index].tde_object;
+      to = tdo->tdo_entry[index]->tde_object;
       tmpfs_lock_object(to);
       to->to_refs++;
 
@@ -1428,7 +1728,7 @@ static int tmpfs_open(FAR struct file *filep, FAR const char *relpath,
 
           if (tfo->tfo_size > 0)
             {
-              ret = tmpfs_realloc_file(&tfo, 0);
+              ret = tmpfs_realloc_file(tfo, 0);
               if (ret < 0)
                 {
                   goto errout_with_filelock;
@@ -1543,7 +1843,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
       return OK;
     }
 
@@ -1583,7 +1883,11 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   nread    = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  if (startpos >= tfo->tfo_size)
+    {
+      nread  = 0;
+    }
+  else if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
       nread  = endpos - startpos;
@@ -1591,7 +1895,7 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
-  memcpy(buffer, &tfo->tfo_data[startpos], nread);
+  tmpfs_copyout(tfo, (size_t)startpos, buffer, nread);
   filep->f_pos += nread;
 
   /* Release the lock on the file */
@@ -1609,6 +1913,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct tmpfs_file_s *tfo;
   ssize_t nwritten;
+  size_t oldsize;
   off_t startpos;
   off_t endpos;
   int ret;
@@ -1633,20 +1938,28 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   if (endpos > tfo->tfo_size)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      /* Reallocate the file to handle the write past the end of the file.
+       * This only adds chunks; the existing data is not moved.
+       */
 
-      ret = tmpfs_realloc_file(&tfo, (size_t)endpos);
+      oldsize = tfo->tfo_size;
+      ret = tmpfs_realloc_file(tfo, (size_t)endpos);
       if (ret < 0)
         {
           goto errout_with_lock;
         }
 
-      filep->f_priv = tfo;
+      /* Zero any gap between the old end of the file and the write */
+
+      if (startpos > oldsize)
+        {
+          tmpfs_copyin(tfo, oldsize, NULL, startpos - oldsize);
+        }
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the user buffer to the memory object */
 
-  memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
+  tmpfs_copyin(tfo, (size_t)startpos, buffer, nwritten);
   filep->f_pos += nwritten;
 
   /* Release the lock on the file */
@@ -1727,25 +2040,42 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   FAR struct tmpfs_file_s *tfo;
   FAR void **ppv = (FAR void**)arg;
+  int ret;
 
   finfo("filep: %p cmd: %d arg: %08lx\n", filep, cmd, arg);
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
 
   /* Recover our private data from the struct file instance */
 
-  tfo = filep->f_inode->i_private;
+  tfo = filep->f_priv;
 
   DEBUGASSERT(tfo != NULL);
 
-  /* Only one ioctl command is supported */
-
   if (cmd == FIOC_MMAP && ppv != NULL)
     {
-      /* Return the address on the media corresponding to the start of
-       * the file.
+      /* Return the address in memory corresponding to the start of the
+       * file.  This is only possible if the file is contiguous in memory.
+       * The data stays in place until the last mapping is released.
        */
 
-      *ppv = (FAR void *)tfo->tfo_data;
+      tmpfs_lock_file(tfo);
+      ret = tmpfs_map_file(tfo);
+      if (ret >= 0)
+        {
+          tfo->tfo_nmaps++;
+          *ppv = (FAR void *)tfo->tfo_mapbase;
+        }
+
+      tmpfs_unlock_file(tfo);
+      return ret;
+    }
+  else if (cmd == FIOC_MUNMAP)
+    {
+      /* Release a mapping obtained with FIOC_MMAP */
+
+      tmpfs_lock_file(tfo);
+      tmpfs_unmap_file(tfo);
+      tmpfs_unlock_file(tfo);
       return OK;
     }
 
@@ -1850,21 +2180,19 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
     {
       /* The size is changing.. up or down.  Reallocate the file memory. */
 
-      ret = tmpfs_realloc_file(&tfo, (size_t)length);
+      ret = tmpfs_realloc_file(tfo, (size_t)length);
       if (ret < 0)
         {
           goto errout_with_lock;
         }
 
-      filep->f_priv = tfo;
-
       /* If the size has increased, then we need to zero the newly added
        * memory.
        */
 
       if (length > oldsize)
         {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
+          tmpfs_copyin(tfo, oldsize, NULL, length - oldsize);
         }
 
       ret = OK;
@@ -1992,7 +2320,7 @@ static int tmpfs_readdir(FAR struct inode *mountpt,
 
       /* Does this entry refer to a file or a directory object? */
 
-      tde = &tdo->tdo_entry[index];
+      tde = tdo->tdo_entry[index];
       to  = tde->tde_object;
       DEBUGASSERT(to != NULL);
 
@@ -2074,7 +2402,7 @@ static int tmpfs_bind(FAR struct inode *blkdriver, FAR const void *data,
   fs->tfs_root.tde_object = (FAR struct tmpfs_object_s *)tdo;
   fs->tfs_root.tde_name   = "";
 
-  /* Set up the backward link (to support reallocation) */
+  /* Set up the backward link */
 
   tdo->tdo_dirent         = &fs->tfs_root;
 
@@ -2116,8 +2444,7 @@ static int tmpfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* Now we can destroy the root file system and the file system itself. */
 
-  nxsem_destroy(&tdo->tdo_exclsem.ts_sem);
-  kmm_free(tdo);
+  tmpfs_free_directory(tdo);
 
   nxsem_destroy(&fs->tfs_exclsem.ts_sem);
   kmm_free(fs);
@@ -2156,13 +2483,12 @@ static int tmpfs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
   tdo              = (FAR struct tmpfs_directory_s *)fs->tfs_root.tde_object;
   inuse            = sizeof(struct tmpfs_s) +
                      SIZEOF_TMPFS_DIRECTORY(tdo->tdo_nentries);
-  avail            = sizeof(struct tmpfs_s) +
-                     tdo->tdo_alloc - inuse;
+  avail            = tdo->tdo_maxentries - tdo->tdo_nentries;
 
-  tmpbuf.tsf_alloc = tdo->tdo_alloc;
+  tmpbuf.tsf_alloc = sizeof(struct tmpfs_s) + tdo->tdo_alloc;
   tmpbuf.tsf_inuse = inuse;
   tmpbuf.tsf_files = 0;
-  tmpbuf.tsf_ffree = avail / sizeof(struct tmpfs_dirent_s);
+  tmpbuf.tsf_ffree = avail;
 
   /* Traverse the file system to accurmulate statistics */
 
@@ -2275,8 +2601,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   else
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Release the reference and lock on the parent directory */
@@ -2401,8 +2726,7 @@ static int tmpfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Free the directory object */
 
-  nxsem_destroy(&tdo->tdo_exclsem.ts_sem);
-  kmm_free(tdo);
+  tmpfs_free_directory(tdo);
 
   /* Release the reference and lock on the parent directory */
 
@@ -2550,7 +2874,7 @@ static int tmpfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 
   /* Add an entry to the new parent directory. */
 
-  ret = tmpfs_add_dirent(&newparent, to, newname);
+  ret = tmpfs_add_dirent(newparent, to, newname);
 
 errout_with_oldparent:
   oldparent->tdo_refs--;
@@ -42,6 +42,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <semaphore.h>
 
@@ -58,6 +59,22 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* Size of the chunks that hold file data */
+
+#ifndef CONFIG_FS_TMPFS_FILE_CHUNKSIZE
+#  define CONFIG_FS_TMPFS_FILE_CHUNKSIZE 512
+#endif
+
+#define TMPFS_CHUNKSIZE   CONFIG_FS_TMPFS_FILE_CHUNKSIZE
+
+/* Number of hash chains in each directory */
+
+#ifndef CONFIG_FS_TMPFS_DIRECTORY_NHASH
+#  define CONFIG_FS_TMPFS_DIRECTORY_NHASH 16
+#endif
+
+#define TMPFS_NHASH       CONFIG_FS_TMPFS_DIRECTORY_NHASH
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -89,12 +106,17 @@ struct tmpfs_sem_s
   uint16_t ts_count;     /* Number of counts held */
 };
 
-/* The form of one directory entry */
+/* The form of one directory entry.  Directory entries are allocated
+ * individually so that they do not move when the directory grows.
+ */
 
 struct tmpfs_dirent_s
 {
+  FAR struct tmpfs_dirent_s *tde_hnext;  /* Next entry in the hash chain */
   FAR struct tmpfs_object_s *tde_object;
   FAR char *tde_name;
+  uint32_t tde_hash;     /* Hash of tde_name */
+  uint16_t tde_index;    /* Index of the entry in tdo_entry[] */
 };
 
 /* The generic form of a TMPFS memory object */
@@ -125,11 +147,22 @@ struct tmpfs_directory_s
   /* Remaining fields are unique to a directory object */
 
   uint16_t tdo_nentries; /* Number of directory entries */
-  struct tmpfs_dirent_s tdo_entry[1];
+  uint16_t tdo_maxentries; /* Allocated size of tdo_entry[] */
+  FAR struct tmpfs_dirent_s **tdo_entry; /* Entries, in no particular order */
+  FAR struct tmpfs_dirent_s *tdo_hash[TMPFS_NHASH]; /* Hashed by name */
 };
 
 #define SIZEOF_TMPFS_DIRECTORY(n) \
-  (sizeof(struct tmpfs_directory_s) + ((n) - 1) * sizeof(struct tmpfs_dirent_s))
+  (sizeof(struct tmpfs_directory_s) + \
+   (n) * (sizeof(FAR struct tmpfs_dirent_s *) + sizeof(struct tmpfs_dirent_s)))
+
+/* One chunk of file data */
+
+struct tmpfs_chunk_s
+{
+  FAR uint8_t *tc_data;  /* Chunk data */
+  bool     tc_first;     /* First chunk of an allocated block */
+};
 
 /* The form of a regular file memory object
  *
@@ -137,6 +170,18 @@ struct tmpfs_directory_s
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * File data is held in fixed size chunks of TMPFS_CHUNKSIZE bytes so that
+ * the file can grow without copying its content and without moving the
+ * file object.  The chunks added by one reallocation are allocated as one
+ * block, so a file that is sized by a single write() or ftruncate() is
+ * contiguous in memory.
+ *
+ * A file whose data lies in one block can be memory mapped in place.  That
+ * block is then the mapped block (tfo_mapbase, tfo_mapchunks) and is
+ * neither moved nor freed while there are mappings (tfo_nmaps), so that
+ * all mappers and read()/write() share the same data.  Other files are
+ * mapped as a private copy by the generic mmap() logic.
  */
 
 struct tmpfs_file_s
@@ -154,10 +199,15 @@ struct tmpfs_file_s
 
   uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
   size_t   tfo_size;     /* Valid file size */
-  uint8_t  tfo_data[1];  /* File data starts here */
+  unsigned int tfo_nchunks;   /* Number of allocated chunks */
+  unsigned int tfo_maxchunks; /* Allocated size of tfo_chunks[] */
+  FAR struct tmpfs_chunk_s *tfo_chunks; /* File data chunks */
+  FAR uint8_t *tfo_mapbase;   /* Contiguous block of mapped chunks */
+  unsigned int tfo_mapchunks; /* Number of chunks in tfo_mapbase */
+  unsigned int tfo_nmaps;     /* Number of active mappings */
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
+#define TMPFS_NCHUNKS(n) (((n) + TMPFS_CHUNKSIZE - 1) / TMPFS_CHUNKSIZE)
 
 /* This structure represents one instance of a TMPFS file system */
 
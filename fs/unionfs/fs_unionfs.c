@@ -75,6 +75,22 @@
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 #define MAX(a,b) (((a) > (b)) ? (a) : (b))
 
+/* Configuration */
+
+#ifndef CONFIG_FS_UNIONFS_NLOOKUP
+#  define CONFIG_FS_UNIONFS_NLOOKUP 32
+#endif
+
+/* Lookup cache value meaning that a path exists on neither file system */
+
+#define UNIONFS_NOENT    2
+
+/* Number of hash buckets in the set of names seen on file system 1 while
+ * a directory is being enumerated.
+ */
+
+#define UNIONFS_NBUCKETS 32
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -86,6 +102,17 @@ struct unionfs_mountpt_s
   FAR char *um_prefix;               /* Path prefix to filesystem */
 };
 
+#if CONFIG_FS_UNIONFS_NLOOKUP > 0
+/* This structure records which file system owns a relative path */
+
+struct unionfs_lookup_s
+{
+  FAR char *ul_path;                 /* Relative path (NULL: unused) */
+  uint32_t ul_hash;                  /* Hash of ul_path */
+  uint8_t ul_ndx;                    /* 0, 1, or UNIONFS_NOENT */
+};
+#endif
+
 /* This structure describes the union file system */
 
 struct unionfs_inode_s
@@ -94,6 +121,27 @@ struct unionfs_inode_s
   sem_t ui_exclsem;                  /* Enforces mutually exclusive access */
   int16_t ui_nopen;                  /* Number of open references */
   bool ui_unmounted;                 /* File system has been unmounted */
+#if CONFIG_FS_UNIONFS_NLOOKUP > 0
+  struct unionfs_lookup_s ui_lookup[CONFIG_FS_UNIONFS_NLOOKUP];
+#endif
+};
+
+/* One name in the set of names seen on file system 1 */
+
+struct unionfs_name_s
+{
+  FAR struct unionfs_name_s *un_flink; /* Next name in the hash bucket */
+  uint32_t un_hash;                  /* Hash of the name */
+  char un_name[1];                   /* The name (variable length) */
+};
+
+/* The set of names seen on file system 1 during a directory enumeration.
+ * Entries on file system 2 with these names are occluded.
+ */
+
+struct unionfs_names_s
+{
+  FAR struct unionfs_name_s *un_bucket[UNIONFS_NBUCKETS];
 };
 
 /* This structure descries one opened file */
@@ -119,6 +167,9 @@ static bool    unionfs_ispartprefix(FAR const char *partprefix,
 static int     unionfs_tryopen(FAR struct file *filep,
                  FAR const char *relpath, FAR const char *prefix, int oflags,
                  mode_t mode);
+static int     unionfs_tryopen_ndx(FAR struct unionfs_inode_s *ui,
+                 FAR struct unionfs_file_s *uf, FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode, int ndx);
 static int     unionfs_tryopendir(FAR struct inode *inode,
                  FAR const char *relpath, FAR const char *prefix,
                  FAR struct fs_dirent_s *dir);
@@ -141,6 +192,23 @@ static int     unionfs_trystatfile(FAR struct inode *inode,
                  FAR const char *relpath, FAR const char *prefix);
 static FAR char *unionfs_relpath(FAR const char *path,
                  FAR const char *name);
+static uint32_t unionfs_hash(FAR const char *name);
+#if CONFIG_FS_UNIONFS_NLOOKUP > 0
+static int     unionfs_lookup(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath);
+static void    unionfs_remember(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath, int ndx);
+static void    unionfs_forget(FAR struct unionfs_inode_s *ui);
+#else
+#  define      unionfs_lookup(ui,relpath) (-ENOENT)
+#  define      unionfs_remember(ui,relpath,ndx)
+#  define      unionfs_forget(ui)
+#endif
+static bool    unionfs_hasname(FAR struct unionfs_names_s *names,
+                 FAR const char *name);
+static void    unionfs_addname(FAR struct unionfs_names_s *names,
+                 FAR const char *name);
+static void    unionfs_freenames(FAR struct unionfs_names_s *names);
 
 static int     unionfs_unbind_child(FAR struct unionfs_mountpt_s *um);
 static void    unionfs_destroy(FAR struct unionfs_inode_s *ui);
@@ -733,6 +801,197 @@ static FAR char *unionfs_relpath(FAR const char *path, FAR const char *name)
     }
 }
 
+/****************************************************************************
+ * Name: unionfs_hash
+ ****************************************************************************/
+
+static uint32_t unionfs_hash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  /* 32-bit FNV-1a */
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+#if CONFIG_FS_UNIONFS_NLOOKUP > 0
+/****************************************************************************
+ * Name: unionfs_lookup
+ *
+ * Description:
+ *   Return the index of the file system that owns 'relpath' (0 or 1),
+ *   UNIONFS_NOENT if the path is known to exist on neither, or -ENOENT if
+ *   nothing is known about the path.
+ *
+ ****************************************************************************/
+
+static int unionfs_lookup(FAR struct unionfs_inode_s *ui,
+                          FAR const char *relpath)
+{
+  FAR struct unionfs_lookup_s *ul;
+  uint32_t hash;
+
+  hash = unionfs_hash(relpath);
+  ul   = &ui->ui_lookup[hash % CONFIG_FS_UNIONFS_NLOOKUP];
+
+  if (ul->ul_path != NULL && ul->ul_hash == hash &&
+      strcmp(ul->ul_path, relpath) == 0)
+    {
+      return ul->ul_ndx;
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: unionfs_remember
+ *
+ * Description:
+ *   Record which file system owns 'relpath'.  The cache is direct-mapped;
+ *   any previous path in the same slot is replaced.
+ *
+ ****************************************************************************/
+
+static void unionfs_remember(FAR struct unionfs_inode_s *ui,
+                             FAR const char *relpath, int ndx)
+{
+  FAR struct unionfs_lookup_s *ul;
+  uint32_t hash;
+
+  hash = unionfs_hash(relpath);
+  ul   = &ui->ui_lookup[hash % CONFIG_FS_UNIONFS_NLOOKUP];
+
+  if (ul->ul_path == NULL || ul->ul_hash != hash ||
+      strcmp(ul->ul_path, relpath) != 0)
+    {
+      if (ul->ul_path != NULL)
+        {
+          kmm_free(ul->ul_path);
+        }
+
+      ul->ul_path = strdup(relpath);
+      if (ul->ul_path == NULL)
+        {
+          return;
+        }
+
+      ul->ul_hash = hash;
+    }
+
+  ul->ul_ndx = ndx;
+}
+
+/****************************************************************************
+ * Name: unionfs_forget
+ *
+ * Description:
+ *   Discard the whole lookup cache.  This is done whenever a path is
+ *   created, removed or renamed through the union.
+ *
+ ****************************************************************************/
+
+static void unionfs_forget(FAR struct unionfs_inode_s *ui)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_NLOOKUP; i++)
+    {
+      if (ui->ui_lookup[i].ul_path != NULL)
+        {
+          kmm_free(ui->ui_lookup[i].ul_path);
+          ui->ui_lookup[i].ul_path = NULL;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_hasname
+ ****************************************************************************/
+
+static bool unionfs_hasname(FAR struct unionfs_names_s *names,
+                            FAR const char *name)
+{
+  FAR struct unionfs_name_s *un;
+  uint32_t hash = unionfs_hash(name);
+
+  for (un = names->un_bucket[hash % UNIONFS_NBUCKETS];
+       un != NULL;
+       un = un->un_flink)
+    {
+      if (un->un_hash == hash && strcmp(un->un_name, name) == 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: unionfs_addname
+ *
+ * Description:
+ *   Add a name to the set.  A name that cannot be added (out of memory)
+ *   is simply not occluded on file system 2.
+ *
+ ****************************************************************************/
+
+static void unionfs_addname(FAR struct unionfs_names_s *names,
+                            FAR const char *name)
+{
+  FAR struct unionfs_name_s *un;
+  uint32_t hash;
+  int ndx;
+
+  if (unionfs_hasname(names, name))
+    {
+      return;
+    }
+
+  un = (FAR struct unionfs_name_s *)
+    kmm_malloc(sizeof(struct unionfs_name_s) + strlen(name));
+  if (un == NULL)
+    {
+      return;
+    }
+
+  hash          = unionfs_hash(name);
+  ndx           = hash % UNIONFS_NBUCKETS;
+  un->un_hash   = hash;
+  strcpy(un->un_name, name);
+  un->un_flink  = names->un_bucket[ndx];
+  names->un_bucket[ndx] = un;
+}
+
+/****************************************************************************
+ * Name: unionfs_freenames
+ ****************************************************************************/
+
+static void unionfs_freenames(FAR struct unionfs_names_s *names)
+{
+  FAR struct unionfs_name_s *un;
+  FAR struct unionfs_name_s *next;
+  int i;
+
+  for (i = 0; i < UNIONFS_NBUCKETS; i++)
+    {
+      for (un = names->un_bucket[i]; un != NULL; un = next)
+        {
+          next = un->un_flink;
+          kmm_free(un);
+        }
+    }
+
+  kmm_free(names);
+}
+
 /****************************************************************************
  * Name: unionfs_unbind_child
  ****************************************************************************/
@@ -824,12 +1083,44 @@ static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
       kmm_free(ui->ui_fs[1].um_prefix);
     }
 
+  /* Free the lookup cache */
+
+  unionfs_forget(ui);
+
   /* And finally free the allocated unionfs state structure as well */
 
   nxsem_destroy(&ui->ui_exclsem);
   kmm_free(ui);
 }
 
+/****************************************************************************
+ * Name: unionfs_tryopen_ndx
+ *
+ * Description:
+ *   Try to open the file on one of the contained file systems.
+ *
+ ****************************************************************************/
+
+static int unionfs_tryopen_ndx(FAR struct unionfs_inode_s *ui,
+                               FAR struct unionfs_file_s *uf,
+                               FAR struct file *filep,
+                               FAR const char *relpath, int oflags,
+                               mode_t mode, int ndx)
+{
+  FAR struct unionfs_mountpt_s *um;
+
+  um = &ui->ui_fs[ndx];
+  DEBUGASSERT(um != NULL && um->um_node != NULL && um->um_node->u.i_mops != NULL);
+
+  uf->uf_file.f_oflags = filep->f_oflags;
+  uf->uf_file.f_pos    = 0;
+  uf->uf_file.f_inode  = um->um_node;
+  uf->uf_file.f_priv   = NULL;
+  uf->uf_ndx           = ndx;
+
+  return unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
+}
+
 /****************************************************************************
  * Name: unionfs_open
  ****************************************************************************/
@@ -839,7 +1130,8 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_file_s *uf;
-  FAR struct unionfs_mountpt_s *um;
+  int ndx;
+  int ret0;
   int ret;
 
   /* Recover the open file data from the struct file instance */
@@ -866,45 +1158,69 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_semaphore;
     }
 
-  /* Try to open the file on file system 1 */
+  /* If the file is not being created, the lookup cache may tell us where
+   * it lives without probing file system 1 first.
+   */
 
-  um = &ui->ui_fs[0];
-  DEBUGASSERT(um != NULL && um->um_node != NULL && um->um_node->u.i_mops != NULL);
+  if ((oflags & O_CREAT) == 0)
+    {
+      ndx = unionfs_lookup(ui, relpath);
+      if (ndx == UNIONFS_NOENT)
+        {
+          ret = -ENOENT;
+          goto errout_with_uf;
+        }
+      else if (ndx >= 0)
+        {
+          ret = unionfs_tryopen_ndx(ui, uf, filep, relpath, oflags, mode,
+                                    ndx);
+          if (ret >= 0)
+            {
+              goto opened;
+            }
+        }
+    }
+  else
+    {
+      /* The file may be created */
 
-  uf->uf_file.f_oflags = filep->f_oflags;
-  uf->uf_file.f_pos    = 0;
-  uf->uf_file.f_inode  = um->um_node;
-  uf->uf_file.f_priv   = NULL;
+      unionfs_forget(ui);
+    }
 
-  ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
-  if (ret >= 0)
+  /* Try to open the file on file system 1 */
+
+  ret0 = unionfs_tryopen_ndx(ui, uf, filep, relpath, oflags, mode, 0);
+  if (ret0 >= 0)
     {
       /* Successfully opened on file system 1 */
 
-      uf->uf_ndx = 0;
+      ndx = 0;
     }
   else
     {
-      /* Try to open the file on file system 1 */
-
-      um  = &ui->ui_fs[1];
+      /* Try to open the file on file system 2 */
 
-      uf->uf_file.f_oflags = filep->f_oflags;
-      uf->uf_file.f_pos    = 0;
-      uf->uf_file.f_inode  = um->um_node;
-      uf->uf_file.f_priv   = NULL;
-
-      ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
+      ret = unionfs_tryopen_ndx(ui, uf, filep, relpath, oflags, mode, 1);
       if (ret < 0)
         {
-          goto errout_with_semaphore;
+          goto errout_with_uf;
         }
 
-      /* Successfully opened on file system 1 */
+      /* Successfully opened on file system 2 */
 
-      uf->uf_ndx = 1;
+      ndx = 1;
     }
 
+  /* Remember the owner unless file system 1 failed for some reason other
+   * than the file not being there.
+   */
+
+  if (ndx == 0 || ret0 == -ENOENT)
+    {
+      unionfs_remember(ui, relpath, ndx);
+    }
+
+opened:
   /* Increment the open reference count */
 
   ui->ui_nopen++;
@@ -913,7 +1229,11 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   /* Save our private data in the file structure */
 
   filep->f_priv = (FAR void *)uf;
-  ret = OK;
+  unionfs_semgive(ui);
+  return OK;
+
+errout_with_uf:
+  kmm_free(uf);
 
 errout_with_semaphore:
   unionfs_semgive(ui);
@@ -1550,6 +1870,19 @@ static int unionfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
         }
     }
 
+  /* If the directory exists on both file systems, then the names seen on
+   * file system 1 are collected as it is enumerated.  Those names are then
+   * omitted when file system 2 is enumerated.  If the allocation fails,
+   * each file system 2 entry is checked with stat() instead.
+   */
+
+  fu->fu_names = NULL;
+  if (fu->fu_lower[0] != NULL && fu->fu_lower[1] != NULL)
+    {
+      fu->fu_names = (FAR struct unionfs_names_s *)
+        kmm_zalloc(sizeof(struct unionfs_names_s));
+    }
+
   /* Increment the number of open references and return success */
 
   ui->ui_nopen++;
@@ -1633,13 +1966,19 @@ static int unionfs_closedir(FAR struct inode *mountpt,
         }
     }
 
-  /* Free any allocated path */
+  /* Free any allocated path and name set */
 
   if (fu->fu_relpath != NULL)
     {
       kmm_free(fu->fu_relpath);
     }
 
+  if (fu->fu_names != NULL)
+    {
+      unionfs_freenames(fu->fu_names);
+      fu->fu_names = NULL;
+    }
+
   fu->fu_ndx      = 0;
   fu->fu_relpath  = NULL;
   fu->fu_lower[0] = NULL;
@@ -1867,7 +2206,24 @@ static int unionfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
            */
 
           duplicate = false;
-          if (ret >= 0 && fu->fu_ndx == 1 && fu->fu_lower[0] != NULL)
+          if (ret >= 0 && fu->fu_names != NULL)
+            {
+              FAR const char *name = fu->fu_lower[fu->fu_ndx]->fd_dir.d_name;
+
+              if (fu->fu_ndx == 0)
+                {
+                  /* Remember the names on file system 1 */
+
+                  unionfs_addname(fu->fu_names, name);
+                }
+              else
+                {
+                  /* Omit names already reported from file system 1 */
+
+                  duplicate = unionfs_hasname(fu->fu_names, name);
+                }
+            }
+          else if (ret >= 0 && fu->fu_ndx == 1 && fu->fu_lower[0] != NULL)
             {
               /* Get the relative path to the same file on file system 1.
                * NOTE: the on any failures we just assume that the filep
@@ -2226,6 +2582,7 @@ static int unionfs_unlink(FAR struct inode *mountpt,
         }
     }
 
+  unionfs_forget(ui);
   unionfs_semgive(ui);
   return ret;
 }
@@ -2302,6 +2659,7 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
     }
 
 errout_with_semaphore:
+  unionfs_forget(ui);
   unionfs_semgive(ui);
   return ret;
 }
@@ -2351,6 +2709,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
       ret = unionfs_tryrmdir(um->um_node, relpath, um->um_prefix);
       if (ret < 0)
         {
+          unionfs_forget(ui);
           unionfs_semgive(ui);
           return ret;
         }
@@ -2375,6 +2734,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
        */
     }
 
+  unionfs_forget(ui);
   unionfs_semgive(ui);
   return ret;
 }
@@ -2429,6 +2789,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
            * file of the same relative path will become visible.
            */
 
+          unionfs_forget(ui);
           unionfs_semgive(ui);
           return OK;
         }
@@ -2451,6 +2812,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
                               um->um_prefix);
     }
 
+  unionfs_forget(ui);
   unionfs_semgive(ui);
   return ret;
 }
@@ -2464,6 +2826,8 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
+  int ndx;
+  int ret0;
   int ret;
 
   finfo("relpath: %s\n", relpath);
@@ -2481,32 +2845,70 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
       return ret;
     }
 
-  /* stat this path on file system 1 */
+  /* Check if the file system that owns this path is already known */
 
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
-  if (ret >= 0)
+  ndx = unionfs_lookup(ui, relpath);
+  if (ndx == 0 || ndx == 1)
     {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
+      um  = &ui->ui_fs[ndx];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret >= 0)
+        {
+          unionfs_semgive(ui);
+          return OK;
+        }
 
-      unionfs_semgive(ui);
-      return OK;
-    }
+      /* The cached information is stale */
 
-  /* stat failed on the file system 1.  Try again on file system 2. */
+      ndx = -ENOENT;
+    }
 
-  um  = &ui->ui_fs[1];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
-  if (ret >= 0)
+  if (ndx != UNIONFS_NOENT)
     {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
+      /* stat this path on file system 1 */
 
-      unionfs_semgive(ui);
-      return OK;
+      um   = &ui->ui_fs[0];
+      ret0 = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret0 >= 0)
+        {
+          /* Return on the first success.  The first instance of the file
+           * will shadow the second anyway.
+           */
+
+          unionfs_remember(ui, relpath, 0);
+          unionfs_semgive(ui);
+          return OK;
+        }
+
+      /* stat failed on the file system 1.  Try again on file system 2. */
+
+      um  = &ui->ui_fs[1];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret >= 0)
+        {
+          /* Return on the first success.  The first instance of the file
+           * will shadow the second anyway.
+           */
+
+          if (ret0 == -ENOENT)
+            {
+              unionfs_remember(ui, relpath, 1);
+            }
+
+          unionfs_semgive(ui);
+          return OK;
+        }
+
+      /* Remember that the path exists on neither file system */
+
+      if (ret0 == -ENOENT && ret == -ENOENT)
+        {
+          unionfs_remember(ui, relpath, UNIONFS_NOENT);
+        }
+    }
+  else
+    {
+      ret = -ENOENT;
     }
 
   /* Special case the unionfs root directory when both file systems are offset.
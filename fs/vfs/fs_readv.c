@@ -0,0 +1,249 @@
+/****************************************************************************
+ * fs/vfs/fs_readv.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_readv
+ *
+ * Description:
+ *   file_readv() is an internal OS interface.  It is functionally similar to
+ *   the standard readv() interface except:
+ *
+ *    - It does not modify the errno variable,
+ *    - It is not a cancellation point,
+ *    - It does not handle socket descriptors, and
+ *    - It accepts a file structure instance instead of file descriptor.
+ *
+ *   If the driver provides a readv method, the whole request is passed to
+ *   the driver in one call.  Otherwise, each buffer is filled in turn with
+ *   the read method until a short read occurs.
+ *
+ * Input Parameters:
+ *   filep  - File structure instance
+ *   iov    - Array of read buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   The number of bytes read on success, 0 on if an end-of-file condition,
+ *   or a negated errno value on any failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt)
+{
+  FAR struct inode *inode;
+  ssize_t ntotal;
+  ssize_t nread;
+  int i;
+
+  DEBUGASSERT(filep);
+  inode = filep->f_inode;
+
+  /* Was this file opened for read access? */
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EACCES;
+    }
+
+  /* Is a driver registered?  Mountpoint operations do not include the
+   * vectored methods.
+   */
+
+  if (inode == NULL || inode->u.i_ops == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (INODE_IS_DRIVER(inode) && inode->u.i_ops->readv != NULL)
+    {
+      return inode->u.i_ops->readv(filep, iov, iovcnt);
+    }
+
+  /* Otherwise, fill each buffer in turn */
+
+  for (i = 0, ntotal = 0; i < iovcnt; i++)
+    {
+      /* Ignore zero-length reads */
+
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nread = file_read(filep, iov[i].iov_base, iov[i].iov_len);
+      if (nread < 0)
+        {
+          /* Report the error only if nothing has been read yet */
+
+          return ntotal > 0 ? ntotal : nread;
+        }
+
+      ntotal += nread;
+
+      /* Stop on a short read (or end of file) */
+
+      if ((size_t)nread < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return ntotal;
+}
+#endif
+
+/****************************************************************************
+ * Name: readv()
+ *
+ * Description:
+ *   The readv() function is equivalent to read(), except as described below.
+ *   The readv() function places the input data into the iovcnt buffers
+ *   specified by the members of the iov array: iov[0], iov[1], ...,
+ *   iov[iovcnt-1].  The iovcnt argument is valid if greater than 0 and less
+ *   than or equal to IOV_MAX as defined in limits.h.
+ *
+ *   Each iovec entry specifies the base address and length of an area in
+ *   memory where data should be placed.  The readv() function will always
+ *   fill an area completely before proceeding to the next.
+ *
+ *   Upon successful completion, readv() will mark for update the st_atime
+ *   field of the file.
+ *
+ * Input Parameters:
+ *   filedes - The open file descriptor for the file to be read
+ *   iov     - Array of read buffer descriptors
+ *   iovcnt  - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   Upon successful completion, readv() will return a non-negative integer
+ *   indicating the number of bytes actually read.  Otherwise, the functions
+ *   will return -1 and set errno to indicate the error.  See read().
+ *
+ ****************************************************************************/
+
+ssize_t readv(int fildes, FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t ret;
+
+  /* readv() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  if (iov == NULL || iovcnt <= 0 || iovcnt > IOV_MAX)
+    {
+      ret = -EINVAL;
+    }
+
+  /* Did we get a valid file descriptor? */
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  else if ((unsigned int)fildes >= CONFIG_NFILE_DESCRIPTORS)
+#else
+  else
+#endif
+    {
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+      /* No.. If networking is enabled, readv() is the same as recvmsg()
+       * with the flags parameter set to zero.
+       */
+
+      struct msghdr msg;
+
+      memset(&msg, 0, sizeof(struct msghdr));
+      msg.msg_iov    = (FAR struct iovec *)iov;
+      msg.msg_iovlen = iovcnt;
+
+      ret = psock_recvmsg(sockfd_socket(fildes), &msg, 0);
+#else
+      /* No networking... it is a bad descriptor in any event */
+
+      ret = -EBADF;
+#endif
+    }
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  else
+    {
+      FAR struct file *filep;
+
+      /* The descriptor is in a valid range to file descriptor... do the
+       * read.  First, get the file structure.
+       */
+
+      ret = (ssize_t)fs_getfilep(fildes, &filep);
+      if (ret >= 0)
+        {
+          /* Then let file_readv do all of the work. */
+
+          ret = file_readv(filep, iov, iovcnt);
+        }
+    }
+#endif
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
@@ -67,6 +67,9 @@
  *   If the destination descriptor is a socket, it gives a better
  *   performance than simple reds() and writes(). The data is read directly
  *   into the net buffer and the whole tcp window is filled if possible.
+ *   If the file system can expose the file data in place (FIOC_MMAP), the
+ *   data is copied straight from the file system storage into the
+ *   outgoing packets.
  *
  *   NOTE: This interface is *not* specified in POSIX.1-2001, or other
  *   standards.  The implementation here is very similar to the Linux
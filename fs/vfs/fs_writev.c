@@ -1,5 +1,5 @@
 /****************************************************************************
- * libc/stdio/lib_writev.c
+ * fs/vfs/fs_writev.c
  *
  *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
@@ -37,15 +37,119 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/types.h>
+#include <sys/socket.h>
 #include <sys/uio.h>
+#include <limits.h>
+#include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
 
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: file_writev
+ *
+ * Description:
+ *   file_writev() is an internal OS interface.  It is functionally similar to
+ *   the standard writev() interface except:
+ *
+ *    - It does not modify the errno variable,
+ *    - It is not a cancellation point,
+ *    - It does not handle socket descriptors, and
+ *    - It accepts a file structure instance instead of file descriptor.
+ *
+ *   If the driver provides a writev method, the whole request is passed to
+ *   the driver in one call.  Otherwise, each buffer is written in turn with
+ *   the write method until a short write occurs.
+ *
+ * Input Parameters:
+ *   filep  - File structure instance
+ *   iov    - Array of write buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   The number of bytes written on success or a negated errno value on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt)
+{
+  FAR struct inode *inode;
+  ssize_t ntotal;
+  ssize_t nwritten;
+  int i;
+
+  DEBUGASSERT(filep);
+  inode = filep->f_inode;
+
+  /* Was this file opened for write access? */
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  /* Is a driver registered?  Mountpoint operations do not include the
+   * vectored methods.
+   */
+
+  if (inode == NULL || inode->u.i_ops == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (INODE_IS_DRIVER(inode) && inode->u.i_ops->writev != NULL)
+    {
+      return inode->u.i_ops->writev(filep, iov, iovcnt);
+    }
+
+  /* Otherwise, write each buffer in turn */
+
+  for (i = 0, ntotal = 0; i < iovcnt; i++)
+    {
+      /* Ignore zero-length writes */
+
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nwritten = file_write(filep, iov[i].iov_base, iov[i].iov_len);
+      if (nwritten < 0)
+        {
+          /* Report the error only if nothing has been written yet */
+
+          return ntotal > 0 ? ntotal : nwritten;
+        }
+
+      ntotal += nwritten;
+
+      /* Stop on a short write */
+
+      if ((size_t)nwritten < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return ntotal;
+}
+#endif
+
 /****************************************************************************
  * Name: writev()
  *
@@ -68,8 +172,8 @@
  *   operation will fail and no data will be transferred.
  *
  * Input Parameters:
- *   filedes - The open file descriptor for the file to be read
- *   iov     - Array of read buffer descriptors
+ *   filedes - The open file descriptor for the file to be written
+ *   iov     - Array of write buffer descriptors
  *   iovcnt  - Number of elements in iov[]
  *
  * Returned Value:
@@ -82,69 +186,69 @@
 
 ssize_t writev(int fildes, FAR const struct iovec *iov, int iovcnt)
 {
-  ssize_t ntotal;
-  ssize_t nwritten;
-  size_t remaining;
-  FAR uint8_t *buffer;
-  off_t pos;
-  int i;
+  ssize_t ret;
+
+  /* writev() is a cancellation point */
 
-  /* Get the current file position in case we have to reset it */
+  (void)enter_cancellation_point();
 
-  pos = lseek(fildes, 0, SEEK_CUR);
-  if (pos == (off_t)-1)
+  if (iov == NULL || iovcnt <= 0 || iovcnt > IOV_MAX)
     {
-      return ERROR;
+      ret = -EINVAL;
     }
 
-  /* Process each entry in the struct iovec array */
+  /* Did we get a valid file descriptor? */
 
-  for (i = 0, ntotal = 0; i < iovcnt; i++)
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  else if ((unsigned int)fildes >= CONFIG_NFILE_DESCRIPTORS)
+#else
+  else
+#endif
     {
-      /* Ignore zero-length writes */
-
-      if (iov[i].iov_len > 0)
-        {
-          buffer    = iov[i].iov_base;
-          remaining = iov[i].iov_len;
-
-          /* Write repeatedly as necessary to write the entire buffer */
-
-          do
-            {
-              /* NOTE:  write() is a cancellation point */
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+      /* No.. If networking is enabled, writev() is the same as sendmsg()
+       * with the flags parameter set to zero.
+       */
 
-              nwritten = write(fildes, buffer, remaining);
+      struct msghdr msg;
 
-              /* Check for a write error */
+      memset(&msg, 0, sizeof(struct msghdr));
+      msg.msg_iov    = (FAR struct iovec *)iov;
+      msg.msg_iovlen = iovcnt;
 
-              if (nwritten < 0)
-                {
-                  /* Save the errno value */
+      ret = psock_sendmsg(sockfd_socket(fildes), &msg, 0);
+#else
+      /* No networking... it is a bad descriptor in any event */
 
-                  int save = get_errno();
-
-                  /* Restore the file position */
-
-                  (void)lseek(fildes, pos, SEEK_SET);
+      ret = -EBADF;
+#endif
+    }
 
-                  /* Restore the errno value */
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  else
+    {
+      FAR struct file *filep;
 
-                  set_errno(save);
-                  return ERROR;
-                }
+      /* The descriptor is in a valid range to file descriptor... do the
+       * write.  First, get the file structure.
+       */
 
-              /* Update pointers and counts in order to handle partial
-               * buffer writes.
-               */
+      ret = (ssize_t)fs_getfilep(fildes, &filep);
+      if (ret >= 0)
+        {
+          /* Then let file_writev do all of the work. */
 
-              buffer    += nwritten;
-              remaining -= nwritten;
-              ntotal    += nwritten;
-            }
-          while (remaining > 0);
+          ret = file_writev(filep, iov, iovcnt);
         }
     }
+#endif
 
-  return ntotal;
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
 }
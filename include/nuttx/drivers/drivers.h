@@ -45,6 +45,23 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Argument of the PIPEIOC_SPLICE ioctl command.  Up to ps_len bytes are
+ * taken from the pipe's buffer and written directly to the file or socket
+ * descriptor ps_fd.
+ */
+
+#if defined(CONFIG_PIPES)
+struct pipe_splice_s
+{
+  int    ps_fd;      /* Destination file or socket descriptor */
+  size_t ps_len;     /* Maximum number of bytes to move */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
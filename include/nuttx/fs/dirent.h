@@ -167,6 +167,7 @@ struct fs_smartfsdir_s
  */
 
 struct fs_dirent_s;                           /* Forward reference */
+struct unionfs_names_s;                       /* Forward reference */
 struct fs_unionfsdir_s
 {
   uint8_t fu_ndx;                             /* Index of file system being enumerated */
@@ -174,6 +175,7 @@ struct fs_unionfsdir_s
   bool fu_prefix[2];                          /* True: Fake directory in prefix */
   FAR char *fu_relpath;                       /* Path being enumerated */
   FAR struct fs_dirent_s *fu_lower[2];        /* dirent struct used by contained file system */
+  FAR struct unionfs_names_s *fu_names;       /* Names seen on file system 1 */
 };
 #endif
 
@@ -196,6 +198,9 @@ struct fs_userfsdir_s
 struct fs_hostfsdir_s
 {
   FAR void *fs_dir;                           /* Opaque pointer to host DIR */
+  FAR struct dirent *fs_ents;                 /* Entries fetched from the host */
+  uint16_t fs_nents;                          /* Number of valid entries */
+  uint16_t fs_index;                          /* Index of the next entry */
 };
 #endif
 
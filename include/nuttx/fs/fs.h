@@ -196,6 +196,7 @@
 struct file;   /* Forward reference */
 struct pollfd; /* Forward reference */
 struct inode;  /* Forward reference */
+struct iovec;  /* Forward reference */
 
 struct file_operations
 {
@@ -222,6 +223,16 @@ struct file_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   int     (*unlink)(FAR struct inode *inode);
 #endif
+
+  /* Optional scatter/gather methods.  If a driver does not provide these,
+   * readv() and writev() fall back to a sequence of read() or write()
+   * calls.
+   */
+
+  ssize_t (*readv)(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt);
+  ssize_t (*writev)(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt);
 };
 
 /* This structure provides information about the state of a block driver */
@@ -927,6 +938,26 @@ ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes);
 
 ssize_t nx_read(int fd, FAR void *buf, size_t nbytes);
 
+/****************************************************************************
+ * Name: file_readv
+ *
+ * Description:
+ *   Equivalent to the standard readv() function except that is accepts a
+ *   struct file instance instead of a file descriptor, does not modify the
+ *   errno variable, and is not a cancellation point.  Drivers that do not
+ *   provide a readv method are read one buffer at a time.
+ *
+ * Returned Value:
+ *   The number of bytes read on success, 0 on if an end-of-file condition,
+ *   or a negated errno value on any failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt);
+#endif
+
 /****************************************************************************
  * Name: file_write
  *
@@ -941,6 +972,26 @@ ssize_t nx_read(int fd, FAR void *buf, size_t nbytes);
 ssize_t file_write(FAR struct file *filep, FAR const void *buf, size_t nbytes);
 #endif
 
+/****************************************************************************
+ * Name: file_writev
+ *
+ * Description:
+ *   Equivalent to the standard writev() function except that is accepts a
+ *   struct file instance instead of a file descriptor, does not modify the
+ *   errno variable, and is not a cancellation point.  Drivers that do not
+ *   provide a writev method are written one buffer at a time.
+ *
+ * Returned Value:
+ *   The number of bytes written on success or a negated errno value on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt);
+#endif
+
 /****************************************************************************
  * Name: nx_write
  *
@@ -151,11 +151,19 @@ struct nuttx_stat_s
  * Public Function Prototypes
  ****************************************************************************/
 
+/* On failure, these functions return a negated errno value (host_opendir()
+ * returns NULL).
+ */
+
 #ifdef __SIM__
 int           host_open(const char *pathname, int flags, int mode);
 int           host_close(int fd);
 ssize_t       host_read(int fd, void *buf, nuttx_size_t count);
 ssize_t       host_write(int fd, const void *buf, nuttx_size_t count);
+ssize_t       host_pread(int fd, void *buf, nuttx_size_t count,
+                         nuttx_off_t offset);
+ssize_t       host_pwrite(int fd, const void *buf, nuttx_size_t count,
+                          nuttx_off_t offset);
 off_t         host_lseek(int fd, off_t offset, int whence);
 int           host_ioctl(int fd, int request, unsigned long arg);
 void          host_sync(int fd);
@@ -163,6 +171,8 @@ int           host_dup(int fd);
 int           host_fstat(int fd, struct nuttx_stat_s *buf);
 void         *host_opendir(const char *name);
 int           host_readdir(void* dirp, struct nuttx_dirent_s* entry);
+int           host_readdirv(void *dirp, struct nuttx_dirent_s *entries,
+                            int nentries);
 void          host_rewinddir(void* dirp);
 int           host_closedir(void* dirp);
 int           host_statfs(const char *path, struct nuttx_statfs_s *buf);
@@ -176,6 +186,9 @@ int           host_open(const char *pathname, int flags, int mode);
 int           host_close(int fd);
 ssize_t       host_read(int fd, void *buf, size_t count);
 ssize_t       host_write(int fd, const void *buf, size_t count);
+ssize_t       host_pread(int fd, void *buf, size_t count, off_t offset);
+ssize_t       host_pwrite(int fd, const void *buf, size_t count,
+                          off_t offset);
 off_t         host_lseek(int fd, off_t offset, int whence);
 int           host_ioctl(int fd, int request, unsigned long arg);
 void          host_sync(int fd);
@@ -183,6 +196,8 @@ int           host_dup(int fd);
 int           host_fstat(int fd, struct stat *buf);
 void         *host_opendir(const char *name);
 int           host_readdir(void* dirp, struct dirent *entry);
+int           host_readdirv(void *dirp, struct dirent *entries,
+                            int nentries);
 void          host_rewinddir(void* dirp);
 int           host_closedir(void* dirp);
 int           host_statfs(const char *path, struct statfs *buf);
@@ -156,6 +156,14 @@
                                            * OUT: Instance number is returned on
                                            *      success.
                                            */
+#define FIOC_PACKSTATS  _FIOC(0x0009)     /* IN:  Pointer to struct nxffs_packstats_s
+                                           *      in which to return statistics.
+                                           * OUT: File system packing statistics.
+                                           */
+#define FIOC_MUNMAP     _FIOC(0x000a)     /* IN:  None
+                                           * OUT: None.  Releases a mapping
+                                           *      obtained with FIOC_MMAP
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -246,6 +254,18 @@
                                            *      to return geometry.
                                            * OUT: Data return in user-provided
                                            *      buffer. */
+#define BIOC_READSECTS  _BIOC(0x000d)     /* Read from a run of consecutive
+                                           * logical sectors.
+                                           * IN:  Pointer to struct
+                                           *      smart_multi_read_write_s
+                                           * OUT: Number of sectors read or
+                                           *      error */
+#define BIOC_WRITESECTS _BIOC(0x000e)     /* Write to a run of consecutive
+                                           * logical sectors.
+                                           * IN:  Pointer to struct
+                                           *      smart_multi_read_write_s
+                                           * OUT: Number of sectors written or
+                                           *      error */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -354,6 +374,11 @@
                                              *       (default)
                                              *     1=fre when empty
                                              * OUT: None */
+#define PIPEIOC_SPLICE    _PIPEIOC(0x0002)  /* Move buffered data to another
+                                             * file or socket descriptor
+                                             * IN: Pointer to struct
+                                             *     pipe_splice_s
+                                             * OUT: Number of bytes moved */
 
 /* RTC driver ioctl definitions *********************************************/
 /* (see nuttx/include/rtc.h */
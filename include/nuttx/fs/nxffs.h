@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #include <nuttx/fs/fs.h>
@@ -110,6 +112,28 @@
 #  endif
 #endif
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Packing statistics as returned by the FIOC_PACKSTATS ioctl command.  Each
+ * incremental pack step moves the packing position toward the end of FLASH;
+ * the erase blocks at the end of FLASH are reclaimed only when the pack
+ * operation finally completes.
+ */
+
+struct nxffs_packstats_s
+{
+  uint32_t npacks;     /* Number of completed pack operations */
+  uint32_t nsteps;     /* Number of incremental (background) pack steps */
+  uint32_t nerased;    /* Number of erase blocks rewritten by packing */
+  uint32_t nreclaimed; /* Number of erase blocks reclaimed at the end of FLASH */
+  off_t    packpos;    /* FLASH offset where a suspended pack will resume
+                        * (zero if no pack is in progress) */
+  off_t    froffset;   /* Offset to the first free byte of FLASH */
+  off_t    volsize;    /* Size of the volume in bytes */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -120,6 +120,20 @@ struct smart_read_write_s
   const uint8_t *buffer;  /* Pointer to the data to write */
 };
 
+/* The following defines a read or write of the same byte range in a run of
+ * consecutive logical sectors (BIOC_READSECTS and BIOC_WRITESECTS).  The
+ * buffer holds nsectors * count bytes, one sector's data after the other.
+ */
+
+struct smart_multi_read_write_s
+{
+  uint16_t logsector;     /* The first logical sector number */
+  uint16_t nsectors;      /* Number of consecutive logical sectors */
+  uint16_t offset;        /* Offset within each sector */
+  uint16_t count;         /* Number of bytes per sector */
+  uint8_t *buffer;        /* Pointer to the data buffer */
+};
+
 /* The following defines the procfs data exchange interface between the
  * SMART MTD and FS layers.
  */
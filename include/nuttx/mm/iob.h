@@ -183,6 +183,52 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_navail
+ *
+ * Description:
+ *   Return the number of free I/O buffers.  If 'throttled' is true, only
+ *   the buffers that a throttled allocation could obtain are counted.
+ *
+ ****************************************************************************/
+
+int iob_navail(bool throttled);
+
+/****************************************************************************
+ * Name: iob_qentry_navail
+ *
+ * Description:
+ *   Return the number of free I/O buffer queue containers.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_NCHAINS > 0
+int iob_qentry_navail(void);
+#endif /* CONFIG_IOB_NCHAINS > 0 */
+
+/****************************************************************************
+ * Name: iob_count
+ *
+ * Description:
+ *   Return the number of I/O buffers in an I/O buffer chain.
+ *
+ ****************************************************************************/
+
+unsigned int iob_count(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_queue_count
+ *
+ * Description:
+ *   Return the number of I/O buffers held by all of the I/O buffer chains
+ *   in a queue.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_NCHAINS > 0
+unsigned int iob_queue_count(FAR struct iob_queue_s *iobq);
+#endif /* CONFIG_IOB_NCHAINS > 0 */
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -141,8 +141,12 @@ typedef uint8_t sockcaps_t;
  * a given address family.
  */
 
-struct socket;  /* Forward reference */
-struct pollfd;  /* Forward reference */
+struct socket;   /* Forward reference */
+struct pollfd;   /* Forward reference */
+struct file;     /* Forward reference */
+struct msghdr;   /* Forward reference */
+struct mmsghdr;  /* Forward reference */
+struct timespec; /* Forward reference */
 
 struct sock_intf_s
 {
@@ -176,6 +180,26 @@ struct sock_intf_s
                     size_t len, int flags, FAR struct sockaddr *from,
                     FAR socklen_t *fromlen);
   CODE int        (*si_close)(FAR struct socket *psock);
+
+  /* Optional scatter/gather methods.  If these are not provided,
+   * sendmsg() and recvmsg() are built on the methods above.
+   */
+
+  CODE ssize_t    (*si_sendmsg)(FAR struct socket *psock,
+                    FAR const struct msghdr *msg, int flags);
+  CODE ssize_t    (*si_recvmsg)(FAR struct socket *psock,
+                    FAR struct msghdr *msg, int flags);
+
+  /* Optional batch methods.  If these are not provided, sendmmsg() and
+   * recvmmsg() call sendmsg() and recvmsg() once for each message.
+   */
+
+  CODE int        (*si_sendmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+  CODE int        (*si_recvmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags, FAR const struct timespec *timeout);
 };
 
 /* This is the internal representation of a socket reference by a file
@@ -856,6 +880,72 @@ ssize_t psock_sendto(FAR struct socket *psock, FAR const void *buf,
                      size_t len, int flags, FAR const struct sockaddr *to,
                      socklen_t tolen);
 
+/****************************************************************************
+ * Name: psock_sendmsg
+ *
+ * Description:
+ *   psock_sendmsg() sends a message gathered from the buffers described by
+ *   msg->msg_iov.  This is an internal OS interface.  It is functionally
+ *   equivalent to sendmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ *   If the address family does not provide an si_sendmsg() method, stream
+ *   sockets send each buffer in turn; datagram sockets gather the buffers
+ *   into one datagram.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - Message to send
+ *   flags - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On any failure, a
+ *   negated errno value is returned (See comments with send() for a list
+ *   of the appropriate errno value).
+ *
+ ****************************************************************************/
+
+ssize_t psock_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
+                      int flags);
+
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends the vlen messages in msgvec[] and sets the
+ *   msg_len field of each message sent to the number of bytes sent.  This
+ *   is an internal OS interface.  It is functionally equivalent to
+ *   sendmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ *   If the address family does not provide an si_sendmmsg() method, the
+ *   messages are sent one at a time with psock_sendmsg().
+ *
+ * Input Parameters:
+ *   psock  - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec - The messages to send
+ *   vlen   - The number of messages in msgvec[]
+ *   flags  - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  This is less than
+ *   vlen if an error occurred after the first message was sent.  If the
+ *   first message could not be sent, a negated errno value is returned
+ *   (See comments with send() for a list of the appropriate errno value).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
 /****************************************************************************
  * Name: psock_recvfrom
  *
@@ -896,6 +986,78 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #define psock_recv(psock,buf,len,flags) \
   psock_recvfrom(psock,buf,len,flags,NULL,0)
 
+/****************************************************************************
+ * Name: psock_recvmsg
+ *
+ * Description:
+ *   psock_recvmsg() receives a message into the buffers described by
+ *   msg->msg_iov.  This is an internal OS interface.  It is functionally
+ *   equivalent to recvmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ *   If the address family does not provide an si_recvmsg() method, the
+ *   data is received with a single psock_recvfrom() into a temporary
+ *   buffer and then scattered over the buffers.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - Buffers to receive the message and, optionally, its source
+ *   flags - Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  If no data is
+ *   available to be received and the peer has performed an orderly
+ *   shutdown, 0 is returned.  Otherwise, on any failure, a negated errno
+ *   value is returned (see comments with recv() for a list of appropriate
+ *   errno values).
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives up to vlen messages into msgvec[] and sets
+ *   the msg_len field of each message received to the number of bytes
+ *   received.  This is an internal OS interface.  It is functionally
+ *   equivalent to recvmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ *   If the address family does not provide an si_recvmmsg() method, the
+ *   messages are received one at a time with psock_recvmsg().
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - Buffers to receive the messages
+ *   vlen    - The number of messages in msgvec[]
+ *   flags   - Receive flags.  With MSG_WAITFORONE, only the first message
+ *             is waited for.
+ *   timeout - If not NULL, no further message is received once this much
+ *             time has elapsed.  As on Linux, this is only checked after
+ *             each message is received.
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  If the first
+ *   message could not be received, a negated errno value is returned (see
+ *   comments with recv() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: nx_recvfrom
  *
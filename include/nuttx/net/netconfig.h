@@ -617,6 +617,28 @@
 #  endif
 #endif
 
+/* Default limits on the data buffered by a socket (bytes of I/O buffer
+ * storage).  Zero means no limit.
+ */
+
+#ifndef CONFIG_NET_RECV_BUFSIZE
+#  define CONFIG_NET_RECV_BUFSIZE 0
+#endif
+
+#ifndef CONFIG_NET_SEND_BUFSIZE
+#  define CONFIG_NET_SEND_BUFSIZE 0
+#endif
+
+/* I/O buffers that the read-ahead of one protocol leaves for the other */
+
+#ifndef CONFIG_NET_TCP_RECV_RESERVE
+#  define CONFIG_NET_TCP_RECV_RESERVE 0
+#endif
+
+#ifndef CONFIG_NET_UDP_RECV_RESERVE
+#  define CONFIG_NET_UDP_RECV_RESERVE 0
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
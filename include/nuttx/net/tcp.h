@@ -76,8 +76,18 @@
 #define TCP_OPT_END       0   /* End of TCP options list */
 #define TCP_OPT_NOOP      1   /* "No-operation" TCP option */
 #define TCP_OPT_MSS       2   /* Maximum segment size TCP option */
+#define TCP_OPT_WS        3   /* Window scale option */
+#define TCP_OPT_SACK_PERM 4   /* Selective acknowledgement permitted option */
+#define TCP_OPT_SACK      5   /* Selective acknowledgement option */
+#define TCP_OPT_TS        8   /* Timestamps option */
 
 #define TCP_OPT_MSS_LEN   4   /* Length of TCP MSS option. */
+#define TCP_OPT_SACK_PERM_LEN 2 /* Length of TCP SACK permitted option */
+#define TCP_OPT_SACK_LEN(n) (2 + ((n) << 3)) /* Length of SACK option with n blocks */
+#define TCP_OPT_WS_LEN    3   /* Length of TCP window scale option */
+#define TCP_OPT_TS_LEN    10  /* Length of TCP timestamps option */
+
+#define TCP_WS_MAXSHIFT   14  /* Largest window scale shift (RFC 7323) */
 
 /* The TCP states used in the struct tcp_conn_s tcpstateflags field */
 
@@ -180,6 +190,8 @@ struct tcp_stats_s
   net_stats_t syndrop;    /* Number of dropped SYNs due to too few
                              available connections */
   net_stats_t synrst;     /* Number of SYNs for closed ports triggering a RST */
+  net_stats_t rcvdrop;    /* Number of TCP segments dropped at a receive
+                             buffer limit or I/O buffer reserve */
 };
 #endif
 
@@ -97,6 +97,8 @@ struct udp_stats_s
   net_stats_t recv;         /* Number of recived UDP segments */
   net_stats_t sent;         /* Number of sent UDP segments */
   net_stats_t chkerr;       /* Number of UDP segments with a bad checksum */
+  net_stats_t rcvdrop;      /* Number of UDP segments dropped at a receive
+                               buffer limit or I/O buffer reserve */
 };
 #endif
 
@@ -275,6 +275,7 @@ struct uart_dev_s
   uint8_t              open_count;   /* Number of times the device has been opened */
   volatile bool        xmitwaiting;  /* true: User waiting for space in xmit.buffer */
   volatile bool        recvwaiting;  /* true: User waiting for data in recv.buffer */
+  volatile int16_t     recvmin;      /* Bytes buffered before waking the reader */
 #ifdef CONFIG_SERIAL_REMOVABLE
   volatile bool        disconnected; /* true: Removable device is not connected */
 #endif
@@ -286,6 +287,8 @@ struct uart_dev_s
   tcflag_t             tc_iflag;     /* Input modes */
   tcflag_t             tc_oflag;     /* Output modes */
   tcflag_t             tc_lflag;     /* Local modes */
+  cc_t                 tc_vmin;      /* VMIN: Minimum bytes for a read */
+  cc_t                 tc_vtime;     /* VTIME: Read idle timeout (deciseconds) */
 #endif
 
   /* Semaphores */
@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <sys/uio.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -109,6 +110,7 @@
 #define MSG_ERRQUEUE   0x2000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL   0x4000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE       0x8000 /* Sender will send more.  */
+#define MSG_WAITFORONE 0x10000 /* recvmmsg(): Block only for the first message */
 
 /* Protocol levels supported by get/setsockopt(): */
 
@@ -195,6 +197,31 @@ struct sockaddr
   char        sa_data[14];     /* 14-bytes of address data */
 };
 
+/* Used with sendmsg() and recvmsg() to describe a message that is
+ * scattered over (or gathered from) several buffers.
+ */
+
+struct msghdr
+{
+  FAR void         *msg_name;       /* Optional address */
+  socklen_t         msg_namelen;    /* Size of address */
+  FAR struct iovec *msg_iov;        /* Scatter/gather array */
+  int               msg_iovlen;     /* Members in msg_iov */
+  FAR void         *msg_control;    /* Ancillary data (not supported) */
+  socklen_t         msg_controllen; /* Ancillary data buffer length */
+  int               msg_flags;      /* Flags on received message */
+};
+
+/* Used with sendmmsg() and recvmmsg() to send or receive a batch of
+ * messages in one call.
+ */
+
+struct mmsghdr
+{
+  struct msghdr     msg_hdr;        /* The message */
+  unsigned int      msg_len;        /* Number of bytes sent or received */
+};
+
 /* Used with the SO_LINGER socket option */
 
 struct linger
@@ -231,6 +258,15 @@ ssize_t recv(int sockfd, FAR void *buf, size_t len, int flags);
 ssize_t recvfrom(int sockfd, FAR void *buf, size_t len, int flags,
                  FAR struct sockaddr *from, FAR socklen_t *fromlen);
 
+ssize_t sendmsg(int sockfd, FAR const struct msghdr *msg, int flags);
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
+
+struct timespec;
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+
 int shutdown(int sockfd, int how);
 
 int setsockopt(int sockfd, int level, int option,
@@ -38,6 +38,12 @@
 #ifndef __INCLUDE_SYS_UIO_H
 #define __INCLUDE_SYS_UIO_H
 
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
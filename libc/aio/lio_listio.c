@@ -136,6 +136,50 @@ static int lio_checkio(FAR struct aiocb * const *list, int nent)
   return ret;
 }
 
+/****************************************************************************
+ * Name: lio_notify
+ *
+ * Description:
+ *   Notify the client that all I/O in the list has completed.
+ *
+ * Input Parameters:
+ *   pid - The ID of the client
+ *   sig - Describes how to notify the client
+ *
+ * Returned Value:
+ *  Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int lio_notify(pid_t pid, FAR struct sigevent *sig)
+{
+  int ret = OK;
+
+  if (sig->sigev_notify == SIGEV_SIGNAL)
+    {
+#ifdef CONFIG_CAN_PASS_STRUCTS
+      ret = sigqueue(pid, sig->sigev_signo, sig->sigev_value);
+#else
+      ret = sigqueue(pid, sig->sigev_signo, sig->sigev_value.sival_ptr);
+#endif
+      if (ret < 0)
+        {
+          ret = -get_errno();
+        }
+    }
+
+#ifdef CONFIG_SIG_EVTHREAD
+  /* Notify the client via a function call */
+
+  else if (sig->sigev_notify == SIGEV_THREAD)
+    {
+      ret = nxsig_notification(pid, sig);
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: lio_sighandler
  *
@@ -191,25 +235,11 @@ static void lio_sighandler(int signo, siginfo_t *info, void *ucontext)
 
       /* Signal the client */
 
-      if (sighand->sig->sigev_notify == SIGEV_SIGNAL)
-        {
-#ifdef CONFIG_CAN_PASS_STRUCTS
-          DEBUGASSERT(sigqueue(sighand->pid, sighand->sig->sigev_signo,
-                               sighand->sig->sigev_value));
-#else
-          DEBUGASSERT(sigqueue(sighand->pid, sighand->sig->sigev_signo,
-                               sighand->sig->sigev_value.sival_ptr));
-#endif
-        }
-
-#ifdef CONFIG_SIG_EVTHREAD
-      /* Notify the client via a function call */
-
-      else if (ighand->sig->sigev_notify == SIGEV_THREAD)
+      ret = lio_notify(sighand->pid, sighand->sig);
+      if (ret < 0)
         {
-          DEBUGASSERT(nxsig_notification(sighand->pid, &sighand->sig));
+          ferr("ERROR: lio_notify failed: %d\n", ret);
         }
-#endif
 
       /* And free the container */
 
@@ -298,12 +328,12 @@ static int lio_sigsetup(FAR struct aiocb * const *list, int nent,
       int errcode = get_errno();
       ferr("ERROR sigprocmask failed: %d\n", errcode);
       DEBUGASSERT(errcode > 0);
-      return -errcode;
+      status = -errcode;
+      goto errout_with_sighand;
     }
 
   /* Attach our signal handler */
 
-  printf("waiter_main: Registering signal handler\n");
   act.sa_sigaction = lio_sighandler;
   act.sa_flags = SA_SIGINFO;
 
@@ -316,10 +346,24 @@ static int lio_sigsetup(FAR struct aiocb * const *list, int nent,
       int errcode = get_errno();
       ferr("ERROR sigaction failed: %d\n", errcode);
       DEBUGASSERT(errcode > 0);
-      return -errcode;
+      status = -errcode;
+      (void)sigprocmask(SIG_SETMASK, &sighand->oprocmask, NULL);
+      goto errout_with_sighand;
     }
 
   return OK;
+
+errout_with_sighand:
+  for (i = 0; i < nent; i++)
+    {
+      if (list[i])
+        {
+          list[i]->aio_priv = NULL;
+        }
+    }
+
+  lib_free(sighand);
+  return status;
 }
 
 /****************************************************************************
@@ -549,8 +593,12 @@ int lio_listio(int mode, FAR struct aiocb *const list[], int nent,
   ret     = OK;   /* Assume success */
 
   /* Lock the scheduler so that no I/O events can complete on the worker
-   * thread until we set our wait set up.  Pre-emption will, of course, be
+   * threads until we set our wait set up.  Pre-emption will, of course, be
    * re-enabled while we are waiting for the signal.
+   *
+   * This also means that the whole list is queued before any worker runs.
+   * The workers then see the complete batch and can merge adjacent
+   * transfers on the same file.
    */
 
   sched_lock();
@@ -663,14 +711,13 @@ int lio_listio(int mode, FAR struct aiocb *const list[], int nent,
 
   /* Case 2: mode == LIO_NOWAIT and sig != NULL
    *
-   *   If any I/O was queued, then setup to signal the caller when all of
+   *   If any I/O was queued, then setup to notify the caller when all of
    *   the transfers complete.
    *
-   *   If no I/O was queue, then we I suppose that we need to signal the
-   *   caller ourself?
+   *   If no I/O was queued, then notify the caller now.
    */
 
-  else if (sig && sig->sigev_notify == SIGEV_SIGNAL)
+  else if (sig && sig->sigev_notify != SIGEV_NONE)
     {
       if (nqueued > 0)
         {
@@ -689,43 +736,19 @@ int lio_listio(int mode, FAR struct aiocb *const list[], int nent,
         }
       else
         {
-#ifdef CONFIG_CAN_PASS_STRUCTS
-          status = sigqueue(getpid(), sig->sigev_signo,
-                            sig->sigev_value);
-#else
-          status = sigqueue(getpid(), sig->sigev_signo,
-                            sig->sigev_value.sival_ptr);
-#endif
+          status = lio_notify(getpid(), sig);
           if (status < 0 && ret == OK)
             {
-              /* Something bad happened while signalling ourself and this is
+              /* Something bad happened while notifying ourself and this is
                * the first error to be reported.
                */
 
-              retcode = get_errno();
+              retcode = -status;
               ret     = ERROR;
             }
         }
     }
 
-#ifdef CONFIG_SIG_EVTHREAD
-  /* Notify the client via a function call */
-
-  else if (sig && sig->sigev_notify == SIGEV_THREAD)
-    {
-      status = nxsig_notification(sighand->pid, &sighand->sig);
-      if (status < 0 && ret == OK)
-        {
-         /* Something bad happened while performing the notification
-          * and this is the first error to be reported.
-          */
-
-          retcode = -status;
-          ret     = ERROR;
-        }
-    }
-#endif
-
   /* Case 3: mode == LIO_NOWAIT and sig == NULL
    *
    *   Just return now.
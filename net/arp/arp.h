@@ -76,6 +76,13 @@
 #  define CONFIG_ARP_SEND_DELAYMSEC 20
 #endif
 
+/* Packets may be held in I/O buffers while their destination is resolved */
+
+#if defined(CONFIG_MM_IOB) && defined(CONFIG_NET_ARP_NPENDING) && \
+    CONFIG_NET_ARP_NPENDING > 0
+#  define ARP_HAVE_PENDING 1
+#endif
+
 /* ARP Definitions **********************************************************/
 
 #define ARP_REQUEST    1
@@ -214,6 +221,10 @@ void arp_timer_initialize(void);
  *   is 10 seconds between the calls.  It is responsible for flushing old
  *   entries in the ARP table.
  *
+ * Assumptions:
+ *   May be called from interrupt context.  Old entries are only marked as
+ *   expired; they are released by the next ARP table operation.
+ *
  ****************************************************************************/
 
 void arp_timer(void);
@@ -394,20 +405,60 @@ FAR struct arp_entry *arp_find(in_addr_t ipaddr);
  * Input Parameters:
  *   ipaddr - Refers to an IP address in network order
  *
+ * Returned Value:
+ *   Zero (OK) if the entry was removed; -ENOENT if there was no entry for
+ *   the address.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+int arp_delete(in_addr_t ipaddr);
+
+/****************************************************************************
+ * Name: arp_queue
+ *
+ * Description:
+ *   Hold on to the IPv4 packet in d_buf until the HW address of 'ipaddr'
+ *   has been resolved.  The packet is sent from the next poll of the
+ *   device after the ARP reply arrives.
+ *
+ * Input Parameters:
+ *   dev    - The device that the packet is to be sent on
+ *   ipaddr - The IP address being resolved (the destination or the router)
+ *
+ * Returned Value:
+ *   None.  The packet is dropped if there is no free I/O buffer.
+ *
  * Assumptions
- *   Interrupts are disabled to assure exclusive access to the ARP table
- *   (and because arp_find() is called).
+ *   The network is locked.
  *
  ****************************************************************************/
 
-#define arp_delete(ipaddr) \
-{ \
-  struct arp_entry *tabptr = arp_find(ipaddr); \
-  if (tabptr) \
-    { \
-      tabptr->at_ipaddr = 0; \
-    } \
-}
+#ifdef ARP_HAVE_PENDING
+void arp_queue(FAR struct net_driver_s *dev, in_addr_t ipaddr);
+#else
+#  define arp_queue(d,i)
+#endif
+
+/****************************************************************************
+ * Name: arp_pending_poll
+ *
+ * Description:
+ *   Send the packets that were waiting for an address that has now been
+ *   resolved.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef ARP_HAVE_PENDING
+int arp_pending_poll(FAR struct net_driver_s *dev,
+                     devif_poll_callback_t callback);
+#endif
 
 /****************************************************************************
  * Name: arp_update
@@ -488,7 +539,8 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 #  define arp_wait(n,t) (0)
 #  define arp_notify(i)
 #  define arp_find(i) (NULL)
-#  define arp_delete(i)
+#  define arp_delete(i) (-ENOENT)
+#  define arp_queue(d,i)
 #  define arp_update(i,m);
 #  define arp_hdr_update(i,m);
 #  define arp_dump(arp)
@@ -255,9 +255,11 @@ void arp_out(FAR struct net_driver_s *dev)
       ninfo("ARP request for IP %08lx\n", (unsigned long)ipaddr);
 
       /* The destination address was not in our ARP table, so we overwrite
-       * the IP packet with an ARP request.
+       * the IP packet with an ARP request.  Keep a copy of the packet, if
+       * we can, to be sent when the reply arrives.
        */
 
+      arp_queue(dev, ipaddr);
       arp_format(dev, ipaddr);
       arp_dump(ARPBUF);
       return;
@@ -47,30 +47,277 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
+#include <queue.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <netinet/in.h>
 #include <net/ethernet.h>
 
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/ip.h>
 
-#include <arp/arp.h>
+#include "netdev/netdev.h"
+#include "arp/arp.h"
 
 #ifdef CONFIG_NET_ARP
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of hash buckets:  A power of two no smaller than the table */
+
+#if CONFIG_NET_ARPTAB_SIZE <= 8
+#  define ARP_HASH_SIZE 8
+#elif CONFIG_NET_ARPTAB_SIZE <= 16
+#  define ARP_HASH_SIZE 16
+#elif CONFIG_NET_ARPTAB_SIZE <= 32
+#  define ARP_HASH_SIZE 32
+#else
+#  define ARP_HASH_SIZE 64
+#endif
+
+/* Values of at_flags */
+
+#define ARP_FLAG_INCOMPLETE (1 << 0) /* Resolution pending, no HW address */
+#define ARP_FLAG_FLUSH      (1 << 1) /* Resolved with packets to send */
+
+/* An incomplete entry is dropped by the next ARP timer tick after this
+ * many ticks.
+ */
+
+#define ARP_INCOMPLETE_MAXAGE 1
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One slot of the ARP table.  The public entry is embedded so that
+ * arp_find() can return it.
+ */
+
+struct arp_table_s
+{
+  dq_entry_t at_node;                 /* LRU list or free list */
+  FAR struct arp_table_s *at_hnext;   /* Next entry in the hash chain */
+  struct arp_entry at_entry;          /* IP/HW address mapping */
+  uint8_t    at_hash;                 /* Hash chain holding the entry */
+  uint8_t    at_flags;                /* See ARP_FLAG_* definitions */
+  volatile uint8_t at_expired;        /* Aged out, release under net_lock */
+#ifdef ARP_HAVE_PENDING
+  uint8_t    at_npending;             /* Number of packets in at_pending[] */
+  FAR struct net_driver_s *at_dev;    /* Device the packets are sent on */
+  FAR struct iob_s *at_pending[CONFIG_NET_ARP_NPENDING];
+#endif
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 /* The table of known address mappings */
 
-static struct arp_entry g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static struct arp_table_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 static uint8_t g_arptime;
 
+/* Entries in use are kept in a hash table for lookup and in a list, most
+ * recently used first, for eviction.
+ */
+
+static FAR struct arp_table_s *g_arphash[ARP_HASH_SIZE];
+static dq_queue_t g_arplru;
+static dq_queue_t g_arpfree;
+
+/* Set by arp_timer() when it has marked entries as expired */
+
+static volatile bool g_arpreap;
+
+#ifdef ARP_HAVE_PENDING
+/* Number of resolved entries with packets waiting to be sent */
+
+static uint8_t g_arpnflush;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_hash
+ *
+ * Description:
+ *   Return the hash chain of an IP address.
+ *
+ ****************************************************************************/
+
+static inline unsigned int arp_hash(in_addr_t ipaddr)
+{
+  uint32_t hash = (uint32_t)ipaddr;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return hash & (ARP_HASH_SIZE - 1);
+}
+
+/****************************************************************************
+ * Name: arp_touch
+ *
+ * Description:
+ *   Make a table slot the most recently used.
+ *
+ ****************************************************************************/
+
+static inline void arp_touch(FAR struct arp_table_s *tab)
+{
+  if (g_arplru.head != &tab->at_node)
+    {
+      dq_rem(&tab->at_node, &g_arplru);
+      dq_addfirst(&tab->at_node, &g_arplru);
+    }
+}
+
+/****************************************************************************
+ * Name: arp_release
+ *
+ * Description:
+ *   Remove a slot from its hash chain and the LRU list, drop any packets
+ *   that it holds and return it to the free list.
+ *
+ ****************************************************************************/
+
+static void arp_release(FAR struct arp_table_s *tab)
+{
+  FAR struct arp_table_s **pprev;
+
+  for (pprev = &g_arphash[tab->at_hash]; *pprev != NULL;
+       pprev = &(*pprev)->at_hnext)
+    {
+      if (*pprev == tab)
+        {
+          *pprev = tab->at_hnext;
+          break;
+        }
+    }
+
+#ifdef ARP_HAVE_PENDING
+  if ((tab->at_flags & ARP_FLAG_FLUSH) != 0)
+    {
+      g_arpnflush--;
+    }
+
+  while (tab->at_npending > 0)
+    {
+      iob_free_chain(tab->at_pending[--tab->at_npending]);
+    }
+#endif
+
+  tab->at_entry.at_ipaddr = 0;
+  tab->at_hnext           = NULL;
+  tab->at_flags           = 0;
+  tab->at_expired         = 0;
+
+  dq_rem(&tab->at_node, &g_arplru);
+  dq_addlast(&tab->at_node, &g_arpfree);
+}
+
+/****************************************************************************
+ * Name: arp_reap
+ *
+ * Description:
+ *   Release the entries that arp_timer() has marked as expired.
+ *
+ * Assumptions
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void arp_reap(void)
+{
+  FAR struct arp_table_s *tab;
+  FAR struct arp_table_s *next;
+
+  if (!g_arpreap)
+    {
+      return;
+    }
+
+  g_arpreap = false;
+  for (tab = (FAR struct arp_table_s *)g_arplru.head; tab != NULL; tab = next)
+    {
+      next = (FAR struct arp_table_s *)tab->at_node.flink;
+      if (tab->at_expired)
+        {
+          arp_release(tab);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: arp_lookup
+ *
+ * Description:
+ *   Find the table slot of an IP address, whether resolved or not.  Any
+ *   expired entries are released first.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_table_s *arp_lookup(in_addr_t ipaddr)
+{
+  FAR struct arp_table_s *tab;
+
+  arp_reap();
+
+  for (tab = g_arphash[arp_hash(ipaddr)]; tab != NULL; tab = tab->at_hnext)
+    {
+      if (net_ipv4addr_cmp(ipaddr, tab->at_entry.at_ipaddr))
+        {
+          return tab;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: arp_allocate
+ *
+ * Description:
+ *   Get a free table slot for an IP address, evicting the least recently
+ *   used entry if the table is full.  The slot is hashed and made the most
+ *   recently used.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_table_s *arp_allocate(in_addr_t ipaddr)
+{
+  FAR struct arp_table_s *tab;
+
+  if (dq_empty(&g_arpfree))
+    {
+      tab = (FAR struct arp_table_s *)g_arplru.tail;
+      ninfo("Evicting ARP entry for %08lx\n",
+            (unsigned long)tab->at_entry.at_ipaddr);
+      arp_release(tab);
+    }
+
+  tab = (FAR struct arp_table_s *)dq_remfirst(&g_arpfree);
+  dq_addfirst(&tab->at_node, &g_arplru);
+
+  tab->at_entry.at_ipaddr = ipaddr;
+  tab->at_entry.at_time   = g_arptime;
+  tab->at_expired         = 0;
+  tab->at_hash            = arp_hash(ipaddr);
+  tab->at_hnext           = g_arphash[tab->at_hash];
+  g_arphash[tab->at_hash] = tab;
+  return tab;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -87,10 +334,21 @@ void arp_reset(void)
 {
   int i;
 
+  dq_init(&g_arplru);
+  dq_init(&g_arpfree);
+  memset(g_arphash, 0, sizeof(g_arphash));
+
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      memset(&g_arptable[i].at_ipaddr, 0, sizeof(in_addr_t));
+      memset(&g_arptable[i], 0, sizeof(struct arp_table_s));
+      dq_addlast(&g_arptable[i].at_node, &g_arpfree);
     }
+
+  g_arpreap = false;
+
+#ifdef ARP_HAVE_PENDING
+  g_arpnflush = 0;
+#endif
 }
 
 /****************************************************************************
@@ -102,22 +360,35 @@ void arp_reset(void)
  *   is 10 seconds between the calls.  It is responsible for flushing old
  *   entries in the ARP table.
  *
+ * Assumptions:
+ *   Called from the ARP watchdog in interrupt context.  Old entries are
+ *   only marked as expired here; the table lists are not touched.  The
+ *   next ARP table operation releases them with the network locked.
+ *
  ****************************************************************************/
 
 void arp_timer(void)
 {
-  FAR struct arp_entry *tabptr;
+  FAR struct arp_table_s *tab;
+  uint8_t maxage;
   int i;
 
   ++g_arptime;
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; i++)
     {
-      tabptr = &g_arptable[i];
+      tab = &g_arptable[i];
+      if (tab->at_entry.at_ipaddr == 0 || tab->at_expired)
+        {
+          continue;
+        }
 
-      if (tabptr->at_ipaddr != 0 &&
-          g_arptime - tabptr->at_time >= CONFIG_NET_ARP_MAXAGE)
+      maxage = (tab->at_flags & ARP_FLAG_INCOMPLETE) != 0 ?
+               ARP_INCOMPLETE_MAXAGE : CONFIG_NET_ARP_MAXAGE;
+
+      if ((uint8_t)(g_arptime - tab->at_entry.at_time) >= maxage)
         {
-          tabptr->at_ipaddr = 0;
+          tab->at_expired = 1;
+          g_arpreap       = true;
         }
     }
 }
@@ -144,79 +415,40 @@ void arp_timer(void)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
-  struct arp_entry *tabptr = NULL;
-  int               i;
+  FAR struct arp_table_s *tab;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Update the existing entry for the IP address, if there is one.
+   * Otherwise, the IP -> MAC address mapping is inserted in the table.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tab = arp_lookup(ipaddr);
+  if (tab == NULL)
     {
-      tabptr = &g_arptable[i];
-
-      /* Only check those entries that are actually in use. */
-
-      if (tabptr->at_ipaddr != 0)
-        {
-          /* Check if the source IP address of the incoming packet matches
-           * the IP address in this ARP table entry.
-           */
-
-          if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-            {
-              /* An old entry found, update this and return. */
-
-              memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-              tabptr->at_time = g_arptime;
-              return OK;
-            }
-        }
+      tab = arp_allocate(ipaddr);
     }
-
-  /* If we get here, no existing ARP table entry was found, so we create one. */
-  /* First, we try to find an unused entry in the ARP table. */
-
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  else
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_ipaddr == 0)
-        {
-          break;
-        }
+      arp_touch(tab);
     }
 
-  /* If no unused entry is found, we try to find the oldest entry and
-   * throw it away.
+  memcpy(tab->at_entry.at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
+  tab->at_entry.at_time = g_arptime;
+  tab->at_expired       = 0;
+
+#ifdef ARP_HAVE_PENDING
+  /* If packets were waiting for this address, have the device poll for
+   * them now.
    */
 
-  if (i == CONFIG_NET_ARPTAB_SIZE)
+  if ((tab->at_flags & ARP_FLAG_INCOMPLETE) != 0 && tab->at_npending > 0)
     {
-      uint8_t tmpage = 0;
-      int j = 0;
-
-      for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
-        {
-          tabptr = &g_arptable[i];
-          if (g_arptime - tabptr->at_time > tmpage)
-            {
-              tmpage = g_arptime - tabptr->at_time;
-              j = i;
-            }
-        }
-
-      i = j;
-      tabptr = &g_arptable[i];
+      tab->at_flags |= ARP_FLAG_FLUSH;
+      g_arpnflush++;
+      netdev_txnotify_dev(tab->at_dev);
     }
+#endif
 
-  /* Now, i is the ARP table entry which we will fill with the new
-   * information.
-   */
-
-  tabptr->at_ipaddr = ipaddr;
-  memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-  tabptr->at_time = g_arptime;
+  tab->at_flags &= ~ARP_FLAG_INCOMPLETE;
   return OK;
 }
 
@@ -253,7 +485,8 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
  * Name: arp_find
  *
  * Description:
- *   Find the ARP entry corresponding to this IP address.
+ *   Find the ARP entry corresponding to this IP address.  Addresses that
+ *   are still being resolved are not returned.
  *
  * Input Parameters:
  *   ipaddr - Refers to an IP address in network order
@@ -266,20 +499,178 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 
 FAR struct arp_entry *arp_find(in_addr_t ipaddr)
 {
-  FAR struct arp_entry *tabptr;
+  FAR struct arp_table_s *tab;
+
+  tab = arp_lookup(ipaddr);
+  if (tab != NULL && (tab->at_flags & ARP_FLAG_INCOMPLETE) == 0)
+    {
+      arp_touch(tab);
+      return &tab->at_entry;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: arp_delete
+ *
+ * Description:
+ *   Remove an IP association from the ARP table
+ *
+ * Input Parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *
+ * Returned Value:
+ *   Zero (OK) if the entry was removed; -ENOENT if there was no entry for
+ *   the address.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+int arp_delete(in_addr_t ipaddr)
+{
+  FAR struct arp_table_s *tab;
+
+  tab = arp_lookup(ipaddr);
+  if (tab == NULL || (tab->at_flags & ARP_FLAG_INCOMPLETE) != 0)
+    {
+      return -ENOENT;
+    }
+
+  arp_release(tab);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: arp_queue
+ *
+ * Description:
+ *   Hold on to the IPv4 packet in d_buf until the HW address of 'ipaddr'
+ *   has been resolved.  If too many packets are already waiting for the
+ *   address, the oldest is dropped.
+ *
+ * Input Parameters:
+ *   dev    - The device that the packet is to be sent on
+ *   ipaddr - The IP address being resolved (the destination or the router)
+ *
+ * Returned Value:
+ *   None.  The packet is dropped if there is no free I/O buffer.
+ *
+ * Assumptions
+ *   The network is locked.  The packet follows the Ethernet header space
+ *   in d_buf and d_len holds its length.
+ *
+ ****************************************************************************/
+
+#ifdef ARP_HAVE_PENDING
+void arp_queue(FAR struct net_driver_s *dev, in_addr_t ipaddr)
+{
+  FAR struct arp_table_s *tab;
+  FAR struct iob_s *iob;
+  int ret;
+
+  tab = arp_lookup(ipaddr);
+  if (tab == NULL)
+    {
+      tab = arp_allocate(ipaddr);
+      tab->at_flags = ARP_FLAG_INCOMPLETE;
+    }
+  else if ((tab->at_flags & ARP_FLAG_INCOMPLETE) == 0)
+    {
+      return;
+    }
+
+  /* Copy the packet into an I/O buffer chain without waiting */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      return;
+    }
+
+  ret = iob_trycopyin(iob, &dev->d_buf[ETH_HDRLEN], dev->d_len, 0, true);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return;
+    }
+
+  if (tab->at_npending >= CONFIG_NET_ARP_NPENDING)
+    {
+      iob_free_chain(tab->at_pending[0]);
+      memmove(&tab->at_pending[0], &tab->at_pending[1],
+              (CONFIG_NET_ARP_NPENDING - 1) * sizeof(FAR struct iob_s *));
+      tab->at_npending--;
+    }
+
+  tab->at_pending[tab->at_npending++] = iob;
+  tab->at_dev = dev;
+}
+#endif
+
+/****************************************************************************
+ * Name: arp_pending_poll
+ *
+ * Description:
+ *   Send the packets that were waiting for an address that has now been
+ *   resolved.  Each packet is placed in d_buf in turn and passed to the
+ *   driver callback, which adds the Ethernet header with arp_out().
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef ARP_HAVE_PENDING
+int arp_pending_poll(FAR struct net_driver_s *dev,
+                     devif_poll_callback_t callback)
+{
+  FAR struct arp_table_s *tab;
+  FAR struct iob_s *iob;
+  int bstop = 0;
   int i;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  /* The callback looks up the entry again and so reorders the LRU list.
+   * Walk the table itself.
+   */
+
+  for (i = 0; g_arpnflush > 0 && i < CONFIG_NET_ARPTAB_SIZE && !bstop; i++)
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+      tab = &g_arptable[i];
+      if ((tab->at_flags & ARP_FLAG_FLUSH) == 0 || tab->at_dev != dev)
         {
-          return tabptr;
+          continue;
+        }
+
+      while (tab->at_npending > 0 && !bstop)
+        {
+          iob = tab->at_pending[0];
+          tab->at_npending--;
+          memmove(&tab->at_pending[0], &tab->at_pending[1],
+                  tab->at_npending * sizeof(FAR struct iob_s *));
+
+          dev->d_len    = iob->io_pktlen;
+          dev->d_sndlen = 0;
+          (void)iob_copyout(&dev->d_buf[ETH_HDRLEN], iob, iob->io_pktlen, 0);
+          iob_free_chain(iob);
+
+          IFF_SET_IPv4(dev->d_flags);
+          bstop = callback(dev);
+        }
+
+      if (tab->at_npending == 0)
+        {
+          tab->at_flags &= ~ARP_FLAG_FLUSH;
+          g_arpnflush--;
         }
     }
 
-  return NULL;
+  return bstop;
 }
+#endif
 
 #endif /* CONFIG_NET_ARP */
 #endif /* CONFIG_NET */
@@ -471,6 +471,27 @@ uint16_t devif_dev_event(FAR struct net_driver_s *dev, void *pvconn,
 
 void devif_send(FAR struct net_driver_s *dev, FAR const void *buf, int len);
 
+/****************************************************************************
+ * Name: devif_iov_send
+ *
+ * Description:
+ *   Called from socket logic in response to a xmit or poll request from the
+ *   the network interface driver.
+ *
+ *   This is identical to calling devif_send() except that the data is
+ *   gathered from an array of buffers, starting 'offset' bytes into the
+ *   data they describe.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+struct iovec;
+void devif_iov_send(FAR struct net_driver_s *dev,
+                    FAR const struct iovec *iov, int iovcnt,
+                    unsigned int len, unsigned int offset);
+
 /****************************************************************************
  * Name: devif_iob_send
  *
@@ -338,18 +338,32 @@ static inline int devif_poll_icmpv6(FAR struct net_driver_s *dev,
 static inline int devif_poll_forward(FAR struct net_driver_s *dev,
                                      devif_poll_callback_t callback)
 {
-  /* Perform the forwarding poll */
-
-  ipfwd_poll(dev);
+  int bstop = 0;
+  int i;
 
-  /* NOTE: that 6LoWPAN packet conversions are handled differently for
-   * forwarded packets.  That is because we don't know what the packet
-   * type is at this point; not within peeking into the device's d_buf.
+  /* Perform the forwarding poll.  As long as the driver can take more
+   * packets, keep polling until no further forwarded packet goes out.
    */
 
-  /* Call back into the driver */
+  for (i = 0; i < CONFIG_NET_IPFORWARD_NSTRUCT && !bstop; i++)
+    {
+      int sent = ipfwd_poll(dev);
 
-  return callback(dev);
+      /* NOTE: that 6LoWPAN packet conversions are handled differently for
+       * forwarded packets.  That is because we don't know what the packet
+       * type is at this point; not within peeking into the device's d_buf.
+       */
+
+      /* Call back into the driver */
+
+      bstop = callback(dev);
+      if (!sent)
+        {
+          break;
+        }
+    }
+
+  return bstop;
 }
 #endif /* CONFIG_NET_ICMPv6_SOCKET || CONFIG_NET_ICMPv6_NEIGHBOR*/
 
@@ -389,6 +403,11 @@ static inline int devif_poll_igmp(FAR struct net_driver_s *dev,
  * Description:
  *   Poll all UDP connections for available packets to send.
  *
+ *   A connection is polled again as long as it produces packets and the
+ *   driver accepts them, up to CONFIG_NET_UDP_TXBURST datagrams.  A batch
+ *   of datagrams queued in the write buffers by sendmmsg() then goes out
+ *   in one poll.
+ *
  * Assumptions:
  *   This function is called from the MAC device driver with the network
  *   locked.
@@ -400,23 +419,34 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
                                       devif_poll_callback_t callback)
 {
   FAR struct udp_conn_s *conn = NULL;
+  int npkts;
   int bstop = 0;
 
   /* Traverse all of the allocated UDP connections and perform the poll action */
 
   while (!bstop && (conn = udp_nextconn(conn)))
     {
-      /* Perform the UDP TX poll */
+      for (npkts = 0; !bstop && npkts < CONFIG_NET_UDP_TXBURST; npkts++)
+        {
+          /* Perform the UDP TX poll */
 
-      udp_poll(dev, conn);
+          udp_poll(dev, conn);
 
-      /* Perform any necessary conversions on outgoing packets */
+          if (dev->d_len == 0)
+            {
+              /* Nothing more to send */
 
-      devif_packet_conversion(dev, DEVIF_UDP);
+              break;
+            }
 
-      /* Call back into the driver */
+          /* Perform any necessary conversions on outgoing packets */
 
-      bstop = callback(dev);
+          devif_packet_conversion(dev, DEVIF_UDP);
+
+          /* Call back into the driver */
+
+          bstop = callback(dev);
+        }
     }
 
   return bstop;
@@ -427,7 +457,15 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
  * Name: devif_poll_tcp_connections
  *
  * Description:
- *   Poll all UDP connections for available packets to send.
+ *   Poll the TCP connections that have data ready to send.  Idle
+ *   connections are not visited here; the timer poll visits every
+ *   connection.
+ *
+ *   A connection is polled again as long as it produces packets and the
+ *   driver accepts them, up to CONFIG_NET_TCP_TXBURST segments.  A driver
+ *   that can queue several packets provides a new d_buf from its callback
+ *   and returns zero; a bulk sender then fills the queue in one poll.  A
+ *   connection that produces nothing is removed from the ready list.
  *
  * Assumptions:
  *   This function is called from the MAC device driver with the network
@@ -439,24 +477,48 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
                                              devif_poll_callback_t callback)
 {
-  FAR struct tcp_conn_s *conn  = NULL;
+  FAR struct tcp_conn_s *conn;
+  FAR struct tcp_conn_s *next;
+  int nsegs;
   int bstop = 0;
 
-  /* Traverse all of the active TCP connections and perform the poll action */
+  /* Traverse the TCP connections that are ready to send and perform the
+   * poll action.
+   */
 
-  while (!bstop && (conn = tcp_nextconn(conn)))
+  for (conn = tcp_nextready(NULL); !bstop && conn != NULL; conn = next)
     {
-      /* Perform the TCP TX poll */
+      next = tcp_nextready(conn);
 
-      tcp_poll(dev, conn);
+      /* Connections bound to other devices are left for their own device */
 
-      /* Perform any necessary conversions on outgoing packets */
+      if (conn->dev != NULL && conn->dev != dev)
+        {
+          continue;
+        }
 
-      devif_packet_conversion(dev, DEVIF_TCP);
+      for (nsegs = 0; !bstop && nsegs < CONFIG_NET_TCP_TXBURST; nsegs++)
+        {
+          /* Perform the TCP TX poll */
 
-      /* Call back into the driver */
+          tcp_poll(dev, conn);
 
-      bstop = callback(dev);
+          if (dev->d_len == 0)
+            {
+              /* Nothing more to send */
+
+              tcp_clrready(conn);
+              break;
+            }
+
+          /* Perform any necessary conversions on outgoing packets */
+
+          devif_packet_conversion(dev, DEVIF_TCP);
+
+          /* Call back into the driver */
+
+          bstop = callback(dev);
+        }
     }
 
   return bstop;
@@ -532,6 +594,11 @@ static inline int devif_poll_tcp_timer(FAR struct net_driver_s *dev,
  *   is set to a value larger than zero. The device driver should then send
  *   out the packet.
  *
+ *   A driver that queues outgoing packets may instead keep the packet in
+ *   d_buf, point d_buf at a free buffer of its queue and return zero.  It
+ *   returns a non-zero value when its queue is full.  TCP connections with
+ *   bulk data are then polled for several segments in a row.
+ *
  * Assumptions:
  *   This function is called from the MAC device driver with the network
  *   locked.
@@ -552,6 +619,24 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
   bstop = arp_poll(dev, callback);
   if (!bstop)
 #endif
+#ifdef ARP_HAVE_PENDING
+    {
+      /* Send packets that were waiting for an ARP reply */
+
+      bstop = arp_pending_poll(dev, callback);
+    }
+
+  if (!bstop)
+#endif
+#ifdef NEIGHBOR_HAVE_PENDING
+    {
+      /* Send packets that were waiting for a Neighbor Advertisement */
+
+      bstop = neighbor_pending_poll(dev, callback);
+    }
+
+  if (!bstop)
+#endif
 #ifdef CONFIG_NET_PKT
     {
       /* Check for pending packet socket transfer */
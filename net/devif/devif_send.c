@@ -41,6 +41,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/uio.h>
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
@@ -72,3 +73,57 @@ void devif_send(struct net_driver_s *dev, const void *buf, int len)
   memcpy(dev->d_appdata, buf, len);
   dev->d_sndlen = len;
 }
+
+/****************************************************************************
+ * Name: devif_iov_send
+ *
+ * Description:
+ *   Called from socket logic in response to a xmit or poll request from the
+ *   the network interface driver.
+ *
+ *   This is identical to calling devif_send() except that the data is
+ *   gathered from an array of buffers, starting 'offset' bytes into the
+ *   data they describe.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void devif_iov_send(FAR struct net_driver_s *dev,
+                    FAR const struct iovec *iov, int iovcnt,
+                    unsigned int len, unsigned int offset)
+{
+  FAR uint8_t *dest = dev->d_appdata;
+  unsigned int remaining = len;
+  unsigned int ncopy;
+  int i;
+
+  DEBUGASSERT(dev != NULL && len > 0 && len < NET_DEV_MTU(dev));
+
+  for (i = 0; i < iovcnt && remaining > 0; i++)
+    {
+      /* Skip the buffers that lie entirely before the offset */
+
+      if (offset >= iov[i].iov_len)
+        {
+          offset -= iov[i].iov_len;
+          continue;
+        }
+
+      ncopy = iov[i].iov_len - offset;
+      if (ncopy > remaining)
+        {
+          ncopy = remaining;
+        }
+
+      memcpy(dest, (FAR const uint8_t *)iov[i].iov_base + offset, ncopy);
+
+      dest      += ncopy;
+      remaining -= ncopy;
+      offset     = 0;
+    }
+
+  DEBUGASSERT(remaining == 0);
+  dev->d_sndlen = len;
+}
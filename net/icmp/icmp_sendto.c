@@ -163,6 +163,7 @@ static void sendto_request(FAR struct net_driver_s *dev,
 {
   FAR struct ipv4_hdr_s *ipv4;
   FAR struct icmp_hdr_s *icmp;
+  uint16_t sum;
 
   IFF_SET_IPv4(dev->d_flags);
 
@@ -194,20 +195,25 @@ static void sendto_request(FAR struct net_driver_s *dev,
   net_ipv4addr_hdrcopy(ipv4->srcipaddr, &dev->d_ipaddr);
   net_ipv4addr_hdrcopy(ipv4->destipaddr, &pstate->snd_toaddr);
 
-  /* Copy the ICMP header and payload into place after the IPv4 header */
+  /* Copy the ICMP header and payload into place after the IPv4 header,
+   * summing it on the way.
+   */
 
   icmp              = ICMPBUF;
-  memcpy(icmp, pstate->snd_buf, pstate->snd_buflen);
+  sum               = chksum_copy(0, (FAR uint8_t *)icmp,
+                                  pstate->snd_buf,
+                                  pstate->snd_buflen);
 
   /* Calculate IP checksum. */
 
   ipv4->ipchksum    = 0;
   ipv4->ipchksum    = ~(ipv4_chksum(dev));
 
-  /* Calculate the ICMP checksum. */
+  /* Calculate the ICMP checksum.  The sum above includes whatever the
+   * caller left in the checksum field; take that back out.
+   */
 
-  icmp->icmpchksum  = 0;
-  icmp->icmpchksum  = ~(icmp_chksum(dev, pstate->snd_buflen));
+  icmp->icmpchksum  = net_chksum_adjust(~htons(sum), icmp->icmpchksum, 0);
   if (icmp->icmpchksum == 0)
     {
       icmp->icmpchksum = 0xffff;
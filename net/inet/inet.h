@@ -142,6 +142,25 @@ void inet_setipid(uint16_t id);
 FAR const struct sock_intf_s *
   inet_sockif(sa_family_t family, int type, int protocol);
 
+/****************************************************************************
+ * Name: inet_setbufsize and inet_getbufsize
+ *
+ * Description:
+ *   Set or return the receive (SO_RCVBUF) or send (SO_SNDBUF) buffer limit
+ *   of a TCP or UDP socket.  The limit is in bytes of I/O buffer storage;
+ *   zero means that there is no limit.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOPROTOOPT if the socket does not buffer data
+ *   in that direction.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+int inet_setbufsize(FAR struct socket *psock, int option, uint32_t size);
+int inet_getbufsize(FAR struct socket *psock, int option, FAR int *size);
+#endif
+
 /****************************************************************************
  * Name: ipv4_getsockname and ipv6_sockname
  *
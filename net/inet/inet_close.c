@@ -375,6 +375,10 @@ static inline int tcp_close_disconnect(FAR struct socket *psock)
       state.cl_cb->flags = (TCP_NEWDATA | TCP_POLL | TCP_DISCONN_EVENTS);
       state.cl_cb->event = tcp_close_eventhandler;
 
+      /* The FIN is sent from the next poll of this connection */
+
+      tcp_setready(conn);
+
 #ifdef CONFIG_NET_SOLINGER
       /* Check for a lingering close */
 
@@ -0,0 +1,223 @@
+/****************************************************************************
+ * net/inet/inet_sockbuf.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET_SOCKOPTS) && \
+    (defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6))
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+
+#include "tcp/tcp.h"
+#include "udp/udp.h"
+#include "inet/inet.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inet_bufsize
+ *
+ * Description:
+ *   Return a reference to the receive (SO_RCVBUF) or send (SO_SNDBUF)
+ *   buffer limit of a TCP or UDP socket, or NULL if the socket does not
+ *   buffer data in that direction.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static FAR uint32_t *inet_bufsize(FAR struct socket *psock, int option)
+{
+  /* ICMP sockets are datagram sockets too, so make sure that this really
+   * is a TCP or UDP socket.
+   */
+
+  if (psock->s_conn == NULL ||
+      psock->s_sockif != inet_sockif(psock->s_domain, psock->s_type, 0))
+    {
+      return NULL;
+    }
+
+#if defined(CONFIG_NET_TCP_READAHEAD) || defined(CONFIG_NET_TCP_WRITE_BUFFERS)
+  if (psock->s_type == SOCK_STREAM)
+    {
+      FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+      if (option == SO_RCVBUF)
+        {
+          return &conn->rcvbufs;
+        }
+#endif
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      if (option == SO_SNDBUF)
+        {
+          return &conn->sndbufs;
+        }
+#endif
+    }
+#endif
+
+#if defined(CONFIG_NET_UDP_READAHEAD) || defined(CONFIG_NET_UDP_WRITE_BUFFERS)
+  if (psock->s_type == SOCK_DGRAM)
+    {
+      FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+      if (option == SO_RCVBUF)
+        {
+          return &conn->rcvbufs;
+        }
+#endif
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+      if (option == SO_SNDBUF)
+        {
+          return &conn->sndbufs;
+        }
+#endif
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inet_setbufsize
+ *
+ * Description:
+ *   Set the receive (SO_RCVBUF) or send (SO_SNDBUF) buffer limit of a TCP
+ *   or UDP socket.  The limit is in bytes of I/O buffer storage; zero
+ *   removes the limit.
+ *
+ * Input Parameters:
+ *   psock  - The socket to modify
+ *   option - SO_RCVBUF or SO_SNDBUF
+ *   size   - The new limit
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOPROTOOPT if the socket does not buffer data
+ *   in that direction.
+ *
+ ****************************************************************************/
+
+int inet_setbufsize(FAR struct socket *psock, int option, uint32_t size)
+{
+  FAR uint32_t *bufsize;
+
+  net_lock();
+  bufsize = inet_bufsize(psock, option);
+  if (bufsize == NULL)
+    {
+      net_unlock();
+      return -ENOPROTOOPT;
+    }
+
+  *bufsize = size;
+
+  /* A sender may be waiting for room in a send buffer that just grew */
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  if (option == SO_SNDBUF && psock->s_type == SOCK_STREAM)
+    {
+      tcp_sendbuffer_notify((FAR struct tcp_conn_s *)psock->s_conn);
+    }
+#endif
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+  if (option == SO_SNDBUF && psock->s_type == SOCK_DGRAM)
+    {
+      udp_sendbuffer_notify((FAR struct udp_conn_s *)psock->s_conn);
+    }
+#endif
+
+  net_unlock();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inet_getbufsize
+ *
+ * Description:
+ *   Return the receive (SO_RCVBUF) or send (SO_SNDBUF) buffer limit of a
+ *   TCP or UDP socket.  Zero means that there is no limit.
+ *
+ * Input Parameters:
+ *   psock  - The socket to query
+ *   option - SO_RCVBUF or SO_SNDBUF
+ *   size   - The location to return the limit
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOPROTOOPT if the socket does not buffer data
+ *   in that direction.
+ *
+ ****************************************************************************/
+
+int inet_getbufsize(FAR struct socket *psock, int option, FAR int *size)
+{
+  FAR uint32_t *bufsize;
+
+  net_lock();
+  bufsize = inet_bufsize(psock, option);
+  if (bufsize == NULL)
+    {
+      net_unlock();
+      return -ENOPROTOOPT;
+    }
+
+  *size = *bufsize > INT_MAX ? INT_MAX : (int)*bufsize;
+  net_unlock();
+  return OK;
+}
+
+#endif /* CONFIG_NET_SOCKOPTS && (CONFIG_NET_IPv4 || CONFIG_NET_IPv6) */
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <stdbool.h>
 #include <assert.h>
 #include <errno.h>
@@ -88,6 +89,16 @@ static ssize_t    inet_sendto(FAR struct socket *psock, FAR const void *buf,
 static ssize_t    inet_sendfile(FAR struct socket *psock, FAR struct file *infile,
                     FAR off_t *offset, size_t count);
 #endif
+#ifndef CONFIG_NET_6LOWPAN
+static ssize_t    inet_sendmsg(FAR struct socket *psock,
+                    FAR const struct msghdr *msg, int flags);
+#endif
+static int        inet_sendmmsg(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+static int        inet_recvmmsg(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags, FAR const struct timespec *timeout);
 
 /****************************************************************************
  * Private Data
@@ -112,7 +123,15 @@ static const struct sock_intf_s g_inet_sockif =
   inet_sendfile,    /* si_sendfile */
 #endif
   inet_recvfrom,    /* si_recvfrom */
-  inet_close        /* si_close */
+  inet_close,       /* si_close */
+#ifndef CONFIG_NET_6LOWPAN
+  inet_sendmsg,     /* si_sendmsg */
+#else
+  NULL,             /* si_sendmsg */
+#endif
+  NULL,             /* si_recvmsg */
+  inet_sendmmsg,    /* si_sendmmsg */
+  inet_recvmmsg     /* si_recvmmsg */
 };
 
 /****************************************************************************
@@ -990,6 +1009,50 @@ static int inet_poll(FAR struct socket *psock, FAR struct pollfd *fds,
 }
 #endif /* !CONFIG_DISABLE_POLL */
 
+/****************************************************************************
+ * Name: inet_checkaddr
+ *
+ * Description:
+ *   Verify the destination address passed to sendto() or sendmsg().
+ *
+ * Returned Value:
+ *   The size of the address structure for the address family on success;
+ *   a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int inet_checkaddr(FAR const struct sockaddr *to, socklen_t tolen)
+{
+  socklen_t minlen;
+
+  switch (to->sa_family)
+    {
+#ifdef CONFIG_NET_IPv4
+    case AF_INET:
+      minlen = sizeof(struct sockaddr_in);
+      break;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+    case AF_INET6:
+      minlen = sizeof(struct sockaddr_in6);
+      break;
+#endif
+
+    default:
+      nerr("ERROR: Unrecognized address family: %d\n", to->sa_family);
+      return -EAFNOSUPPORT;
+    }
+
+  if (tolen < minlen)
+    {
+      nerr("ERROR: Invalid address length: %d < %d\n", tolen, minlen);
+      return -EBADF;
+    }
+
+  return (int)minlen;
+}
+
 /****************************************************************************
  * Name: inet_send
  *
@@ -1110,34 +1173,14 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
                            size_t len, int flags, FAR const struct sockaddr *to,
                            socklen_t tolen)
 {
-  socklen_t minlen;
   ssize_t nsent;
 
   /* Verify that a valid address has been provided */
 
-  switch (to->sa_family)
-    {
-#ifdef CONFIG_NET_IPv4
-    case AF_INET:
-      minlen = sizeof(struct sockaddr_in);
-      break;
-#endif
-
-#ifdef CONFIG_NET_IPv6
-    case AF_INET6:
-      minlen = sizeof(struct sockaddr_in6);
-      break;
-#endif
-
-    default:
-      nerr("ERROR: Unrecognized address family: %d\n", to->sa_family);
-      return -EAFNOSUPPORT;
-    }
-
-  if (tolen < minlen)
+  nsent = inet_checkaddr(to, tolen);
+  if (nsent < 0)
     {
-      nerr("ERROR: Invalid address length: %d < %d\n", tolen, minlen);
-      return -EBADF;
+      return nsent;
     }
 
 #ifdef CONFIG_NET_UDP
@@ -1154,7 +1197,7 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
 #if defined(CONFIG_NET_6LOWPAN)
   /* Try 6LoWPAN UDP packet sendto() */
 
-  nsent = psock_6lowpan_udp_sendto(psock, buf, len, flags, to, minlen);
+  nsent = psock_6lowpan_udp_sendto(psock, buf, len, flags, to, tolen);
 
 #ifdef NET_UDP_HAVE_STACK
   if (nsent < 0)
@@ -1178,6 +1221,153 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
   return nsent;
 }
 
+/****************************************************************************
+ * Name: inet_sendmsg
+ *
+ * Description:
+ *   Implements the sendmsg() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.  The data in the msg_iov[] array is passed to the
+ *   TCP or UDP layer as a whole so that it is sent as a single stream of
+ *   bytes (TCP) or as a single datagram (UDP).
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Message to send
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see sendmsg() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_6LOWPAN
+static ssize_t inet_sendmsg(FAR struct socket *psock,
+                            FAR const struct msghdr *msg, int flags)
+{
+  ssize_t ret;
+
+  switch (psock->s_type)
+    {
+#ifdef NET_TCP_HAVE_STACK
+      case SOCK_STREAM:
+        {
+          /* Any destination address is ignored on a connected stream */
+
+          ret = psock_tcp_sendv(psock, msg->msg_iov, msg->msg_iovlen);
+        }
+        break;
+#endif /* NET_TCP_HAVE_STACK */
+
+#ifdef NET_UDP_HAVE_STACK
+      case SOCK_DGRAM:
+        {
+          if (msg->msg_name == NULL)
+            {
+              ret = psock_udp_sendv(psock, msg->msg_iov, msg->msg_iovlen);
+            }
+          else
+            {
+              ret = inet_checkaddr((FAR const struct sockaddr *)msg->msg_name,
+                                   msg->msg_namelen);
+              if (ret >= 0)
+                {
+                  ret = psock_udp_sendtov(psock, msg->msg_iov,
+                                          msg->msg_iovlen, flags,
+                                          (FAR const struct sockaddr *)
+                                          msg->msg_name, msg->msg_namelen);
+                }
+            }
+        }
+        break;
+#endif /* NET_UDP_HAVE_STACK */
+
+      default:
+        {
+          nerr("ERROR:  Bad socket type: %d\n", psock->s_type);
+          ret = -EDESTADDRREQ;
+        }
+        break;
+    }
+
+  return ret;
+}
+#endif /* !CONFIG_NET_6LOWPAN */
+
+/****************************************************************************
+ * Name: inet_sendmmsg
+ *
+ * Description:
+ *   Implements the sendmmsg() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.  The network is locked once for the whole batch so
+ *   that the device cannot be polled part way through it.  With UDP write
+ *   buffering, all of the datagrams are then queued before the driver
+ *   takes the first one and they go out back-to-back in the next poll.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Messages to send
+ *   vlen     Number of messages in msgvec[]
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent or, if the first message could not be
+ *   sent, a negated errno value (see sendmsg() for the list of appropriate
+ *   error values).
+ *
+ ****************************************************************************/
+
+static int inet_sendmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec, unsigned int vlen,
+                         int flags)
+{
+  int ret;
+
+  net_lock();
+  ret = psock_sendmsg_batch(psock, msgvec, vlen, flags);
+  net_unlock();
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: inet_recvmmsg
+ *
+ * Description:
+ *   Implements the recvmmsg() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.  The network is locked once for the whole batch.
+ *   Datagrams already held in the read-ahead buffers are then all taken
+ *   without the lock being released in between.  The lock is released
+ *   only while waiting for a message to arrive.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Buffers to receive the messages
+ *   vlen     Number of messages in msgvec[]
+ *   flags    Receive flags
+ *   timeout  Optional limit on the time spent receiving
+ *
+ * Returned Value:
+ *   The number of messages received or, if the first message could not be
+ *   received, a negated errno value (see recvmsg() for the list of
+ *   appropriate error values).
+ *
+ ****************************************************************************/
+
+static int inet_recvmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec, unsigned int vlen,
+                         int flags, FAR const struct timespec *timeout)
+{
+  int ret;
+
+  net_lock();
+  ret = psock_recvmsg_batch(psock, msgvec, vlen, flags, timeout);
+  net_unlock();
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: inet_sendfile
  *
@@ -1204,7 +1394,7 @@ static ssize_t inet_sendfile(FAR struct socket *psock,
                              size_t count)
 {
 #if defined(CONFIG_NET_TCP) && !defined(CONFIG_NET_TCP_NO_STACK)
-  return tcp_sendfile(psock, infile, offset, size_t count);
+  return tcp_sendfile(psock, infile, offset, count);
 #else
   return -ENOSYS;
 #endif
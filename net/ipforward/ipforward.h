@@ -44,7 +44,10 @@
 
 #include <stdint.h>
 
+#include <nuttx/net/ip.h>
+
 #undef HAVE_FWDALLOC
+#undef IPFWD_HAVE_FLOWCACHE
 #ifdef CONFIG_NET_IPFORWARD
 
 /****************************************************************************
@@ -57,6 +60,18 @@
 #  define CONFIG_NET_IPFORWARD_NSTRUCT 4
 #endif
 
+#ifndef CONFIG_NET_IPFORWARD_NFLOWS
+#  define CONFIG_NET_IPFORWARD_NFLOWS 0
+#endif
+
+#ifndef CONFIG_NET_IPFORWARD_FLOWAGE
+#  define CONFIG_NET_IPFORWARD_FLOWAGE 1000
+#endif
+
+#if CONFIG_NET_IPFORWARD_NFLOWS > 0
+#  define IPFWD_HAVE_FLOWCACHE 1
+#endif
+
 /* Allocate a new IP forwarding data callback */
 
 #define ipfwd_callback_alloc(dev)   devif_callback_alloc(dev, &(dev)->d_conncb)
@@ -83,6 +98,23 @@ struct forward_s
 #endif
 };
 
+#ifdef IPFWD_HAVE_FLOWCACHE
+/* Identifies a flow of forwarded packets.  IPv4 addresses occupy the first
+ * four bytes of the address fields.  The ports are zero unless the packet
+ * is TCP or UDP.
+ */
+
+struct ipfwd_flowkey_s
+{
+  net_ipv6addr_t fk_srcipaddr;  /* Source address */
+  net_ipv6addr_t fk_destipaddr; /* Destination address */
+  uint16_t       fk_srcport;    /* Source port, network order */
+  uint16_t       fk_destport;   /* Destination port, network order */
+  uint8_t        fk_proto;      /* IP protocol */
+  uint8_t        fk_domain;     /* PF_INET or PF_INET6 */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -132,6 +164,19 @@ FAR struct forward_s *ipfwd_alloc(void);
 
 void ipfwd_free(FAR struct forward_s *fwd);
 
+/****************************************************************************
+ * Name: ipfwd_navail
+ *
+ * Description:
+ *   Return the number of free forwarding structures.
+ *
+ * Assumptions:
+ *   Caller holds the network lock.
+ *
+ ****************************************************************************/
+
+int ipfwd_navail(void);
+
 /****************************************************************************
  * Name: ipv4_forward_broadcast
  *
@@ -245,13 +290,84 @@ int ipfwd_forward(FAR struct forward_s *fwd);
  * Description:
  *   Poll all pending transfer for ARP requests to send.
  *
+ * Returned Value:
+ *   Non-zero if a forwarded packet was placed in d_buf and its forwarding
+ *   structure released.  The device may then be polled again for the next
+ *   packet.
+ *
  * Assumptions:
  *   This function is called from the MAC device driver indirectly through
  *   devif_poll() and devif_timer().
  *
  ****************************************************************************/
 
-void ipfwd_poll(FAR struct net_driver_s *dev);
+int ipfwd_poll(FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Name: ipfwd_flow_lookup
+ *
+ * Description:
+ *   Return the device that the last packet of a flow was forwarded on.
+ *   This saves the routing decision for each following packet.
+ *
+ * Input Parameters:
+ *   key - Identifies the flow
+ *
+ * Returned Value:
+ *   The forwarding device or NULL if the flow is not in the cache, has
+ *   expired or its device is down.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef IPFWD_HAVE_FLOWCACHE
+FAR struct net_driver_s *
+  ipfwd_flow_lookup(FAR const struct ipfwd_flowkey_s *key);
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flow_add
+ *
+ * Description:
+ *   Remember the device that a flow is forwarded on, replacing whatever
+ *   flow occupied the same cache slot.
+ *
+ * Input Parameters:
+ *   key    - Identifies the flow
+ *   fwddev - The forwarding device
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef IPFWD_HAVE_FLOWCACHE
+void ipfwd_flow_add(FAR const struct ipfwd_flowkey_s *key,
+                    FAR struct net_driver_s *fwddev);
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flowkey_ipv4 and ipfwd_flowkey_ipv6
+ *
+ * Description:
+ *   Set up the flow key of a packet to be forwarded.
+ *
+ ****************************************************************************/
+
+#if defined(IPFWD_HAVE_FLOWCACHE) && defined(CONFIG_NET_IPv4)
+void ipfwd_flowkey_ipv4(FAR struct ipfwd_flowkey_s *key,
+                        FAR struct ipv4_hdr_s *ipv4);
+#endif
+
+#if defined(IPFWD_HAVE_FLOWCACHE) && defined(CONFIG_NET_IPv6)
+void ipfwd_flowkey_ipv6(FAR struct ipfwd_flowkey_s *key,
+                        FAR struct ipv6_hdr_s *ipv6);
+#endif
 
 /****************************************************************************
  * Name: ipfwd_dropstats
@@ -376,4 +492,24 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #endif
 
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipfwd_flow_flush
+ *
+ * Description:
+ *   Forget the cached forwarding decisions for flows on a device, or for
+ *   all flows if 'dev' is NULL.  This must be called when a device goes
+ *   away or the routing table is changed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef IPFWD_HAVE_FLOWCACHE
+void ipfwd_flow_flush(FAR struct net_driver_s *dev);
+#else
+#  define ipfwd_flow_flush(dev)
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
@@ -86,6 +86,7 @@ static struct forward_s g_fwdpool[CONFIG_NET_IPFORWARD_NSTRUCT];
 /* This is a list of free forwarding structures */
 
 static FAR struct forward_s *g_fwdfree;
+static uint8_t g_fwdnfree;
 
 /****************************************************************************
  * Public Functions
@@ -115,7 +116,8 @@ void ipfwd_initialize(void)
 
   /* Add all pre-allocated forwarding structures to the free list */
 
-  g_fwdfree = NULL;
+  g_fwdfree  = NULL;
+  g_fwdnfree = CONFIG_NET_IPFORWARD_NSTRUCT;
 
   for (i = 0; i < CONFIG_NET_IPFORWARD_NSTRUCT; i++)
     {
@@ -146,6 +148,7 @@ FAR struct forward_s *ipfwd_alloc(void)
   if (fwd != NULL)
     {
       g_fwdfree = fwd->f_flink;
+      g_fwdnfree--;
       memset (fwd, 0, sizeof(struct forward_s));
     }
 
@@ -168,6 +171,23 @@ void ipfwd_free(FAR struct forward_s *fwd)
 {
   fwd->f_flink = g_fwdfree;
   g_fwdfree    = fwd;
+  g_fwdnfree++;
+}
+
+/****************************************************************************
+ * Name: ipfwd_navail
+ *
+ * Description:
+ *   Return the number of free forwarding structures.
+ *
+ * Assumptions:
+ *   Caller holds the network lock.
+ *
+ ****************************************************************************/
+
+int ipfwd_navail(void)
+{
+  return g_fwdnfree;
 }
 
 #endif /* CONFIG_NET_IPFORWARD */
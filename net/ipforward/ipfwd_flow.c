@@ -0,0 +1,288 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flow.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <sys/socket.h>
+#include <net/if.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+
+#include "ipforward/ipforward.h"
+
+#ifdef IPFWD_HAVE_FLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPFWD_FLOWAGE  MSEC2TICK(CONFIG_NET_IPFORWARD_FLOWAGE)
+
+/* IPv4 fragmentation flags and offset, in host order */
+
+#define IPv4_FRAGMASK  0x3fff
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One slot of the flow cache */
+
+struct ipfwd_flow_s
+{
+  struct ipfwd_flowkey_s   fl_key;  /* Flow of the cached decision */
+  FAR struct net_driver_s *fl_dev;  /* Forwarding device, NULL if unused */
+  systime_t                fl_time; /* Time that the route was found */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The flow cache is direct mapped:  A flow can only be held in the slot
+ * that its key hashes to.
+ */
+
+static struct ipfwd_flow_s g_ipfwd_flows[CONFIG_NET_IPFORWARD_NFLOWS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_flow_slot
+ *
+ * Description:
+ *   Return the cache slot of a flow.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfwd_flow_s *
+  ipfwd_flow_slot(FAR const struct ipfwd_flowkey_s *key)
+{
+  uint32_t hash;
+  int i;
+
+  hash = ((uint32_t)key->fk_srcport << 16 | key->fk_destport) ^
+         key->fk_proto;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash = hash * 31 + (key->fk_srcipaddr[i] ^ key->fk_destipaddr[i]);
+    }
+
+  hash ^= hash >> 16;
+  return &g_ipfwd_flows[hash % CONFIG_NET_IPFORWARD_NFLOWS];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfwd_flowkey_ipv4
+ *
+ * Description:
+ *   Set up the flow key of an IPv4 packet to be forwarded.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void ipfwd_flowkey_ipv4(FAR struct ipfwd_flowkey_s *key,
+                        FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR const uint8_t *l4hdr;
+  uint16_t fragoff;
+
+  memset(key, 0, sizeof(struct ipfwd_flowkey_s));
+  memcpy(key->fk_srcipaddr, ipv4->srcipaddr, sizeof(in_addr_t));
+  memcpy(key->fk_destipaddr, ipv4->destipaddr, sizeof(in_addr_t));
+  key->fk_proto  = ipv4->proto;
+  key->fk_domain = PF_INET;
+
+  /* Only an unfragmented packet is sure to hold the ports */
+
+  fragoff = ((uint16_t)ipv4->ipoffset[0] << 8) | ipv4->ipoffset[1];
+  if ((fragoff & IPv4_FRAGMASK) == 0 &&
+      (ipv4->proto == IP_PROTO_TCP || ipv4->proto == IP_PROTO_UDP))
+    {
+      l4hdr = (FAR const uint8_t *)ipv4 + ((ipv4->vhl & 0x0f) << 2);
+      memcpy(&key->fk_srcport, &l4hdr[0], sizeof(uint16_t));
+      memcpy(&key->fk_destport, &l4hdr[2], sizeof(uint16_t));
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flowkey_ipv6
+ *
+ * Description:
+ *   Set up the flow key of an IPv6 packet to be forwarded.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+void ipfwd_flowkey_ipv6(FAR struct ipfwd_flowkey_s *key,
+                        FAR struct ipv6_hdr_s *ipv6)
+{
+  FAR const uint8_t *l4hdr;
+
+  memset(key, 0, sizeof(struct ipfwd_flowkey_s));
+  net_ipv6addr_copy(key->fk_srcipaddr, ipv6->srcipaddr);
+  net_ipv6addr_copy(key->fk_destipaddr, ipv6->destipaddr);
+  key->fk_proto  = ipv6->proto;
+  key->fk_domain = PF_INET6;
+
+  /* The ports are only found if there are no extension headers */
+
+  if (ipv6->proto == IP_PROTO_TCP || ipv6->proto == IP_PROTO_UDP)
+    {
+      l4hdr = (FAR const uint8_t *)ipv6 + IPv6_HDRLEN;
+      memcpy(&key->fk_srcport, &l4hdr[0], sizeof(uint16_t));
+      memcpy(&key->fk_destport, &l4hdr[2], sizeof(uint16_t));
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flow_lookup
+ *
+ * Description:
+ *   Return the device that the last packet of a flow was forwarded on.
+ *   This saves the routing decision for each following packet.
+ *
+ * Input Parameters:
+ *   key - Identifies the flow
+ *
+ * Returned Value:
+ *   The forwarding device or NULL if the flow is not in the cache, has
+ *   expired or its device is down.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct net_driver_s *
+  ipfwd_flow_lookup(FAR const struct ipfwd_flowkey_s *key)
+{
+  FAR struct ipfwd_flow_s *flow = ipfwd_flow_slot(key);
+
+  if (flow->fl_dev == NULL ||
+      memcmp(&flow->fl_key, key, sizeof(struct ipfwd_flowkey_s)) != 0)
+    {
+      return NULL;
+    }
+
+  /* The decision is re-made from time to time so that changes of the
+   * device addresses are picked up.
+   */
+
+  if ((systime_t)(clock_systimer() - flow->fl_time) >= IPFWD_FLOWAGE ||
+      !IFF_IS_UP(flow->fl_dev->d_flags))
+    {
+      flow->fl_dev = NULL;
+      return NULL;
+    }
+
+  return flow->fl_dev;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_add
+ *
+ * Description:
+ *   Remember the device that a flow is forwarded on, replacing whatever
+ *   flow occupied the same cache slot.
+ *
+ * Input Parameters:
+ *   key    - Identifies the flow
+ *   fwddev - The forwarding device
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipfwd_flow_add(FAR const struct ipfwd_flowkey_s *key,
+                    FAR struct net_driver_s *fwddev)
+{
+  FAR struct ipfwd_flow_s *flow = ipfwd_flow_slot(key);
+
+  memcpy(&flow->fl_key, key, sizeof(struct ipfwd_flowkey_s));
+  flow->fl_dev  = fwddev;
+  flow->fl_time = clock_systimer();
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_flush
+ *
+ * Description:
+ *   Forget the cached forwarding decisions for flows on a device, or for
+ *   all flows if 'dev' is NULL.  This must be called when a device goes
+ *   away or the routing table is changed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipfwd_flow_flush(FAR struct net_driver_s *dev)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPFORWARD_NFLOWS; i++)
+    {
+      if (dev == NULL || g_ipfwd_flows[i].fl_dev == dev)
+        {
+          g_ipfwd_flows[i].fl_dev = NULL;
+        }
+    }
+}
+
+#endif /* IPFWD_HAVE_FLOWCACHE */
@@ -166,15 +166,21 @@ static void ipfwd_packet_conversion(FAR struct net_driver_s *dev, int proto)
  * Description:
  *   Poll all pending transfer for ARP requests to send.
  *
+ * Returned Value:
+ *   Non-zero if a forwarded packet was placed in d_buf and its forwarding
+ *   structure released.  The device may then be polled again for the next
+ *   packet.
+ *
  * Assumptions:
  *   This function is called from the MAC device driver indirectly through
  *   devif_poll() and devif_timer().
  *
  ****************************************************************************/
 
-void ipfwd_poll(FAR struct net_driver_s *dev)
+int ipfwd_poll(FAR struct net_driver_s *dev)
 {
   uint16_t flags;
+  int navail = ipfwd_navail();
 
   /* Setup for the callback (most of these do not apply) */
 
@@ -204,6 +210,13 @@ void ipfwd_poll(FAR struct net_driver_s *dev)
 #else
   UNUSED(flags);
 #endif
+
+  /* A forwarding structure is only released when its packet has gone out
+   * (or been dropped).  If the packet was replaced by an ARP request or a
+   * Neighbor Solicitation, it is still pending.
+   */
+
+  return ipfwd_navail() > navail;
 }
 
 #endif /* CONFIG_NET_ARP_SEND */
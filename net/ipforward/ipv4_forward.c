@@ -146,7 +146,8 @@ static int ipv4_hdrsize(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 {
-  uint16_t sum;
+  uint16_t oldword;
+  uint16_t newword;
   int ttl = (int)ipv4->ttl - 1;
 
   if (ttl <= 0)
@@ -163,25 +164,15 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
   /* Save the updated TTL value */
 
+  oldword   = HTONS(((uint16_t)ipv4->ttl << 8) | ipv4->proto);
   ipv4->ttl = ttl;
+  newword   = HTONS(((uint16_t)ipv4->ttl << 8) | ipv4->proto);
 
-  /* Re-calculate the IPv4 checksum.  This checksum is the Internet checksum
-   * of the 20 bytes of the IPv4 header.  This checksum will be different
-   * because we just modify the IPv4 TTL.
+  /* Update the IPv4 checksum for the changed 16-bit word of the header
+   * instead of summing the whole header again.
    */
 
-  ipv4->ipchksum = 0;
-  sum            = chksum(0, (FAR const uint8_t *)ipv4, IPv4_HDRLEN);
-  if (sum == 0)
-    {
-      sum = 0xffff;
-    }
-  else
-    {
-      sum = htons(sum);
-    }
-
-  ipv4->ipchksum = ~sum;
+  ipv4->ipchksum = net_chksum_adjust(ipv4->ipchksum, oldword, newword);
   return ttl;
 }
 
@@ -429,18 +420,36 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   in_addr_t destipaddr;
   in_addr_t srcipaddr;
   FAR struct net_driver_s *fwddev;
+#ifdef IPFWD_HAVE_FLOWCACHE
+  struct ipfwd_flowkey_s key;
+#endif
   int ret;
 
-  /* Search for a device that can forward this packet. */
-
-  destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
-  srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+#ifdef IPFWD_HAVE_FLOWCACHE
+  /* Packets of a flow that was forwarded recently go out on the same
+   * device without searching the routing table again.
+   */
 
-  fwddev     = netdev_findby_ipv4addr(srcipaddr, destipaddr);
+  ipfwd_flowkey_ipv4(&key, ipv4);
+  fwddev = ipfwd_flow_lookup(&key);
   if (fwddev == NULL)
+#endif
     {
-      nwarn("WARNING: Not routable\n");
-      return (ssize_t)-ENETUNREACH;
+      /* Search for a device that can forward this packet. */
+
+      destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+      srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+
+      fwddev     = netdev_findby_ipv4addr(srcipaddr, destipaddr);
+      if (fwddev == NULL)
+        {
+          nwarn("WARNING: Not routable\n");
+          return (ssize_t)-ENETUNREACH;
+        }
+
+#ifdef IPFWD_HAVE_FLOWCACHE
+      ipfwd_flow_add(&key, fwddev);
+#endif
     }
 
   /* Check if we are forwarding on the same device that we received the
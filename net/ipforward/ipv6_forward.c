@@ -569,15 +569,33 @@ int ipv6_forward_callback(FAR struct net_driver_s *fwddev, FAR void *arg)
 int ipv6_forward(FAR struct net_driver_s *dev, FAR struct ipv6_hdr_s *ipv6)
 {
   FAR struct net_driver_s *fwddev;
+#ifdef IPFWD_HAVE_FLOWCACHE
+  struct ipfwd_flowkey_s key;
+#endif
   int ret;
 
-  /* Search for a device that can forward this packet. */
+#ifdef IPFWD_HAVE_FLOWCACHE
+  /* Packets of a flow that was forwarded recently go out on the same
+   * device without searching the routing table again.
+   */
 
-  fwddev = netdev_findby_ipv6addr(ipv6->srcipaddr, ipv6->destipaddr);
+  ipfwd_flowkey_ipv6(&key, ipv6);
+  fwddev = ipfwd_flow_lookup(&key);
   if (fwddev == NULL)
+#endif
     {
-      nwarn("WARNING: Not routable\n");
-      return (ssize_t)-ENETUNREACH;
+      /* Search for a device that can forward this packet. */
+
+      fwddev = netdev_findby_ipv6addr(ipv6->srcipaddr, ipv6->destipaddr);
+      if (fwddev == NULL)
+        {
+          nwarn("WARNING: Not routable\n");
+          return (ssize_t)-ENETUNREACH;
+        }
+
+#ifdef IPFWD_HAVE_FLOWCACHE
+      ipfwd_flow_add(&key, fwddev);
+#endif
     }
 
   /* Check if we are forwarding on the same device that we received the
@@ -46,6 +46,7 @@
  ****************************************************************************/
 
 #include <stdint.h>
+#include <queue.h>
 
 #include <net/ethernet.h>
 
@@ -66,6 +67,36 @@
 
 #define NEIGHBOR_MAXTIME 128
 
+/* Number of hash buckets:  A power of two no smaller than the table */
+
+#if CONFIG_NET_IPv6_NCONF_ENTRIES <= 8
+#  define NEIGHBOR_HASH_SIZE 8
+#elif CONFIG_NET_IPv6_NCONF_ENTRIES <= 16
+#  define NEIGHBOR_HASH_SIZE 16
+#elif CONFIG_NET_IPv6_NCONF_ENTRIES <= 32
+#  define NEIGHBOR_HASH_SIZE 32
+#else
+#  define NEIGHBOR_HASH_SIZE 64
+#endif
+
+#define NEIGHBOR_NOHASH  0xff   /* ne_hash value of an unused entry */
+
+/* Values of ne_flags */
+
+#define NEIGHBOR_INCOMPLETE (1 << 0) /* Solicited, no link layer address */
+#define NEIGHBOR_FLUSH      (1 << 1) /* Resolved with packets to send */
+
+/* An incomplete entry is dropped after this many half seconds */
+
+#define NEIGHBOR_INCOMPLETE_MAXTIME 6
+
+/* Packets may be held in I/O buffers while their destination is resolved */
+
+#if defined(CONFIG_MM_IOB) && defined(CONFIG_NET_IPv6_NPENDING) && \
+    CONFIG_NET_IPv6_NPENDING > 0
+#  define NEIGHBOR_HAVE_PENDING 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -92,11 +123,23 @@ struct neighbor_addr_s
  * for internal use within the Neighbor implementation.
  */
 
+struct iob_s;        /* Forward reference */
+struct net_driver_s; /* Forward reference */
+
 struct neighbor_entry
 {
+  dq_entry_t             ne_node;    /* LRU list, most recently used first */
+  FAR struct neighbor_entry *ne_hnext; /* Next entry in the hash chain */
   net_ipv6addr_t         ne_ipaddr;  /* IPv6 address of the Neighbor */
   struct neighbor_addr_s ne_addr;    /* Link layer address of the Neighbor */
   uint8_t                ne_time;    /* For aging, units of half seconds */
+  uint8_t                ne_hash;    /* Hash chain or NEIGHBOR_NOHASH */
+  uint8_t                ne_flags;   /* See NEIGHBOR_* flag definitions */
+#ifdef NEIGHBOR_HAVE_PENDING
+  uint8_t                ne_npending; /* Number of packets in ne_pending[] */
+  FAR struct net_driver_s *ne_dev;   /* Device the packets are sent on */
+  FAR struct iob_s      *ne_pending[CONFIG_NET_IPv6_NPENDING];
+#endif
 };
 
 /****************************************************************************
@@ -109,12 +152,24 @@ struct neighbor_entry
 
 extern struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* Entries in use are hashed by IPv6 address.  All entries are kept in an
+ * LRU list, most recently used first, so that the entry to be replaced is
+ * always at the tail.
+ */
+
+extern FAR struct neighbor_entry *g_neighbor_hash[NEIGHBOR_HASH_SIZE];
+extern dq_queue_t g_neighbor_lru;
+
+#ifdef NEIGHBOR_HAVE_PENDING
+/* Number of resolved entries with packets waiting to be sent */
+
+extern uint8_t g_neighbor_nflush;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
-struct net_driver_s; /* Forward reference */
-
 /****************************************************************************
  * Name: neighbor_initialize
  *
@@ -134,12 +189,68 @@ struct net_driver_s; /* Forward reference */
 
 void neighbor_initialize(void);
 
+/****************************************************************************
+ * Name: neighbor_hashfind
+ *
+ * Description:
+ *   Find the entry of an IPv6 address in the Neighbor Table, whether the
+ *   address has been resolved or not.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address to use in the lookup;
+ *
+ * Returned Value:
+ *   The Neighbor Table entry or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry *neighbor_hashfind(const net_ipv6addr_t ipaddr);
+
+/****************************************************************************
+ * Name: neighbor_touch
+ *
+ * Description:
+ *   Make a Neighbor Table entry the most recently used.
+ *
+ ****************************************************************************/
+
+void neighbor_touch(FAR struct neighbor_entry *neighbor);
+
+/****************************************************************************
+ * Name: neighbor_allocate
+ *
+ * Description:
+ *   Take the least recently used entry of the Neighbor Table, dropping
+ *   whatever it held, and hash it under a new IPv6 address.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address of the new entry
+ *
+ * Returned Value:
+ *   The new entry, which is made the most recently used.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry *neighbor_allocate(const net_ipv6addr_t ipaddr);
+
+/****************************************************************************
+ * Name: neighbor_release
+ *
+ * Description:
+ *   Remove an entry from its hash chain, drop any packets that it holds
+ *   and make it the first candidate for reuse.
+ *
+ ****************************************************************************/
+
+void neighbor_release(FAR struct neighbor_entry *neighbor);
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
  * Description:
  *   Find an entry in the Neighbor Table.  This interface is internal to
  *   the neighbor implementation; Consider using neighbor_lookup() instead;
+ *   Addresses that are still being resolved are not returned.
  *
  * Input Parameters:
  *   ipaddr - The IPv6 address to use in the lookup;
@@ -225,6 +336,51 @@ void neighbor_update(const net_ipv6addr_t ipaddr);
 
 void neighbor_periodic(int hsec);
 
+/****************************************************************************
+ * Name: neighbor_queue
+ *
+ * Description:
+ *   Hold on to the IPv6 packet in d_buf until the link layer address of
+ *   'ipaddr' has been resolved.  The packet is sent from the next poll of
+ *   the device after the Neighbor Advertisement arrives.
+ *
+ * Input Parameters:
+ *   dev    - The device that the packet is to be sent on
+ *   ipaddr - The IPv6 address being resolved (the destination or router)
+ *
+ * Returned Value:
+ *   None.  The packet is dropped if there is no free I/O buffer.
+ *
+ * Assumptions
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef NEIGHBOR_HAVE_PENDING
+void neighbor_queue(FAR struct net_driver_s *dev,
+                    const net_ipv6addr_t ipaddr);
+#else
+#  define neighbor_queue(d,i)
+#endif
+
+/****************************************************************************
+ * Name: neighbor_pending_poll
+ *
+ * Description:
+ *   Send the packets that were waiting for an address that has now been
+ *   resolved.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef NEIGHBOR_HAVE_PENDING
+int neighbor_pending_poll(FAR struct net_driver_s *dev,
+                          devif_poll_callback_t callback);
+#endif
+
 /****************************************************************************
  * Name: neighbor_dumpentry
  *
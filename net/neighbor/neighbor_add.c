@@ -80,55 +80,47 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
-  uint8_t lltype;
-  uint8_t oldest_time;
-  int     oldest_ndx;
-  int     i;
+  FAR struct neighbor_entry *neighbor;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the first unused entry or the oldest used entry. */
-
-  oldest_time = 0;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  /* Update the existing entry for the IPv6 address, if there is one.
+   * Otherwise, the least recently used entry is replaced.
+   */
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  neighbor = neighbor_hashfind(ipaddr);
+  if (neighbor == NULL)
     {
-      if (g_neighbors[i].ne_time == NEIGHBOR_MAXTIME)
-        {
-          oldest_ndx = i;
-          break;
-        }
-
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
-        {
-          oldest_ndx = i;
-          break;
-        }
-
-      if (g_neighbors[i].ne_time > oldest_time)
-        {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
-        }
+      neighbor = neighbor_allocate(ipaddr);
+    }
+  else
+    {
+      neighbor_touch(neighbor);
     }
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+  neighbor->ne_time = 0;
+  neighbor->ne_addr.na_lltype = dev->d_lltype;
+  neighbor->ne_addr.na_llsize = netdev_dev_lladdrsize(dev);
 
-  g_neighbors[oldest_ndx].ne_time = 0;
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_dev_lladdrsize(dev);
+#ifdef NEIGHBOR_HAVE_PENDING
+  /* If packets were waiting for this address, have the device poll for
+   * them now.
+   */
+
+  if ((neighbor->ne_flags & NEIGHBOR_INCOMPLETE) != 0 &&
+      neighbor->ne_npending > 0)
+    {
+      neighbor->ne_flags |= NEIGHBOR_FLUSH;
+      g_neighbor_nflush++;
+      netdev_txnotify_dev(neighbor->ne_dev);
+    }
+#endif
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  neighbor->ne_flags &= ~NEIGHBOR_INCOMPLETE;
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
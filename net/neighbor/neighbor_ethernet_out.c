@@ -231,9 +231,11 @@ void neighbor_out(FAR struct net_driver_s *dev)
 
           /* The destination address was not in our Neighbor Table, so we
            * overwrite the IPv6 packet with an ICMDv6 Neighbor Solicitation
-           * message.
+           * message.  Keep a copy of the packet to send once the address
+           * has been resolved.
            */
 
+          neighbor_queue(dev, ipaddr);
           icmpv6_solicit(dev, ipaddr);
           return;
         }
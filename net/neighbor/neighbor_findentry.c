@@ -58,6 +58,7 @@
  * Description:
  *   Find an entry in the Neighbor Table.  This interface is internal to
  *   the neighbor implementation; Consider using neighbor_lookup() instead;
+ *   Addresses that are still being resolved are not returned.
  *
  * Input Parameters:
  *   ipaddr - The IPv6 address to use in the lookup;
@@ -70,17 +71,14 @@
 
 FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_entry *neighbor;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  neighbor = neighbor_hashfind(ipaddr);
+  if (neighbor != NULL && (neighbor->ne_flags & NEIGHBOR_INCOMPLETE) == 0)
     {
-      FAR struct neighbor_entry *neighbor = &g_neighbors[i];
-
-      if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
-        {
-          neighbor_dumpentry("Entry found", neighbor);
-          return neighbor;
-        }
+      neighbor_touch(neighbor);
+      neighbor_dumpentry("Entry found", neighbor);
+      return neighbor;
     }
 
   neighbor_dumpipaddr("Not found", ipaddr);
@@ -42,6 +42,10 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <string.h>
+#include <queue.h>
+
 #include <nuttx/clock.h>
 
 #include "neighbor/neighbor.h"
@@ -56,6 +60,17 @@
 
 struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* Hash chains and LRU list of the Neighbor table */
+
+FAR struct neighbor_entry *g_neighbor_hash[NEIGHBOR_HASH_SIZE];
+dq_queue_t g_neighbor_lru;
+
+#ifdef NEIGHBOR_HAVE_PENDING
+/* Number of resolved entries with packets waiting to be sent */
+
+uint8_t g_neighbor_nflush;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -81,8 +96,14 @@ void neighbor_initialize(void)
 {
   int i;
 
+  dq_init(&g_neighbor_lru);
+  memset(g_neighbor_hash, 0, sizeof(g_neighbor_hash));
+
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
     {
+      memset(&g_neighbors[i], 0, sizeof(struct neighbor_entry));
       g_neighbors[i].ne_time = NEIGHBOR_MAXTIME;
+      g_neighbors[i].ne_hash = NEIGHBOR_NOHASH;
+      dq_addlast(&g_neighbors[i].ne_node, &g_neighbor_lru);
     }
 }
@@ -85,6 +85,14 @@ void neighbor_periodic(int hsec)
             }
 
           g_neighbors[i].ne_time = newtime;
+
+          /* Give up on addresses that have not been resolved in time */
+
+          if ((g_neighbors[i].ne_flags & NEIGHBOR_INCOMPLETE) != 0 &&
+              newtime >= NEIGHBOR_INCOMPLETE_MAXTIME)
+            {
+              neighbor_release(&g_neighbors[i]);
+            }
         }
     }
 }
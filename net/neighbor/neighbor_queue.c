@@ -0,0 +1,194 @@
+/****************************************************************************
+ * net/neighbor/neighbor_queue.c
+ *
+ *   Copyright (C) 2007-2009, 2015, 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * A leverage of logic from uIP which also has a BSD style license
+ *
+ *   Copyright (c) 2006, Swedish Institute of Computer Science.  All rights
+ *     reserved.
+ *   Author: Adam Dunkels <adam@sics.se>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+
+#include "neighbor/neighbor.h"
+
+#ifdef NEIGHBOR_HAVE_PENDING
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_queue
+ *
+ * Description:
+ *   Hold on to the IPv6 packet in d_buf until the link layer address of
+ *   'ipaddr' has been resolved.  If too many packets are already waiting
+ *   for the address, the oldest is dropped.
+ *
+ * Input Parameters:
+ *   dev    - The device that the packet is to be sent on
+ *   ipaddr - The IPv6 address being resolved (the destination or router)
+ *
+ * Returned Value:
+ *   None.  The packet is dropped if there is no free I/O buffer.
+ *
+ * Assumptions
+ *   The network is locked.  The packet follows the link layer header space
+ *   in d_buf and d_len holds its length.
+ *
+ ****************************************************************************/
+
+void neighbor_queue(FAR struct net_driver_s *dev,
+                    const net_ipv6addr_t ipaddr)
+{
+  FAR struct neighbor_entry *neighbor;
+  FAR struct iob_s *iob;
+  int ret;
+
+  neighbor = neighbor_hashfind(ipaddr);
+  if (neighbor == NULL)
+    {
+      neighbor = neighbor_allocate(ipaddr);
+      neighbor->ne_flags = NEIGHBOR_INCOMPLETE;
+    }
+  else if ((neighbor->ne_flags & NEIGHBOR_INCOMPLETE) == 0)
+    {
+      return;
+    }
+
+  /* Copy the packet into an I/O buffer chain without waiting */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      return;
+    }
+
+  ret = iob_trycopyin(iob, &dev->d_buf[NET_LL_HDRLEN(dev)], dev->d_len, 0,
+                      true);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return;
+    }
+
+  if (neighbor->ne_npending >= CONFIG_NET_IPv6_NPENDING)
+    {
+      iob_free_chain(neighbor->ne_pending[0]);
+      memmove(&neighbor->ne_pending[0], &neighbor->ne_pending[1],
+              (CONFIG_NET_IPv6_NPENDING - 1) * sizeof(FAR struct iob_s *));
+      neighbor->ne_npending--;
+    }
+
+  neighbor->ne_pending[neighbor->ne_npending++] = iob;
+  neighbor->ne_dev = dev;
+}
+
+/****************************************************************************
+ * Name: neighbor_pending_poll
+ *
+ * Description:
+ *   Send the packets that were waiting for an address that has now been
+ *   resolved.  Each packet is placed in d_buf in turn and passed to the
+ *   driver callback, which adds the link layer header.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+int neighbor_pending_poll(FAR struct net_driver_s *dev,
+                          devif_poll_callback_t callback)
+{
+  FAR struct neighbor_entry *neighbor;
+  FAR struct iob_s *iob;
+  int bstop = 0;
+  int i;
+
+  /* The callback looks up the entry again and so reorders the LRU list.
+   * Walk the table itself.
+   */
+
+  for (i = 0;
+       g_neighbor_nflush > 0 && i < CONFIG_NET_IPv6_NCONF_ENTRIES && !bstop;
+       i++)
+    {
+      neighbor = &g_neighbors[i];
+      if ((neighbor->ne_flags & NEIGHBOR_FLUSH) == 0 ||
+          neighbor->ne_dev != dev)
+        {
+          continue;
+        }
+
+      while (neighbor->ne_npending > 0 && !bstop)
+        {
+          iob = neighbor->ne_pending[0];
+          neighbor->ne_npending--;
+          memmove(&neighbor->ne_pending[0], &neighbor->ne_pending[1],
+                  neighbor->ne_npending * sizeof(FAR struct iob_s *));
+
+          dev->d_len    = iob->io_pktlen;
+          dev->d_sndlen = 0;
+          (void)iob_copyout(&dev->d_buf[NET_LL_HDRLEN(dev)], iob,
+                            iob->io_pktlen, 0);
+          iob_free_chain(iob);
+
+          IFF_SET_IPv6(dev->d_flags);
+          bstop = callback(dev);
+        }
+
+      if (neighbor->ne_npending == 0)
+        {
+          neighbor->ne_flags &= ~NEIGHBOR_FLUSH;
+          g_neighbor_nflush--;
+        }
+    }
+
+  return bstop;
+}
+
+#endif /* NEIGHBOR_HAVE_PENDING */
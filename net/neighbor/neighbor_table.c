@@ -0,0 +1,217 @@
+/****************************************************************************
+ * net/neighbor/neighbor_table.c
+ *
+ *   Copyright (C) 2007-2009, 2015, 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * A leverage of logic from uIP which also has a BSD style license
+ *
+ *   Copyright (c) 2006, Swedish Institute of Computer Science.  All rights
+ *     reserved.
+ *   Author: Adam Dunkels <adam@sics.se>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <queue.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ip.h>
+
+#include "neighbor/neighbor.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash chain of an IPv6 address.
+ *
+ ****************************************************************************/
+
+static unsigned int neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint16_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash ^= ipaddr[i];
+    }
+
+  hash ^= hash >> 8;
+  return hash & (NEIGHBOR_HASH_SIZE - 1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hashfind
+ *
+ * Description:
+ *   Find the entry of an IPv6 address in the Neighbor Table, whether the
+ *   address has been resolved or not.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address to use in the lookup;
+ *
+ * Returned Value:
+ *   The Neighbor Table entry or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry *neighbor_hashfind(const net_ipv6addr_t ipaddr)
+{
+  FAR struct neighbor_entry *neighbor;
+
+  for (neighbor = g_neighbor_hash[neighbor_hash(ipaddr)];
+       neighbor != NULL;
+       neighbor = neighbor->ne_hnext)
+    {
+      if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+        {
+          return neighbor;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: neighbor_touch
+ *
+ * Description:
+ *   Make a Neighbor Table entry the most recently used.
+ *
+ ****************************************************************************/
+
+void neighbor_touch(FAR struct neighbor_entry *neighbor)
+{
+  if (g_neighbor_lru.head != &neighbor->ne_node)
+    {
+      dq_rem(&neighbor->ne_node, &g_neighbor_lru);
+      dq_addfirst(&neighbor->ne_node, &g_neighbor_lru);
+    }
+}
+
+/****************************************************************************
+ * Name: neighbor_release
+ *
+ * Description:
+ *   Remove an entry from its hash chain, drop any packets that it holds
+ *   and make it the first candidate for reuse.
+ *
+ ****************************************************************************/
+
+void neighbor_release(FAR struct neighbor_entry *neighbor)
+{
+  FAR struct neighbor_entry **pprev;
+
+  if (neighbor->ne_hash != NEIGHBOR_NOHASH)
+    {
+      for (pprev = &g_neighbor_hash[neighbor->ne_hash]; *pprev != NULL;
+           pprev = &(*pprev)->ne_hnext)
+        {
+          if (*pprev == neighbor)
+            {
+              *pprev = neighbor->ne_hnext;
+              break;
+            }
+        }
+    }
+
+#ifdef NEIGHBOR_HAVE_PENDING
+  if ((neighbor->ne_flags & NEIGHBOR_FLUSH) != 0)
+    {
+      g_neighbor_nflush--;
+    }
+
+  while (neighbor->ne_npending > 0)
+    {
+      iob_free_chain(neighbor->ne_pending[--neighbor->ne_npending]);
+    }
+#endif
+
+  memset(neighbor->ne_ipaddr, 0, sizeof(net_ipv6addr_t));
+  neighbor->ne_hnext = NULL;
+  neighbor->ne_hash  = NEIGHBOR_NOHASH;
+  neighbor->ne_flags = 0;
+  neighbor->ne_time  = NEIGHBOR_MAXTIME;
+
+  dq_rem(&neighbor->ne_node, &g_neighbor_lru);
+  dq_addlast(&neighbor->ne_node, &g_neighbor_lru);
+}
+
+/****************************************************************************
+ * Name: neighbor_allocate
+ *
+ * Description:
+ *   Take the least recently used entry of the Neighbor Table, dropping
+ *   whatever it held, and hash it under a new IPv6 address.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address of the new entry
+ *
+ * Returned Value:
+ *   The new entry, which is made the most recently used.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry *neighbor_allocate(const net_ipv6addr_t ipaddr)
+{
+  FAR struct neighbor_entry *neighbor;
+
+  neighbor = (FAR struct neighbor_entry *)g_neighbor_lru.tail;
+  if (neighbor->ne_hash != NEIGHBOR_NOHASH)
+    {
+      neighbor_dumpentry("Evicting entry", neighbor);
+    }
+
+  neighbor_release(neighbor);
+  neighbor_touch(neighbor);
+
+  net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
+  neighbor->ne_time  = 0;
+  neighbor->ne_hash  = neighbor_hash(ipaddr);
+  neighbor->ne_hnext = g_neighbor_hash[neighbor->ne_hash];
+  g_neighbor_hash[neighbor->ne_hash] = neighbor;
+  return neighbor;
+}
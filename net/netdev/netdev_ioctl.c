@@ -89,6 +89,7 @@
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 
 #if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
 
@@ -1168,22 +1169,9 @@ static int netdev_arp_ioctl(FAR struct socket *psock, int cmd,
               FAR struct sockaddr_in *addr =
                 (FAR struct sockaddr_in *)&req->arp_pa;
 
-              /* Find the existing ARP table entry for this protocol address. */
-
-              FAR struct arp_entry *entry = arp_find(addr->sin_addr.s_addr);
-              if (entry != NULL)
-                {
-                  /* The ARP table is fixed size; an entry is deleted
-                   * by nullifying its protocol address.
-                   */
+              /* Delete the ARP table entry for this protocol address. */
 
-                  entry->at_ipaddr = 0;
-                  ret = OK;
-                }
-              else
-                {
-                  ret = -ENOENT;
-                }
+              ret = arp_delete(addr->sin_addr.s_addr);
             }
           else
             {
@@ -1340,6 +1328,17 @@ static int netdev_rt_ioctl(FAR struct socket *psock, int cmd,
         break;
     }
 
+#ifdef IPFWD_HAVE_FLOWCACHE
+  /* Packets of cached flows may now take a different route */
+
+  if (ret >= 0)
+    {
+      net_lock();
+      ipfwd_flow_flush(NULL);
+      net_unlock();
+    }
+#endif
+
   return ret;
 }
 #endif
@@ -1549,6 +1548,10 @@ void netdev_ifdown(FAR struct net_driver_s *dev)
       /* Notify clients that the network has been taken down */
 
       (void)devif_dev_event(dev, NULL, NETDEV_DOWN);
+
+      /* Packets can no longer be forwarded on this device */
+
+      ipfwd_flow_flush(dev);
     }
 }
 
@@ -54,6 +54,7 @@
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -124,6 +125,9 @@ int netdev_unregister(FAR struct net_driver_s *dev)
           curr->flink = NULL;
         }
 
+      /* Forget any flows that were forwarded on the device */
+
+      ipfwd_flow_flush(dev);
       net_unlock();
 
 #ifdef CONFIG_NET_ETHERNET
@@ -70,6 +70,9 @@ static int     netprocfs_ipv4_dropped(FAR struct netprocfs_file_s *netfile);
 static int     netprocfs_ipv6_dropped(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_IPv4 */
 static int     netprocfs_checksum(FAR struct netprocfs_file_s *netfile);
+#if defined(CONFIG_NET_TCP) || defined(CONFIG_NET_UDP)
+static int     netprocfs_buffer(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_TCP || CONFIG_NET_UDP */
 #ifdef CONFIG_NET_TCP
 static int     netprocfs_tcp_dropped_1(FAR struct netprocfs_file_s *netfile);
 static int     netprocfs_tcp_dropped_2(FAR struct netprocfs_file_s *netfile);
@@ -102,6 +105,10 @@ static const linegen_t g_stat_linegen[] =
 
   netprocfs_checksum,
 
+#if defined(CONFIG_NET_TCP) || defined(CONFIG_NET_UDP)
+  netprocfs_buffer,
+#endif /* CONFIG_NET_TCP || CONFIG_NET_UDP */
+
 #ifdef CONFIG_NET_TCP
   netprocfs_tcp_dropped_1,
   netprocfs_tcp_dropped_2,
@@ -298,6 +305,43 @@ static int netprocfs_checksum(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS  */
 
+/****************************************************************************
+ * Name: netprocfs_buffer
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && \
+    (defined(CONFIG_NET_TCP) || defined(CONFIG_NET_UDP))
+static int netprocfs_buffer(FAR struct netprocfs_file_s *netfile)
+{
+  int len = 0;
+
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  Buffer   ");
+#ifdef CONFIG_NET_IPv4
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_IPv6
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_TCP
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
+                  g_netstats.tcp.rcvdrop);
+#endif
+#ifdef CONFIG_NET_UDP
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
+                  g_netstats.udp.rcvdrop);
+#endif
+#ifdef CONFIG_NET_ICMP
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_ICMPv6
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
+  return len;
+}
+#endif /* CONFIG_NET_STATISTICS && (CONFIG_NET_TCP || CONFIG_NET_UDP) */
+
 /****************************************************************************
  * Name: netprocfs_tcp_dropped_1
  ****************************************************************************/
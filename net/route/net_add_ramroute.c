@@ -76,6 +76,14 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 {
   FAR struct net_route_ipv4_s *route;
 
+  /* Routes are looked up by network prefix */
+
+  if (ramroute_prefixlen(&netmask, sizeof(in_addr_t)) < 0)
+    {
+      nerr("ERROR:  Non-contiguous netmask\n");
+      return -EINVAL;
+    }
+
   /* Allocate a route entry */
 
   route = net_allocroute_ipv4();
@@ -100,6 +108,7 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_ipv4_routes);
+  net_indexroute_ipv4();
   net_unlock();
   return OK;
 }
@@ -111,6 +120,14 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 {
   FAR struct net_route_ipv6_s *route;
 
+  /* Routes are looked up by network prefix */
+
+  if (ramroute_prefixlen(netmask, sizeof(net_ipv6addr_t)) < 0)
+    {
+      nerr("ERROR:  Non-contiguous netmask\n");
+      return -EINVAL;
+    }
+
   /* Allocate a route entry */
 
   route = net_allocroute_ipv6();
@@ -135,6 +152,7 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_ipv6_routes);
+  net_indexroute_ipv6();
   net_unlock();
   return OK;
 }
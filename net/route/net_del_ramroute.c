@@ -45,6 +45,7 @@
 #include <debug.h>
 
 #include <arpa/inet.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #include "route/ramroute.h"
@@ -212,6 +213,7 @@ static int net_match_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
 int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 {
   struct route_match_ipv4_s match;
+  int ret;
 
   /* Set up the comparison structure */
 
@@ -219,9 +221,19 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   net_ipv4addr_copy(match.target, target);
   net_ipv4addr_copy(match.netmask, netmask);
 
-  /* Then remove the entry from the routing table */
+  /* Then remove the entry from the routing table and update the prefix
+   * trie to match.
+   */
+
+  net_lock();
+  ret = net_foreachroute_ipv4(net_match_ipv4, &match);
+  if (ret > 0)
+    {
+      net_indexroute_ipv4();
+    }
 
-  return net_foreachroute_ipv4(net_match_ipv4, &match) ? OK : -ENOENT;
+  net_unlock();
+  return ret > 0 ? OK : -ENOENT;
 }
 #endif
 
@@ -229,6 +241,7 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 {
   struct route_match_ipv6_s match;
+  int ret;
 
   /* Set up the comparison structure */
 
@@ -236,9 +249,19 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
   net_ipv6addr_copy(match.target, target);
   net_ipv6addr_copy(match.netmask, netmask);
 
-  /* Then remove the entry from the routing table */
+  /* Then remove the entry from the routing table and update the prefix
+   * trie to match.
+   */
+
+  net_lock();
+  ret = net_foreachroute_ipv6(net_match_ipv6, &match);
+  if (ret > 0)
+    {
+      net_indexroute_ipv6();
+    }
 
-  return net_foreachroute_ipv6(net_match_ipv6, &match) ? OK : -ENOENT;
+  net_unlock();
+  return ret > 0 ? OK : -ENOENT;
 }
 #endif
 
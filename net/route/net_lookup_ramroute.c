@@ -0,0 +1,466 @@
+/****************************************************************************
+ * net/route/net_lookup_ramroute.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/ramroute.h"
+#include "route/route.h"
+
+#if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A path-compressed binary trie with N prefixes has at most N - 1 nodes
+ * that only join two sub-tries.
+ */
+
+#define RAMROUTE_IPv4_NNODES (2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES)
+#define RAMROUTE_IPv6_NNODES (2 * CONFIG_ROUTE_MAX_IPv6_RAMROUTES)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of the trie.  Nodes are only created where a prefix ends or
+ * where two prefixes diverge.  The key is the destination address of some
+ * route below the node; only its first 'plen' bits are significant.
+ */
+
+struct ramroute_node_s
+{
+  FAR struct ramroute_node_s *child[2]; /* Sub-tries for next bit 0 and 1 */
+  FAR const uint8_t *key;               /* Address bytes, network order */
+  FAR void *route;                      /* Route of this prefix or NULL */
+  uint8_t plen;                         /* Prefix length in bits */
+};
+
+/* The trie and the pool that its nodes are taken from */
+
+struct ramroute_trie_s
+{
+  FAR struct ramroute_node_s *root;
+  FAR struct ramroute_node_s *pool;
+  uint16_t nused;
+  uint16_t npool;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+static struct ramroute_node_s g_ipv4_nodes[RAMROUTE_IPv4_NNODES];
+static struct ramroute_trie_s g_ipv4_trie =
+{
+  NULL, g_ipv4_nodes, 0, RAMROUTE_IPv4_NNODES
+};
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+static struct ramroute_node_s g_ipv6_nodes[RAMROUTE_IPv6_NNODES];
+static struct ramroute_trie_s g_ipv6_trie =
+{
+  NULL, g_ipv6_nodes, 0, RAMROUTE_IPv6_NNODES
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ramroute_bit
+ *
+ * Description:
+ *   Return bit 'pos' of an address, counting from the most significant bit
+ *   of the first byte.
+ *
+ ****************************************************************************/
+
+static inline int ramroute_bit(FAR const uint8_t *key, unsigned int pos)
+{
+  return (key[pos >> 3] >> (7 - (pos & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: ramroute_matchlen
+ *
+ * Description:
+ *   Return the number of leading bits, up to 'maxbits', that two addresses
+ *   have in common.
+ *
+ ****************************************************************************/
+
+static unsigned int ramroute_matchlen(FAR const uint8_t *a,
+                                      FAR const uint8_t *b,
+                                      unsigned int maxbits)
+{
+  unsigned int nbits;
+  uint8_t diff;
+
+  for (nbits = 0; nbits < maxbits; nbits += 8)
+    {
+      diff = a[nbits >> 3] ^ b[nbits >> 3];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              nbits++;
+            }
+
+          break;
+        }
+    }
+
+  return nbits < maxbits ? nbits : maxbits;
+}
+
+/****************************************************************************
+ * Name: ramroute_newnode
+ *
+ * Description:
+ *   Take a node from the pool of the trie.
+ *
+ ****************************************************************************/
+
+static FAR struct ramroute_node_s *
+  ramroute_newnode(FAR struct ramroute_trie_s *trie,
+                   FAR const uint8_t *key, unsigned int plen,
+                   FAR void *route)
+{
+  FAR struct ramroute_node_s *node;
+
+  DEBUGASSERT(trie->nused < trie->npool);
+
+  node           = &trie->pool[trie->nused++];
+  node->child[0] = NULL;
+  node->child[1] = NULL;
+  node->key      = key;
+  node->route    = route;
+  node->plen     = plen;
+  return node;
+}
+
+/****************************************************************************
+ * Name: ramroute_insert
+ *
+ * Description:
+ *   Add the prefix of a route to the trie.  If the prefix is already in the
+ *   trie, the earlier route is kept so that, as before, the first of
+ *   several identical routes in the table is used.
+ *
+ ****************************************************************************/
+
+static void ramroute_insert(FAR struct ramroute_trie_s *trie,
+                            FAR const uint8_t *key, unsigned int plen,
+                            FAR void *route)
+{
+  FAR struct ramroute_node_s **pnode;
+  FAR struct ramroute_node_s *node;
+  FAR struct ramroute_node_s *join;
+  unsigned int common = 0;
+
+  /* Descend while the prefix of the node is a prefix of the new one */
+
+  for (pnode = &trie->root; (node = *pnode) != NULL;
+       pnode = &node->child[ramroute_bit(key, node->plen)])
+    {
+      common = ramroute_matchlen(node->key, key,
+                                 node->plen < plen ? node->plen : plen);
+      if (common < node->plen)
+        {
+          break;
+        }
+
+      if (node->plen == plen)
+        {
+          if (node->route == NULL)
+            {
+              node->route = route;
+              node->key   = key;
+            }
+
+          return;
+        }
+    }
+
+  if (node == NULL)
+    {
+      *pnode = ramroute_newnode(trie, key, plen, route);
+    }
+  else if (common == plen)
+    {
+      /* The new prefix is a prefix of the node:  Insert it above */
+
+      join = ramroute_newnode(trie, key, plen, route);
+      join->child[ramroute_bit(node->key, plen)] = node;
+      *pnode = join;
+    }
+  else
+    {
+      /* The prefixes diverge at bit 'common':  Join them there */
+
+      join = ramroute_newnode(trie, key, common, NULL);
+      join->child[ramroute_bit(key, common)] =
+        ramroute_newnode(trie, key, plen, route);
+      join->child[ramroute_bit(node->key, common)] = node;
+      *pnode = join;
+    }
+}
+
+/****************************************************************************
+ * Name: ramroute_lookup
+ *
+ * Description:
+ *   Return the route with the longest prefix that matches an address.
+ *
+ ****************************************************************************/
+
+static FAR void *ramroute_lookup(FAR struct ramroute_trie_s *trie,
+                                 FAR const uint8_t *key, unsigned int nbits)
+{
+  FAR struct ramroute_node_s *node;
+  FAR void *best = NULL;
+
+  for (node = trie->root; node != NULL;
+       node = node->child[ramroute_bit(key, node->plen)])
+    {
+      if (ramroute_matchlen(node->key, key, node->plen) < node->plen)
+        {
+          break;
+        }
+
+      if (node->route != NULL)
+        {
+          best = node->route;
+        }
+
+      if (node->plen >= nbits)
+        {
+          break;
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ramroute_prefixlen
+ *
+ * Description:
+ *   Return the number of leading one bits in a network mask.
+ *
+ * Parameters:
+ *   mask   - The network mask, network order
+ *   nbytes - The size of the mask in bytes
+ *
+ * Returned Value:
+ *   The prefix length in bits; -EINVAL if the one bits of the mask are not
+ *   contiguous.
+ *
+ ****************************************************************************/
+
+int ramroute_prefixlen(FAR const void *mask, unsigned int nbytes)
+{
+  FAR const uint8_t *bytes = (FAR const uint8_t *)mask;
+  unsigned int plen = 0;
+  unsigned int i;
+  uint8_t byte;
+
+  for (i = 0; i < nbytes && bytes[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < nbytes)
+    {
+      /* The remaining bits must be leading ones followed only by zeroes */
+
+      for (byte = bytes[i]; (byte & 0x80) != 0; byte <<= 1)
+        {
+          plen++;
+        }
+
+      if (byte != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (i++; i < nbytes; i++)
+        {
+          if (bytes[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: net_indexroute_ipv4 and net_indexroute_ipv6
+ *
+ * Description:
+ *   Rebuild the prefix trie used to look up routes after the routing table
+ *   has been modified.
+ *
+ * Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+void net_indexroute_ipv4(void)
+{
+  FAR struct net_route_ipv4_entry_s *route;
+  int plen;
+
+  g_ipv4_trie.root  = NULL;
+  g_ipv4_trie.nused = 0;
+
+  for (route = g_ipv4_routes.head; route != NULL; route = route->flink)
+    {
+      plen = ramroute_prefixlen(&route->entry.netmask, sizeof(in_addr_t));
+      DEBUGASSERT(plen >= 0);
+
+      ramroute_insert(&g_ipv4_trie,
+                      (FAR const uint8_t *)&route->entry.target, plen,
+                      &route->entry);
+    }
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+void net_indexroute_ipv6(void)
+{
+  FAR struct net_route_ipv6_entry_s *route;
+  int plen;
+
+  g_ipv6_trie.root  = NULL;
+  g_ipv6_trie.nused = 0;
+
+  for (route = g_ipv6_routes.head; route != NULL; route = route->flink)
+    {
+      plen = ramroute_prefixlen(route->entry.netmask, sizeof(net_ipv6addr_t));
+      DEBUGASSERT(plen >= 0);
+
+      ramroute_insert(&g_ipv6_trie,
+                      (FAR const uint8_t *)route->entry.target, plen,
+                      &route->entry);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lookuproute_ipv4 and net_lookuproute_ipv6
+ *
+ * Description:
+ *   Find the route with the longest network prefix that contains an
+ *   address.
+ *
+ * Parameters:
+ *   target - The address to be routed
+ *   router - The location to return the router address of the route
+ *
+ * Returned Value:
+ *   1 if a route was found; 0 if there is no route to the address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+int net_lookuproute_ipv4(in_addr_t target, FAR in_addr_t *router)
+{
+  FAR struct net_route_ipv4_s *route;
+
+  net_lock();
+  route = (FAR struct net_route_ipv4_s *)
+    ramroute_lookup(&g_ipv4_trie, (FAR const uint8_t *)&target, 32);
+  if (route != NULL)
+    {
+      net_ipv4addr_copy(*router, route->router);
+    }
+
+  net_unlock();
+  return route != NULL ? 1 : 0;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+int net_lookuproute_ipv6(const net_ipv6addr_t target, net_ipv6addr_t router)
+{
+  FAR struct net_route_ipv6_s *route;
+
+  net_lock();
+  route = (FAR struct net_route_ipv6_s *)
+    ramroute_lookup(&g_ipv6_trie, (FAR const uint8_t *)target, 128);
+  if (route != NULL)
+    {
+      net_ipv6addr_copy(router, route->router);
+    }
+
+  net_unlock();
+  return route != NULL ? 1 : 0;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_IPv4_RAMROUTE || CONFIG_ROUTE_IPv6_RAMROUTE */
@@ -48,6 +48,7 @@
 #include <nuttx/net/ip.h>
 
 #include "devif/devif.h"
+#include "route/ramroute.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
 
@@ -116,7 +117,7 @@ struct route_ipv6_match_s
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv4
+#if defined(CONFIG_NET_IPv4) && !defined(CONFIG_ROUTE_IPv4_RAMROUTE)
 static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
 {
   FAR struct route_ipv4_match_s *match = (FAR struct route_ipv4_match_s *)arg;
@@ -142,7 +143,7 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
 
   return 0;
 }
-#endif /* CONFIG_NET_IPv4 */
+#endif /* CONFIG_NET_IPv4 && !CONFIG_ROUTE_IPv4_RAMROUTE */
 
 /****************************************************************************
  * Name: net_ipv6_match
@@ -159,7 +160,7 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv6
+#if defined(CONFIG_NET_IPv6) && !defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 {
   FAR struct route_ipv6_match_s *match = (FAR struct route_ipv6_match_s *)arg;
@@ -185,7 +186,7 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 
   return 0;
 }
-#endif /* CONFIG_NET_IPv6 */
+#endif /* CONFIG_NET_IPv6 && !CONFIG_ROUTE_IPv6_RAMROUTE */
 
 /****************************************************************************
  * Public Functions
@@ -233,11 +234,19 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
   if (ret <= 0)
 #endif
     {
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+      /* Find the router entry with the longest network prefix that
+       * contains this address.
+       */
+
+      ret = net_lookuproute_ipv4(target, &match.router);
+#else
       /* Not found in the cache.  Try to find a router entry with the
        * routing table that can forward to this address
        */
 
       ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -308,11 +317,19 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
   if (ret <= 0)
 #endif
     {
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+      /* Find the router entry with the longest network prefix that
+       * contains this address.
+       */
+
+      ret = net_lookuproute_ipv6(target, match.router);
+#else
       /* Not found in the cache.  Try to find a router entry with the
        * routing table that can forward to this address
        */
 
       ret = net_foreachroute_ipv6(net_ipv6_match, &match);
+#endif
     }
 
   /* Did we find a route? */
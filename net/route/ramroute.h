@@ -196,6 +196,74 @@ void net_freeroute_ipv4(FAR struct net_route_ipv4_s *route);
 void net_freeroute_ipv6(FAR struct net_route_ipv6_s *route);
 #endif
 
+/****************************************************************************
+ * Name: ramroute_prefixlen
+ *
+ * Description:
+ *   Return the number of leading one bits in a network mask.
+ *
+ * Parameters:
+ *   mask   - The network mask, network order
+ *   nbytes - The size of the mask in bytes
+ *
+ * Returned Value:
+ *   The prefix length in bits; -EINVAL if the one bits of the mask are not
+ *   contiguous.
+ *
+ ****************************************************************************/
+
+int ramroute_prefixlen(FAR const void *mask, unsigned int nbytes);
+
+/****************************************************************************
+ * Name: net_indexroute_ipv4 and net_indexroute_ipv6
+ *
+ * Description:
+ *   Rebuild the prefix trie used to look up routes after the routing table
+ *   has been modified.
+ *
+ * Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+void net_indexroute_ipv4(void);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+void net_indexroute_ipv6(void);
+#endif
+
+/****************************************************************************
+ * Name: net_lookuproute_ipv4 and net_lookuproute_ipv6
+ *
+ * Description:
+ *   Find the route with the longest network prefix that contains an
+ *   address.
+ *
+ * Parameters:
+ *   target - The address to be routed
+ *   router - The location to return the router address of the route
+ *
+ * Returned Value:
+ *   1 if a route was found; 0 if there is no route to the address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+int net_lookuproute_ipv4(in_addr_t target, FAR in_addr_t *router);
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+int net_lookuproute_ipv6(const net_ipv6addr_t target, net_ipv6addr_t router);
+#endif
+
 /****************************************************************************
  * Name: (various low-level list operations)
  *
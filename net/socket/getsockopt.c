@@ -48,6 +48,7 @@
 #include <errno.h>
 
 #include "socket/socket.h"
+#include "inet/inet.h"
 #include "usrsock/usrsock.h"
 #include "utils/utils.h"
 
@@ -240,12 +241,42 @@ int psock_getsockopt(FAR struct socket *psock, int level, int option,
         }
         break;
 
+      case SO_SNDBUF:     /* Gets send buffer size */
+      case SO_RCVBUF:     /* Gets receive buffer size */
+        {
+          int ret = -ENOPROTOOPT;
+
+          /* Verify that option is the size of an 'int'.  Should also check
+           * that 'value' is properly aligned for an 'int'
+           */
+
+          if (*value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          /* Only TCP and UDP sockets buffer data */
+
+#if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
+          if (psock->s_domain == PF_INET || psock->s_domain == PF_INET6)
+            {
+              ret = inet_getbufsize(psock, option, (FAR int *)value);
+            }
+#endif
+
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          *value_len = sizeof(int);
+        }
+        break;
+
       /* The following are not yet implemented */
 
       case SO_ACCEPTCONN: /* Reports whether socket listening is enabled */
       case SO_LINGER:
-      case SO_SNDBUF:     /* Sets send buffer size */
-      case SO_RCVBUF:     /* Sets receive buffer size */
       case SO_ERROR:      /* Reports and clears error status. */
       case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
       case SO_SNDLOWAT:   /* Sets the minimum number of bytes to output */
@@ -0,0 +1,238 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmsg_batch
+ *
+ * Description:
+ *   Receive up to vlen messages into msgvec[] one at a time with
+ *   psock_recvmsg().
+ *
+ ****************************************************************************/
+
+int psock_recvmsg_batch(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                        unsigned int vlen, int flags,
+                        FAR const struct timespec *timeout)
+{
+  systime_t start = 0;
+  systime_t ticks = 0;
+  ssize_t nrecvd = 0;
+  unsigned int i;
+
+  if (timeout != NULL)
+    {
+      start = clock_systimer();
+      ticks = SEC2TICK(timeout->tv_sec) + NSEC2TICK(timeout->tv_nsec);
+    }
+
+  for (i = 0; i < vlen; i++)
+    {
+      /* As on Linux, the timeout is only checked after a message has been
+       * received.
+       */
+
+      if (i > 0 && timeout != NULL && clock_systimer() - start >= ticks)
+        {
+          break;
+        }
+
+      nrecvd = psock_recvmsg(psock, &msgvec[i].msg_hdr,
+                             flags & ~MSG_WAITFORONE);
+      if (nrecvd < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = (unsigned int)nrecvd;
+
+      /* Don't wait for the rest if asked to wait only for the first */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+    }
+
+  /* Running out of messages or an error after the first message only ends
+   * the batch.
+   */
+
+  return i > 0 ? (int)i : (int)nrecvd;
+}
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives up to vlen messages into msgvec[] and sets
+ *   the msg_len field of each message received to the number of bytes
+ *   received.  This is an internal OS interface.  It is functionally
+ *   equivalent to recvmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - Buffers to receive the messages
+ *   vlen    - The number of messages in msgvec[]
+ *   flags   - Receive flags
+ *   timeout - Optional limit on the time spent receiving
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  If the first
+ *   message could not be received, a negated errno value is returned (see
+ *   comments with recv() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout)
+{
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  if (vlen == 0)
+    {
+      return 0;
+    }
+
+  if (msgvec == NULL ||
+      (timeout != NULL &&
+       (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+        timeout->tv_nsec >= NSEC_PER_SEC)))
+    {
+      return -EINVAL;
+    }
+
+  if (vlen > SOCK_MMSG_MAXVLEN)
+    {
+      vlen = SOCK_MMSG_MAXVLEN;
+    }
+
+  /* Let the address family's recvmmsg() method handle the operation, if it
+   * has one.
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+  if (psock->s_sockif->si_recvmmsg != NULL)
+    {
+      return psock->s_sockif->si_recvmmsg(psock, msgvec, vlen, flags,
+                                          timeout);
+    }
+
+  return psock_recvmsg_batch(psock, msgvec, vlen, flags, timeout);
+}
+
+/****************************************************************************
+ * Name: recvmmsg
+ *
+ * Description:
+ *   The recvmmsg() function receives up to vlen messages from a socket
+ *   with a single call.  Each message is received as by recvmsg() and the
+ *   number of bytes received is returned in its msg_len field.
+ *
+ * Parameters:
+ *   sockfd  - Socket descriptor of socket
+ *   msgvec  - Buffers to receive the messages
+ *   vlen    - Number of messages in msgvec
+ *   flags   - Receive flags.  With MSG_WAITFORONE, only the first message
+ *             is waited for.
+ *   timeout - If not NULL, no further message is received once this much
+ *             time has elapsed.  It is only checked after each message.
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  On  error,
+ *   -1 is returned, and errno is set appropriately (see recvfrom() for the
+ *   list of error values).
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* And let psock_recvmmsg do all of the work */
+
+  ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
@@ -0,0 +1,321 @@
+/****************************************************************************
+ * net/socket/recvmsg.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: recvmsg_scatter
+ *
+ * Description:
+ *   Fallback used when the address family does not provide si_recvmsg().
+ *   Stream sockets fill each buffer in turn.  Only the first receive may
+ *   block (unless MSG_WAITALL is given); the following ones just take the
+ *   data that is already available.  A datagram must be received in one
+ *   piece so, if there is more than one non-empty buffer, it is received
+ *   into a temporary buffer no larger than the largest datagram and then
+ *   scattered over the buffers.
+ *
+ ****************************************************************************/
+
+static ssize_t recvmsg_scatter(FAR struct socket *psock,
+                               FAR struct msghdr *msg, int flags)
+{
+  FAR struct iovec *iov = msg->msg_iov;
+  FAR struct sockaddr *from = (FAR struct sockaddr *)msg->msg_name;
+  FAR socklen_t *fromlen = from != NULL ? &msg->msg_namelen : NULL;
+  FAR uint8_t *buffer;
+  FAR uint8_t *ptr;
+  FAR void *single = NULL;
+  ssize_t nrecvd;
+  ssize_t total;
+  size_t remaining;
+  size_t ncopy;
+  size_t len;
+  int nbufs;
+  int i;
+
+  for (i = 0, len = 0, nbufs = 0; i < msg->msg_iovlen; i++)
+    {
+      if (iov[i].iov_len > 0)
+        {
+          single = iov[i].iov_base;
+          len   += iov[i].iov_len;
+          nbufs++;
+        }
+    }
+
+  if (nbufs == 0)
+    {
+      return 0;
+    }
+
+  if (nbufs == 1)
+    {
+      return psock_recvfrom(psock, single, len, flags, from, fromlen);
+    }
+
+  if (psock->s_type == SOCK_STREAM)
+    {
+      for (i = 0, total = 0; i < msg->msg_iovlen; i++)
+        {
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          nrecvd = psock_recvfrom(psock, iov[i].iov_base, iov[i].iov_len,
+                                  flags, from, fromlen);
+          if (nrecvd < 0)
+            {
+              return total > 0 ? total : nrecvd;
+            }
+
+          total += nrecvd;
+
+          /* Stop at a short receive.  Peeking again would only return the
+           * same data.
+           */
+
+          if ((size_t)nrecvd < iov[i].iov_len || (flags & MSG_PEEK) != 0)
+            {
+              break;
+            }
+
+          if ((flags & MSG_WAITALL) == 0)
+            {
+              flags |= MSG_DONTWAIT;
+            }
+        }
+
+      return total;
+    }
+
+  /* Any part of a datagram beyond the largest datagram size can only be
+   * buffer space that is never used.
+   */
+
+  if (len > SOCK_MAXDGRAM(psock))
+    {
+      len = SOCK_MAXDGRAM(psock);
+    }
+
+  buffer = (FAR uint8_t *)kmm_malloc(len);
+  if (buffer == NULL)
+    {
+      nerr("ERROR: Failed to allocate a %lu byte receive buffer\n",
+           (unsigned long)len);
+      return -ENOMEM;
+    }
+
+  nrecvd = psock_recvfrom(psock, buffer, len, flags, from, fromlen);
+  if (nrecvd > 0)
+    {
+      for (i = 0, ptr = buffer, remaining = nrecvd;
+           i < msg->msg_iovlen && remaining > 0;
+           i++)
+        {
+          ncopy = iov[i].iov_len;
+          if (ncopy > remaining)
+            {
+              ncopy = remaining;
+            }
+
+          memcpy(iov[i].iov_base, ptr, ncopy);
+          ptr       += ncopy;
+          remaining -= ncopy;
+        }
+    }
+
+  kmm_free(buffer);
+  return nrecvd;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmsg
+ *
+ * Description:
+ *   psock_recvmsg() receives a message into the buffers described by
+ *   msg->msg_iov.  This is an internal OS interface.  It is functionally
+ *   equivalent to recvmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - Buffers to receive the message and, optionally, its source
+ *   flags - Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  If no data is
+ *   available to be received and the peer has performed an orderly
+ *   shutdown, 0 is returned.  Otherwise, on any failure, a negated errno
+ *   value is returned (see comments with recv() for a list of appropriate
+ *   errno values).
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags)
+{
+  ssize_t ret;
+  size_t len;
+  int i;
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  /* Verify the message.  The total length must be representable in the
+   * ssize_t return value.
+   */
+
+  if (msg == NULL || msg->msg_iovlen < 0 || msg->msg_iovlen > IOV_MAX ||
+      (msg->msg_iovlen > 0 && msg->msg_iov == NULL))
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0, len = 0; i < msg->msg_iovlen; i++)
+    {
+      if (msg->msg_iov[i].iov_len > SSIZE_MAX - len)
+        {
+          return -EINVAL;
+        }
+
+      len += msg->msg_iov[i].iov_len;
+    }
+
+  /* No ancillary data is ever returned */
+
+  msg->msg_controllen = 0;
+  msg->msg_flags      = 0;
+
+  /* Let the address family's recvmsg() method handle the operation, if it
+   * has one.
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+  if (psock->s_sockif->si_recvmsg != NULL)
+    {
+      psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_RECV);
+      ret = psock->s_sockif->si_recvmsg(psock, msg, flags);
+      psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+      return ret;
+    }
+
+  return recvmsg_scatter(psock, msg, flags);
+}
+
+/****************************************************************************
+ * Name: recvmsg
+ *
+ * Description:
+ *   The recvmsg() function receives a message from a socket and scatters
+ *   it over the msg_iovlen buffers described by msg_iov.  If msg_name is
+ *   not NULL, and the underlying protocol provides the source address,
+ *   the source address is returned there and msg_namelen is updated.  No
+ *   ancillary data is supported; msg_controllen is always set to zero.
+ *
+ * Parameters:
+ *   sockfd  - Socket descriptor of socket
+ *   msg     - Buffers to receive the message and, optionally, its source
+ *   flags   - Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On  error,
+ *   -1 is returned, and errno is set appropriately (see recvfrom() for the
+ *   list of error values).
+ *
+ ****************************************************************************/
+
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags)
+{
+  FAR struct socket *psock;
+  ssize_t ret;
+
+  /* recvmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* And let psock_recvmsg do all of the work */
+
+  ret = psock_recvmsg(psock, msg, flags);
+  if (ret < 0)
+    {
+      set_errno((int)-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
@@ -0,0 +1,278 @@
+/****************************************************************************
+ * net/socket/sendmsg.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendmsg_gather
+ *
+ * Description:
+ *   Fallback used when the address family does not provide si_sendmsg().
+ *   Stream sockets send each buffer in turn, stopping at the first short
+ *   send.  A datagram must go out in one piece so, if there is more than
+ *   one non-empty buffer, the buffers are first gathered into a temporary
+ *   buffer.  A datagram larger than the largest datagram size is refused
+ *   before anything is allocated.
+ *
+ ****************************************************************************/
+
+static ssize_t sendmsg_gather(FAR struct socket *psock,
+                              FAR const struct msghdr *msg, int flags)
+{
+  FAR const struct iovec *iov = msg->msg_iov;
+  FAR const struct sockaddr *to = (FAR const struct sockaddr *)msg->msg_name;
+  FAR const void *single = "";
+  FAR uint8_t *buffer;
+  FAR uint8_t *ptr;
+  ssize_t nsent;
+  ssize_t total;
+  size_t len;
+  int nbufs;
+  int i;
+
+  for (i = 0, len = 0, nbufs = 0; i < msg->msg_iovlen; i++)
+    {
+      if (iov[i].iov_len > 0)
+        {
+          single = iov[i].iov_base;
+          len   += iov[i].iov_len;
+          nbufs++;
+        }
+    }
+
+  if (psock->s_type == SOCK_STREAM)
+    {
+      for (i = 0, total = 0; i < msg->msg_iovlen; i++)
+        {
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          nsent = psock_sendto(psock, iov[i].iov_base, iov[i].iov_len, flags,
+                               to, msg->msg_namelen);
+          if (nsent < 0)
+            {
+              return total > 0 ? total : nsent;
+            }
+
+          total += nsent;
+          if ((size_t)nsent < iov[i].iov_len)
+            {
+              break;
+            }
+        }
+
+      return total;
+    }
+
+  /* A datagram held in a single buffer needs no copy */
+
+  if (nbufs < 2)
+    {
+      return psock_sendto(psock, single, len, flags, to, msg->msg_namelen);
+    }
+
+  if (len > SOCK_MAXDGRAM(psock))
+    {
+      return -EMSGSIZE;
+    }
+
+  buffer = (FAR uint8_t *)kmm_malloc(len);
+  if (buffer == NULL)
+    {
+      nerr("ERROR: Failed to allocate a %lu byte datagram\n",
+           (unsigned long)len);
+      return -ENOMEM;
+    }
+
+  for (i = 0, ptr = buffer; i < msg->msg_iovlen; i++)
+    {
+      memcpy(ptr, iov[i].iov_base, iov[i].iov_len);
+      ptr += iov[i].iov_len;
+    }
+
+  nsent = psock_sendto(psock, buffer, len, flags, to, msg->msg_namelen);
+  kmm_free(buffer);
+  return nsent;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_sendmsg
+ *
+ * Description:
+ *   psock_sendmsg() sends a message gathered from the buffers described by
+ *   msg->msg_iov.  This is an internal OS interface.  It is functionally
+ *   equivalent to sendmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - I accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock - A pointer to a NuttX-specific, internal socket structure
+ *   msg   - Message to send
+ *   flags - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On any failure, a
+ *   negated errno value is returned (See comments with send() for a list
+ *   of the appropriate errno value).
+ *
+ ****************************************************************************/
+
+ssize_t psock_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
+                      int flags)
+{
+  size_t len;
+  int i;
+
+  /* Verify that the psock corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      nerr("ERROR: Invalid socket\n");
+      return -EBADF;
+    }
+
+  /* Verify the message.  The total length must be representable in the
+   * ssize_t return value.
+   */
+
+  if (msg == NULL || msg->msg_iovlen < 0 || msg->msg_iovlen > IOV_MAX ||
+      (msg->msg_iovlen > 0 && msg->msg_iov == NULL))
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0, len = 0; i < msg->msg_iovlen; i++)
+    {
+      if (msg->msg_iov[i].iov_len > SSIZE_MAX - len)
+        {
+          return -EINVAL;
+        }
+
+      len += msg->msg_iov[i].iov_len;
+    }
+
+  /* Let the address family's sendmsg() method handle the operation, if it
+   * has one.
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL);
+  if (psock->s_sockif->si_sendmsg != NULL)
+    {
+      return psock->s_sockif->si_sendmsg(psock, msg, flags);
+    }
+
+  return sendmsg_gather(psock, msg, flags);
+}
+
+/****************************************************************************
+ * Name: sendmsg
+ *
+ * Description:
+ *   The sendmsg() function sends a message on a socket.  The data is
+ *   gathered from the msg_iovlen buffers described by msg_iov and is sent
+ *   as a single message.  If msg_name is not NULL, it gives the address of
+ *   the recipient for connectionless sockets.  No ancillary data is
+ *   supported; msg_control is ignored.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msg      Message to send
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   -1 is returned, and errno is set appropriately (see sendto() for the
+ *   list of error values).
+ *
+ ****************************************************************************/
+
+ssize_t sendmsg(int sockfd, FAR const struct msghdr *msg, int flags)
+{
+  FAR struct socket *psock;
+  ssize_t ret;
+
+  /* sendmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* And let psock_sendmsg do all of the work */
+
+  ret = psock_sendmsg(psock, msg, flags);
+  if (ret < 0)
+    {
+      set_errno((int)-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
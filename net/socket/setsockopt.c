@@ -52,6 +52,7 @@
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
+#include "inet/inet.h"
 #include "usrsock/usrsock.h"
 #include "utils/utils.h"
 
@@ -276,10 +277,41 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
         }
         break;
 #endif
-      /* The following are not yet implemented */
 
       case SO_SNDBUF:     /* Sets send buffer size */
       case SO_RCVBUF:     /* Sets receive buffer size */
+        {
+          int buffersize;
+
+          /* Verify that option is the size of an 'int'.  Should also check
+           * that 'value' is properly aligned for an 'int'
+           */
+
+          if (value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          buffersize = *(FAR int *)value;
+          if (buffersize < 0)
+            {
+              return -EINVAL;
+            }
+
+          /* Only TCP and UDP sockets buffer data */
+
+#if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
+          if (psock->s_domain == PF_INET || psock->s_domain == PF_INET6)
+            {
+              return inet_setbufsize(psock, option, (uint32_t)buffersize);
+            }
+#endif
+
+          return -ENOPROTOOPT;
+        }
+
+      /* The following are not yet implemented */
+
       case SO_RCVLOWAT:   /* Sets the minimum number of bytes to input */
       case SO_SNDLOWAT:   /* Sets the minimum number of bytes to output */
 
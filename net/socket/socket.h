@@ -48,6 +48,7 @@
 #include <time.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 
 /****************************************************************************
@@ -131,6 +132,24 @@
 #define _SO_GETVALID(o)  (((unsigned int)(o)) <= _SO_MAXOPT)
 #define _SO_SETVALID(o)  ((((unsigned int)(o)) <= _SO_MAXOPT) && !_SO_GETONLY(o))
 
+/* The largest number of messages handled by one sendmmsg() or recvmmsg()
+ * call.  Larger vectors are silently truncated, as on Linux.
+ */
+
+#define SOCK_MMSG_MAXVLEN 1024
+
+/* The largest datagram that can be sent or received on a socket.  Local
+ * datagrams carry a 16-bit length; any other datagram must fit in one
+ * packet of the device with the largest MTU.
+ */
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+#  define SOCK_MAXDGRAM(p) \
+     ((p)->s_domain == PF_LOCAL ? UINT16_MAX : MAX_NET_DEV_MTU)
+#else
+#  define SOCK_MAXDGRAM(p) MAX_NET_DEV_MTU
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -321,6 +340,60 @@ int net_timeo(systime_t start_time, socktimeo_t timeo);
 ssize_t psock_send(FAR struct socket *psock, FAR const void *buf, size_t len,
                    int flags);
 
+/****************************************************************************
+ * Name: psock_sendmsg_batch
+ *
+ * Description:
+ *   Send the vlen messages in msgvec[] one at a time with psock_sendmsg(),
+ *   stopping at the first error.  This is what sendmmsg() does when the
+ *   address family has no si_sendmmsg() method.  An si_sendmmsg() method
+ *   may use it to do the same under a lock of its own.
+ *
+ * Input Parameters:
+ *   psock  - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec - The messages to send
+ *   vlen   - The number of messages in msgvec[]; at least one
+ *   flags  - Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent or, if the first message could not be
+ *   sent, a negated errno value.
+ *
+ ****************************************************************************/
+
+int psock_sendmsg_batch(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                        unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmsg_batch
+ *
+ * Description:
+ *   Receive up to vlen messages into msgvec[] one at a time with
+ *   psock_recvmsg().  This is what recvmmsg() does when the address family
+ *   has no si_recvmmsg() method.  An si_recvmmsg() method may use it to do
+ *   the same under a lock of its own.
+ *
+ *   With MSG_WAITFORONE, the messages after the first are received with
+ *   MSG_DONTWAIT and the batch ends when nothing more is ready.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - Buffers to receive the messages
+ *   vlen    - The number of messages in msgvec[]; at least one
+ *   flags   - Receive flags
+ *   timeout - If not NULL, the time after which no further message is
+ *             received
+ *
+ * Returned Value:
+ *   The number of messages received or, if the first message could not be
+ *   received, a negated errno value.
+ *
+ ****************************************************************************/
+
+int psock_recvmsg_batch(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                        unsigned int vlen, int flags,
+                        FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: net_clone
  *
@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <queue.h>
+#include <semaphore.h>
 
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/ip.h>
@@ -63,6 +64,12 @@
 #  define HAVE_TCP_POLL
 #endif
 
+/* Maximum number of segments taken from one connection in one device poll */
+
+#ifndef CONFIG_NET_TCP_TXBURST
+#  define CONFIG_NET_TCP_TXBURST 1
+#endif
+
 /* Allocate a new TCP data callback */
 
 /* These macros allocate and free callback structures used for receiving
@@ -83,10 +90,10 @@
 #  define TCP_WBNRTX(wrb)            ((wrb)->wb_nrtx)
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
-#  define TCP_WBCOPYIN(wrb,src,n) \
-     (iob_copyin((wrb)->wb_iob,src,(n),0,false))
-#  define TCP_WBTRYCOPYIN(wrb,src,n) \
-     (iob_trycopyin((wrb)->wb_iob,src,(n),0,false))
+#  define TCP_WBCOPYIN(wrb,src,n,off) \
+     (iob_copyin((wrb)->wb_iob,src,(n),(off),false))
+#  define TCP_WBTRYCOPYIN(wrb,src,n,off) \
+     (iob_trycopyin((wrb)->wb_iob,src,(n),(off),false))
 
 #  define TCP_WBTRIM(wrb,n) \
      do { (wrb)->wb_iob = iob_trimhead((wrb)->wb_iob,(n)); } while (0)
@@ -99,10 +106,104 @@
 #  endif
 #endif
 
+/* Sequence number comparison, modulo 2**32 */
+
+#define TCP_SEQ_LT(a,b)    ((int32_t)((a) - (b)) < 0)
+#define TCP_SEQ_LE(a,b)    ((int32_t)((a) - (b)) <= 0)
+#define TCP_SEQ_GT(a,b)    ((int32_t)((a) - (b)) > 0)
+#define TCP_SEQ_GE(a,b)    ((int32_t)((a) - (b)) >= 0)
+
+#ifdef CONFIG_NET_TCP_CC
+/* Congestion control state flags (tcp_conn_s::ccflags) */
+
+#  define TCP_CC_RECOVERY    (1 << 0) /* In fast recovery */
+#  define TCP_CC_FASTREXMIT  (1 << 1) /* Retransmit the oldest unACKed segment */
+#  define TCP_CC_RTTTIMING   (1 << 2) /* A round trip time is being measured */
+
+/* Number of duplicate ACKs that trigger fast retransmit */
+
+#  define TCP_CC_DUPTHRESH   3
+
+/* Bounds on the retransmission timeout (units: half-seconds) */
+
+#  define TCP_CC_RTOMIN      2        /* RFC 6298: one second */
+#  define TCP_CC_RTOMAX      120
+#endif
+
+/* Space taken by the timestamps option in each segment:  Two NOPs for
+ * alignment and the option itself.
+ */
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+#  define TCP_TS_SPACE (2 + TCP_OPT_TS_LEN)
+#endif
+
+/* 6LoWPAN builds the headers of TCP data segments itself, with an unscaled
+ * window and no options.  Window scaling and timestamps are therefore never
+ * negotiated on a connection through a 6LoWPAN radio device.
+ */
+
+#ifdef CONFIG_NET_6LOWPAN
+#  define TCP_6LOWPAN_DEV(d) \
+     ((d)->d_lltype == NET_LL_IEEE802154 || (d)->d_lltype == NET_LL_PKTRADIO)
+#else
+#  define TCP_6LOWPAN_DEV(d) false
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+/* This structure describes one block of out-of-order data held by a TCP
+ * connection until the data in front of it has been received.
+ */
+
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+struct tcp_ofoseg_s
+{
+  uint32_t      os_seqno;   /* Sequence number of the first byte held */
+  uint16_t      os_len;     /* Number of bytes held */
+  FAR struct iob_s *os_iob; /* I/O buffer chain holding the data */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+struct tcp_conn_s;        /* Forward reference */
+
+/* A congestion control algorithm.  Slow start and fast recovery are common
+ * to all algorithms; an algorithm decides how the congestion window grows
+ * in congestion avoidance and how far it is reduced on loss.
+ *
+ *   init      - Set up the algorithm's state for a new connection.
+ *   congavoid - Grow the congestion window after 'acked' new bytes were
+ *               acknowledged with the window at or above ssthresh.
+ *   ssthresh  - Return the new slow start threshold after a loss.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+  CODE void (*congavoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* CUBIC state.  Windows are in bytes and times in milliseconds. */
+
+struct tcp_cubic_s
+{
+  uint32_t epoch;         /* Start of the congestion avoidance epoch (ticks),
+                           * zero if no epoch has started */
+  uint32_t wmax;          /* Window just before the last reduction */
+  uint32_t origin;        /* Window at the plateau of the cubic function */
+  uint32_t k;             /* Time from the epoch to the plateau */
+  uint32_t west;          /* Window a standard TCP would have reached */
+  uint32_t westcnt;       /* Bytes ACKed toward the next west increment */
+};
+#endif
+#endif
+
 /* Representation of a TCP connection.
  *
  * The tcp_conn_s structure is used for identifying a connection. All
@@ -141,7 +242,8 @@ struct tcp_conn_s
   uint16_t rport;         /* The remoteTCP port, in network byte order */
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
-  uint16_t winsize;       /* Current window size of the connection */
+  uint32_t winsize;       /* Current window size of the connection */
+  uint32_t rcvwnd;        /* Receive window that we last advertised */
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t unacked;       /* Number bytes sent but not yet ACKed */
 #else
@@ -155,14 +257,69 @@ struct tcp_conn_s
 
   FAR struct net_driver_s *dev;
 
+  /* Connections with data to send are kept in a list of their own so that
+   * the device poll does not have to visit idle connections.
+   *
+   *   txnext  - The next connection in the TX ready list.
+   *   txready - True if the connection is in the TX ready list.
+   */
+
+  FAR struct tcp_conn_s *txnext;
+  bool     txready;
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Read-ahead buffering.
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the TCP/IP read-ahead data is retained.
+   *   rcvbufs   - The most I/O buffer storage (bytes) that readahead may
+   *               hold (SO_RCVBUF).  Zero means no limit.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+  uint32_t   rcvbufs;             /* Receive buffer limit */
+#endif
+
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+  /* Out-of-order receive queue.
+   *
+   *   ofosegs  - Blocks of data received ahead of rcvseq, sorted by
+   *              sequence number.  Blocks never touch or overlap.
+   *   ofonew   - Sequence number of the most recently queued segment.  The
+   *              block holding it is reported first in SACK options.
+   *   nofosegs - The number of valid entries in ofosegs[].
+   *   sackok   - The peer agreed to use selective acknowledgements.
+   */
+
+  struct tcp_ofoseg_s ofosegs[CONFIG_NET_TCP_OUTOFORDER_NSEGS];
+  uint32_t   ofonew;      /* Sequence number of newest out-of-order data */
+  uint8_t    nofosegs;    /* Number of out-of-order blocks held */
+  uint8_t    sackok;      /* Non-zero: SACK was negotiated */
+#endif
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* Window scaling (RFC 7323)
+   *
+   *   sndscale - Shift applied to the windows advertised by the peer
+   *   rcvscale - Shift applied to the windows that we advertise
+   *   wsok     - The peer sent the window scale option
+   */
+
+  uint8_t    sndscale;    /* Peer's window scale shift */
+  uint8_t    rcvscale;    /* Our window scale shift */
+  uint8_t    wsok;        /* Non-zero: window scaling was negotiated */
+#endif
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* Timestamps (RFC 7323)
+   *
+   *   tsrecent - The timestamp to echo: TSval of the last segment received
+   *              in sequence
+   *   tsok     - The peer sent the timestamps option
+   */
+
+  uint32_t   tsrecent;    /* Timestamp to echo to the peer */
+  uint8_t    tsok;        /* Non-zero: timestamps were negotiated */
 #endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -172,6 +329,9 @@ struct tcp_conn_s
    *               list may be partially sent.  FIFO ordering.
    *   unacked_q - A queue of completely sent, but unacked I/O buffer
    *               chains.  Sequence number ordering.
+   *   sndbufs   - The most I/O buffer storage (bytes) that write_q and
+   *               unacked_q may hold (SO_SNDBUF).  Zero means no limit.
+   *   sndsem    - Senders wait here for the queues to drain below sndbufs.
    */
 
   sq_queue_t write_q;     /* Write buffering for segments */
@@ -182,6 +342,44 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
   uint32_t   sndseq_max;  /* The sequence number of next not-retransmitted
                            * segment (next greater sndseq) */
+  uint32_t   sndbufs;     /* Send buffer limit */
+  sem_t      sndsem;      /* Waits for send buffer space */
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control for buffered sends
+   *
+   *   ccops    - The congestion control algorithm in use
+   *   snduna   - The oldest unacknowledged sequence number
+   *   cwnd     - The congestion window (bytes)
+   *   ssthresh - The slow start threshold (bytes)
+   *   recover  - sndseq_max when loss was last detected.  Fast recovery
+   *              ends when this much has been acknowledged.
+   *   ackcnt   - Bytes ACKed toward the next congestion window increment
+   *   rttseq   - The ACK of this sequence number completes the current
+   *              round trip time measurement
+   *   rttstart - The time (ticks) that the timed segment was sent
+   *   srtt     - Smoothed round trip time (ticks, scaled by 8)
+   *   rttvar   - Round trip time variation (ticks, scaled by 4)
+   *   dupacks  - The number of consecutive duplicate ACKs
+   *   ccflags  - See TCP_CC_* definitions
+   */
+
+  FAR const struct tcp_cc_ops_s *ccops;
+  uint32_t   snduna;      /* Oldest unacknowledged sequence number */
+  uint32_t   cwnd;        /* Congestion window */
+  uint32_t   ssthresh;    /* Slow start threshold */
+  uint32_t   recover;     /* End of the current fast recovery */
+  uint32_t   ackcnt;      /* ACKed bytes toward the next cwnd increment */
+  uint32_t   rttseq;      /* Sequence number being timed */
+  uint32_t   rttstart;    /* Time the timed sequence number was sent */
+  uint32_t   srtt;        /* Smoothed round trip time */
+  uint32_t   rttvar;      /* Round trip time variation */
+  uint8_t    dupacks;     /* Consecutive duplicate ACKs */
+  uint8_t    ccflags;     /* Congestion control state flags */
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  struct tcp_cubic_s cubic; /* CUBIC state */
+#endif
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -373,6 +571,47 @@ FAR struct tcp_conn_s *tcp_active(FAR struct net_driver_s *dev,
 
 FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_setready
+ *
+ * Description:
+ *   Add a connection to the end of the TX ready list, if it is not already
+ *   there.  This is done when the connection has data to send; the next
+ *   poll of the device will then give the connection a TCP_POLL event.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_setready(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_clrready
+ *
+ * Description:
+ *   Remove a connection from the TX ready list.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_clrready(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_nextready
+ *
+ * Description:
+ *   Traverse the list of TCP connections with data ready to send
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_nextready(FAR struct tcp_conn_s *conn);
+
 /****************************************************************************
  * Name: tcp_local_ipv4_device
  *
@@ -1069,6 +1308,253 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
                          uint16_t nbytes);
 #endif
 
+/****************************************************************************
+ * Name: tcp_ofoseg_add
+ *
+ * Description:
+ *   Hold a segment that was received ahead of the next expected sequence
+ *   number.  The segment is merged with any adjacent or overlapping data
+ *   already held.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure that received the segment
+ *   conn   - A pointer to the TCP connection structure
+ *   seqno  - The sequence number of the first byte of the segment
+ *   buffer - The segment data
+ *   buflen - The number of bytes of segment data
+ *
+ * Returned Value:
+ *   Zero (OK) if the data is held; a negated errno value if it was
+ *   discarded.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+int tcp_ofoseg_add(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
+                   uint32_t seqno, FAR const uint8_t *buffer,
+                   uint16_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: tcp_ofoseg_deliver
+ *
+ * Description:
+ *   Pass out-of-order data that is no longer preceded by a gap to the
+ *   application, at most one MSS at a time through dev->d_appdata, and
+ *   advance rcvseq past it.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure whose d_appdata buffer is used
+ *   conn - A pointer to the TCP connection structure
+ *
+ * Returned Value:
+ *   The event flags returned by the application, less TCP_NEWDATA.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+uint16_t tcp_ofoseg_deliver(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_ofoseg_sack
+ *
+ * Description:
+ *   Format a SACK option describing the out-of-order data held by the
+ *   connection.
+ *
+ * Input Parameters:
+ *   conn - A pointer to the TCP connection structure
+ *   opt  - The location of the TCP options in the outgoing packet
+ *
+ * Returned Value:
+ *   The number of option bytes written (a multiple of 4; zero if there is
+ *   nothing to report).
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+unsigned int tcp_ofoseg_sack(FAR struct tcp_conn_s *conn, FAR uint8_t *opt);
+#endif
+
+/****************************************************************************
+ * Name: tcp_ofoseg_free
+ *
+ * Description:
+ *   Release all out-of-order data held by the connection.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+void tcp_ofoseg_free(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize congestion control for a connection that has just entered
+ *   the ESTABLISHED state.  conn->isn and conn->mss must already be set.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_init(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_rtt
+ *
+ * Description:
+ *   Fold a round trip time measurement into the smoothed estimates and
+ *   recompute the retransmission timeout (RFC 6298).
+ *
+ * Input Parameters:
+ *   conn - A pointer to the TCP connection structure
+ *   rtt  - The measured round trip time (clock ticks)
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_rtt(FAR struct tcp_conn_s *conn, uint32_t rtt);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Process the acknowledgement number of an incoming segment:  Complete
+ *   round trip time measurements, grow the congestion window when new data
+ *   is acknowledged, and count duplicate ACKs.  The third duplicate ACK (or
+ *   a partial ACK during fast recovery) sets TCP_CC_FASTREXMIT to request
+ *   a retransmission of the oldest unacknowledged segment.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the TCP connection structure
+ *   ackno  - The acknowledgement number of the incoming segment
+ *   dupack - True if the segment may be a duplicate ACK: it carries no data
+ *            and does not change the window
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackno, bool dupack);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_sent
+ *
+ * Description:
+ *   Called when a data segment is sent.  Starts a round trip time
+ *   measurement for new data and abandons it for retransmissions (Karn's
+ *   algorithm).
+ *
+ * Input Parameters:
+ *   conn  - A pointer to the TCP connection structure
+ *   seqno - The sequence number of the first byte sent
+ *   len   - The number of bytes sent
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_sent(FAR struct tcp_conn_s *conn, uint32_t seqno, uint32_t len);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_sndwnd
+ *
+ * Description:
+ *   Return the number of bytes that may be sent starting at 'seqno': the
+ *   smaller of the congestion window and the peer's receive window, less
+ *   the data already in flight ahead of 'seqno'.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+uint32_t tcp_cc_sndwnd(FAR struct tcp_conn_s *conn, uint32_t seqno);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Called when the retransmission timer expires on an established
+ *   connection.  Collapses the congestion window to one segment and leaves
+ *   fast recovery.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked.
+ *   conn->nrtx has already been incremented for this retransmission.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_get_recvwindow
+ *
+ * Description:
+ *   Return the receive window (bytes) to advertise for a connection.  With
+ *   NET_TCP_WINDOW_SCALE or NET_TCP_RWND_CONTROL, this is sized from the
+ *   I/O buffers available for read-ahead; otherwise it is the fixed window
+ *   of the network device.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure to use in the send operation
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_get_rcvscale
+ *
+ * Description:
+ *   Return the window scale shift to offer in a SYN or SYNACK:  The
+ *   smallest shift that lets the largest possible receive window be
+ *   advertised.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_get_rcvscale(void);
+#endif
+
 /****************************************************************************
  * Name: tcp_backlogcreate
  *
@@ -1271,6 +1757,28 @@ struct socket;
 ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+/****************************************************************************
+ * Name: psock_tcp_sendv
+ *
+ * Description:
+ *   This is psock_tcp_send() with the data gathered from an array of
+ *   buffers.  The data is queued (or sent) as one stream of bytes so that,
+ *   for example, a header and a payload can share one TCP segment.
+ *
+ * Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   iov      Array of buffers to send
+ *   iovcnt   Number of elements in iov[]
+ *
+ * Returned Value:
+ *   See psock_tcp_send().
+ *
+ ****************************************************************************/
+
+struct iovec;
+ssize_t psock_tcp_sendv(FAR struct socket *psock,
+                        FAR const struct iovec *iov, int iovcnt);
+
 /****************************************************************************
  * Name: psock_tcp_cansend
  *
@@ -1351,6 +1859,38 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void);
 void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb);
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Name: tcp_wrbuffer_inqueue_size
+ *
+ * Description:
+ *   Return the I/O buffer storage (bytes) held by the write buffers queued
+ *   on a connection, sent or not.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+uint32_t tcp_wrbuffer_inqueue_size(FAR struct tcp_conn_s *conn);
+#endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
+
+/****************************************************************************
+ * Name: tcp_sendbuffer_notify
+ *
+ * Description:
+ *   Wake up a sender that is waiting for the write buffers queued on a
+ *   connection to drop below the send buffer limit.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+void tcp_sendbuffer_notify(FAR struct tcp_conn_s *conn);
+#endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
+
 /****************************************************************************
  * Name: tcp_wrbuffer_test
  *
@@ -234,8 +234,28 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
                          uint16_t buflen)
 {
   FAR struct iob_s *iob;
+  unsigned int nbufs;
   int ret;
 
+  /* Leave the I/O buffers reserved for UDP and drop the segment if the
+   * receive buffer of the socket is already full.  The receive window
+   * normally keeps the peer from sending more than the limit, so unlike
+   * UDP, the segment is only checked against the data already queued.
+   */
+
+  nbufs = (buflen + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE;
+  if (iob_navail(true) < nbufs + CONFIG_NET_UDP_RECV_RESERVE ||
+      (conn->rcvbufs > 0 &&
+       iob_queue_count(&conn->readahead) * CONFIG_IOB_BUFSIZE >=
+       conn->rcvbufs))
+    {
+      nwarn("WARNING: No receive buffer space for %u bytes\n", buflen);
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.rcvdrop++;
+#endif
+      return 0;
+    }
+
   /* Try to allocate on I/O buffer to start the chain without waiting (and
    * throttling as necessary).  If we would have to wait, then drop the
    * packet.
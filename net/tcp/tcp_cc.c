@@ -0,0 +1,721 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_CC)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+#  define TCP_CC_DEFAULT   (&g_tcp_cubic)
+#else
+#  define TCP_CC_DEFAULT   (&g_tcp_newreno)
+#endif
+
+/* The congestion window never needs to exceed this */
+
+#define TCP_CC_MAXCWND     0x3fffffff
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* CUBIC constants (RFC 8312):  C = 0.4 and beta = 0.7.  The standard TCP
+ * estimate grows by 3 * (1 - beta) / (1 + beta) = 9/17 segment per RTT.
+ */
+
+#  define CUBIC_BETA_NUM   7
+#  define CUBIC_BETA_DEN   10
+#  define CUBIC_WEST_NUM   9
+#  define CUBIC_WEST_DEN   17
+
+/* Limit on |t - K| (msec) so that the cube cannot overflow */
+
+#  define CUBIC_MAXDELTA   65535
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+static void tcp_newreno_congavoid(FAR struct tcp_conn_s *conn,
+                                  uint32_t acked);
+static uint32_t tcp_newreno_ssthresh(FAR struct tcp_conn_s *conn);
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn);
+static void tcp_cubic_congavoid(FAR struct tcp_conn_s *conn,
+                                uint32_t acked);
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+static const struct tcp_cc_ops_s g_tcp_newreno =
+{
+  "newreno",               /* name */
+  NULL,                    /* init */
+  tcp_newreno_congavoid,   /* congavoid */
+  tcp_newreno_ssthresh     /* ssthresh */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+static const struct tcp_cc_ops_s g_tcp_cubic =
+{
+  "cubic",                 /* name */
+  tcp_cubic_init,          /* init */
+  tcp_cubic_congavoid,     /* congavoid */
+  tcp_cubic_ssthresh       /* ssthresh */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_flight
+ *
+ * Description:
+ *   Return the number of bytes sent but not yet acknowledged.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cc_flight(FAR struct tcp_conn_s *conn)
+{
+  if (TCP_SEQ_GT(conn->sndseq_max, conn->snduna))
+    {
+      return conn->sndseq_max - conn->snduna;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: tcp_newreno_congavoid
+ *
+ * Description:
+ *   Additive increase: one segment per congestion window of ACKed data.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+static void tcp_newreno_congavoid(FAR struct tcp_conn_s *conn,
+                                  uint32_t acked)
+{
+  conn->ackcnt += acked;
+  if (conn->ackcnt >= conn->cwnd)
+    {
+      conn->ackcnt -= conn->cwnd;
+      conn->cwnd   += conn->mss;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_newreno_ssthresh
+ *
+ * Description:
+ *   Multiplicative decrease: half of the data in flight (RFC 5681).
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  uint32_t ssthresh = tcp_cc_flight(conn) >> 1;
+  uint32_t minimum  = 2 * (uint32_t)conn->mss;
+
+  return ssthresh > minimum ? ssthresh : minimum;
+}
+#endif /* CONFIG_NET_TCP_CC_NEWRENO */
+
+/****************************************************************************
+ * Name: tcp_cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+static uint32_t tcp_cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b   = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_init
+ ****************************************************************************/
+
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->cubic, 0, sizeof(struct tcp_cubic_s));
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_congavoid
+ *
+ * Description:
+ *   Grow the window toward W_cubic(t + RTT) = C * (t - K)^3 + W_max, or the
+ *   window that a standard TCP would have reached if that is larger.
+ *
+ ****************************************************************************/
+
+static void tcp_cubic_congavoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cubic;
+  uint32_t now = (uint32_t)clock_systimer();
+  uint32_t target;
+  uint32_t thresh;
+  uint32_t incr;
+  int64_t delta;
+  int64_t offset;
+
+  /* Start a new epoch on the first ACK after a reduction */
+
+  if (cubic->epoch == 0)
+    {
+      cubic->epoch = (now != 0) ? now : 1;
+
+      if (conn->cwnd < cubic->wmax)
+        {
+          /* K = cbrt((W_max - cwnd) / C) with the window in segments and
+           * K in milliseconds.
+           */
+
+          cubic->k      = tcp_cubic_cbrt((uint64_t)(cubic->wmax - conn->cwnd) *
+                                         2500000000ull / conn->mss);
+          cubic->origin = cubic->wmax;
+        }
+      else
+        {
+          cubic->k      = 0;
+          cubic->origin = conn->cwnd;
+        }
+
+      cubic->west    = conn->cwnd;
+      cubic->westcnt = 0;
+      conn->ackcnt   = 0;
+    }
+
+  /* t is the time since the epoch plus one RTT, in milliseconds */
+
+  delta = (int64_t)TICK2MSEC(now - cubic->epoch + (conn->srtt >> 3)) -
+          cubic->k;
+
+  if (delta > CUBIC_MAXDELTA)
+    {
+      delta = CUBIC_MAXDELTA;
+    }
+  else if (delta < -CUBIC_MAXDELTA)
+    {
+      delta = -CUBIC_MAXDELTA;
+    }
+
+  /* C * (t - K)^3 segments, scaled to bytes.  C = 0.4 / sec^3. */
+
+  offset = (delta * delta * delta / 100000) * 4 * conn->mss / 100000;
+  if (offset < 0 && (uint64_t)-offset >= cubic->origin)
+    {
+      target = conn->mss;
+    }
+  else
+    {
+      target = (uint32_t)(cubic->origin + offset);
+    }
+
+  /* TCP-friendly region: track the window standard TCP would have */
+
+  cubic->westcnt += acked;
+  thresh = (uint32_t)((uint64_t)conn->cwnd * CUBIC_WEST_DEN / CUBIC_WEST_NUM);
+  if (thresh > 0 && cubic->westcnt >= thresh)
+    {
+      cubic->west    += (cubic->westcnt / thresh) * conn->mss;
+      cubic->westcnt %= thresh;
+    }
+
+  if (cubic->west > target)
+    {
+      target = cubic->west;
+    }
+
+  if (target > conn->cwnd)
+    {
+      /* Concave/convex region:  (target - cwnd) / cwnd per segment ACKed,
+       * but never faster than slow start.
+       */
+
+      incr = (uint32_t)((uint64_t)(target - conn->cwnd) * acked / conn->cwnd);
+      conn->cwnd += (incr < acked) ? incr : acked;
+    }
+  else
+    {
+      /* At the plateau:  One segment per 100 windows of ACKed data */
+
+      conn->ackcnt += acked;
+      if (conn->ackcnt >= 100 * conn->cwnd)
+        {
+          conn->ackcnt = 0;
+          conn->cwnd  += conn->mss;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_ssthresh
+ *
+ * Description:
+ *   Remember where the loss happened and reduce the window by beta.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cubic;
+  uint32_t ssthresh;
+  uint32_t minimum;
+
+  /* Fast convergence:  If the window did not recover to the last W_max,
+   * release some bandwidth to new flows.
+   */
+
+  if (conn->cwnd < cubic->wmax)
+    {
+      cubic->wmax = (uint32_t)((uint64_t)conn->cwnd *
+                               (CUBIC_BETA_DEN + CUBIC_BETA_NUM) /
+                               (2 * CUBIC_BETA_DEN));
+    }
+  else
+    {
+      cubic->wmax = conn->cwnd;
+    }
+
+  cubic->epoch = 0;
+
+  ssthresh = (uint32_t)((uint64_t)conn->cwnd * CUBIC_BETA_NUM /
+                        CUBIC_BETA_DEN);
+  minimum  = 2 * (uint32_t)conn->mss;
+
+  return ssthresh > minimum ? ssthresh : minimum;
+}
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_rtt
+ *
+ * Description:
+ *   Fold a new round trip time measurement into the smoothed estimates and
+ *   recompute the retransmission timeout as described in RFC 6298.
+ *
+ * Input Parameters:
+ *   conn - A pointer to the TCP connection structure
+ *   rtt  - The measured round trip time in system clock ticks
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_rtt(FAR struct tcp_conn_s *conn, uint32_t rtt)
+{
+  uint32_t rto;
+  int32_t delta;
+
+  if (rtt == 0)
+    {
+      rtt = 1;
+    }
+
+  if (conn->srtt == 0)
+    {
+      /* First measurement: SRTT = R, RTTVAR = R/2 */
+
+      conn->srtt   = rtt << 3;
+      conn->rttvar = rtt << 1;
+    }
+  else
+    {
+      /* SRTT += (R - SRTT) / 8, RTTVAR += (|R - SRTT| - RTTVAR) / 4 */
+
+      delta         = (int32_t)(rtt - (conn->srtt >> 3));
+      conn->srtt   += delta;
+      if (delta < 0)
+        {
+          delta = -delta;
+        }
+
+      delta        -= (int32_t)(conn->rttvar >> 2);
+      conn->rttvar += delta;
+    }
+
+  /* RTO = SRTT + max(G, 4 * RTTVAR), rounded up to the half-second units of
+   * the TCP timer.
+   */
+
+  rto = (conn->srtt >> 3) + (conn->rttvar > 0 ? conn->rttvar : 1);
+  rto = (rto + TICK_PER_HSEC - 1) / TICK_PER_HSEC;
+
+  if (rto < TCP_CC_RTOMIN)
+    {
+      rto = TCP_CC_RTOMIN;
+    }
+  else if (rto > TCP_CC_RTOMAX)
+    {
+      rto = TCP_CC_RTOMAX;
+    }
+
+  conn->rto = (uint8_t)rto;
+
+  ninfo("RTT: rtt=%u srtt=%u rttvar=%u rto=%u\n",
+        rtt, conn->srtt >> 3, conn->rttvar >> 2, conn->rto);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize congestion control for a connection that has just entered
+ *   the ESTABLISHED state.  conn->isn and conn->mss must already be set.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn)
+{
+  uint32_t mss = conn->mss;
+
+  /* Nothing is in flight yet */
+
+  conn->snduna     = conn->isn;
+  conn->sndseq_max = conn->isn;
+  conn->recover    = conn->isn;
+
+  /* Initial window (RFC 5681) */
+
+  if (mss > 2190)
+    {
+      conn->cwnd = 2 * mss;
+    }
+  else if (mss > 1095)
+    {
+      conn->cwnd = 3 * mss;
+    }
+  else
+    {
+      conn->cwnd = 4 * mss;
+    }
+
+  conn->ssthresh = UINT32_MAX;
+  conn->ackcnt   = 0;
+  conn->srtt     = 0;
+  conn->rttvar   = 0;
+  conn->dupacks  = 0;
+  conn->ccflags  = 0;
+
+  conn->ccops    = TCP_CC_DEFAULT;
+  if (conn->ccops->init != NULL)
+    {
+      conn->ccops->init(conn);
+    }
+
+  ninfo("CC: %s cwnd=%u\n", conn->ccops->name, conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Process the acknowledgement number of an incoming segment:  Complete
+ *   round trip time measurements, grow the congestion window when new data
+ *   is acknowledged, and count duplicate ACKs.  The third duplicate ACK (or
+ *   a partial ACK during fast recovery) sets TCP_CC_FASTREXMIT to request
+ *   a retransmission of the oldest unacknowledged segment.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the TCP connection structure
+ *   ackno  - The acknowledgement number of the incoming segment
+ *   dupack - True if the segment may be a duplicate ACK: it carries no data
+ *            and does not change the window
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackno, bool dupack)
+{
+  uint32_t mss = conn->mss;
+
+  if (TCP_SEQ_GT(ackno, conn->snduna))
+    {
+      uint32_t acked = ackno - conn->snduna;
+
+      /* New data was acknowledged */
+
+      conn->snduna  = ackno;
+      conn->dupacks = 0;
+      conn->nrtx    = 0;
+
+      if ((conn->ccflags & TCP_CC_RTTTIMING) != 0 &&
+          TCP_SEQ_GE(ackno, conn->rttseq))
+        {
+          conn->ccflags &= ~TCP_CC_RTTTIMING;
+          tcp_cc_rtt(conn, (uint32_t)clock_systimer() - conn->rttstart);
+        }
+
+      if ((conn->ccflags & TCP_CC_RECOVERY) != 0)
+        {
+          if (TCP_SEQ_GE(ackno, conn->recover))
+            {
+              uint32_t flight = tcp_cc_flight(conn) + mss;
+
+              /* Full ACK:  Deflate the window and leave fast recovery */
+
+              conn->cwnd     = conn->ssthresh < flight ? conn->ssthresh : flight;
+              conn->ackcnt   = 0;
+              conn->ccflags &= ~(TCP_CC_RECOVERY | TCP_CC_FASTREXMIT);
+
+              ninfo("CC: recovered cwnd=%u\n", conn->cwnd);
+            }
+          else
+            {
+              /* Partial ACK:  The next hole is lost too.  Retransmit it and
+               * deflate the window by the amount of new data ACKed.
+               */
+
+              conn->cwnd  = conn->cwnd > acked ? conn->cwnd - acked : 0;
+              if (acked >= mss)
+                {
+                  conn->cwnd += mss;
+                }
+
+              if (conn->cwnd < mss)
+                {
+                  conn->cwnd = mss;
+                }
+
+              conn->ccflags |= TCP_CC_FASTREXMIT;
+            }
+        }
+      else if (conn->cwnd < conn->ssthresh)
+        {
+          /* Slow start: at most one segment per ACK (RFC 3465, L = 1) */
+
+          conn->cwnd += acked < mss ? acked : mss;
+        }
+      else
+        {
+          conn->ccops->congavoid(conn, acked);
+        }
+
+      if (conn->cwnd > TCP_CC_MAXCWND)
+        {
+          conn->cwnd = TCP_CC_MAXCWND;
+        }
+    }
+  else if (dupack && ackno == conn->snduna && tcp_cc_flight(conn) > 0)
+    {
+      if ((conn->ccflags & TCP_CC_RECOVERY) != 0)
+        {
+          /* Each further duplicate ACK means one more segment has left the
+           * network.
+           */
+
+          conn->cwnd += mss;
+        }
+      else if (++conn->dupacks == TCP_CC_DUPTHRESH &&
+               TCP_SEQ_GT(ackno, conn->recover))
+        {
+          /* Fast retransmit.  Losses from a window that has already been
+           * reduced (ackno not beyond 'recover') do not reduce it again.
+           */
+
+          conn->ssthresh = conn->ccops->ssthresh(conn);
+          conn->cwnd     = conn->ssthresh + TCP_CC_DUPTHRESH * mss;
+          conn->recover  = conn->sndseq_max;
+          conn->ackcnt   = 0;
+          conn->ccflags |= (TCP_CC_RECOVERY | TCP_CC_FASTREXMIT);
+          conn->ccflags &= ~TCP_CC_RTTTIMING;
+
+          ninfo("CC: fast retransmit ssthresh=%u cwnd=%u recover=%u\n",
+                conn->ssthresh, conn->cwnd, conn->recover);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_sent
+ *
+ * Description:
+ *   Called when a data segment is sent.  Starts a round trip time
+ *   measurement for new data and abandons it for retransmissions (Karn's
+ *   algorithm).
+ *
+ * Input Parameters:
+ *   conn  - A pointer to the TCP connection structure
+ *   seqno - The sequence number of the first byte sent
+ *   len   - The number of bytes sent
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_sent(FAR struct tcp_conn_s *conn, uint32_t seqno, uint32_t len)
+{
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* With timestamps, every ACK is timed by the echoed timestamp instead */
+
+  if (conn->tsok)
+    {
+      return;
+    }
+
+#endif
+  if (TCP_SEQ_LT(seqno, conn->sndseq_max))
+    {
+      conn->ccflags &= ~TCP_CC_RTTTIMING;
+    }
+  else if ((conn->ccflags & TCP_CC_RTTTIMING) == 0)
+    {
+      conn->rttseq   = seqno + len;
+      conn->rttstart = (uint32_t)clock_systimer();
+      conn->ccflags |= TCP_CC_RTTTIMING;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_sndwnd
+ *
+ * Description:
+ *   Return the number of bytes that may be sent starting at 'seqno': the
+ *   smaller of the congestion window and the peer's receive window, less
+ *   the data already in flight ahead of 'seqno'.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+uint32_t tcp_cc_sndwnd(FAR struct tcp_conn_s *conn, uint32_t seqno)
+{
+  uint32_t wnd = conn->cwnd < conn->winsize ? conn->cwnd : conn->winsize;
+  uint32_t inflight = 0;
+
+  if (TCP_SEQ_GT(seqno, conn->snduna))
+    {
+      inflight = seqno - conn->snduna;
+    }
+
+  return inflight < wnd ? wnd - inflight : 0;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Called when the retransmission timer expires on an established
+ *   connection.  Collapses the congestion window to one segment and leaves
+ *   fast recovery.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked.
+ *   conn->nrtx has already been incremented for this retransmission.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* Only the first timeout for the same data reduces ssthresh; by the
+   * later ones the window is already down to one segment.
+   */
+
+  if (conn->nrtx <= 1)
+    {
+      conn->ssthresh = conn->ccops->ssthresh(conn);
+    }
+
+  conn->cwnd     = conn->mss;
+  conn->recover  = conn->sndseq_max;
+  conn->ackcnt   = 0;
+  conn->dupacks  = 0;
+  conn->ccflags  = 0;
+
+  ninfo("CC: timeout ssthresh=%u cwnd=%u\n", conn->ssthresh, conn->cwnd);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_CC */
@@ -53,6 +53,7 @@
 
 #include <arch/irq.h>
 
+#include <nuttx/semaphore.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -86,6 +87,11 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+/* A list of the connections with data ready to send, in FIFO order */
+
+static FAR struct tcp_conn_s *g_ready_tcp_head;
+static FAR struct tcp_conn_s *g_ready_tcp_tail;
+
 /* Last port used by a TCP connection connection. */
 
 static uint16_t g_last_tcp_port;
@@ -714,6 +720,19 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
       conn->tcpstateflags = TCP_ALLOCATED;
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       conn->domain        = domain;
+#endif
+#ifdef CONFIG_NET_TCP_READAHEAD
+      conn->rcvbufs       = CONFIG_NET_RECV_BUFSIZE;
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+      conn->sndbufs       = CONFIG_NET_SEND_BUFSIZE;
+
+      /* The send buffer semaphore is used for signaling and, hence, should
+       * not have priority inheritance enabled.
+       */
+
+      nxsem_init(&conn->sndsem, 0, 0);
+      nxsem_setprotocol(&conn->sndsem, SEM_PRIO_NONE);
 #endif
     }
 
@@ -766,12 +785,22 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       dq_rem(&conn->node, &g_active_tcp_connections);
     }
 
+  /* Remove the connection from the TX ready list */
+
+  tcp_clrready(conn);
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Release any read-ahead buffers attached to the connection */
 
   iob_free_queue(&conn->readahead);
 #endif
 
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+  /* Release any out-of-order data held by the connection */
+
+  tcp_ofoseg_free(conn);
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
 
@@ -784,6 +813,8 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       tcp_wrbuffer_release(wrbuffer);
     }
+
+  nxsem_destroy(&conn->sndsem);
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -868,6 +899,109 @@ FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: tcp_setready
+ *
+ * Description:
+ *   Add a connection to the end of the TX ready list, if it is not already
+ *   there.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the nework locked.
+ *
+ ****************************************************************************/
+
+void tcp_setready(FAR struct tcp_conn_s *conn)
+{
+  if (!conn->txready)
+    {
+      conn->txnext  = NULL;
+      conn->txready = true;
+
+      if (g_ready_tcp_tail == NULL)
+        {
+          g_ready_tcp_head = conn;
+        }
+      else
+        {
+          g_ready_tcp_tail->txnext = conn;
+        }
+
+      g_ready_tcp_tail = conn;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_clrready
+ *
+ * Description:
+ *   Remove a connection from the TX ready list.  The list holds at most
+ *   CONFIG_NET_TCP_CONNS entries, so a linear search is fine.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the nework locked.
+ *
+ ****************************************************************************/
+
+void tcp_clrready(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s *prev = NULL;
+  FAR struct tcp_conn_s *curr;
+
+  if (!conn->txready)
+    {
+      return;
+    }
+
+  for (curr = g_ready_tcp_head; curr != NULL; prev = curr, curr = curr->txnext)
+    {
+      if (curr == conn)
+        {
+          if (prev == NULL)
+            {
+              g_ready_tcp_head = conn->txnext;
+            }
+          else
+            {
+              prev->txnext = conn->txnext;
+            }
+
+          if (g_ready_tcp_tail == conn)
+            {
+              g_ready_tcp_tail = prev;
+            }
+
+          break;
+        }
+    }
+
+  conn->txnext  = NULL;
+  conn->txready = false;
+}
+
+/****************************************************************************
+ * Name: tcp_nextready
+ *
+ * Description:
+ *   Traverse the list of TCP connections with data ready to send
+ *
+ * Assumptions:
+ *   This function is called from network logic with the nework locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_nextready(FAR struct tcp_conn_s *conn)
+{
+  if (!conn)
+    {
+      return g_ready_tcp_head;
+    }
+  else
+    {
+      return conn->txnext;
+    }
+}
+
 /****************************************************************************
  * Name: tcp_alloc_accept
  *
@@ -120,9 +120,27 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 #else /* if defined(CONFIG_NET_IPv6) */
           tcp_ipv6_select(dev);
 #endif
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+          /* Deliver out-of-order data that tcp_input() could not pass on
+           * because the same packet carried data to send.  The application
+           * is polled for new data only if it did not already send some.
+           */
+
+          result = 0;
+          if (conn->nofosegs > 0)
+            {
+              result = tcp_ofoseg_deliver(dev, conn);
+            }
+
+          if (dev->d_sndlen == 0)
+            {
+              result |= tcp_callback(dev, conn, TCP_POLL);
+            }
+#else
           /* Perform the callback */
 
           result = tcp_callback(dev, conn, TCP_POLL);
+#endif
 
           /* Handle the callback response */
 
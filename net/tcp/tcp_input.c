@@ -51,6 +51,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
@@ -58,6 +59,7 @@
 #include <nuttx/net/tcp.h>
 
 #include "devif/devif.h"
+#include "netdev/netdev.h"
 #include "utils/utils.h"
 #include "tcp/tcp.h"
 
@@ -65,6 +67,240 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_parse_options
+ *
+ * Description:
+ *   Parse the options of a SYN or SYNACK segment:  The MSS and, if the
+ *   corresponding features are enabled, whether the peer permits selective
+ *   acknowledgements, its window scale and its first timestamp.
+ *
+ * Parameters:
+ *   dev   - The device driver structure containing the received TCP packet.
+ *   conn  - The TCP connection being set up
+ *   iplen - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN).
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_parse_options(FAR struct net_driver_s *dev,
+                              FAR struct tcp_conn_s *conn,
+                              unsigned int iplen)
+{
+  FAR struct tcp_hdr_s *tcp;
+  FAR uint8_t *optdata;
+  unsigned int optlen;
+  unsigned int i;
+  uint16_t tmp16;
+  uint8_t opt;
+
+  tcp = (FAR struct tcp_hdr_s *)&dev->d_buf[iplen + NET_LL_HDRLEN(dev)];
+  if ((tcp->tcpoffset & 0xf0) <= 0x50)
+    {
+      return;
+    }
+
+  optdata = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  optlen  = ((tcp->tcpoffset >> 4) - 5) << 2;
+
+  for (i = 0; i < optlen; )
+    {
+      opt = optdata[i];
+      if (opt == TCP_OPT_END)
+        {
+          /* End of options. */
+
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          /* NOP option. */
+
+          ++i;
+          continue;
+        }
+      else if (i + 1 >= optlen || optdata[i + 1] == 0)
+        {
+          /* All other options have a length field.  If the length field is
+           * missing or zero, the options are malformed and we don't process
+           * them further.
+           */
+
+          break;
+        }
+      else if (opt == TCP_OPT_MSS && optdata[i + 1] == TCP_OPT_MSS_LEN &&
+               i + TCP_OPT_MSS_LEN <= optlen)
+        {
+          uint16_t tcp_mss = TCP_MSS(dev, iplen);
+
+          /* An MSS option with the right option length. */
+
+          tmp16 = ((uint16_t)optdata[i + 2] << 8) | (uint16_t)optdata[i + 3];
+          conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+        }
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+      else if (opt == TCP_OPT_SACK_PERM &&
+               optdata[i + 1] == TCP_OPT_SACK_PERM_LEN)
+        {
+          /* The peer can make use of SACK blocks */
+
+          conn->sackok = 1;
+        }
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      else if (opt == TCP_OPT_WS && optdata[i + 1] == TCP_OPT_WS_LEN &&
+               i + TCP_OPT_WS_LEN <= optlen && !TCP_6LOWPAN_DEV(dev))
+        {
+          /* The peer's windows will be scaled by this shift count */
+
+          conn->sndscale = optdata[i + 2] > TCP_WS_MAXSHIFT ?
+                           TCP_WS_MAXSHIFT : optdata[i + 2];
+          conn->wsok     = 1;
+        }
+#endif
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      else if (opt == TCP_OPT_TS && optdata[i + 1] == TCP_OPT_TS_LEN &&
+               i + TCP_OPT_TS_LEN <= optlen && !TCP_6LOWPAN_DEV(dev))
+        {
+          /* The peer will send timestamps; remember its first one */
+
+          conn->tsrecent = tcp_getsequence(&optdata[i + 2]);
+          conn->tsok     = 1;
+        }
+#endif
+
+      /* Skip past the option */
+
+      i += optdata[i + 1];
+    }
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* The timestamps option takes space from every segment */
+
+  if (conn->tsok)
+    {
+      conn->mss -= TCP_TS_SPACE;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_get_timestamps
+ *
+ * Description:
+ *   Find the timestamps option in a segment.
+ *
+ * Parameters:
+ *   tcp   - The TCP header of the received segment
+ *   len   - Length of the TCP header including options
+ *   tsval - Location to return the peer's timestamp
+ *   tsecr - Location to return our timestamp echoed by the peer
+ *
+ * Returned Value:
+ *   True if the segment carries a timestamps option.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+static bool tcp_get_timestamps(FAR struct tcp_hdr_s *tcp, unsigned int len,
+                               FAR uint32_t *tsval, FAR uint32_t *tsecr)
+{
+  FAR uint8_t *optdata = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  unsigned int optlen = len - TCP_HDRLEN;
+  unsigned int i;
+
+  for (i = 0; i < optlen; )
+    {
+      if (optdata[i] == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (optdata[i] == TCP_OPT_NOOP)
+        {
+          ++i;
+          continue;
+        }
+      else if (i + 1 >= optlen || optdata[i + 1] == 0)
+        {
+          break;
+        }
+      else if (optdata[i] == TCP_OPT_TS &&
+               optdata[i + 1] == TCP_OPT_TS_LEN &&
+               i + TCP_OPT_TS_LEN <= optlen)
+        {
+          *tsval = tcp_getsequence(&optdata[i + 2]);
+          *tsecr = tcp_getsequence(&optdata[i + 6]);
+          return true;
+        }
+
+      i += optdata[i + 1];
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_update_rto
+ *
+ * Description:
+ *   Update the smoothed RTT estimate and the retransmission timeout from
+ *   an ACK of new data (Van Jacobson's algorithm).  No estimate is made
+ *   after retransmissions unless the peer echoed a timestamp.
+ *
+ * Parameters:
+ *   conn  - The TCP connection
+ *   tsecr - Our timestamp echoed by the peer, or zero if there is none
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_update_rto(FAR struct tcp_conn_s *conn, uint32_t tsecr)
+{
+  signed char m;
+
+  if (conn->nrtx != 0 && tsecr == 0)
+    {
+      return;
+    }
+
+  if (tsecr != 0)
+    {
+      uint32_t rtt = TICK2HSEC((uint32_t)clock_systimer() - tsecr);
+      m = rtt > 127 ? 127 : (signed char)rtt;
+    }
+  else
+    {
+      m = conn->rto - conn->timer;
+    }
+
+  /* This is taken directly from VJs original code in his paper */
+
+  m = m - (conn->sa >> 3);
+  conn->sa += m;
+  if (m < 0)
+    {
+      m = -m;
+    }
+
+  m = m - (conn->sv >> 2);
+  conn->sv += m;
+  conn->rto = (conn->sa >> 3) + conn->sv;
+}
+
 /****************************************************************************
  * Name: tcp_input
  *
@@ -90,13 +326,18 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   FAR struct tcp_hdr_s *tcp;
   FAR struct tcp_conn_s *conn = NULL;
   unsigned int tcpiplen;
-  unsigned int hdrlen;
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
-  uint8_t  opt;
   int      len;
-  int      i;
+  uint32_t wnd;
+#ifdef CONFIG_NET_TCP_CC
+  bool     wndupdate;
+#endif
+  uint32_t tsecr = 0;
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  uint32_t tsval;
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -114,10 +355,6 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   tcpiplen = iplen + TCP_HDRLEN;
 
-  /* Get the size of the link layer header, the IP header, and the TCP header */
-
-  hdrlen = tcpiplen + NET_LL_HDRLEN(dev);
-
   /* Start of TCP input header processing code. */
 
   if (tcp_chksum(dev) != 0xffff)
@@ -226,58 +463,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
           net_incr32(conn->rcvseq, 1);
 
-          /* Parse the TCP MSS option, if present. */
+          /* Parse the TCP options, if present. */
 
-          if ((tcp->tcpoffset & 0xf0) > 0x50)
-            {
-              for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                {
-                  opt = dev->d_buf[hdrlen + i];
-                  if (opt == TCP_OPT_END)
-                    {
-                      /* End of options. */
-
-                      break;
-                    }
-                  else if (opt == TCP_OPT_NOOP)
-                    {
-                      /* NOP option. */
-
-                      ++i;
-                    }
-                  else if (opt == TCP_OPT_MSS &&
-                          dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                    {
-                      uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                      /* An MSS option with the right option length. */
-
-                      tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
-                               (uint16_t)dev->d_buf[hdrlen + 3 + i];
-                      conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                      /* And we are done processing options. */
-
-                      break;
-                    }
-                  else
-                    {
-                      /* All other options have a length field, so that we easily
-                       * can skip past them.
-                       */
-
-                      if (dev->d_buf[hdrlen + 1 + i] == 0)
-                        {
-                          /* If the length field is zero, the options are malformed
-                           * and we don't process them further.
-                           */
-
-                          break;
-                        }
-                      i += dev->d_buf[hdrlen + 1 + i];
-                    }
-                }
-            }
+          tcp_parse_options(dev, conn, iplen);
 
           /* Our response will be a SYNACK. */
 
@@ -311,7 +499,19 @@ found:
 
   /* Update the connection's window size */
 
-  conn->winsize = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
+  wnd           = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if ((tcp->flags & TCP_SYN) == 0)
+    {
+      /* The window in a SYN or SYNACK is never scaled */
+
+      wnd <<= conn->sndscale;
+    }
+#endif
+#ifdef CONFIG_NET_TCP_CC
+  wndupdate     = (wnd != conn->winsize);
+#endif
+  conn->winsize = wnd;
 
   flags = 0;
 
@@ -384,6 +584,43 @@ found:
 
   dev->d_len -= (len + iplen);
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* Once timestamps are negotiated, reject old duplicate segments whose
+   * timestamp is older than the most recent one (PAWS, RFC 7323).  Note
+   * the peer's timestamp to be echoed if this is the next expected
+   * segment.
+   */
+
+  if (conn->tsok && (tcp->flags & TCP_SYN) == 0 &&
+      tcp_get_timestamps(tcp, len, &tsval, &tsecr))
+    {
+      if (TCP_SEQ_LT(tsval, conn->tsrecent))
+        {
+          nwarn("WARNING: PAWS rejected tsval=%u tsrecent=%u\n",
+                tsval, conn->tsrecent);
+          tcp_send(dev, conn, TCP_ACK, tcpiplen);
+          return;
+        }
+
+      if (memcmp(tcp->seqno, conn->rcvseq, 4) == 0)
+        {
+          conn->tsrecent = tsval;
+        }
+    }
+#endif
+
+  /* If the segment carries TCP options, move the data down over them.
+   * d_appdata must stay where outgoing data is placed, just after a TCP
+   * header without options.  The options of a SYN are still needed and
+   * any data it carries is ignored.
+   */
+
+  if (len > TCP_HDRLEN && dev->d_len > 0 && (tcp->flags & TCP_SYN) == 0)
+    {
+      memmove(dev->d_appdata, (FAR uint8_t *)dev->d_appdata + len - TCP_HDRLEN,
+              dev->d_len);
+    }
+
   /* First, check if the sequence number of the incoming packet is
    * what we're expecting next. If not, we send out an ACK with the
    * correct numbers in, unless we are in the SYN_RCVD state and
@@ -399,6 +636,21 @@ found:
       if ((dev->d_len > 0 || ((tcp->flags & (TCP_SYN | TCP_FIN)) != 0)) &&
           memcmp(tcp->seqno, conn->rcvseq, 4) != 0)
         {
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+          /* Hold on to plain data that arrived ahead of a gap so that the
+           * peer only needs to retransmit the missing data.  The ACK below
+           * reports it in a SACK option.
+           */
+
+          if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+              (tcp->flags & (TCP_SYN | TCP_FIN | TCP_RST | TCP_URG)) == 0 &&
+              dev->d_len > 0)
+            {
+              (void)tcp_ofoseg_add(dev, conn, tcp_getsequence(tcp->seqno),
+                                   dev->d_appdata, dev->d_len);
+            }
+#endif
+
           tcp_send(dev, conn, TCP_ACK, tcpiplen);
           return;
         }
@@ -441,6 +693,15 @@ found:
 
       if (ackseq <= unackseq)
         {
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+          /* Only an ACK of new data gives a valid RTT sample */
+
+          if (unackseq - ackseq >= conn->unacked)
+            {
+              tsecr = 0;
+            }
+
+#endif
           /* Calculate the new number of outstanding, unacknowledged bytes */
 
           conn->unacked = unackseq - ackseq;
@@ -472,26 +733,34 @@ found:
             conn->sndseq, ackseq, unackseq, conn->unacked);
       tcp_setsequence(conn->sndseq, ackseq);
 
-      /* Do RTT estimation, unless we have done retransmissions. */
+#ifdef CONFIG_NET_TCP_CC
+      /* Once the connection is established, congestion control measures
+       * the RTT and watches for duplicate ACKs: ACKs with no data that
+       * neither advance ackseq nor change the window.
+       */
 
-      if (conn->nrtx == 0)
+      if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED)
         {
-          signed char m;
-          m = conn->rto - conn->timer;
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+          /* The echoed timestamp times retransmitted data too */
 
-          /* This is taken directly from VJs original code in his paper */
-
-          m = m - (conn->sa >> 3);
-          conn->sa += m;
-          if (m < 0)
+          if (tsecr != 0)
             {
-              m = -m;
+              tcp_cc_rtt(conn, (uint32_t)clock_systimer() - tsecr);
             }
 
-          m = m - (conn->sv >> 2);
-          conn->sv += m;
-          conn->rto = (conn->sa >> 3) + conn->sv;
+#endif
+          tcp_cc_ack(conn, ackseq,
+                     dev->d_len == 0 && !wndupdate &&
+                     (tcp->flags & (TCP_SYN | TCP_FIN)) == 0);
         }
+      else
+        {
+          tcp_update_rto(conn, tsecr);
+        }
+#else
+      tcp_update_rto(conn, tsecr);
+#endif
 
         /* Set the acknowledged flag. */
 
@@ -555,6 +824,9 @@ found:
             tcp_setsequence(conn->sndseq, conn->isn);
             conn->sent          = 0;
             conn->sndseq_max    = 0;
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
+#endif
 #endif
             conn->unacked       = 0;
             flags               = TCP_CONNECTED;
@@ -591,59 +863,21 @@ found:
 
         if ((flags & TCP_ACKDATA) != 0 && (tcp->flags & TCP_CTL) == (TCP_SYN | TCP_ACK))
           {
-            /* Parse the TCP MSS option, if present. */
+            /* Parse the TCP options, if present. */
+
+            tcp_parse_options(dev, conn, iplen);
 
-            if ((tcp->tcpoffset & 0xf0) > 0x50)
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+            /* Our SYN offered window scaling; it is only used if the peer
+             * offered it too.
+             */
+
+            if (!conn->wsok)
               {
-                for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                  {
-                    opt = dev->d_buf[hdrlen + i];
-                    if (opt == TCP_OPT_END)
-                      {
-                        /* End of options. */
-
-                        break;
-                      }
-                    else if (opt == TCP_OPT_NOOP)
-                      {
-                        /* NOP option. */
-
-                        ++i;
-                      }
-                    else if (opt == TCP_OPT_MSS &&
-                              dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                      {
-                        uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                        /* An MSS option with the right option length. */
-
-                        tmp16 =
-                          (dev->d_buf[hdrlen + 2 + i] << 8) |
-                          dev->d_buf[hdrlen + 3 + i];
-                        conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                        /* And we are done processing options. */
-
-                        break;
-                      }
-                    else
-                      {
-                        /* All other options have a length field, so that we
-                         * easily can skip past them.
-                         */
-
-                        if (dev->d_buf[hdrlen + 1 + i] == 0)
-                          {
-                            /* If the length field is zero, the options are
-                             * malformed and we don't process them further.
-                             */
-
-                            break;
-                          }
-                        i += dev->d_buf[hdrlen + 1 + i];
-                      }
-                  }
+                conn->rcvscale = 0;
+                conn->sndscale = 0;
               }
+#endif
 
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
@@ -654,6 +888,9 @@ found:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
+#endif
 #endif
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
@@ -817,6 +1054,32 @@ found:
                 /* Update the sequence number using the saved length */
 
                 net_incr32(conn->rcvseq, len);
+
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+                /* The segment may have filled the gap in front of data in
+                 * the out-of-order queue.  Pass that data on too.  The one
+                 * ACK sent below then covers all of it.
+                 */
+
+                if (conn->nofosegs > 0 && dev->d_sndlen == 0)
+                  {
+                    dev->d_appdata = &dev->d_buf[tcpiplen +
+                                                 NET_LL_HDRLEN(dev)];
+                    result |= tcp_ofoseg_deliver(dev, conn);
+                  }
+
+                /* d_appdata is also the buffer that the queued data is
+                 * passed through.  If it holds data to send, the rest of the
+                 * queue is delivered by tcp_poll() once this packet is out.
+                 * Only connections on the TX ready list are polled.
+                 */
+
+                if (conn->nofosegs > 0 && dev->d_sndlen > 0)
+                  {
+                    tcp_setready(conn);
+                    netdev_txnotify_dev(dev);
+                  }
+#endif
               }
 
             /* Send the response, ACKing the data or not, as appropriate */
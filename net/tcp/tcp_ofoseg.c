@@ -0,0 +1,478 @@
+/****************************************************************************
+ * net/tcp/tcp_ofoseg.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_OUTOFORDER)
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Maximum number of blocks in one SACK option (40 bytes of options).  One
+ * block less fits alongside the timestamps option.
+ */
+
+#define TCP_SACK_MAXBLOCKS 4
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_ofoseg_remove
+ *
+ * Description:
+ *   Remove entry 'ndx' from the out-of-order queue.  The I/O buffer chain
+ *   must already have been released or handed off.
+ *
+ ****************************************************************************/
+
+static void tcp_ofoseg_remove(FAR struct tcp_conn_s *conn, int ndx)
+{
+  conn->nofosegs--;
+  memmove(&conn->ofosegs[ndx], &conn->ofosegs[ndx + 1],
+          (conn->nofosegs - ndx) * sizeof(struct tcp_ofoseg_s));
+}
+
+/****************************************************************************
+ * Name: tcp_ofoseg_merge
+ *
+ * Description:
+ *   Merge blocks that touch or overlap their successor so that each entry
+ *   describes one contiguous, maximal run of data.
+ *
+ ****************************************************************************/
+
+static void tcp_ofoseg_merge(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_ofoseg_s *curr;
+  FAR struct tcp_ofoseg_s *next;
+  uint32_t overlap;
+  int ndx = 0;
+
+  while (ndx + 1 < conn->nofosegs)
+    {
+      curr    = &conn->ofosegs[ndx];
+      next    = &conn->ofosegs[ndx + 1];
+
+      if (TCP_SEQ_LT(curr->os_seqno + curr->os_len, next->os_seqno))
+        {
+          /* There is a gap between the two blocks */
+
+          ndx++;
+          continue;
+        }
+
+      overlap = curr->os_seqno + curr->os_len - next->os_seqno;
+      if (overlap >= next->os_len)
+        {
+          /* The next block is a duplicate of data already held */
+
+          iob_free_chain(next->os_iob);
+        }
+      else if ((uint32_t)curr->os_len + next->os_len - overlap > UINT16_MAX)
+        {
+          /* Too much for one I/O buffer chain.  Leave them apart. */
+
+          ndx++;
+          continue;
+        }
+      else
+        {
+          /* Drop the overlapping part and append the rest */
+
+          next->os_iob = iob_trimhead(next->os_iob, overlap);
+          iob_concat(curr->os_iob, next->os_iob);
+          curr->os_len += next->os_len - overlap;
+        }
+
+      tcp_ofoseg_remove(conn, ndx + 1);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_ofoseg_add
+ *
+ * Description:
+ *   Hold a segment that was received ahead of the next expected sequence
+ *   number.  The segment is merged with any adjacent or overlapping data
+ *   already held.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure that received the segment
+ *   conn   - A pointer to the TCP connection structure
+ *   seqno  - The sequence number of the first byte of the segment
+ *   buffer - The segment data
+ *   buflen - The number of bytes of segment data
+ *
+ * Returned Value:
+ *   Zero (OK) if the data is held; a negated errno value if it was
+ *   discarded.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+int tcp_ofoseg_add(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
+                   uint32_t seqno, FAR const uint8_t *buffer,
+                   uint16_t buflen)
+{
+  FAR struct tcp_ofoseg_s *seg;
+  FAR struct iob_s *iob;
+  uint32_t rcvseq;
+  int ndx;
+  int ret;
+
+  /* Only data strictly ahead of rcvseq and inside the window that we have
+   * advertised is kept.  Anything else is an old duplicate or is beyond
+   * what the peer may send.
+   */
+
+  rcvseq = tcp_getsequence(conn->rcvseq);
+  if (TCP_SEQ_LE(seqno, rcvseq) ||
+      seqno + buflen - rcvseq > conn->rcvwnd)
+    {
+      return -EINVAL;
+    }
+
+  /* Find where the segment goes.  The queue is short, so a linear search
+   * is fine.
+   */
+
+  for (ndx = 0; ndx < conn->nofosegs; ndx++)
+    {
+      if (TCP_SEQ_LT(seqno, conn->ofosegs[ndx].os_seqno))
+        {
+          break;
+        }
+    }
+
+  conn->ofonew = seqno;
+
+  /* Is the data already held in the preceding block? */
+
+  if (ndx > 0)
+    {
+      seg = &conn->ofosegs[ndx - 1];
+      if (TCP_SEQ_LE(seqno + buflen, seg->os_seqno + seg->os_len))
+        {
+          return OK;
+        }
+    }
+
+  /* If all entries are in use, give up the block furthest ahead.  It is the
+   * one the peer will get around to retransmitting last.
+   */
+
+  if (conn->nofosegs >= CONFIG_NET_TCP_OUTOFORDER_NSEGS)
+    {
+      if (ndx >= conn->nofosegs)
+        {
+          return -ENOSPC;
+        }
+
+      iob_free_chain(conn->ofosegs[conn->nofosegs - 1].os_iob);
+      conn->nofosegs--;
+    }
+
+  /* Copy the data into an I/O buffer chain without waiting */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      nerr("ERROR: Failed to allocate an I/O buffer\n");
+      return -ENOMEM;
+    }
+
+  ret = iob_trycopyin(iob, buffer, buflen, 0, true);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to copy out-of-order data: %d\n", ret);
+      iob_free_chain(iob);
+      return ret;
+    }
+
+  /* Insert the new block and merge it with its neighbors */
+
+  memmove(&conn->ofosegs[ndx + 1], &conn->ofosegs[ndx],
+          (conn->nofosegs - ndx) * sizeof(struct tcp_ofoseg_s));
+
+  seg           = &conn->ofosegs[ndx];
+  seg->os_seqno = seqno;
+  seg->os_len   = buflen;
+  seg->os_iob   = iob;
+  conn->nofosegs++;
+
+  tcp_ofoseg_merge(conn);
+
+  ninfo("Holding %u bytes at %08x, rcvseq %08x, %d blocks\n",
+        buflen, seqno, rcvseq, conn->nofosegs);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_ofoseg_deliver
+ *
+ * Description:
+ *   Pass out-of-order data that is no longer preceded by a gap to the
+ *   application, at most one MSS at a time through dev->d_appdata, and
+ *   advance rcvseq past it.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure whose d_appdata buffer is used
+ *   conn - A pointer to the TCP connection structure
+ *
+ * Returned Value:
+ *   The event flags returned by the application, less TCP_NEWDATA.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+uint16_t tcp_ofoseg_deliver(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_ofoseg_s *seg;
+  uint32_t rcvseq;
+  uint32_t skip;
+  uint16_t result;
+  uint16_t ret = 0;
+  uint16_t len;
+
+  while (conn->nofosegs > 0 && (conn->tcpstateflags & TCP_STOPPED) == 0)
+    {
+      seg    = &conn->ofosegs[0];
+      rcvseq = tcp_getsequence(conn->rcvseq);
+
+      /* Is there still a gap in front of the first block? */
+
+      if (TCP_SEQ_LT(rcvseq, seg->os_seqno))
+        {
+          break;
+        }
+
+      /* Discard anything that has already been received in order */
+
+      skip = rcvseq - seg->os_seqno;
+      if (skip >= seg->os_len)
+        {
+          iob_free_chain(seg->os_iob);
+          tcp_ofoseg_remove(conn, 0);
+          continue;
+        }
+
+      if (skip > 0)
+        {
+          seg->os_iob    = iob_trimhead(seg->os_iob, skip);
+          seg->os_seqno += skip;
+          seg->os_len   -= skip;
+        }
+
+      /* Present the next MSS worth of data as if it had just arrived */
+
+      len = seg->os_len > conn->mss ? conn->mss : seg->os_len;
+      (void)iob_copyout(dev->d_appdata, seg->os_iob, len, 0);
+
+      dev->d_len    = len;
+      dev->d_sndlen = 0;
+
+      result = tcp_callback(dev, conn, TCP_NEWDATA);
+      if ((result & TCP_SNDACK) == 0)
+        {
+          /* Not accepted (the read-ahead buffers are exhausted).  Keep it
+           * for later.
+           */
+
+          break;
+        }
+
+      net_incr32(conn->rcvseq, len);
+      ret |= result & ~TCP_NEWDATA;
+
+      if (len >= seg->os_len)
+        {
+          iob_free_chain(seg->os_iob);
+          tcp_ofoseg_remove(conn, 0);
+        }
+      else
+        {
+          seg->os_iob    = iob_trimhead(seg->os_iob, len);
+          seg->os_seqno += len;
+          seg->os_len   -= len;
+        }
+
+      /* Stop if the application queued data to send in d_appdata */
+
+      if (dev->d_sndlen > 0)
+        {
+          break;
+        }
+    }
+
+  dev->d_len = dev->d_sndlen;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tcp_ofoseg_sack
+ *
+ * Description:
+ *   Format a SACK option describing the out-of-order data held by the
+ *   connection.
+ *
+ * Input Parameters:
+ *   conn - A pointer to the TCP connection structure
+ *   opt  - The location of the TCP options in the outgoing packet
+ *
+ * Returned Value:
+ *   The number of option bytes written (a multiple of 4; zero if there is
+ *   nothing to report).
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+unsigned int tcp_ofoseg_sack(FAR struct tcp_conn_s *conn, FAR uint8_t *opt)
+{
+  FAR struct tcp_ofoseg_s *seg;
+  FAR uint8_t *block;
+  int maxblocks = TCP_SACK_MAXBLOCKS;
+  int nblocks;
+  int first;
+  int ndx;
+
+  if (!conn->sackok || conn->nofosegs == 0)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  if (conn->tsok)
+    {
+      maxblocks--;
+    }
+#endif
+
+  nblocks = conn->nofosegs;
+  if (nblocks > maxblocks)
+    {
+      nblocks = maxblocks;
+    }
+
+  /* RFC 2018: The first block must report the most recently received
+   * segment.  The others follow in sequence order.
+   */
+
+  for (first = 0; first < conn->nofosegs - 1; first++)
+    {
+      seg = &conn->ofosegs[first];
+      if (TCP_SEQ_LT(conn->ofonew, seg->os_seqno + seg->os_len))
+        {
+          break;
+        }
+    }
+
+  opt[0] = TCP_OPT_NOOP;
+  opt[1] = TCP_OPT_NOOP;
+  opt[2] = TCP_OPT_SACK;
+  opt[3] = TCP_OPT_SACK_LEN(nblocks);
+
+  block = &opt[4];
+  seg   = &conn->ofosegs[first];
+  tcp_setsequence(block, seg->os_seqno);
+  tcp_setsequence(block + 4, seg->os_seqno + seg->os_len);
+  block += 8;
+
+  for (ndx = 0; ndx < conn->nofosegs && block < &opt[4 + 8 * nblocks]; ndx++)
+    {
+      if (ndx != first)
+        {
+          seg = &conn->ofosegs[ndx];
+          tcp_setsequence(block, seg->os_seqno);
+          tcp_setsequence(block + 4, seg->os_seqno + seg->os_len);
+          block += 8;
+        }
+    }
+
+  return 4 + 8 * nblocks;
+}
+
+/****************************************************************************
+ * Name: tcp_ofoseg_free
+ *
+ * Description:
+ *   Release all out-of-order data held by the connection.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_ofoseg_free(FAR struct tcp_conn_s *conn)
+{
+  while (conn->nofosegs > 0)
+    {
+      conn->nofosegs--;
+      iob_free_chain(conn->ofosegs[conn->nofosegs].os_iob);
+    }
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_OUTOFORDER */
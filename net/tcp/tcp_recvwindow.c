@@ -0,0 +1,177 @@
+/****************************************************************************
+ * net/tcp/tcp_recvwindow.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
+
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_READAHEAD) && \
+    (defined(CONFIG_NET_TCP_WINDOW_SCALE) || defined(CONFIG_NET_TCP_RWND_CONTROL))
+#  define HAVE_IOB_RCVWND 1
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_get_recvwindow
+ *
+ * Description:
+ *   Return the receive window (bytes) to advertise for a connection.  With
+ *   NET_TCP_WINDOW_SCALE or NET_TCP_RWND_CONTROL, this is sized from the
+ *   I/O buffers available for read-ahead and limited by the receive buffer
+ *   of the socket; otherwise it is the fixed window of the network device.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure to use in the send operation
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn)
+{
+#ifdef HAVE_IOB_RCVWND
+  uint32_t rwnd;
+  uint32_t maxwnd;
+  int navail;
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+  int ndx;
+#endif
+
+  /* Read-ahead buffers are allocated throttled, so only count the I/O
+   * buffers that such an allocation can obtain, less those reserved for
+   * UDP.
+   */
+
+  navail = iob_navail(true) - CONFIG_NET_UDP_RECV_RESERVE;
+  rwnd   = navail > 0 ? (uint32_t)navail * CONFIG_IOB_BUFSIZE : 0;
+
+#if CONFIG_IOB_NCHAINS > 0
+  /* Each segment queued for read-ahead also needs a queue container */
+
+  maxwnd = (uint32_t)iob_qentry_navail() * conn->mss;
+  if (rwnd > maxwnd)
+    {
+      rwnd = maxwnd;
+    }
+#endif
+
+  /* Nor can the window exceed what is left of the socket receive buffer */
+
+  if (conn->rcvbufs > 0)
+    {
+      maxwnd = iob_queue_count(&conn->readahead) * CONFIG_IOB_BUFSIZE;
+      maxwnd = maxwnd < conn->rcvbufs ? conn->rcvbufs - maxwnd : 0;
+      if (rwnd > maxwnd)
+        {
+          rwnd = maxwnd;
+        }
+    }
+
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+  /* Out-of-order data already held lies inside the window */
+
+  for (ndx = 0; ndx < conn->nofosegs; ndx++)
+    {
+      rwnd += conn->ofosegs[ndx].os_len;
+    }
+#endif
+
+  /* Never close the window completely.  Nothing would reopen it when the
+   * application consumes the read-ahead data, and the peer would be left
+   * probing a zero window with an ever increasing backoff.  A segment that
+   * cannot be buffered is simply not acknowledged and will be resent.
+   */
+
+  if (rwnd < conn->mss)
+    {
+      rwnd = conn->mss;
+    }
+
+  return rwnd;
+#else
+  return NET_DEV_RCVWNDO(dev);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_get_rcvscale
+ *
+ * Description:
+ *   Return the window scale shift to offer in a SYN or SYNACK:  The
+ *   smallest shift that lets the largest possible receive window be
+ *   advertised.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+uint8_t tcp_get_rcvscale(void)
+{
+  uint32_t maxwnd = (uint32_t)CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE;
+  uint8_t shift = 0;
+
+  while (shift < TCP_WS_MAXSHIFT && (maxwnd >> shift) > UINT16_MAX)
+    {
+      shift++;
+    }
+
+  return shift;
+}
+#endif
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP */
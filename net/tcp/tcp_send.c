@@ -52,12 +52,9 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/clock.h>
 #include <nuttx/net/tcp.h>
 
-#ifdef CONFIG_NET_TCP_RWND_CONTROL
-#  include <nuttx/semaphore.h>
-#endif
-
 #include "devif/devif.h"
 #include "inet/inet.h"
 #include "tcp/tcp.h"
@@ -313,11 +310,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                            FAR struct tcp_conn_s *conn,
                            FAR struct tcp_hdr_s *tcp)
 {
-#ifdef CONFIG_NET_TCP_RWND_CONTROL
-  extern sem_t g_qentry_sem;
-  int  qentry_sem_count;
   uint32_t rwnd;
-#endif
 
   /* Copy the IP address into the IPv6 header */
 
@@ -351,19 +344,6 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
   tcp->srcport  = conn->lport;
   tcp->destport = conn->rport;
 
-#ifdef CONFIG_NET_TCP_RWND_CONTROL
-  /* Update the TCP received window based on I/O buffer */
-  /* NOTE: This algorithm is still experimental */
-
-  if (OK == nxsem_getvalue(&g_qentry_sem, &qentry_sem_count))
-    {
-      rwnd = (qentry_sem_count * CONFIG_NET_ETH_TCP_RECVWNDO)
-             / CONFIG_IOB_NCHAINS;
-
-      NET_DEV_RCVWNDO(dev) = (uint16_t)rwnd;
-    }
-#endif
-
   /* Set the TCP window */
 
   if (conn->tcpstateflags & TCP_STOPPED)
@@ -372,15 +352,40 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
        * window so that the remote host will stop sending data.
        */
 
-      tcp->wnd[0] = 0;
-      tcp->wnd[1] = 0;
+      rwnd = 0;
+    }
+  else
+    {
+      rwnd = tcp_get_recvwindow(dev, conn);
+    }
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window in a SYN or SYNACK is never scaled */
+
+  if ((tcp->flags & TCP_SYN) == 0)
+    {
+      rwnd >>= conn->rcvscale;
+      if (rwnd > UINT16_MAX)
+        {
+          rwnd = UINT16_MAX;
+        }
+
+      conn->rcvwnd = rwnd << conn->rcvscale;
     }
   else
+#endif
     {
-      tcp->wnd[0] = ((NET_DEV_RCVWNDO(dev)) >> 8);
-      tcp->wnd[1] = ((NET_DEV_RCVWNDO(dev)) & 0xff);
+      if (rwnd > UINT16_MAX)
+        {
+          rwnd = UINT16_MAX;
+        }
+
+      conn->rcvwnd = rwnd;
     }
 
+  tcp->wnd[0] = rwnd >> 8;
+  tcp->wnd[1] = rwnd & 0xff;
+
   /* Finish the IP portion of the message and calculate checksums */
 
   tcp_sendcomplete(dev, tcp);
@@ -415,10 +420,56 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
               uint16_t flags, uint16_t len)
 {
   FAR struct tcp_hdr_s *tcp = tcp_header(dev);
+#if defined(CONFIG_NET_TCP_TIMESTAMPS) || defined(CONFIG_NET_TCP_OUTOFORDER)
+  FAR uint8_t *opt = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  unsigned int optlen = 0;
+#endif
 
   tcp->flags     = flags;
   dev->d_len     = len;
   tcp->tcpoffset = (TCP_HDRLEN / 4) << 4;
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* Once negotiated, every segment other than a reset carries timestamps.
+   * Any payload is moved up to make room for the option; conn->mss was
+   * reduced by the same amount so the packet still fits.
+   */
+
+  if (conn->tsok && (flags & TCP_RST) == 0)
+    {
+      unsigned int hdrlen = opt - &dev->d_buf[NET_LL_HDRLEN(dev)];
+
+      if (len > hdrlen)
+        {
+          memmove(opt + TCP_TS_SPACE, opt, len - hdrlen);
+        }
+
+      opt[0]  = TCP_OPT_NOOP;
+      opt[1]  = TCP_OPT_NOOP;
+      opt[2]  = TCP_OPT_TS;
+      opt[3]  = TCP_OPT_TS_LEN;
+      tcp_setsequence(&opt[4], (uint32_t)clock_systimer());
+      tcp_setsequence(&opt[8], conn->tsrecent);
+      optlen += TCP_TS_SPACE;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+  /* A pure ACK reports the out-of-order data that we hold, if any, so that
+   * the peer only needs to retransmit what is missing.
+   */
+
+  if (flags == TCP_ACK)
+    {
+      optlen += tcp_ofoseg_sack(conn, opt + optlen);
+    }
+#endif
+
+#if defined(CONFIG_NET_TCP_TIMESTAMPS) || defined(CONFIG_NET_TCP_OUTOFORDER)
+  dev->d_len    += optlen;
+  tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
+#endif
+
   tcp_sendcommon(dev, conn, tcp);
 }
 
@@ -561,6 +612,7 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 {
   struct tcp_hdr_s *tcp;
   uint16_t tcp_mss;
+  uint16_t optlen = TCP_OPT_MSS_LEN;
 
   /* Get values that vary with the underlying IP domain */
 
@@ -606,7 +658,69 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->optdata[1] = TCP_OPT_MSS_LEN;
   tcp->optdata[2] = tcp_mss >> 8;
   tcp->optdata[3] = tcp_mss & 0xff;
-  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+
+#ifdef CONFIG_NET_TCP_OUTOFORDER
+  /* Offer selective acknowledgements in our SYN.  In a SYNACK, agree to
+   * them only if the peer offered them.
+   */
+
+  if ((ack & TCP_ACK) == 0 || conn->sackok)
+    {
+      FAR uint8_t *opt = (FAR uint8_t *)tcp + TCP_HDRLEN + optlen;
+
+      opt[0]      = TCP_OPT_NOOP;
+      opt[1]      = TCP_OPT_NOOP;
+      opt[2]      = TCP_OPT_SACK_PERM;
+      opt[3]      = TCP_OPT_SACK_PERM_LEN;
+      optlen     += 4;
+      dev->d_len += 4;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* Offer window scaling in our SYN; in a SYNACK only if the peer offered
+   * it.  Our windows are scaled only if both sides agree.  Never offer it
+   * through 6LoWPAN, which does not scale the windows that it sends.
+   */
+
+  if (((ack & TCP_ACK) == 0 || conn->wsok) && !TCP_6LOWPAN_DEV(dev))
+    {
+      FAR uint8_t *opt = (FAR uint8_t *)tcp + TCP_HDRLEN + optlen;
+
+      conn->rcvscale = tcp_get_rcvscale();
+
+      opt[0]      = TCP_OPT_NOOP;
+      opt[1]      = TCP_OPT_WS;
+      opt[2]      = TCP_OPT_WS_LEN;
+      opt[3]      = conn->rcvscale;
+      optlen     += 4;
+      dev->d_len += 4;
+    }
+  else
+    {
+      conn->rcvscale = 0;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* Likewise for timestamps.  A SYN has nothing to echo yet. */
+
+  if (((ack & TCP_ACK) == 0 || conn->tsok) && !TCP_6LOWPAN_DEV(dev))
+    {
+      FAR uint8_t *opt = (FAR uint8_t *)tcp + TCP_HDRLEN + optlen;
+
+      opt[0]      = TCP_OPT_NOOP;
+      opt[1]      = TCP_OPT_NOOP;
+      opt[2]      = TCP_OPT_TS;
+      opt[3]      = TCP_OPT_TS_LEN;
+      tcp_setsequence(&opt[4], (uint32_t)clock_systimer());
+      tcp_setsequence(&opt[8], (ack & TCP_ACK) != 0 ? conn->tsrecent : 0);
+      optlen     += TCP_TS_SPACE;
+      dev->d_len += TCP_TS_SPACE;
+    }
+#endif
+
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
 
   /* Complete the common portions of the TCP message */
 
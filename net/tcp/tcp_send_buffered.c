@@ -52,6 +52,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -66,6 +67,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/tcp.h>
 
@@ -204,6 +206,12 @@ static inline void psock_lost_connection(FAR struct socket *psock,
   sq_init(&conn->write_q);
   conn->sent       = 0;
   conn->sndseq_max = 0;
+
+  /* Wake up a sender waiting for send buffer space so that it can see
+   * that the connection was lost.
+   */
+
+  tcp_sendbuffer_notify(conn);
 }
 
 /****************************************************************************
@@ -320,6 +328,99 @@ static inline bool psock_send_addrchck(FAR struct tcp_conn_s *conn)
 #  define psock_send_addrchck(r) (true)
 #endif /* CONFIG_NET_ETHERNET */
 
+/****************************************************************************
+ * Name: psock_send_fastrexmit
+ *
+ * Description:
+ *   Retransmit the segment at the oldest unacknowledged sequence number
+ *   without waiting for the retransmission timer.  Congestion control asks
+ *   for this after three duplicate ACKs and on partial ACKs during fast
+ *   recovery.  Only that one segment is resent; the write queues are not
+ *   touched.
+ *
+ * Parameters:
+ *   dev      The structure of the network driver that caused the event
+ *   conn     The connection structure associated with the socket
+ *
+ * Returned Value:
+ *   True if a segment was set up for sending.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+static bool psock_send_fastrexmit(FAR struct net_driver_s *dev,
+                                  FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  size_t sndlen;
+
+  conn->ccflags &= ~TCP_CC_FASTREXMIT;
+
+  /* The oldest unacknowledged data is at the head of the unacked_q or, if
+   * that is empty, in the partially sent write buffer at the head of the
+   * write_q.
+   */
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->unacked_q);
+  if (wrb != NULL)
+    {
+      sndlen = TCP_WBPKTLEN(wrb);
+    }
+  else
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+      if (wrb == NULL || TCP_WBSENT(wrb) == 0)
+        {
+          return false;
+        }
+
+      sndlen = TCP_WBSENT(wrb);
+    }
+
+  if (TCP_WBSEQNO(wrb) != conn->snduna)
+    {
+      ninfo("FASTREXMIT: wrb=%p seqno=%u snduna=%u\n",
+            wrb, TCP_WBSEQNO(wrb), conn->snduna);
+      return false;
+    }
+
+  if (sndlen > conn->mss)
+    {
+      sndlen = conn->mss;
+    }
+
+  if (sndlen > conn->winsize)
+    {
+      sndlen = conn->winsize;
+    }
+
+  if (sndlen == 0)
+    {
+      return false;
+    }
+
+  ninfo("FASTREXMIT: wrb=%p seqno=%u sndlen=%u\n",
+        wrb, TCP_WBSEQNO(wrb), sndlen);
+
+  tcp_setsequence(conn->sndseq, TCP_WBSEQNO(wrb));
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+  send_ipselect(dev, conn);
+#endif
+
+  devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, 0);
+  tcp_cc_sent(conn, TCP_WBSEQNO(wrb), sndlen);
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.rexmit++;
+#endif
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -504,6 +605,12 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%u pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+      /* ACKed data has been freed.  There may be room in the send buffer
+       * for a waiting sender now.
+       */
+
+      tcp_sendbuffer_notify(conn);
     }
 
   /* Check for a loss of connection */
@@ -690,16 +797,39 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       return flags;
     }
 
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control may have detected a lost segment from duplicate
+   * ACKs.  Resend it now unless the packet buffer still holds incoming data.
+   */
+
+  if ((conn->ccflags & TCP_CC_FASTREXMIT) != 0 &&
+      (conn->tcpstateflags & TCP_ESTABLISHED) &&
+      (flags & TCP_NEWDATA) == 0 && psock_send_addrchck(conn) &&
+      psock_send_fastrexmit(dev, conn))
+    {
+      flags &= ~TCP_POLL;
+      return flags;
+    }
+#endif
+
   /* We get here if (1) not all of the data has been ACKed, (2) we have been
    * asked to retransmit data, (3) the connection is still healthy, and (4)
    * the outgoing packet is available for our use.  In this case, we are
    * now free to send more data to receiver -- UNLESS the buffer contains
    * unprocessed incoming data.  In that event, we will have to wait for the
    * next polling cycle.
+   *
+   * With congestion control, an ACK that opens the window also clocks out
+   * new data.
    */
 
   if ((conn->tcpstateflags & TCP_ESTABLISHED) &&
+#ifdef CONFIG_NET_TCP_CC
+      ((flags & (TCP_POLL | TCP_REXMIT)) != 0 ||
+       (flags & (TCP_ACKDATA | TCP_NEWDATA)) == TCP_ACKDATA) &&
+#else
       (flags & (TCP_POLL | TCP_REXMIT)) &&
+#endif
       !(sq_empty(&conn->write_q)))
     {
       /* Check if the destination IP address is in the ARP  or Neighbor
@@ -711,6 +841,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
         {
           FAR struct tcp_wrbuffer_s *wrb;
           uint32_t predicted_seqno;
+#ifdef CONFIG_NET_TCP_CC
+          uint32_t sndwnd;
+#endif
           size_t sndlen;
 
           /* Peek at the head of the write queue (but don't remove anything
@@ -721,6 +854,16 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
           DEBUGASSERT(wrb);
 
+          /* Set the sequence number for this segment.  If we are
+           * retransmitting, then the sequence number will already
+           * be set for this write buffer.
+           */
+
+           if (TCP_WBSEQNO(wrb) == (unsigned)-1)
+            {
+              TCP_WBSEQNO(wrb) = conn->isn + conn->sent;
+            }
+
           /* Get the amount of data that we can send in the next packet.
            * We will send either the remaining data in the buffer I/O
            * buffer chain, or as much as will fit given the MSS and current
@@ -733,24 +876,33 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               sndlen = conn->mss;
             }
 
+#ifdef CONFIG_NET_TCP_CC
+          /* The window is shared with the data already in flight.  If it
+           * is full, wait for ACKs to open it.
+           */
+
+          sndwnd = tcp_cc_sndwnd(conn, TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb));
+          if (sndlen > sndwnd)
+            {
+              sndlen = sndwnd;
+            }
+
+          if (sndlen == 0)
+            {
+              ninfo("SEND: wrb=%p window full cwnd=%u winsize=%u\n",
+                    wrb, conn->cwnd, conn->winsize);
+              return flags;
+            }
+#else
           if (sndlen > conn->winsize)
             {
               sndlen = conn->winsize;
             }
+#endif
 
           ninfo("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u\n",
                 wrb, TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb), sndlen);
 
-          /* Set the sequence number for this segment.  If we are
-           * retransmitting, then the sequence number will already
-           * be set for this write buffer.
-           */
-
-           if (TCP_WBSEQNO(wrb) == (unsigned)-1)
-            {
-              TCP_WBSEQNO(wrb) = conn->isn + conn->sent;
-            }
-
           /* The TCP stack updates sndseq on receipt of ACK *before*
            * this function is called. In that case sndseq will point
            * to the next unacknowledged byte (which might have already
@@ -775,6 +927,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
            */
 
           devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, TCP_WBSENT(wrb));
+#ifdef CONFIG_NET_TCP_CC
+          tcp_cc_sent(conn, TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb), sndlen);
+#endif
 
           /* Remember how much data we send out now so that we know
            * when everything has been acknowledged.  Just increment
@@ -835,6 +990,16 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
         }
     }
 
+  /* If more data is queued, the next poll of the device should come back to
+   * this connection.  This lets an ACK that opens the window clock out more
+   * than the one segment sent above.
+   */
+
+  if (!sq_empty(&conn->write_q))
+    {
+      tcp_setready(conn);
+    }
+
   /* Continue waiting */
 
   return flags;
@@ -859,6 +1024,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 static inline void send_txnotify(FAR struct socket *psock,
                                  FAR struct tcp_conn_s *conn)
 {
+  /* Have the next poll of the device visit this connection */
+
+  tcp_setready(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -892,16 +1061,18 @@ static inline void send_txnotify(FAR struct socket *psock,
  ****************************************************************************/
 
 /****************************************************************************
- * Name: psock_tcp_send
+ * Name: psock_tcp_sendv
  *
  * Description:
- *   psock_tcp_send() call may be used only when the TCP socket is in a
- *   connected state (so that the intended recipient is known).
+ *   psock_tcp_sendv() call may be used only when the TCP socket is in a
+ *   connected state (so that the intended recipient is known).  The data
+ *   is gathered from all of the buffers into one write buffer so that it
+ *   is segmented as one stream of bytes.
  *
  * Parameters:
  *   psock    An instance of the internal socket structure.
- *   buf      Data to send
- *   len      Length of data to send
+ *   iov      Array of buffers to send
+ *   iovcnt   Number of elements in iov[]
  *
  * Returned Value:
  *   On success, returns the number of characters sent.  On  error,
@@ -948,14 +1119,16 @@ static inline void send_txnotify(FAR struct socket *psock,
  *
  ****************************************************************************/
 
-ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
-                       size_t len)
+ssize_t psock_tcp_sendv(FAR struct socket *psock,
+                        FAR const struct iovec *iov, int iovcnt)
 {
   FAR struct tcp_conn_s *conn;
   FAR struct tcp_wrbuffer_s *wrb;
   ssize_t    result = 0;
+  size_t     len;
   int        errcode;
   int        ret = OK;
+  int        i;
 
   if (psock == NULL || psock->s_crefs <= 0)
     {
@@ -1009,9 +1182,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
-  /* Dump the incoming buffer */
+  /* Get the total length of the data and dump the incoming buffers */
 
-  BUF_DUMP("psock_tcp_send", buf, len);
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      BUF_DUMP("psock_tcp_send", iov[i].iov_base, iov[i].iov_len);
+      len += iov[i].iov_len;
+    }
 
   /* Set the socket state to sending */
 
@@ -1019,11 +1196,42 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   if (len > 0)
     {
+      net_lock();
+
+      /* Wait until the write buffers queued on the connection drop below
+       * its send buffer limit.  Non-blocking sockets cannot wait.
+       */
+
+      while (conn->sndbufs > 0 &&
+             tcp_wrbuffer_inqueue_size(conn) >= conn->sndbufs)
+        {
+          if (_SS_ISNONBLOCK(psock->s_flags))
+            {
+              errcode = EAGAIN;
+              goto errout_with_lock;
+            }
+
+          ret = net_lockedwait(&conn->sndsem);
+          if (ret < 0)
+            {
+              errcode = -ret;
+              goto errout_with_lock;
+            }
+
+          /* The connection may have been lost while we waited */
+
+          if (!_SS_ISCONNECTED(psock->s_flags))
+            {
+              nerr("ERROR: Not connected\n");
+              errcode = ENOTCONN;
+              goto errout_with_lock;
+            }
+        }
+
       /* Allocate a write buffer.  Careful, the network will be momentarily
        * unlocked here.
        */
 
-      net_lock();
       wrb = tcp_wrbuffer_alloc();
       if (!wrb)
         {
@@ -1068,13 +1276,33 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
        * buffer space if the socket was opened non-blocking.
        */
 
-      if (_SS_ISNONBLOCK(psock->s_flags))
-        {
-          result = TCP_WBTRYCOPYIN(wrb, (FAR uint8_t *)buf, len);
-        }
-      else
+      for (i = 0, result = 0; i < iovcnt; i++)
         {
-          result = TCP_WBCOPYIN(wrb, (FAR uint8_t *)buf, len);
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          if (_SS_ISNONBLOCK(psock->s_flags))
+            {
+              ret = TCP_WBTRYCOPYIN(wrb, (FAR uint8_t *)iov[i].iov_base,
+                                    iov[i].iov_len, result);
+            }
+          else
+            {
+              ret = TCP_WBCOPYIN(wrb, (FAR uint8_t *)iov[i].iov_base,
+                                 iov[i].iov_len, result);
+            }
+
+          if (ret < 0)
+            {
+              /* Nothing has been queued yet; discard what was copied */
+
+              errcode = -ret;
+              goto errout_with_wrb;
+            }
+
+          result += iov[i].iov_len;
         }
 
       /* Dump I/O buffer chain */
@@ -1136,6 +1364,27 @@ errout:
   return ERROR;
 }
 
+/****************************************************************************
+ * Name: psock_tcp_send
+ *
+ * Description:
+ *   psock_tcp_send() call may be used only when the TCP socket is in a
+ *   connected state (so that the intended recipient is known).  See
+ *   psock_tcp_sendv().
+ *
+ ****************************************************************************/
+
+ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
+                       size_t len)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
+  return psock_tcp_sendv(psock, &iov, 1);
+}
+
 /****************************************************************************
  * Name: psock_tcp_cansend
  *
@@ -43,6 +43,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -100,8 +101,9 @@ struct send_s
   FAR struct socket      *snd_sock;    /* Points to the parent socket structure */
   FAR struct devif_callback_s *snd_cb; /* Reference to callback instance */
   sem_t                   snd_sem;     /* Used to wake up the waiting thread */
-  FAR const uint8_t      *snd_buffer;  /* Points to the buffer of data to send */
-  size_t                  snd_buflen;  /* Number of bytes in the buffer to send */
+  FAR const struct iovec *snd_iov;     /* Buffers holding the data to send */
+  int                     snd_iovcnt;  /* Number of buffers in snd_iov[] */
+  size_t                  snd_buflen;  /* Total number of bytes to send */
   ssize_t                 snd_sent;    /* The number of bytes sent */
   uint32_t                snd_isn;     /* Initial sequence number */
   uint32_t                snd_acked;   /* The number of bytes acked */
@@ -560,7 +562,8 @@ static uint16_t tcpsend_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          devif_send(dev, &pstate->snd_buffer[pstate->snd_sent], sndlen);
+          devif_iov_send(dev, pstate->snd_iov, pstate->snd_iovcnt, sndlen,
+                         pstate->snd_sent);
 
           /* Check if the destination IP address is in the ARP  or Neighbor
            * table.  If not, then the send won't actually make it out... it
@@ -634,6 +637,10 @@ end_wait:
 static inline void send_txnotify(FAR struct socket *psock,
                                  FAR struct tcp_conn_s *conn)
 {
+  /* Have the next poll of the device visit this connection */
+
+  tcp_setready(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -667,7 +674,7 @@ static inline void send_txnotify(FAR struct socket *psock,
  ****************************************************************************/
 
 /****************************************************************************
- * Name: psock_tcp_send
+ * Name: psock_tcp_sendv
  *
  * Description:
  *   psock_tcp_send() call may be used only when the TCP socket is in a
@@ -675,8 +682,8 @@ static inline void send_txnotify(FAR struct socket *psock,
  *
  * Parameters:
  *   psock    An instance of the internal socket structure.
- *   buf      Data to send
- *   len      Length of data to send
+ *   iov      Array of buffers to send
+ *   iovcnt   Number of elements in iov[]
  *
  * Returned Value:
  *   On success, returns the number of characters sent.  On  error,
@@ -721,13 +728,15 @@ static inline void send_txnotify(FAR struct socket *psock,
  *
  ****************************************************************************/
 
-ssize_t psock_tcp_send(FAR struct socket *psock,
-                       FAR const void *buf, size_t len)
+ssize_t psock_tcp_sendv(FAR struct socket *psock,
+                        FAR const struct iovec *iov, int iovcnt)
 {
   FAR struct tcp_conn_s *conn;
   struct send_s state;
+  size_t len;
   int errcode;
   int ret = OK;
+  int i;
 
   /* Verify that the sockfd corresponds to valid, allocated socket */
 
@@ -786,6 +795,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+  /* Get the total length of the data */
+
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
   /* Set the socket state to sending */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
@@ -809,7 +825,8 @@ ssize_t psock_tcp_send(FAR struct socket *psock,
 
   state.snd_sock      = psock;             /* Socket descriptor to use */
   state.snd_buflen    = len;               /* Number of bytes to send */
-  state.snd_buffer    = buf;               /* Buffer to send from */
+  state.snd_iov       = iov;               /* Buffers to send from */
+  state.snd_iovcnt    = iovcnt;
 
   if (len > 0)
     {
@@ -892,6 +909,27 @@ errout:
   return ERROR;
 }
 
+/****************************************************************************
+ * Name: psock_tcp_send
+ *
+ * Description:
+ *   psock_tcp_send() call may be used only when the TCP socket is in a
+ *   connected state (so that the intended recipient is known).  See
+ *   psock_tcp_sendv().
+ *
+ ****************************************************************************/
+
+ssize_t psock_tcp_send(FAR struct socket *psock,
+                       FAR const void *buf, size_t len)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
+  return psock_tcp_sendv(psock, &iov, 1);
+}
+
 /****************************************************************************
  * Name: psock_tcp_cansend
  *
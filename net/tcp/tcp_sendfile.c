@@ -58,6 +58,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -96,9 +97,9 @@
 struct sendfile_s
 {
   FAR struct socket *snd_sock;    /* Points to the parent socket structure */
-  FAR struct devif_callback_s *snd_datacb; /* Data callback */
-  FAR struct devif_callback_s *snd_ackcb;  /* ACK callback */
+  FAR struct devif_callback_s *snd_datacb; /* Data and ACK callback */
   FAR struct file   *snd_file;    /* File structure of the input file */
+  FAR const uint8_t *snd_map;     /* Mapped file data (NULL: use file_read) */
   sem_t              snd_sem;     /* Used to wake up the waiting thread */
   off_t              snd_foffset; /* Input file offset */
   size_t             snd_flen;    /* File length */
@@ -154,110 +155,6 @@ static inline int sendfile_timeout(FAR struct sendfile_s *pstate)
 }
 #endif /* CONFIG_NET_SOCKOPTS */
 
-static uint16_t ack_eventhandler(FAR struct net_driver_s *dev,
-                                 FAR void *pvconn,
-                                 FAR void *pvpriv, uint16_t flags)
-{
-  FAR struct sendfile_s *pstate = (FAR struct sendfile_s *)pvpriv;
-
-  ninfo("flags: %04x\n", flags);
-
-  if ((flags & TCP_ACKDATA) != 0)
-    {
-      FAR struct tcp_hdr_s *tcp;
-
-#ifdef CONFIG_NET_SOCKOPTS
-      /* Update the timeout */
-
-      pstate->snd_time = clock_systimer();
-#endif
-
-      /* Get the offset address of the TCP header */
-
-#ifdef CONFIG_NET_IPv6
-#ifdef CONFIG_NET_IPv4
-      if (IFF_IS_IPv6(dev->d_flags))
-#endif
-        {
-          DEBUGASSERT(pstate->snd_sock == PF_INET6);
-          tcp = TCPIPv6BUF;
-        }
-#endif /* CONFIG_NET_IPv6 */
-
-#ifdef CONFIG_NET_IPv4
-#ifdef CONFIG_NET_IPv6
-      else
-#endif
-        {
-          DEBUGASSERT(pstate->snd_sock == PF_INET);
-          tcp = TCPIPv4BUF;
-        }
-#endif /* CONFIG_NET_IPv4 */
-
-      /* The current acknowledgement number number is the (relative) offset
-       * of the of the next byte needed by the receiver.  The snd_isn is the
-       * offset of the first byte to send to the receiver.  The difference
-       * is the number of bytes to be acknowledged.
-       */
-
-      pstate->snd_acked = tcp_getsequence(tcp->ackno) - pstate->snd_isn;
-      ninfo("ACK: acked=%d sent=%d flen=%d\n",
-            pstate->snd_acked, pstate->snd_sent, pstate->snd_flen);
-
-      dev->d_sndlen = 0;
-
-      flags &= ~TCP_ACKDATA;
-    }
-  else if ((flags & TCP_REXMIT) != 0)
-    {
-      nwarn("WARNING: TCP_REXMIT\n");
-
-      /* Yes.. in this case, reset the number of bytes that have been sent
-       * to the number of bytes that have been ACKed.
-       */
-
-      pstate->snd_sent = pstate->snd_acked;
-    }
-
-  /* Check for a loss of connection */
-
-  else if ((flags & TCP_DISCONN_EVENTS) != 0)
-    {
-      FAR struct socket *psock = pstate->snd_sock;
-
-      nwarn("WARNING: Lost connection\n");
-
-      /* We could get here recursively through the callback actions of
-       * tcp_lost_connection().  So don't repeat that action if we have
-       * already been disconnected.
-       */
-
-      DEBUGASSERT(psock != NULL);
-      if (_SS_ISCONNECTED(psock->s_flags))
-         {
-           /* Report not connected */
-
-           tcp_lost_connection(psock, pstate->snd_ackcb, flags);
-         }
-
-      /* Report not connected */
-
-      pstate->snd_sent = -ENOTCONN;
-    }
-
-  /* Prohibit further callbacks */
-
-  pstate->snd_ackcb->flags = 0;
-  pstate->snd_ackcb->priv  = NULL;
-  pstate->snd_ackcb->event = NULL;
-
-  /* Wake up the waiting thread */
-
-  nxsem_post(&pstate->snd_sem);
-
-  return flags;
-}
-
 /****************************************************************************
  * Name: sendfile_addrcheck
  *
@@ -318,15 +215,72 @@ static inline bool sendfile_addrcheck(FAR struct tcp_conn_s *conn)
 }
 
 #else /* CONFIG_NET_ETHERNET */
-#  sendfile_addrcheck(r) (true)
+#  define sendfile_addrcheck(r) (true)
 #endif /* CONFIG_NET_ETHERNET */
 
+/****************************************************************************
+ * Name: sendfile_copyin
+ *
+ * Description:
+ *   Copy the next 'sndlen' bytes of the file into the outgoing packet.  If
+ *   the file data could be mapped, the data is copied straight from the
+ *   file system storage into the packet buffer.  Otherwise, the file is
+ *   read into the packet buffer.
+ *
+ * Parameters:
+ *   dev    - The structure of the network driver that caused the event
+ *   pstate - send state structure
+ *   sndlen - The number of bytes to send
+ *
+ * Returned Value:
+ *   The number of bytes placed in the packet on success; a negated errno
+ *   value on failure.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_copyin(FAR struct net_driver_s *dev,
+                               FAR struct sendfile_s *pstate,
+                               uint32_t sndlen)
+{
+  off_t pos = pstate->snd_foffset + pstate->snd_sent;
+  ssize_t ret;
+
+  if (pstate->snd_map != NULL)
+    {
+      devif_send(dev, &pstate->snd_map[pos], sndlen);
+      return sndlen;
+    }
+
+  ret = file_seek(pstate->snd_file, pos, SEEK_SET);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to lseek: %d\n", (int)ret);
+      return ret;
+    }
+
+  ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
+      return ret;
+    }
+
+  dev->d_sndlen = ret;
+  return ret;
+}
+
 /****************************************************************************
  * Name: sendfile_eventhandler
  *
  * Description:
  *   This function is called to perform the actual send operation when
- *   polled by the lower, device interfacing layer.
+ *   polled by the lower, device interfacing layer.  It is also called
+ *   on ACK and retransmission events so that new segments are queued as
+ *   soon as the receive window opens, keeping as many segments in flight
+ *   as the window allows.
  *
  * Parameters:
  *   dev      The structure of the network driver that caused the event
@@ -347,7 +301,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
 {
   FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)pvconn;
   FAR struct sendfile_s *pstate = (FAR struct sendfile_s *)pvpriv;
-  int ret;
+  ssize_t ret;
 
   /* The TCP socket is connected and, hence, should be bound to a device.
    * Make sure that the polling device is the own that we are bound to.
@@ -362,9 +316,82 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
   ninfo("flags: %04x acked: %d sent: %d\n",
         flags, pstate->snd_acked, pstate->snd_sent);
 
+  /* If this packet contains an acknowledgement, then update the count of
+   * acknowledged bytes.
+   */
+
+  if ((flags & TCP_ACKDATA) != 0)
+    {
+      FAR struct tcp_hdr_s *tcp;
+
+#ifdef CONFIG_NET_SOCKOPTS
+      /* Update the timeout */
+
+      pstate->snd_time = clock_systimer();
+#endif
+
+      /* Get the offset address of the TCP header */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      if (IFF_IS_IPv6(dev->d_flags))
+#endif
+        {
+#ifdef CONFIG_NET_IPv4
+          DEBUGASSERT(conn->domain == PF_INET6);
+#endif
+          tcp = TCPIPv6BUF;
+        }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      else
+#endif
+        {
+#ifdef CONFIG_NET_IPv6
+          DEBUGASSERT(conn->domain == PF_INET);
+#endif
+          tcp = TCPIPv4BUF;
+        }
+#endif /* CONFIG_NET_IPv4 */
+
+      /* The current acknowledgement number number is the (relative) offset
+       * of the of the next byte needed by the receiver.  The snd_isn is the
+       * offset of the first byte to send to the receiver.  The difference
+       * is the number of bytes to be acknowledged.
+       */
+
+      pstate->snd_acked = tcp_getsequence(tcp->ackno) - pstate->snd_isn;
+      ninfo("ACK: acked=%d sent=%d flen=%d\n",
+            pstate->snd_acked, pstate->snd_sent, pstate->snd_flen);
+
+      /* Has all of the file data been sent and acknowledged? */
+
+      if (pstate->snd_acked >= pstate->snd_flen)
+        {
+          goto end_wait;
+        }
+
+      /* No.. fall through to send more data if the window allows */
+    }
+
+  /* Check if we are being asked to retransmit data */
+
+  else if ((flags & TCP_REXMIT) != 0)
+    {
+      nwarn("WARNING: TCP_REXMIT\n");
+
+      /* Yes.. in this case, reset the number of bytes that have been sent
+       * to the number of bytes that have been ACKed.
+       */
+
+      pstate->snd_sent = pstate->snd_acked;
+    }
+
   /* Check for a loss of connection */
 
-  if ((flags & TCP_DISCONN_EVENTS) != 0)
+  else if ((flags & TCP_DISCONN_EVENTS) != 0)
     {
       FAR struct socket *psock = pstate->snd_sock;
 
@@ -418,24 +445,28 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
+          ret = sendfile_copyin(dev, pstate, sndlen);
           if (ret < 0)
             {
-              nerr("ERROR: Failed to lseek: %d\n", ret);
               pstate->snd_sent = ret;
               goto end_wait;
             }
-
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
+          else if (ret == 0)
             {
-              nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
+              /* The file was truncated while we were sending it.  Send
+               * only what is already on its way.
+               */
+
+              pstate->snd_flen = pstate->snd_sent;
+              if (pstate->snd_acked >= pstate->snd_flen)
+                {
+                  goto end_wait;
+                }
+
+              return flags;
             }
 
-          dev->d_sndlen = sndlen;
+          sndlen = ret;
 
           /* Set the sequence number for this packet.  NOTE:  The network updates
            * sndseq on recept of ACK *before* this function is called.  In that
@@ -445,7 +476,8 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            */
 
           seqno = pstate->snd_sent + pstate->snd_isn;
-          ninfo("SEND: sndseq %08x->%08x len: %d\n", conn->sndseq, seqno, ret);
+          ninfo("SEND: sndseq %08x->%08x len: %d\n",
+                conn->sndseq, seqno, sndlen);
 
           tcp_setsequence(conn->sndseq, seqno);
 
@@ -465,8 +497,7 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
         }
       else
         {
-          nwarn("WARNING: Window full, wait for ack\n");
-          goto wait;
+          ninfo("Window full, wait for ack\n");
         }
     }
 
@@ -485,13 +516,9 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
     }
 #endif /* CONFIG_NET_SOCKOPTS */
 
-  if (pstate->snd_sent >= pstate->snd_flen
-      && pstate->snd_acked < pstate->snd_flen)
-    {
-      /* All data has been sent, but there are outstanding ACK's */
+  /* Continue waiting */
 
-      goto wait;
-    }
+  return flags;
 
 end_wait:
 
@@ -501,11 +528,13 @@ end_wait:
   pstate->snd_datacb->priv    = NULL;
   pstate->snd_datacb->event   = NULL;
 
+  /* There are no outstanding, unacknowledged bytes */
+
+  conn->unacked               = 0;
+
   /* Wake up the waiting thread */
 
   nxsem_post(&pstate->snd_sem);
-
-wait:
   return flags;
 }
 
@@ -528,6 +557,10 @@ wait:
 static inline void sendfile_txnotify(FAR struct socket *psock,
                                      FAR struct tcp_conn_s *conn)
 {
+  /* Have the next poll of the device visit this connection */
+
+  tcp_setready(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -567,11 +600,18 @@ static inline void sendfile_txnotify(FAR struct socket *psock,
  *   The tcp_sendfile() call may be used only when the INET socket is in a
  *   connected state (so that the intended recipient is known).
  *
+ *   If the file system can expose the file data in place (FIOC_MMAP, as
+ *   with ROMFS on XIP media or a TMPFS file held in one block), the file
+ *   data is copied straight from the file system storage into the
+ *   outgoing packets.  Otherwise, the file is read into each outgoing
+ *   packet.
+ *
  * Parameters:
  *   psock    An instance of the internal socket structure.
- *   buf      Data to send
- *   len      Length of data to send
- *   flags    Send flags
+ *   infile   The file to send
+ *   offset   The file offset to start from, or NULL to use (and update)
+ *            the current file position
+ *   count    The number of bytes to send
  *
  * Returned Value:
  *   On success, returns the number of characters sent.  On  error,
@@ -585,7 +625,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 {
   FAR struct tcp_conn_s *conn;
   struct sendfile_s state;
-  int ret;
+  FAR void *map = NULL;
+  off_t startpos;
+  off_t fsize;
+  int ret = OK;
 
   /* If this is an un-connected socket, then return ENOTCONN */
 
@@ -631,6 +674,61 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+  /* Get the size of the file so that we never send beyond its end.  If no
+   * offset is provided, we start at (and later update) the current file
+   * position.
+   */
+
+  startpos = infile->f_pos;
+  fsize    = file_seek(infile, 0, SEEK_END);
+  if (fsize < 0)
+    {
+      nerr("ERROR: Failed to lseek: %d\n", (int)fsize);
+      return (ssize_t)fsize;
+    }
+
+  memset(&state, 0, sizeof(struct sendfile_s));
+
+  state.snd_sock    = psock;                       /* Socket descriptor to use */
+  state.snd_foffset = offset ? *offset : startpos; /* Input file offset */
+  state.snd_file    = infile;                      /* File to read from */
+
+  if (state.snd_foffset >= fsize)
+    {
+      count = 0;
+    }
+  else if (count > fsize - state.snd_foffset)
+    {
+      count = fsize - state.snd_foffset;
+    }
+
+  state.snd_flen    = count;                       /* Number of bytes to send */
+  if (count == 0)
+    {
+      goto errout;
+    }
+
+  /* Try to map the file.  FIOC_MMAP succeeds only where the file system
+   * can expose the file data in place, without allocating or copying;
+   * every other file is sent through the file_read() path.
+   */
+
+  if (INODE_IS_MOUNTPT(infile->f_inode) &&
+      file_ioctl(infile, FIOC_MMAP, (unsigned long)((uintptr_t)&map)) >= 0)
+    {
+      if (map != NULL)
+        {
+          state.snd_map = (FAR const uint8_t *)map;
+        }
+      else
+        {
+          (void)file_ioctl(infile, FIOC_MUNMAP, 0);
+        }
+    }
+
+  ninfo("Send %lu bytes from offset %lu (%s)\n", (unsigned long)count,
+        (unsigned long)state.snd_foffset, map ? "mapped" : "read");
+
   /* Set the socket state to sending */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
@@ -641,7 +739,6 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
    */
 
   net_lock();
-  memset(&state, 0, sizeof(struct sendfile_s));
 
   /* This semaphore is used for signaling and, hence, should not have
    * priority inheritance enabled.
@@ -650,11 +747,6 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   nxsem_init(&state.snd_sem, 0, 0);           /* Doesn't really fail */
   nxsem_setprotocol(&state.snd_sem, SEM_PRIO_NONE);
 
-  state.snd_sock    = psock;                /* Socket descriptor to use */
-  state.snd_foffset = offset ? *offset : 0; /* Input file offset */
-  state.snd_flen    = count;                /* Number of bytes to send */
-  state.snd_file    = infile;               /* File to read from */
-
   /* Allocate resources to receive a callback */
 
   state.snd_datacb = tcp_callback_alloc(conn);
@@ -662,17 +754,8 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   if (state.snd_datacb == NULL)
     {
       nerr("ERROR: Failed to allocate data callback\n");
-      ret =- ENOMEM;
-      goto errout_locked;
-    }
-
-  state.snd_ackcb = tcp_callback_alloc(conn);
-
-  if (state.snd_ackcb == NULL)
-    {
-      nerr("ERROR: Failed to allocate ack callback\n");
       ret = -ENOMEM;
-      goto errout_datacb;
+      goto errout_locked;
     }
 
   /* Get the initial sequence number that will be used */
@@ -691,42 +774,61 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_time         = clock_systimer();
 #endif
 
-  /* Set up the ACK callback in the connection */
+  /* Set up the callback in the connection.  It stays armed until all of
+   * the data has been sent and acknowledged, so that each poll and each
+   * ACK can queue another segment without waking this thread.
+   */
+
+  state.snd_datacb->flags = (TCP_ACKDATA | TCP_REXMIT | TCP_POLL |
+                             TCP_DISCONN_EVENTS);
+  state.snd_datacb->priv  = (FAR void *)&state;
+  state.snd_datacb->event = sendfile_eventhandler;
 
-  state.snd_ackcb->flags = (TCP_ACKDATA | TCP_REXMIT | TCP_DISCONN_EVENTS);
-  state.snd_ackcb->priv  = (FAR void *)&state;
-  state.snd_ackcb->event = ack_eventhandler;
+  /* Notify the device driver of the availability of TX data */
 
-  /* Perform the TCP send operation */
+  sendfile_txnotify(psock, conn);
 
-  do
-    {
-      state.snd_datacb->flags = TCP_POLL;
-      state.snd_datacb->priv  = (FAR void *)&state;
-      state.snd_datacb->event = sendfile_eventhandler;
+  /* Wait for the send to complete.  net_lockedwait() will also terminate
+   * if a signal is received.
+   */
 
-      /* Notify the device driver of the availability of TX data */
+  ret = net_lockedwait(&state.snd_sem);
 
-      sendfile_txnotify(psock, conn);
-      net_lockedwait(&state.snd_sem);
-    }
-  while (state.snd_sent >= 0 && state.snd_acked < state.snd_flen);
+  tcp_callback_free(conn, state.snd_datacb);
+
+errout_locked:
 
   /* Set the socket state to idle */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
 
-  tcp_callback_free(conn, state.snd_ackcb);
+  nxsem_destroy(&state.snd_sem);
+  net_unlock();
+
+  if (state.snd_map != NULL)
+    {
+      (void)file_ioctl(infile, FIOC_MUNMAP, 0);
+    }
 
-errout_datacb:
-  tcp_callback_free(conn, state.snd_datacb);
+errout:
 
-errout_locked:
+  /* Leave the file position (or the caller's offset) just after the last
+   * byte that was sent.
+   */
 
-  nxsem_destroy(&state. snd_sem);
-  net_unlock();
+  if (state.snd_sent > 0)
+    {
+      if (offset != NULL)
+        {
+          *offset = state.snd_foffset + state.snd_sent;
+        }
+      else
+        {
+          startpos = state.snd_foffset + state.snd_sent;
+        }
+    }
 
-errout:
+  (void)file_seek(infile, startpos, SEEK_SET);
 
   if (ret < 0)
     {
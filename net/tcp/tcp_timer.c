@@ -196,6 +196,10 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
             }
           else
             {
+#ifdef CONFIG_NET_TCP_CC
+              unsigned int backoff;
+
+#endif
               /* Will decrement to zero */
 
               conn->timer = 0;
@@ -290,7 +294,14 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
              /* Exponential backoff. */
 
+#ifdef CONFIG_NET_TCP_CC
+              /* Back off from the measured RTO rather than the fixed one */
+
+              backoff = (unsigned int)conn->rto << (conn->nrtx > 4 ? 4: conn->nrtx);
+              conn->timer = backoff > TCP_CC_RTOMAX ? TCP_CC_RTOMAX : backoff;
+#else
               conn->timer = TCP_RTO << (conn->nrtx > 4 ? 4: conn->nrtx);
+#endif
               (conn->nrtx)++;
 
               /* Ok, so we need to retransmit. We do this differently
@@ -326,6 +337,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                      * the code for sending out the packet.
                      */
 
+#ifdef CONFIG_NET_TCP_CC
+                    tcp_cc_timeout(conn);
+#endif
                     result = tcp_callback(dev, conn, TCP_REXMIT);
                     tcp_rexmit(dev, conn, result);
                     goto done;
@@ -197,6 +197,59 @@ void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb)
   nxsem_post(&g_wrbuffer.sem);
 }
 
+/****************************************************************************
+ * Name: tcp_wrbuffer_inqueue_size
+ *
+ * Description:
+ *   Return the I/O buffer storage (bytes) held by the write buffers queued
+ *   on a connection, sent or not.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_wrbuffer_inqueue_size(FAR struct tcp_conn_s *conn)
+{
+  FAR sq_entry_t *entry;
+  uint32_t nbufs = 0;
+
+  for (entry = sq_peek(&conn->write_q); entry; entry = sq_next(entry))
+    {
+      nbufs += iob_count(TCP_WBIOB((FAR struct tcp_wrbuffer_s *)entry));
+    }
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      nbufs += iob_count(TCP_WBIOB((FAR struct tcp_wrbuffer_s *)entry));
+    }
+
+  return nbufs * CONFIG_IOB_BUFSIZE;
+}
+
+/****************************************************************************
+ * Name: tcp_sendbuffer_notify
+ *
+ * Description:
+ *   Wake up a sender that is waiting for the write buffers queued on a
+ *   connection to drop below the send buffer limit.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_sendbuffer_notify(FAR struct tcp_conn_s *conn)
+{
+  int val = 0;
+
+  nxsem_getvalue(&conn->sndsem, &val);
+  if (val < 0)
+    {
+      nxsem_post(&conn->sndsem);
+    }
+}
+
 /****************************************************************************
  * Name: tcp_wrbuffer_test
  *
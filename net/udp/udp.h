@@ -45,6 +45,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <queue.h>
+#include <semaphore.h>
 
 #include <nuttx/clock.h>
 #include <nuttx/net/ip.h>
@@ -68,6 +69,12 @@
 #  define HAVE_UDP_POLL
 #endif
 
+/* Maximum number of datagrams taken from one connection in one device poll */
+
+#ifndef CONFIG_NET_UDP_TXBURST
+#  define CONFIG_NET_UDP_TXBURST 1
+#endif
+
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
 /* UDP write buffer dump macros */
 
@@ -110,20 +117,28 @@ struct udp_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the UDP/IP read-ahead data is retained.
+   *   rcvbufs   - The most I/O buffer storage (bytes) that readahead may
+   *               hold (SO_RCVBUF).  Zero means no limit.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+  uint32_t rcvbufs;               /* Receive buffer limit */
 #endif
 
-#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Write buffering
    *
    *   write_q   - The queue of unsent I/O buffers.  The head of this
    *               list may be partially sent.  FIFO ordering.
+   *   sndbufs   - The most I/O buffer storage (bytes) that write_q may
+   *               hold (SO_SNDBUF).  Zero means no limit.
+   *   sndsem    - Senders wait here for write_q to drain below sndbufs.
    */
 
   sq_queue_t write_q;             /* Write buffering for UDP packets */
   FAR struct net_driver_s *dev;   /* Last device */
+  uint32_t sndbufs;               /* Send buffer limit */
+  sem_t    sndsem;                /* Waits for send buffer space */
 #endif
 
   /* Defines the list of UDP callbacks */
@@ -385,6 +400,38 @@ FAR struct udp_wrbuffer_s *udp_wrbuffer_alloc(void);
 void udp_wrbuffer_release(FAR struct udp_wrbuffer_s *wrb);
 #endif /* CONFIG_NET_UDP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Name: udp_wrbuffer_inqueue_size
+ *
+ * Description:
+ *   Return the I/O buffer storage (bytes) held by the write buffers queued
+ *   on a connection.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+uint32_t udp_wrbuffer_inqueue_size(FAR struct udp_conn_s *conn);
+#endif /* CONFIG_NET_UDP_WRITE_BUFFERS */
+
+/****************************************************************************
+ * Name: udp_sendbuffer_notify
+ *
+ * Description:
+ *   Wake up a sender that is waiting for the write buffers queued on a
+ *   connection to drop below the send buffer limit.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+void udp_sendbuffer_notify(FAR struct udp_conn_s *conn);
+#endif /* CONFIG_NET_UDP_WRITE_BUFFERS */
+
 /****************************************************************************
  * Name: udp_wrbuffer_test
  *
@@ -565,6 +612,19 @@ uint16_t udp_callback(FAR struct net_driver_s *dev,
 ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+/****************************************************************************
+ * Name: psock_udp_sendv
+ *
+ * Description:
+ *   Implements sendmsg() for connected UDP sockets.  The datagram payload
+ *   is gathered from the iov[] array.
+ *
+ ****************************************************************************/
+
+struct iovec;
+ssize_t psock_udp_sendv(FAR struct socket *psock,
+                        FAR const struct iovec *iov, int iovcnt);
+
 /****************************************************************************
  * Name: psock_udp_sendto
  *
@@ -594,6 +654,19 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags, FAR const struct sockaddr *to,
                          socklen_t tolen);
 
+/****************************************************************************
+ * Name: psock_udp_sendtov
+ *
+ * Description:
+ *   This is psock_udp_sendto() with the datagram payload gathered from an
+ *   array of buffers.  All of the buffers are sent as one datagram.
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendtov(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt, int flags,
+                          FAR const struct sockaddr *to, socklen_t tolen);
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
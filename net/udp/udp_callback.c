@@ -41,6 +41,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <debug.h>
 
@@ -62,10 +63,49 @@
 #define UDPIPv4BUF ((FAR struct udp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv4_HDRLEN])
 #define UDPIPv6BUF ((FAR struct udp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv6_HDRLEN])
 
+/* I/O buffers needed to hold 'n' bytes */
+
+#define UDP_NBUFFERS(n) (((n) + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_rcvbuf_avail
+ *
+ * Description:
+ *   Check if a datagram that needs 'nbufs' I/O buffers may be added to the
+ *   read-ahead queue:  It must fit in the receive buffer limit of the
+ *   connection and must leave the I/O buffers reserved for TCP.  A
+ *   datagram is always accepted into an empty queue as long as there are
+ *   I/O buffers for it so that a small limit cannot block the socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_READAHEAD
+static bool udp_rcvbuf_avail(FAR struct udp_conn_s *conn,
+                             unsigned int nbufs)
+{
+  if (iob_navail(true) < nbufs + CONFIG_NET_TCP_RECV_RESERVE)
+    {
+      return false;
+    }
+
+  if (conn->rcvbufs > 0 && !IOB_QEMPTY(&conn->readahead))
+    {
+      unsigned int queued = iob_queue_count(&conn->readahead);
+
+      if ((queued + nbufs) * CONFIG_IOB_BUFSIZE > conn->rcvbufs)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif /* CONFIG_NET_UDP_READAHEAD */
+
 /****************************************************************************
  * Name: udp_datahandler
  *
@@ -90,17 +130,6 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
   FAR void  *src_addr;
   uint8_t src_addr_size;
 
-  /* Allocate on I/O buffer to start the chain (throttling as necessary).
-   * We will not wait for an I/O buffer to become available in this context.
-   */
-
-  iob = iob_tryalloc(true);
-  if (iob == NULL)
-    {
-      nerr("ERROR: Failed to create new I/O buffer chain\n");
-      return 0;
-    }
-
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
@@ -164,6 +193,31 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
     }
 #endif /* CONFIG_NET_IPv4 */
 
+  /* The datagram is held as the address size, the address and the data.
+   * Drop it if that would exceed the receive buffer of the socket.
+   */
+
+  if (!udp_rcvbuf_avail(conn, UDP_NBUFFERS(sizeof(uint8_t) +
+                                            src_addr_size + buflen)))
+    {
+      nwarn("WARNING: No receive buffer space for %d bytes\n", buflen);
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.udp.rcvdrop++;
+#endif
+      return 0;
+    }
+
+  /* Allocate on I/O buffer to start the chain (throttling as necessary).
+   * We will not wait for an I/O buffer to become available in this context.
+   */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      nerr("ERROR: Failed to create new I/O buffer chain\n");
+      return 0;
+    }
+
   /* Copy the src address info into the I/O buffer chain.  We will not wait
    * for an I/O buffer to become available in this context.  It there is
    * any failure to allocated, the entire I/O buffer chain will be discarded.
@@ -486,10 +486,22 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
       conn->lport  = 0;
       conn->ttl    = IP_TTL;
 
-#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+#ifdef CONFIG_NET_UDP_READAHEAD
+      conn->rcvbufs = CONFIG_NET_RECV_BUFSIZE;
+#endif
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
       /* Initialize the write buffer lists */
 
       sq_init(&conn->write_q);
+      conn->sndbufs = CONFIG_NET_SEND_BUFSIZE;
+
+      /* The send buffer semaphore is used for signaling and, hence, should
+       * not have priority inheritance enabled.
+       */
+
+      nxsem_init(&conn->sndsem, 0, 0);
+      nxsem_setprotocol(&conn->sndsem, SEM_PRIO_NONE);
 #endif
       /* Enqueue the connection into the active list */
 
@@ -539,6 +551,8 @@ void udp_free(FAR struct udp_conn_s *conn)
     {
       udp_wrbuffer_release(wrbuffer);
     }
+
+  nxsem_destroy(&conn->sndsem);
 #endif
 
   /* Free the connection */
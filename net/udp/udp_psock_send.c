@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
@@ -54,15 +55,15 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: psock_udp_send
+ * Name: psock_udp_sendv
  *
  * Description:
- *   Implements send() for connected UDP sockets
+ *   Implements sendmsg() for connected UDP sockets
  *
  ****************************************************************************/
 
-ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
-                       size_t len)
+ssize_t psock_udp_sendv(FAR struct socket *psock,
+                        FAR const struct iovec *iov, int iovcnt)
 {
   FAR struct udp_conn_s *conn;
   union
@@ -118,5 +119,24 @@ ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
     }
 #endif /* CONFIG_NET_IPv6 */
 
-  return psock_udp_sendto(psock, buf, len, 0, &to.addr, tolen);
+  return psock_udp_sendtov(psock, iov, iovcnt, 0, &to.addr, tolen);
+}
+
+/****************************************************************************
+ * Name: psock_udp_send
+ *
+ * Description:
+ *   Implements send() for connected UDP sockets
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_send(FAR struct socket *psock, FAR const void *buf,
+                       size_t len)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
+  return psock_udp_sendv(psock, &iov, 1);
 }
@@ -51,6 +51,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -178,6 +179,7 @@ static void sendto_writebuffer_release(FAR struct socket *psock,
           DEBUGASSERT(wrb != NULL);
 
           udp_wrbuffer_release(wrb);
+          udp_sendbuffer_notify(conn);
 
           /* Set up for the next packet transfer by setting the connection
            * address to the address of the next packet now at the header of
@@ -556,8 +558,10 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
 
           sendto_writebuffer_release(psock, conn);
 
-          /* Only one data can be sent by low level driver at once,
-           * tell the caller stop polling the other connections.
+          /* Only one datagram can be sent in this poll of the connection.
+           * Tell the caller to stop polling the other callbacks;
+           * devif_poll() will poll the connection again for the next
+           * datagram if the driver can take it.
            */
 
           flags &= ~UDP_POLL;
@@ -587,16 +591,17 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 /****************************************************************************
- * Name: psock_udp_sendto
+ * Name: psock_udp_sendtov
  *
  * Description:
  *   This function implements the UDP-specific logic of the standard
- *   sendto() socket operation.
+ *   sendto() socket operation with the datagram payload gathered from an
+ *   array of buffers.
  *
  * Input Parameters:
  *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
+ *   iov      Array of buffers to send
+ *   iovcnt   Number of elements in iov[]
  *   flags    Send flags
  *   to       Address of recipient
  *   tolen    The length of the address structure
@@ -611,13 +616,17 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
-                         size_t len, int flags, FAR const struct sockaddr *to,
-                         socklen_t tolen)
+ssize_t psock_udp_sendtov(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt, int flags,
+                          FAR const struct sockaddr *to, socklen_t tolen)
 {
   FAR struct udp_conn_s *conn;
   FAR struct udp_wrbuffer_s *wrb;
+  size_t len;
+  size_t offset;
+  bool empty;
   int ret = OK;
+  int i;
 
   /* Make sure that we have the IP address mapping */
 
@@ -656,9 +665,13 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
-  /* Dump the incoming buffer */
+  /* Get the total length of the datagram and dump the incoming buffers */
 
-  BUF_DUMP("psock_udp_send", buf, len);
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      BUF_DUMP("psock_udp_send", iov[i].iov_base, iov[i].iov_len);
+      len += iov[i].iov_len;
+    }
 
   /* Set the socket state to sending */
 
@@ -666,11 +679,32 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
   if (len > 0)
     {
+      net_lock();
+
+      /* Wait until the write buffers queued on the socket drop below its
+       * send buffer limit.  Non-blocking sockets cannot wait.
+       */
+
+      while (conn->sndbufs > 0 &&
+             udp_wrbuffer_inqueue_size(conn) >= conn->sndbufs)
+        {
+          if (_SS_ISNONBLOCK(psock->s_flags))
+            {
+              ret = -EAGAIN;
+              goto errout_with_lock;
+            }
+
+          ret = net_lockedwait(&conn->sndsem);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
+        }
+
       /* Allocate a write buffer.  Careful, the network will be momentarily
        * unlocked here.
        */
 
-      net_lock();
       wrb = udp_wrbuffer_alloc();
       if (wrb == NULL)
         {
@@ -690,18 +724,30 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
        * buffer space if the socket was opened non-blocking.
        */
 
-      if (_SS_ISNONBLOCK(psock->s_flags))
-        {
-          ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf, len, 0, false);
-        }
-      else
-        {
-          ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf, len, 0, false);
-        }
-
-      if (ret < 0)
+      for (i = 0, offset = 0; i < iovcnt; i++)
         {
-          goto errout_with_wrb;
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          if (_SS_ISNONBLOCK(psock->s_flags))
+            {
+              ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)iov[i].iov_base,
+                                  iov[i].iov_len, offset, false);
+            }
+          else
+            {
+              ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)iov[i].iov_base,
+                               iov[i].iov_len, offset, false);
+            }
+
+          if (ret < 0)
+            {
+              goto errout_with_wrb;
+            }
+
+          offset += iov[i].iov_len;
         }
 
       /* Dump I/O buffer chain */
@@ -719,6 +765,7 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
        * not a very common use case, however.
        */
 
+      empty = sq_empty(&conn->write_q);
       sq_addlast(&wrb->wb_node, &conn->write_q);
       ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
             wrb, wrb->wb_iob->io_pktlen,
@@ -726,15 +773,21 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
       /* Set up for the next packet transfer by setting the connection
        * address to the address of the next packet now at the header of the
-       * write buffer queue.
+       * write buffer queue.  If other write buffers were already queued,
+       * the transfer of the one at the head is already set up and this
+       * one will follow when that has been sent.  A batch of datagrams
+       * queued by sendmmsg() thus sets up the transfer only once.
        */
 
-     ret = sendto_next_transfer(psock, conn);
-     if (ret < 0)
-       {
-         (void)sq_remlast(&conn->write_q);
-         goto errout_with_wrb;
-       }
+      if (empty)
+        {
+          ret = sendto_next_transfer(psock, conn);
+          if (ret < 0)
+            {
+              (void)sq_remlast(&conn->write_q);
+              goto errout_with_wrb;
+            }
+        }
 
       net_unlock();
     }
@@ -755,4 +808,25 @@ errout_with_lock:
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_udp_sendto
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the standard
+ *   sendto() socket operation.  See psock_udp_sendtov().
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags, FAR const struct sockaddr *to,
+                         socklen_t tolen)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
+  return psock_udp_sendtov(psock, &iov, 1, flags, to, tolen);
+}
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP && CONFIG_NET_UDP_WRITE_BUFFERS */
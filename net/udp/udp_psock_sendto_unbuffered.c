@@ -42,6 +42,7 @@
 #ifdef CONFIG_NET_UDP
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>
@@ -86,7 +87,8 @@ struct sendto_s
   FAR struct devif_callback_s *st_cb; /* Reference to callback instance */
   sem_t st_sem;                       /* Semaphore signals sendto completion */
   uint16_t st_buflen;                 /* Length of send buffer (error if <0) */
-  const char *st_buffer;              /* Pointer to send buffer */
+  FAR const struct iovec *st_iov;     /* Buffers holding the datagram */
+  int st_iovcnt;                      /* Number of buffers in st_iov[] */
   int st_sndlen;                      /* Result of the send (length sent or negated errno) */
 };
 
@@ -268,7 +270,8 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
 
           /* Copy the user data into d_appdata and send it */
 
-          devif_send(dev, pstate->st_buffer, pstate->st_buflen);
+          devif_iov_send(dev, pstate->st_iov, pstate->st_iovcnt,
+                         pstate->st_buflen, 0);
           pstate->st_sndlen = pstate->st_buflen;
         }
 
@@ -291,16 +294,17 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 /****************************************************************************
- * Name: psock_udp_sendto
+ * Name: psock_udp_sendtov
  *
  * Description:
  *   This function implements the UDP-specific logic of the standard
- *   sendto() socket operation.
+ *   sendto() socket operation with the datagram payload gathered from an
+ *   array of buffers.
  *
  * Input Parameters:
  *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
+ *   iov      Array of buffers to send
+ *   iovcnt   Number of elements in iov[]
  *   flags    Send flags
  *   to       Address of recipient
  *   tolen    The length of the address structure
@@ -315,14 +319,16 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
-                         size_t len, int flags, FAR const struct sockaddr *to,
-                         socklen_t tolen)
+ssize_t psock_udp_sendtov(FAR struct socket *psock,
+                          FAR const struct iovec *iov, int iovcnt, int flags,
+                          FAR const struct sockaddr *to, socklen_t tolen)
 {
   FAR struct udp_conn_s *conn;
   FAR struct net_driver_s *dev;
   struct sendto_s state;
+  size_t len;
   int ret;
+  int i;
 
 #if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ICMPv6_NEIGHBOR)
 #ifdef CONFIG_NET_ARP_SEND
@@ -362,6 +368,13 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+  /* Get the total length of the datagram */
+
+  for (i = 0, len = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
   /* Set the socket state to sending */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
@@ -382,7 +395,8 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
   nxsem_setprotocol(&state.st_sem, SEM_PRIO_NONE);
 
   state.st_buflen = len;
-  state.st_buffer = buf;
+  state.st_iov    = iov;
+  state.st_iovcnt = iovcnt;
 
 #if defined(CONFIG_NET_SOCKOPTS) || defined(NEED_IPDOMAIN_SUPPORT)
   /* Save the reference to the socket structure if it will be needed for
@@ -477,4 +491,25 @@ errout_with_lock:
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_udp_sendto
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the standard
+ *   sendto() socket operation.  See psock_udp_sendtov().
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags, FAR const struct sockaddr *to,
+                         socklen_t tolen)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
+  return psock_udp_sendtov(psock, &iov, 1, flags, to, tolen);
+}
+
 #endif /* CONFIG_NET_UDP */
@@ -196,6 +196,53 @@ void udp_wrbuffer_release(FAR struct udp_wrbuffer_s *wrb)
   nxsem_post(&g_wrbuffer.sem);
 }
 
+/****************************************************************************
+ * Name: udp_wrbuffer_inqueue_size
+ *
+ * Description:
+ *   Return the I/O buffer storage (bytes) held by the write buffers queued on a connection.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+uint32_t udp_wrbuffer_inqueue_size(FAR struct udp_conn_s *conn)
+{
+  FAR sq_entry_t *entry;
+  uint32_t nbufs = 0;
+
+  for (entry = sq_peek(&conn->write_q); entry; entry = sq_next(entry))
+    {
+      nbufs += iob_count(((FAR struct udp_wrbuffer_s *)entry)->wb_iob);
+    }
+
+  return nbufs * CONFIG_IOB_BUFSIZE;
+}
+
+/****************************************************************************
+ * Name: udp_sendbuffer_notify
+ *
+ * Description:
+ *   Wake up a sender that is waiting for the write buffers queued on a
+ *   connection to drop below the send buffer limit.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void udp_sendbuffer_notify(FAR struct udp_conn_s *conn)
+{
+  int val = 0;
+
+  nxsem_getvalue(&conn->sndsem, &val);
+  if (val < 0)
+    {
+      nxsem_post(&conn->sndsem);
+    }
+}
+
 /****************************************************************************
  * Name: udp_wrbuffer_test
  *
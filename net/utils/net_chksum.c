@@ -41,6 +41,7 @@
 #ifdef CONFIG_NET
 
 #include <stdint.h>
+#include <string.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -57,6 +58,89 @@
 #define IPv4BUF   ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF   ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The accumulator used by the generic chksum() and chksum_copy() */
+
+#ifdef CONFIG_NET_CHKSUM_ACC64
+typedef uint64_t chksum_acc_t;
+#else
+typedef uint32_t chksum_acc_t;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_fold
+ *
+ * Description:
+ *   Fold the wide accumulator of chksum() and chksum_copy() into 16 bits,
+ *   convert it to host order and add it to the carried-over sum.
+ *
+ *   The words were summed in memory order.  The one's complement sum does
+ *   not depend on byte order (RFC 1071), so on a little-endian machine it
+ *   is enough to swap the bytes of the folded result.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_NET_ARCH_CHKSUM_CORE)
+static inline uint16_t chksum_fold(uint16_t sum, chksum_acc_t acc)
+{
+#ifdef CONFIG_NET_CHKSUM_ACC64
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+#endif
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+#ifndef CONFIG_ENDIAN_BIG
+  acc = ((acc & 0xff) << 8) | ((acc >> 8) & 0xff);
+#endif
+
+  acc += sum;
+  acc  = (acc & 0xffff) + (acc >> 16);
+  return (uint16_t)acc;
+}
+#endif
+
+/****************************************************************************
+ * Name: chksum_bytes
+ *
+ * Description:
+ *   Sum a region that does not start on a 16-bit boundary one byte pair at
+ *   a time.  The returned value is in host order.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_NET_ARCH_CHKSUM_CORE)
+static uint16_t chksum_bytes(uint16_t sum, FAR const uint8_t *data,
+                             uint16_t len)
+{
+  uint32_t acc = sum;
+
+  while (len > 1)
+    {
+      acc  += ((uint16_t)data[0] << 8) | data[1];
+      data += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+      acc += (uint16_t)data[0] << 8;
+    }
+
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+  return (uint16_t)acc;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -68,6 +152,11 @@
  *   Calculate the raw change some over the memory region described by
  *   data and len.
  *
+ *   The data is summed a word at a time into a wide accumulator and the
+ *   carries are folded back once at the end:  16-bit words into 32 bits,
+ *   or 32-bit words into 64 bits with CONFIG_NET_CHKSUM_ACC64.  Neither
+ *   accumulator can overflow for a 16-bit length.
+ *
  * Input Parameters:
  *   sum  - Partial calculations carried over from a previous call to chksum().
  *          This should be zero on the first time that check sum is called.
@@ -79,43 +168,200 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_NET_ARCH_CHKSUM_CORE)
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  FAR const uint16_t *p16;
+#ifdef CONFIG_NET_CHKSUM_ACC64
+  FAR const uint32_t *p32;
+#endif
+  chksum_acc_t acc = 0;
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  if (((uintptr_t)data & 1) != 0)
+    {
+      return chksum_bytes(sum, data, len);
+    }
+
+  p16 = (FAR const uint16_t *)data;
 
-  while (dataptr < last_byte)
+#ifdef CONFIG_NET_CHKSUM_ACC64
+  if (((uintptr_t)p16 & 2) != 0 && len > 1)
     {
-      /* At least two more bytes */
+      acc += *p16++;
+      len -= 2;
+    }
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  p32 = (FAR const uint32_t *)p16;
+  while (len >= 16)
+    {
+      acc += p32[0];
+      acc += p32[1];
+      acc += p32[2];
+      acc += p32[3];
+      p32 += 4;
+      len -= 16;
+    }
+
+  while (len >= 4)
+    {
+      acc += *p32++;
+      len -= 4;
+    }
 
-      dataptr += 2;
+  p16 = (FAR const uint16_t *)p32;
+#else
+  while (len >= 16)
+    {
+      acc += p16[0];
+      acc += p16[1];
+      acc += p16[2];
+      acc += p16[3];
+      acc += p16[4];
+      acc += p16[5];
+      acc += p16[6];
+      acc += p16[7];
+      p16 += 8;
+      len -= 16;
     }
+#endif
 
-  if (dataptr == last_byte)
+  while (len > 1)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
+      acc += *p16++;
+      len -= 2;
+    }
+
+  /* A trailing odd byte is the high order byte of a zero-padded word */
+
+  if (len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc += (uint16_t)(*(FAR const uint8_t *)p16) << 8;
+#else
+      acc += *(FAR const uint8_t *)p16;
+#endif
+    }
+
+  /* Return sum in host byte order. */
+
+  return chksum_fold(sum, acc);
+}
+#endif /* !CONFIG_NET_ARCH_CHKSUM && !CONFIG_NET_ARCH_CHKSUM_CORE */
+
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy len bytes from src to dest and return the raw checksum of the
+ *   data, as chksum() would.  The data is read only once, so this is
+ *   cheaper than memcpy() followed by chksum() when a send path moves
+ *   payload into the packet buffer.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum() or chksum_copy().
+ *   dest - The location to copy the data to.
+ *   src  - The data to be copied and included in the checksum.
+ *   len  - Length of the data.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && !defined(CONFIG_NET_ARCH_CHKSUM_CORE)
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len)
+{
+  FAR const uint16_t *s16;
+  FAR uint16_t *d16;
+  chksum_acc_t acc = 0;
+
+  /* Both buffers must be 16-bit aligned, otherwise copy and sum in two
+   * passes.
+   */
+
+  if ((((uintptr_t)src | (uintptr_t)dest) & 1) != 0)
+    {
+      memcpy(dest, src, len);
+      return chksum(sum, dest, len);
+    }
+
+  s16 = (FAR const uint16_t *)src;
+  d16 = (FAR uint16_t *)dest;
+
+#ifdef CONFIG_NET_CHKSUM_ACC64
+  /* Use 32-bit words only if both buffers can be brought to a 32-bit
+   * boundary together.
+   */
+
+  if ((((uintptr_t)s16 ^ (uintptr_t)d16) & 2) == 0)
+    {
+      FAR const uint32_t *s32;
+      FAR uint32_t *d32;
+
+      if (((uintptr_t)s16 & 2) != 0 && len > 1)
         {
-          sum++; /* carry */
+          acc   += *s16;
+          *d16++ = *s16++;
+          len   -= 2;
         }
+
+      s32 = (FAR const uint32_t *)s16;
+      d32 = (FAR uint32_t *)d16;
+
+      while (len >= 4)
+        {
+          uint32_t word = *s32++;
+
+          acc    += word;
+          *d32++  = word;
+          len    -= 4;
+        }
+
+      s16 = (FAR const uint16_t *)s32;
+      d16 = (FAR uint16_t *)d32;
     }
+#endif
 
-  /* Return sum in host byte order. */
+  while (len > 1)
+    {
+      uint16_t word = *s16++;
+
+      acc    += word;
+      *d16++  = word;
+      len    -= 2;
+    }
+
+  if (len > 0)
+    {
+      uint8_t byte = *(FAR const uint8_t *)s16;
+
+      *(FAR uint8_t *)d16 = byte;
+#ifdef CONFIG_ENDIAN_BIG
+      acc += (uint16_t)byte << 8;
+#else
+      acc += byte;
+#endif
+    }
+
+  return chksum_fold(sum, acc);
+}
+#endif /* !CONFIG_NET_ARCH_CHKSUM && !CONFIG_NET_ARCH_CHKSUM_CORE */
+
+#ifdef CONFIG_NET_ARCH_CHKSUM
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len)
+{
+  uint32_t acc;
+
+  /* Only net_chksum() is available from the architecture */
+
+  memcpy(dest, src, len);
 
-  return sum;
+  acc = (uint32_t)sum + ntohs(net_chksum((FAR uint16_t *)dest, len));
+  acc = (acc & 0xffff) + (acc >> 16);
+  return (uint16_t)acc;
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
@@ -1,5 +1,5 @@
 /****************************************************************************
- * libc/stdio/lib_readv.c
+ * net/utils/net_chksum_adjust.c
  *
  *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
  *   Author: Gregory Nutt <gnutt@nuttx.org>
@@ -37,95 +37,87 @@
  * Included Files
  ****************************************************************************/
 
-#include <sys/types.h>
-#include <sys/uio.h>
-#include <unistd.h>
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include "utils/utils.h"
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: readv()
+ * Name: net_chksum_adjust
  *
  * Description:
- *   The readv() function is equivalent to read(), except as described below.
- *   The readv() function places the input data into the iovcnt buffers
- *   specified by the members of the iov array: iov[0], iov[1], ...,
- *   iov[iovcnt-1].  The iovcnt argument is valid if greater than 0 and less
- *   than or equal to IOV_MAX as defined in limits.h.
+ *   Update an Internet checksum for a 16-bit word of the covered data
+ *   that has been changed from oldval to newval, instead of summing all
+ *   of the data again (RFC 1624, eqn. 3):
+ *
+ *     HC' = ~(~HC + ~m + m')
  *
- *   Each iovec entry specifies the base address and length of an area in
- *   memory where data should be placed.  The readv() function will always
- *   fill an area completely before proceeding to the next.
+ *   The one's complement sum does not depend on byte order, so the
+ *   checksum and the two values may be passed just as they are held in
+ *   the packet (i.e., in network order) as long as all three are.
  *
- *   Upon successful completion, readv() will mark for update the st_atime
- *   field of the file.
+ *   A UDP checksum of zero means that no checksum was sent.  It is up to
+ *   the caller not to adjust such a checksum and to replace a result of
+ *   zero with 0xffff.
  *
  * Input Parameters:
- *   filedes - The open file descriptor for the file to be read
- *   iov     - Array of read buffer descriptors
- *   iovcnt  - Number of elements in iov[]
+ *   chksum - The current checksum field of the packet
+ *   oldval - The 16-bit word before it was changed
+ *   newval - The 16-bit word after it was changed
  *
  * Returned Value:
- *   Upon successful completion, readv() will return a non-negative integer
- *   indicating the number of bytes actually read.  Otherwise, the functions
- *   will return -1 and set errno to indicate the error.  See read().
+ *   The new value of the checksum field.
  *
  ****************************************************************************/
 
-ssize_t readv(int fildes, FAR const struct iovec *iov, int iovcnt)
+uint16_t net_chksum_adjust(uint16_t chksum, uint16_t oldval, uint16_t newval)
 {
-  ssize_t ntotal;
-  ssize_t nread;
-  size_t remaining;
-  FAR uint8_t *buffer;
-  int i;
-
-  /* Process each entry in the struct iovec array */
-
-  for (i = 0, ntotal = 0; i < iovcnt; i++)
-    {
-      /* Ignore zero-length reads */
-
-      if (iov[i].iov_len > 0)
-        {
-          buffer    = iov[i].iov_base;
-          remaining = iov[i].iov_len;
+  uint32_t sum;
 
-          /* Read repeatedly as necessary to fill buffer */
+  sum  = (uint16_t)~chksum;
+  sum += (uint16_t)~oldval;
+  sum += newval;
+  sum  = (sum & 0xffff) + (sum >> 16);
+  sum  = (sum & 0xffff) + (sum >> 16);
 
-          do
-            {
-              /* NOTE:  read() is a cancellation point */
-
-              nread = read(fildes, buffer, remaining);
-
-              /* Check for a read error */
-
-              if (nread < 0)
-                {
-                  return nread;
-                }
-
-              /* Check for an end-of-file condition */
+  return (uint16_t)~sum;
+}
 
-              else if (nread == 0)
-                {
-                  return ntotal;
-                }
+/****************************************************************************
+ * Name: net_chksum_adjust32
+ *
+ * Description:
+ *   Same as net_chksum_adjust() but for a changed 32-bit value such as an
+ *   IPv4 address or a TCP sequence number.  The value must be 16-bit
+ *   aligned within the data covered by the checksum.
+ *
+ * Input Parameters:
+ *   chksum - The current checksum field of the packet
+ *   oldval - The 32-bit value before it was changed
+ *   newval - The 32-bit value after it was changed
+ *
+ * Returned Value:
+ *   The new value of the checksum field.
+ *
+ ****************************************************************************/
 
-              /* Update pointers and counts in order to handle partial
-               * buffer reads.
-               */
+uint16_t net_chksum_adjust32(uint16_t chksum, uint32_t oldval,
+                             uint32_t newval)
+{
+  uint32_t sum;
 
-              buffer    += nread;
-              remaining -= nread;
-              ntotal    += nread;
-            }
-          while (remaining > 0);
-        }
-    }
+  sum  = (uint16_t)~chksum;
+  sum += (uint16_t)~(oldval >> 16);
+  sum += (uint16_t)~oldval;
+  sum += newval >> 16;
+  sum += newval & 0xffff;
+  sum  = (sum & 0xffff) + (sum >> 16);
+  sum  = (sum & 0xffff) + (sum >> 16);
 
-  return ntotal;
+  return (uint16_t)~sum;
 }
@@ -213,6 +213,51 @@ void net_ipv6_pref2mask(uint8_t preflen, net_ipv6addr_t mask);
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 #endif
 
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy the data from src to dest and calculate its raw checksum in the
+ *   same pass.  The result is the same as memcpy() followed by chksum().
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum() or chksum_copy().
+ *   dest - The location to copy the data to.
+ *   src  - The data to be copied and included in the checksum.
+ *   len  - Length of the data.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len);
+
+/****************************************************************************
+ * Name: net_chksum_adjust and net_chksum_adjust32
+ *
+ * Description:
+ *   Update the checksum of a packet after a 16- or 32-bit value covered by
+ *   the checksum has been rewritten (RFC 1624).  Used when forwarding or
+ *   rewriting headers so that the whole packet need not be summed again.
+ *   The checksum and the values are all passed in network order.
+ *
+ * Input Parameters:
+ *   chksum - The current checksum field of the packet
+ *   oldval - The value before it was changed
+ *   newval - The value after it was changed
+ *
+ * Returned Value:
+ *   The new value of the checksum field.
+ *
+ ****************************************************************************/
+
+uint16_t net_chksum_adjust(uint16_t chksum, uint16_t oldval, uint16_t newval);
+uint16_t net_chksum_adjust32(uint16_t chksum, uint32_t oldval,
+                             uint32_t newval);
+
 /****************************************************************************
  * Name: net_chksum
  *